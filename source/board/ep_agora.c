@@ -32,4 +32,5 @@ const board_info_t g_board_info = {
     .target_cfg = &target_device_nrf52840,
     .board_vendor = "Embedded Planet",
     .board_name = "Agora",
+    .uf2_family_id = UF2_FAMILY_ID_NRF52840,
 };
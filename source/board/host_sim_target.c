@@ -0,0 +1,117 @@
+/**
+ * @file    host_sim_target.c
+ * @brief   board ID and meta-data for the simulated target of the host_sim HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "target_config.h"
+#include "target_board.h"
+#include "target_family.h"
+#include "util.h"
+#include "swd_target_sim.h"
+
+// The simulated core does not execute the algorithm, it recognizes the entry
+// points below (see swd_target_sim.c). Every word is a BKPT so a real core
+// would halt immediately.
+static const uint32_t HOST_SIM_FLM[] = {
+    0xBE00BE00, 0xBE00BE00, 0xBE00BE00, 0xBE00BE00, 0xBE00BE00, 0xBE00BE00, 0xBE00BE00, 0xBE00BE00,
+    0xBE00BE00, 0xBE00BE00, 0xBE00BE00, 0xBE00BE00,
+};
+
+/**
+* List of start and size for each size of flash sector
+* The size will apply to all sectors between the listed address and the next address
+* in the list.
+* The last pair in the list will have sectors starting at that address and ending
+* at address start + size.
+*/
+static const sector_info_t sectors_info[] = {
+    {0, KB(4)},
+ };
+
+static const program_target_t flash = {
+    0x20000005, // Init
+    0x20000009, // UnInit
+    0x2000000D, // EraseChip
+    0x20000011, // EraseSector
+    0x20000015, // ProgramPage
+    0x20000019, // Verify
+
+    // breakpoint = RAM start + 1
+    // RSB : base address is address of Execution Region PrgData in map file
+    //       to access global/static data
+    // RSP : Initial stack pointer
+    {
+        0x20000001, // breakpoint instruction address
+        0x20000030, // static base register value (unused)
+        0x20000800  // initial stack pointer
+    },
+
+    0x20001000, // program_buffer, any valid RAM location with +512 bytes of headroom
+    0x20000000, // algo_start, start of RAM
+    sizeof(HOST_SIM_FLM), // algo_size, size of array above
+    HOST_SIM_FLM,  // image, flash algo instruction array
+    KB(4),      // ram_to_flash_bytes_to_be_written
+    kAlgoVerifyReturnsAddress | kAlgoEraseSectorRange, // algo_flags
+    0x2000001D, // ProgramPages
+    0x20000021, // ProgramCompressed
+};
+
+target_cfg_t target_device = {
+    .version                    = kTargetConfigVersion,
+    .sectors_info               = sectors_info,
+    .sector_info_length         = (sizeof(sectors_info))/(sizeof(sector_info_t)),
+    .flash_regions[0].start     = 0x00000000,
+    .flash_regions[0].end       = KB(512),
+    .flash_regions[0].flags     = kRegionIsDefault,
+    .flash_regions[0].flash_algo = (program_target_t *) &flash,
+    .ram_regions[0].start       = 0x20000000,
+    .ram_regions[0].end         = 0x20010000,
+    .target_vendor              = "DAPLink",
+    .target_part_number         = "host_sim_target",
+};
+
+static const swd_target_sim_config_t sim_config = {
+    .idcode             = 0x2BA01477,
+    .cpuid              = 0x410FC241,   // Cortex-M4 r0p1
+    .flash_start        = 0x00000000,
+    .flash_size         = KB(512),
+    .sector_size        = KB(4),
+    .page_size          = KB(1),
+    .ram_start          = 0x20000000,
+    .ram_size           = KB(64),
+    .erase_sector_us    = 20000,
+    .erase_chip_us      = 250000,
+    .program_page_us    = 1000,
+    .flash_algo         = &flash,
+};
+
+static void prerun_board_config(void)
+{
+    swd_target_sim_init(&sim_config);
+}
+
+const board_info_t g_board_info = {
+    .info_version = kBoardInfoVersion,
+    .board_id = "0000",
+    .family_id = kStub_SWSysReset_FamilyID,
+    .prerun_board_config = prerun_board_config,
+    .target_cfg = &target_device,
+    .board_vendor = "DAPLink",
+    .board_name = "host_sim target",
+};
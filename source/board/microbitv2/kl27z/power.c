@@ -217,7 +217,7 @@ static void power_pre_switch_hook(smc_power_state_t originPowerState, app_power_
     while (!(LPUART_STAT_TC_MASK & UART->STAT))
     {
     }
-    uart_uninitialize();
+    uart_uninitialize(0);
 
     /* Disable pins to lower current leakage */
     PORT_SetPinMux(UART_PORT, PIN_UART_RX_BIT, kPORT_PinDisabledOrAnalog);
@@ -257,7 +257,7 @@ static void power_post_switch_hook(smc_power_state_t originPowerState, app_power
     PORT_SetPinMux(UART_PORT, PIN_UART_RX_BIT, (port_mux_t)PIN_UART_RX_MUX_ALT);
     PORT_SetPinMux(UART_PORT, PIN_UART_TX_BIT, (port_mux_t)PIN_UART_TX_MUX_ALT);
 
-    uart_initialize();
+    uart_initialize(0);
     // TODO: Check if this is necessary, when we have time to test. This has always been in the V2 code.
     // It used to be at the end of board_handle_powerdown. We are not aware that this is causing a problem,
     // but it seems odd if we have been woken by an I2C transaction from the target.
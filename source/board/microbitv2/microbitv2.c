@@ -479,4 +479,5 @@ const board_info_t g_board_info = {
     .target_set_state = target_set_state_microbit,
     .board_vendor = "Micro:bit Educational Foundation",
     .board_name = "BBC micro:bit V2",
+    .uf2_family_id = UF2_FAMILY_ID_NRF52833,
 };
@@ -117,7 +117,7 @@ static void power_before(bool systemoff)
     // KL27 waits "for debug console output finished" by checking (LPUART_STAT_TC_MASK & UART->STAT),
     // but we never get here with USB connected, so there is no need to wait
 
-    uart_uninitialize(); // disables RX and TX pins
+    uart_uninitialize(0); // disables RX and TX pins
 
     gpio_disable_hid_led();
     
@@ -185,7 +185,7 @@ static void power_after()
     /* Configure I/O pin SWCLK, SWDIO */
     PORT_SWD_SETUP();
     
-    uart_initialize();
+    uart_initialize(0);
     // The KL27 code calls i2c_deinitialize() and i2c_initialize()
     // but tests have indicated this is not necessary here
 }
@@ -33,4 +33,5 @@ const board_info_t g_board_info = {
     .target_cfg = &target_device,
     .board_vendor = "NXP",
     .board_name = "MIMXRT1060-EVK",
+    .uf2_family_id = UF2_FAMILY_ID_MIMXRT10XX,
 };
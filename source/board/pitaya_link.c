@@ -34,4 +34,5 @@ const board_info_t g_board_info = {
     .target_cfg = &target_device_nrf52840,
     .board_vendor = "makerdiary",
     .board_name = "Pitaya-Link",
+    .uf2_family_id = UF2_FAMILY_ID_NRF52840,
 };
@@ -76,7 +76,7 @@ void HardFault_Handler()
     register unsigned int _lr __asm("lr");
     _fault_handler(_lr);
 }
-#else // gcc and armclang
+#elif defined(__arm__) // gcc and armclang
 void HardFault_Handler()
 {
     __ASM volatile (
@@ -178,7 +178,8 @@ void main_task(void * arg)
         }
 
         if (flags & FLAGS_MAIN_90MS) {
-            vfs_mngr_periodic(90); // FLAGS_MAIN_90MS
+            // Poll the vfs state machine
+            vfs_mngr_process();
 
             // Update USB busy status
             switch (usb_busy) {
@@ -22,7 +22,40 @@
 #include <string.h>
 #include "DAP_queue.h"
 #include "daplink_vendor_commands.h"
+#include "itm_bridge.h"
 #include "main_interface.h"
+#include "swd_sched.h"
+#include "util.h"
+#include "cmsis_os2.h"
+
+// The CMSIS-DAP timestamp, or the RTOS tick where there is none
+#if (TIMESTAMP_CLOCK != 0)
+#define TRACE_TIME()            TIMESTAMP_GET()
+#define TRACE_CLOCK()           TIMESTAMP_CLOCK
+#else
+#define TRACE_TIME()            osKernelGetTickCount()
+#define TRACE_CLOCK()           osKernelGetTickFreq()
+#endif
+
+#if DAP_TRACE_COUNT
+static DAP_trace_record trace[DAP_TRACE_COUNT];
+static uint32_t trace_head;     // Records written since the reset
+static BOOL trace_enabled = __TRUE;
+
+static void trace_add(const DAP_queue * queue, const uint8_t *reqbuf, int len, uint32_t start, uint32_t rsize)
+{
+    DAP_trace_record *record = &trace[trace_head % DAP_TRACE_COUNT];
+
+    record->timestamp = start;
+    record->duration = TRACE_TIME() - start;
+    record->request_size = rsize >> 16;
+    record->response_size = rsize & 0xFFFF;
+    record->queued = queue->send_count;
+    memset(record->request, 0, sizeof(record->request));
+    memcpy(record->request, reqbuf, MIN(len, sizeof(record->request)));
+    trace_head++;
+}
+#endif
 
 void DAP_queue_init(DAP_queue * queue)
 {
@@ -30,6 +63,12 @@ void DAP_queue_init(DAP_queue * queue)
     queue->send_idx = 0;
     queue->free_count = FREE_COUNT_INIT;
     queue->send_count = SEND_COUNT_INIT;
+    queue->packet_size = DAP_PACKET_SIZE;
+}
+
+void DAP_queue_set_packet_size(DAP_queue * queue, uint32_t size)
+{
+    queue->packet_size = MIN(size, DAP_PACKET_SIZE);
 }
 
 /*
@@ -65,6 +104,56 @@ __WEAK uint8_t DAP_activity_blink(const uint8_t *buf)
             buf[0] == ID_DAP_MSD_Write) ? 0 : 1;
 }
 
+// SWO commands change the trace indexes the ITM bridge reads with
+static bool DAP_uses_trace(const uint8_t *buf)
+{
+    switch (buf[0]) {
+        case ID_DAP_SWO_Transport:
+        case ID_DAP_SWO_Mode:
+        case ID_DAP_SWO_Baudrate:
+        case ID_DAP_SWO_Control:
+        case ID_DAP_SWO_Status:
+        case ID_DAP_SWO_ExtendedStatus:
+        case ID_DAP_SWO_Data:
+        case ID_DAP_ExecuteCommands:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Commands that neither drive SWD/JTAG nor change how it is driven, so
+// they do not wait while another thread holds the link for a flash erase
+static bool DAP_uses_link(const uint8_t *buf)
+{
+    switch (buf[0]) {
+        case ID_DAP_Info:
+        case ID_DAP_HostStatus:
+        case ID_DAP_Delay:
+        case ID_DAP_SWO_Transport:
+        case ID_DAP_SWO_Mode:
+        case ID_DAP_SWO_Baudrate:
+        case ID_DAP_SWO_Control:
+        case ID_DAP_SWO_Status:
+        case ID_DAP_SWO_ExtendedStatus:
+        case ID_DAP_SWO_Data:
+        case ID_DAP_GetUniqueID:
+        case ID_DAP_UART_GetLineCoding:
+        case ID_DAP_UART_SetConfiguration:
+        case ID_DAP_UART_Read:
+        case ID_DAP_UART_Write:
+        case ID_DAP_SetUSBTestMode:
+        case ID_DAP_SelectEraseMode:
+        case ID_DAP_ITM_Bridge:
+        case ID_DAP_RTT_Bridge:
+        case ID_DAP_CDC_Latency:
+        case ID_DAP_TraceRead:
+            return false;
+        default:
+            return true;
+    }
+}
+
 /*
  *  Execute a request and store result to the DAP_queue
  *    Parameters:      queue - DAP queue, reqbuf = buffer with DAP request, len = of the request buffer, retbuf = buffer to peek on the result of the DAP operation
@@ -75,6 +164,11 @@ __WEAK uint8_t DAP_activity_blink(const uint8_t *buf)
 BOOL DAP_queue_execute_buf(DAP_queue * queue, const uint8_t *reqbuf, int len, uint8_t ** retbuf)
 {
     uint32_t rsize;
+    bool link;
+    bool trace;
+#if DAP_TRACE_COUNT
+    uint32_t start;
+#endif
     if (queue->free_count > 0) {
         if (DAP_activity_blink(reqbuf)) {
             main_blink_hid_led(MAIN_LED_FLASH);
@@ -85,7 +179,34 @@ BOOL DAP_queue_execute_buf(DAP_queue * queue, const uint8_t *reqbuf, int len, ui
         }
         queue->free_count--;
         memcpy(queue->USB_Request[queue->recv_idx], reqbuf, len);
+        link = DAP_uses_link(reqbuf);
+        trace = DAP_uses_trace(reqbuf);
+        if (trace) {
+            itm_bridge_lock();
+        }
+        if (link) {
+            swd_sched_begin(SWD_SCHED_INTERACTIVE);
+        }
+#if DAP_TRACE_COUNT
+        start = TRACE_TIME();
+#endif
         rsize = DAP_ExecuteCommand(reqbuf, queue->USB_Request[queue->recv_idx]);
+        if (link) {
+            swd_sched_end(SWD_SCHED_INTERACTIVE);
+        }
+        if (trace) {
+            itm_bridge_unlock();
+        }
+#if DAP_TRACE_COUNT
+        if (trace_enabled) {
+            trace_add(queue, reqbuf, len, start, rsize);
+        }
+#endif
+        // DAP_PACKET_SIZE is shared by all transports, report the one of this queue
+        if ((reqbuf[0] == ID_DAP_Info) && (reqbuf[1] == DAP_ID_PACKET_SIZE)) {
+            queue->USB_Request[queue->recv_idx][2] = (uint8_t)(queue->packet_size >> 0);
+            queue->USB_Request[queue->recv_idx][3] = (uint8_t)(queue->packet_size >> 8);
+        }
         queue->resp_size[queue->recv_idx] = rsize & 0xFFFF; //get the response size
         *retbuf = queue->USB_Request[queue->recv_idx];
         queue->recv_idx = (queue->recv_idx + 1) % DAP_PACKET_COUNT;
@@ -94,3 +215,45 @@ BOOL DAP_queue_execute_buf(DAP_queue * queue, const uint8_t *reqbuf, int len, ui
     }
     return (__FALSE);
 }
+
+void DAP_queue_trace_start(void)
+{
+#if DAP_TRACE_COUNT
+    trace_head = 0;
+    trace_enabled = __TRUE;
+#endif
+}
+
+void DAP_queue_trace_stop(void)
+{
+#if DAP_TRACE_COUNT
+    trace_enabled = __FALSE;
+#endif
+}
+
+BOOL DAP_queue_trace_get(uint32_t index, DAP_trace_record * record)
+{
+#if DAP_TRACE_COUNT
+    uint32_t count = DAP_queue_trace_count();
+
+    if (index < count) {
+        *record = trace[(trace_head - count + index) % DAP_TRACE_COUNT];
+        return (__TRUE);
+    }
+#endif
+    return (__FALSE);
+}
+
+uint32_t DAP_queue_trace_count(void)
+{
+#if DAP_TRACE_COUNT
+    return MIN(trace_head, DAP_TRACE_COUNT);
+#else
+    return 0;
+#endif
+}
+
+uint32_t DAP_queue_trace_clock(void)
+{
+    return TRACE_CLOCK();
+}
@@ -33,6 +33,24 @@ extern "C" {
 #define FREE_COUNT_INIT          (DAP_PACKET_COUNT)
 #define SEND_COUNT_INIT          0
 
+// Number of executed requests kept in the trace, 0 leaves the trace out.
+// Each one costs sizeof(DAP_trace_record) of RAM.
+#ifndef DAP_TRACE_COUNT
+#define DAP_TRACE_COUNT          0
+#endif
+
+// First bytes of a request kept in the trace, enough for the transfer counts
+#define DAP_TRACE_REQUEST_SIZE   7
+
+typedef struct _DAP_trace_record {
+    uint32_t    timestamp;      // Start of the execution, in DAP_queue_trace_clock() ticks
+    uint32_t    duration;       // Ticks spent in DAP_ExecuteCommand()
+    uint16_t    request_size;   // Bytes of the request that were executed
+    uint16_t    response_size;
+    uint8_t     queued;         // Responses waiting to be sent, this one excluded
+    uint8_t     request[DAP_TRACE_REQUEST_SIZE];    // Starts with the command ID
+} DAP_trace_record;
+
 typedef struct _DAP_queue {
     uint8_t     USB_Request [DAP_PACKET_COUNT][DAP_PACKET_SIZE];  // Request  Buffer
     uint16_t    resp_size[DAP_PACKET_COUNT]; //track the return response size
@@ -40,10 +58,18 @@ typedef struct _DAP_queue {
     uint32_t    send_count;
     uint32_t    recv_idx;
     uint32_t    send_idx;
+    uint32_t    packet_size; //packet size reported by DAP_Info
 } DAP_queue;
 
 void DAP_queue_init(DAP_queue * queue);
 
+/*
+ *  Set the packet size DAP_Info reports for the requests of this queue
+ *    Parameters:      queue - DAP queue, size - largest request the transport takes, at most DAP_PACKET_SIZE
+ *    Return Value:    None
+ */
+void DAP_queue_set_packet_size(DAP_queue * queue, uint32_t size);
+
 /*
  *  Get the a buffer from the DAP_queue where the response to the request is stored
  *    Parameters:      queue - DAP queue, buf = return the buffer location, len = return the len of the response
@@ -58,6 +84,41 @@ BOOL DAP_queue_get_send_buf(DAP_queue * queue, uint8_t ** buf, int * len);
  */
 BOOL DAP_queue_execute_buf(DAP_queue * queue, const uint8_t *reqbuf, int len, uint8_t ** retbuf);
 
+/*
+ *  Clear the trace of executed requests and record the next ones. It records from power up.
+ *    Parameters:      None
+ *    Return Value:    None
+ */
+void DAP_queue_trace_start(void);
+
+/*
+ *  Stop recording, the trace is kept for reading
+ *    Parameters:      None
+ *    Return Value:    None
+ */
+void DAP_queue_trace_stop(void);
+
+/*
+ *  Get a record of the trace, the oldest first
+ *    Parameters:      index - record number, record = return the record
+ *    Return Value:    TRUE - Success, FALSE - No such record
+ */
+BOOL DAP_queue_trace_get(uint32_t index, DAP_trace_record * record);
+
+/*
+ *  Get the number of records in the trace
+ *    Parameters:      None
+ *    Return Value:    Records, at most DAP_TRACE_COUNT
+ */
+uint32_t DAP_queue_trace_count(void);
+
+/*
+ *  Get the frequency the trace times are counted in
+ *    Parameters:      None
+ *    Return Value:    Ticks per second
+ */
+uint32_t DAP_queue_trace_clock(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,11 +39,15 @@
 #include "target_family.h"
 #include "flash_manager.h"
 #include "util.h"
+#include "itm_bridge.h"
+#include "rtt_bridge.h"
 #include <string.h>
 #include "daplink_vendor_commands.h"
+#include "DAP_queue.h"
 
 #ifdef DRAG_N_DROP_SUPPORT
 #include "file_stream.h"
+#include "transfer_perf.h"
 
 // Reusing the MSC sector buffer from vfs_manager.c to save memory
 // as using both at the same time will break anyway
@@ -88,7 +92,7 @@ uint32_t DAP_ProcessVendorCommand(const uint8_t *request, uint8_t *response) {
         // get line coding
         int32_t read_len = sizeof(CDC_LINE_CODING);
         CDC_LINE_CODING cdc_line_coding;
-        USBD_CDC_ACM_PortGetLineCoding(&cdc_line_coding);
+        USBD_CDC_ACM_PortGetLineCoding(0, &cdc_line_coding);
         memcpy(response, &cdc_line_coding, read_len);
         num += (read_len + 1);
         break;
@@ -96,13 +100,13 @@ uint32_t DAP_ProcessVendorCommand(const uint8_t *request, uint8_t *response) {
     case ID_DAP_UART_SetConfiguration: {
         // set uart configuration
         CDC_LINE_CODING cdc_line_coding;
-        USBD_CDC_ACM_PortGetLineCoding(&cdc_line_coding);
+        USBD_CDC_ACM_PortGetLineCoding(0, &cdc_line_coding);
         //set BaudRate
         uint32_t baud_rate = 0;
         memcpy(&baud_rate, request, sizeof(uint32_t));
         cdc_line_coding.dwDTERate = baud_rate;
-        USBD_CDC_ACM_PortSetLineCoding(&cdc_line_coding);
-        USBD_CDC_ACM_SendBreak(0);
+        USBD_CDC_ACM_PortSetLineCoding(0, &cdc_line_coding);
+        USBD_CDC_ACM_SendBreak(0, 0);
         *response = 1;
         num += (sizeof(uint32_t) << 16) | 1;
         break;
@@ -110,7 +114,7 @@ uint32_t DAP_ProcessVendorCommand(const uint8_t *request, uint8_t *response) {
     case ID_DAP_UART_Read:  {
         // uart read
         int32_t read_len = 62;
-        read_len = uart_read_data(response + 1, read_len);
+        read_len = uart_read_data(0, response + 1, read_len);
         if (read_len) {
             main_blink_cdc_led(MAIN_LED_FLASH);
         }
@@ -123,7 +127,7 @@ uint32_t DAP_ProcessVendorCommand(const uint8_t *request, uint8_t *response) {
         // uart write
         int32_t write_len = *request;
         request++;
-        uart_write_data((uint8_t *)request, write_len);
+        uart_write_data(0, (uint8_t *)request, write_len);
         main_blink_cdc_led(MAIN_LED_FLASH);
         *response = 1;
         num += ((write_len + 1) << 16) | 1;
@@ -224,9 +228,61 @@ uint32_t DAP_ProcessVendorCommand(const uint8_t *request, uint8_t *response) {
         num += (1U << 16) | 1U; // increment request and response count each by 1
         break;
     }
-    case ID_DAP_Vendor14: break;
-    case ID_DAP_Vendor15: break;
-    case ID_DAP_Vendor16: break;
+    case ID_DAP_ITM_Bridge: {
+        // forward ITM stimulus ports received over SWO to the virtual COM port
+        //              COMMAND(OUT Packet)
+        //              BYTE 0 1000 1110 0x8E
+        //              BYTE 1-4 Stimulus port mask, 0 stops the bridge
+        //              BYTE 5-8 SWO baudrate
+        //              RESPONSE(IN Packet)
+        //              BYTE 0
+        //                                              0x00 - OK
+        //                                              0xFF - Error
+        uint32_t port_mask;
+        uint32_t baudrate;
+        memcpy(&port_mask, request, sizeof(uint32_t));
+        memcpy(&baudrate, request + sizeof(uint32_t), sizeof(uint32_t));
+        if (0 == port_mask) {
+            itm_bridge_stop();
+            *response = DAP_OK;
+        } else {
+            *response = itm_bridge_start(baudrate, port_mask) ? DAP_OK : DAP_ERROR;
+        }
+        num += (8U << 16) | 1U;
+        break;
+    }
+    case ID_DAP_RTT_Bridge: {
+        // connect the virtual COM port to RTT channel 0 of the target
+        //              COMMAND(OUT Packet)
+        //              BYTE 0 1000 1111 0x8F
+        //              BYTE 1 Desired Mode:
+        //                                              0x00 - Target UART
+        //                                              nonzero - RTT channel 0
+        //              RESPONSE(IN Packet)
+        //              BYTE 0
+        //                                              0x00 - OK
+        rtt_bridge_enable(0x00U != *request);
+        *response = DAP_OK;
+        num += (1U << 16) | 1U;
+        break;
+    }
+    case ID_DAP_CDC_Latency: {
+        // set the latency timer of the virtual COM port
+        //              COMMAND(OUT Packet)
+        //              BYTE 0 1001 0000 0x90
+        //              BYTE 1 Latency in ms, a partial packet waits at most
+        //                     this long for more data. 0 sends it right away
+        //              RESPONSE(IN Packet)
+        //              BYTE 0
+        //                                              0x00 - OK
+        // Kept in flash, only write a change
+        if (config_get_cdc_latency() != *request) {
+            config_set_cdc_latency(*request);
+        }
+        *response = DAP_OK;
+        num += (1U << 16) | 1U;
+        break;
+    }
     case ID_DAP_Vendor17: break;
     case ID_DAP_Vendor18: break;
     case ID_DAP_Vendor19: break;
@@ -248,4 +304,107 @@ uint32_t DAP_ProcessVendorCommand(const uint8_t *request, uint8_t *response) {
   return (num);
 }
 
+/** Process DAP Vendor extended Command and prepare Response Data
+\param request   pointer to request data
+\param response  pointer to response data
+\return          number of bytes in response (lower 16 bits)
+                 number of bytes in request (upper 16 bits)
+*/
+uint32_t DAP_ProcessVendorCommandEx(const uint8_t *request, uint8_t *response) {
+  uint32_t num = (1U << 16) | 1U;
+
+  *response++ = *request;        // copy Command ID
+
+  switch (*request++) {          // first byte in request is Command ID
+#ifdef DRAG_N_DROP_SUPPORT
+    case ID_DAP_TransferPerf: {
+        // read the counters of the last drag-n-drop transfer
+        //              COMMAND(OUT Packet)
+        //              BYTE 0 1010 0000 0xA0
+        //              BYTE 1 Phase, the phase count for the whole transfer
+        //              RESPONSE(IN Packet)
+        //              BYTE 0
+        //                                              0x00 - OK
+        //                                              0xFF - No transfer or unknown phase
+        //              BYTE 1 Phase count
+        //              BYTE 2-5 Time in the phase in us
+        //              BYTE 6-9 Bytes handled by the phase
+        //              BYTE 10-13 Bytes per second while in the phase
+        transfer_perf_counter_t counter;
+        bool valid = (*request <= TRANSFER_PERF_PHASE_COUNT) &&
+                     transfer_perf_get((transfer_perf_phase_t)*request, &counter);
+        if (!valid) {
+            memset(&counter, 0, sizeof(counter));
+        }
+        response[0] = valid ? DAP_OK : DAP_ERROR;
+        response[1] = TRANSFER_PERF_PHASE_COUNT;
+        memcpy(&response[2], &counter.time_us, sizeof(uint32_t));
+        memcpy(&response[6], &counter.bytes, sizeof(uint32_t));
+        memcpy(&response[10], &counter.bytes_per_s, sizeof(uint32_t));
+        num += (1U << 16) | 14U;
+        break;
+    }
+#endif
+    case ID_DAP_TraceRead: {
+        // read the trace of executed requests
+        //              COMMAND(OUT Packet)
+        //              BYTE 0 1010 0001 0xA1
+        //              BYTE 1 Operation
+        //                                              0x00 - Read
+        //                                              0x01 - Clear and record
+        //                                              0x02 - Stop recording
+        //              BYTE 2-3 First record to read, 0 is the oldest
+        //              RESPONSE(IN Packet)
+        //              BYTE 0
+        //                                              0x00 - OK
+        //                                              0xFF - No trace in this build
+        //              BYTE 1-2 Records in the trace
+        //              BYTE 3-6 Ticks per second of the times
+        //              BYTE 7 Records in this response
+        //              BYTE 8.. Records of 20 bytes: start time (4), duration (4),
+        //                       request size (2), response size (2), queued responses (1),
+        //                       first 7 bytes of the request
+        DAP_trace_record record;
+        uint32_t index = request[1] | (request[2] << 8);
+        uint32_t count;
+        uint32_t clock;
+        uint8_t *data = &response[8];
+        uint8_t n = 0;
+
+        if (request[0] == 1) {
+            DAP_queue_trace_start();
+        } else if (request[0] == 2) {
+            DAP_queue_trace_stop();
+        }
+        // Only the records written in full fit a packet
+        while ((data + 20 <= response + DAP_PACKET_SIZE - 1) &&
+               DAP_queue_trace_get(index + n, &record)) {
+            memcpy(&data[0], &record.timestamp, sizeof(uint32_t));
+            memcpy(&data[4], &record.duration, sizeof(uint32_t));
+            memcpy(&data[8], &record.request_size, sizeof(uint16_t));
+            memcpy(&data[10], &record.response_size, sizeof(uint16_t));
+            data[12] = record.queued;
+            memcpy(&data[13], record.request, DAP_TRACE_REQUEST_SIZE);
+            data += 20;
+            n++;
+        }
+        count = DAP_queue_trace_count();
+        clock = DAP_queue_trace_clock();
+        response[0] = (DAP_TRACE_COUNT > 0) ? DAP_OK : DAP_ERROR;
+        response[1] = count & 0xFF;
+        response[2] = (count >> 8) & 0xFF;
+        memcpy(&response[3], &clock, sizeof(uint32_t));
+        response[7] = n;
+        num += (3U << 16) | (8U + 20U * n);
+        break;
+    }
+    default:
+        // Not one of ours
+        *(response - 1) = ID_DAP_Invalid;
+        break;
+  }
+
+  return (num);
+}
+
 ///@}
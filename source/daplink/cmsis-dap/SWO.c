@@ -732,6 +732,38 @@ uint32_t SWO_Data (const uint8_t *request, uint8_t *response) {
 }
 
 
+// Read captured trace data on the probe (DAPLink extension)
+//   buf:    pointer to buffer for trace data
+//   num:    maximum number of bytes to read
+//   return: number of bytes read
+// Only available while no host transport is selected, so that on-probe
+// consumers (e.g. the ITM to CDC bridge) never race with DAP_SWO_Data.
+uint32_t SWO_ReadTrace (uint8_t *buf, uint32_t num) {
+  uint32_t count;
+  uint32_t index;
+  uint32_t i, n;
+
+  if (TraceTransport != 0U) {
+    return (0U);
+  }
+
+  count = GetTraceCount();
+  if (count > num) {
+    count = num;
+  }
+
+  index = TraceIndexO;
+  for (i = index, n = count; n; n--) {
+    i &= SWO_BUFFER_SIZE - 1U;
+    *buf++ = TraceBuf[i++];
+  }
+  TraceIndexO = index + count;
+  ResumeTrace();
+
+  return (count);
+}
+
+
 #if (SWO_STREAM != 0)
 
 // SWO Data Transfer complete callback
@@ -27,6 +27,7 @@
 
 #include "DAP_config.h"
 #include "DAP.h"
+#include "swd_sched.h"
 
 #if defined(__CC_ARM)
 #pragma push
@@ -283,11 +284,20 @@ SWD_TransferFunction(Slow)
 //   data:    DATA[31:0]
 //   return:  ACK[2:0]
 __WEAK uint8_t  SWD_Transfer(uint32_t request, uint32_t *data) {
+  uint8_t ack;
+
   if (DAP_Data.fast_clock) {
-    return SWD_TransferFast(request, data);
+    ack = SWD_TransferFast(request, data);
   } else {
-    return SWD_TransferSlow(request, data);
+    ack = SWD_TransferSlow(request, data);
+  }
+
+  // SELECT is write only, the link scheduler follows it here
+  if ((ack == DAP_TRANSFER_OK) &&
+      ((request & (DAP_TRANSFER_APnDP | DAP_TRANSFER_RnW | DAP_TRANSFER_A2 | DAP_TRANSFER_A3)) == DP_SELECT)) {
+    swd_sched_select_written(*data);
   }
+  return ack;
 }
 
 
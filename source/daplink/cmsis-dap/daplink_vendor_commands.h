@@ -35,5 +35,14 @@
 #define ID_DAP_MSD_Close                ID_DAP_Vendor11
 #define ID_DAP_MSD_Write                ID_DAP_Vendor12
 #define ID_DAP_SelectEraseMode          ID_DAP_Vendor13
+#define ID_DAP_ITM_Bridge               ID_DAP_Vendor14
+#define ID_DAP_RTT_Bridge               ID_DAP_Vendor15
+#define ID_DAP_CDC_Latency              ID_DAP_Vendor16
+//@}
+
+//! @name DAPLink vendor-specific extended CMSIS-DAP command IDs
+//@{
+#define ID_DAP_TransferPerf             ID_DAP_VendorExFirst
+#define ID_DAP_TraceRead                (ID_DAP_VendorExFirst + 1)
 //@}
 
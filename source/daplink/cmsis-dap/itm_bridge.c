@@ -0,0 +1,201 @@
+/**
+ * @file    itm_bridge.c
+ * @brief   Forward ITM stimulus port output from SWO to the virtual COM port
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cmsis_os2.h"
+#include "DAP_config.h"
+#include "DAP.h"
+#include "itm_bridge.h"
+#include "itm_decoder.h"
+
+#if ((SWO_UART != 0) || (SWO_MANCHESTER != 0))
+
+// Raw trace staging buffer, decoded in place
+#define ITM_RAW_BUFFER_SIZE 64
+
+static itm_decoder_t decoder;
+static uint8_t raw_buf[ITM_RAW_BUFFER_SIZE];
+static uint32_t raw_pos;
+static uint32_t raw_len;
+static bool active = false;
+
+static osMutexId_t trace_mutex;
+static const osMutexAttr_t k_trace_mutex_attr = {
+    .name = "swo",
+    .attr_bits = osMutexRecursive | osMutexPrioInherit,
+};
+
+// Run one of the single byte SWO command handlers
+static bool swo_command(uint32_t (*handler)(const uint8_t *, uint8_t *), uint8_t arg)
+{
+    uint8_t response;
+
+    handler(&arg, &response);
+    return response == DAP_OK;
+}
+
+static bool swo_set_baudrate(uint32_t baudrate)
+{
+    uint8_t request[4];
+    uint8_t response[4];
+
+    request[0] = (uint8_t)(baudrate >> 0);
+    request[1] = (uint8_t)(baudrate >> 8);
+    request[2] = (uint8_t)(baudrate >> 16);
+    request[3] = (uint8_t)(baudrate >> 24);
+    SWO_Baudrate(request, response);
+    return (response[0] | response[1] | response[2] | response[3]) != 0;
+}
+
+static void stop_capture(void)
+{
+    if (!active) {
+        return;
+    }
+    active = false;
+    swo_command(SWO_Control, 0);
+    swo_command(SWO_Mode, DAP_SWO_OFF);
+}
+
+static bool start_capture(uint32_t baudrate, uint32_t port_mask)
+{
+    uint8_t status[5];
+
+    SWO_Status(status);
+    if (!active && (status[0] & DAP_SWO_CAPTURE_ACTIVE)) {
+        // A debugger is already using SWO
+        return false;
+    }
+
+    stop_capture();
+    if (!swo_command(SWO_Transport, 0) ||
+        !swo_command(SWO_Mode, DAP_SWO_UART) ||
+        !swo_set_baudrate(baudrate) ||
+        !swo_command(SWO_Control, DAP_SWO_CAPTURE_ACTIVE)) {
+        swo_command(SWO_Mode, DAP_SWO_OFF);
+        return false;
+    }
+
+    itm_decoder_init(&decoder, port_mask);
+    raw_pos = 0;
+    raw_len = 0;
+    active = true;
+    return true;
+}
+
+void itm_bridge_init(void)
+{
+    trace_mutex = osMutexNew(&k_trace_mutex_attr);
+}
+
+void itm_bridge_lock(void)
+{
+    osMutexAcquire(trace_mutex, osWaitForever);
+}
+
+void itm_bridge_unlock(void)
+{
+    osMutexRelease(trace_mutex);
+}
+
+bool itm_bridge_start(uint32_t baudrate, uint32_t port_mask)
+{
+    bool started;
+
+    itm_bridge_lock();
+    started = start_capture(baudrate, port_mask);
+    itm_bridge_unlock();
+    return started;
+}
+
+void itm_bridge_stop(void)
+{
+    itm_bridge_lock();
+    stop_capture();
+    itm_bridge_unlock();
+}
+
+bool itm_bridge_is_active(void)
+{
+    return active;
+}
+
+uint32_t itm_bridge_read(uint8_t *buf, uint32_t size)
+{
+    uint32_t total = 0;
+    uint32_t produced;
+
+    if (!active) {
+        return 0;
+    }
+
+    itm_bridge_lock();
+    // Stopped while waiting for the lock
+    while (active && (total < size)) {
+        if (raw_pos >= raw_len) {
+            raw_pos = 0;
+            raw_len = SWO_ReadTrace(raw_buf, sizeof(raw_buf));
+            if (0 == raw_len) {
+                break;
+            }
+        }
+        raw_pos += itm_decoder_process(&decoder, &raw_buf[raw_pos], raw_len - raw_pos,
+                                       &buf[total], size - total, &produced);
+        total += produced;
+    }
+    itm_bridge_unlock();
+
+    return total;
+}
+
+#else
+
+void itm_bridge_init(void)
+{
+}
+
+void itm_bridge_lock(void)
+{
+}
+
+void itm_bridge_unlock(void)
+{
+}
+
+bool itm_bridge_start(uint32_t baudrate, uint32_t port_mask)
+{
+    return false;
+}
+
+void itm_bridge_stop(void)
+{
+}
+
+bool itm_bridge_is_active(void)
+{
+    return false;
+}
+
+uint32_t itm_bridge_read(uint8_t *buf, uint32_t size)
+{
+    return 0;
+}
+
+#endif
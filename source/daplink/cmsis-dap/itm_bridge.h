@@ -0,0 +1,69 @@
+/**
+ * @file    itm_bridge.h
+ * @brief   Forward ITM stimulus port output from SWO to the virtual COM port
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ITM_BRIDGE_H
+#define ITM_BRIDGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @brief Create the SWO trace lock, before the DAP and CDC threads run.
+void itm_bridge_init(void);
+
+//! @brief Take the SWO trace.
+//!
+//! The DAP thread holds it while it runs SWO commands and the bridge while
+//! it reads the trace, so the trace indexes are changed by one thread at a
+//! time.
+void itm_bridge_lock(void);
+
+//! @brief Give back the SWO trace taken with itm_bridge_lock().
+void itm_bridge_unlock(void);
+
+//! @brief Start SWO capture and decode ITM packets for the CDC port.
+//!
+//! Fails if the HIC has no SWO support or if a debugger currently owns the
+//! SWO capture.
+//!
+//! @param baudrate SWO UART baudrate of the target.
+//! @param port_mask Bitmask of ITM stimulus ports to forward.
+//! @return True if capture was started.
+bool itm_bridge_start(uint32_t baudrate, uint32_t port_mask);
+
+//! @brief Stop SWO capture started by itm_bridge_start().
+void itm_bridge_stop(void);
+
+//! @brief Check whether the bridge is forwarding trace data.
+bool itm_bridge_is_active(void);
+
+//! @brief Read decoded stimulus port data.
+//! @return Number of bytes written to @a buf.
+uint32_t itm_bridge_read(uint8_t *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
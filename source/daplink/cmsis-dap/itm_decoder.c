@@ -0,0 +1,150 @@
+/**
+ * @file    itm_decoder.c
+ * @brief   ITM/DWT trace packet decoder
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "itm_decoder.h"
+
+// Parser states
+#define STATE_HEADER        0   // Waiting for a packet header
+#define STATE_PAYLOAD       1   // Inside a source packet payload
+#define STATE_CONTINUATION  2   // Skipping bytes until one without the C bit
+
+// A sync packet is at least 47 zero bits followed by a one bit
+#define SYNC_MIN_ZEROS      5
+
+// Header byte fields (ARMv7-M ARM, appendix D4)
+#define HDR_SIZE_MASK       0x03
+#define HDR_HW_SOURCE       0x04
+#define HDR_PORT_SHIFT      3
+#define HDR_CONTINUATION    0x80
+#define HDR_OVERFLOW        0x70
+#define HDR_GTS_MASK        0xDF
+#define HDR_GTS             0x94
+#define HDR_EXTENSION_MASK  0x0B
+#define HDR_EXTENSION       0x08
+#define HDR_EXT_SH          0x04
+#define HDR_EXT_PAGE_SHIFT  4
+#define HDR_EXT_PAGE_MASK   0x07
+
+static const uint8_t payload_size[4] = {0, 1, 2, 4};
+
+void itm_decoder_init(itm_decoder_t *decoder, uint32_t port_mask)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->port_mask = port_mask;
+    decoder->state = STATE_HEADER;
+}
+
+static void decode_header(itm_decoder_t *decoder, uint8_t header)
+{
+    uint8_t port;
+
+    if (header == 0x00) {
+        // Part of a sync packet or idle padding
+        if (decoder->zeros < SYNC_MIN_ZEROS) {
+            decoder->zeros++;
+        }
+        return;
+    }
+
+    if ((header == 0x80) && (decoder->zeros >= SYNC_MIN_ZEROS)) {
+        // End of sync packet
+        decoder->zeros = 0;
+        return;
+    }
+    decoder->zeros = 0;
+
+    if (header & HDR_SIZE_MASK) {
+        // Instrumentation (software) or hardware source packet
+        port = header >> HDR_PORT_SHIFT;
+        decoder->remaining = payload_size[header & HDR_SIZE_MASK];
+        decoder->forward = !(header & HDR_HW_SOURCE) && (0 == decoder->page) &&
+                           (decoder->port_mask & (1UL << port));
+        decoder->state = STATE_PAYLOAD;
+    } else if (header == HDR_OVERFLOW) {
+        decoder->overflows++;
+    } else if (((header & HDR_EXTENSION_MASK) == HDR_EXTENSION) &&
+               !(header & (HDR_CONTINUATION | HDR_EXT_SH))) {
+        // Stimulus port page, selects ports 32 * page and up
+        decoder->page = (header >> HDR_EXT_PAGE_SHIFT) & HDR_EXT_PAGE_MASK;
+    } else if (((header & 0x0F) == 0) ||
+               ((header & HDR_GTS_MASK) == HDR_GTS) ||
+               ((header & HDR_EXTENSION_MASK) == HDR_EXTENSION)) {
+        // Local timestamp, global timestamp or extension packet. Only the
+        // single byte local timestamp has no continuation bytes.
+        if (header & HDR_CONTINUATION) {
+            decoder->state = STATE_CONTINUATION;
+        }
+    } else {
+        // Reserved encoding, ignore it and resynchronize on the next header
+    }
+}
+
+uint32_t itm_decoder_process(itm_decoder_t *decoder, const uint8_t *data, uint32_t size,
+                             uint8_t *out, uint32_t out_size, uint32_t *out_len)
+{
+    uint32_t consumed = 0;
+    uint32_t produced = 0;
+    uint8_t byte;
+
+    while (consumed < size) {
+        byte = data[consumed];
+
+        switch (decoder->state) {
+            case STATE_PAYLOAD:
+                if (decoder->forward) {
+                    if (produced >= out_size) {
+                        *out_len = produced;
+                        return consumed;
+                    }
+                    // Word and halfword writes pad short strings with zeros
+                    if (byte != 0) {
+                        out[produced++] = byte;
+                    }
+                } else {
+                    decoder->dropped++;
+                }
+                decoder->remaining--;
+                if (0 == decoder->remaining) {
+                    decoder->state = STATE_HEADER;
+                }
+                break;
+
+            case STATE_CONTINUATION:
+                if (!(byte & HDR_CONTINUATION)) {
+                    decoder->state = STATE_HEADER;
+                }
+                break;
+
+            case STATE_HEADER:
+            default:
+                decoder->state = STATE_HEADER;
+                decode_header(decoder, byte);
+                break;
+        }
+
+        consumed++;
+    }
+
+    *out_len = produced;
+    return consumed;
+}
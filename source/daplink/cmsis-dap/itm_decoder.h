@@ -0,0 +1,70 @@
+/**
+ * @file    itm_decoder.h
+ * @brief   ITM/DWT trace packet decoder
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ITM_DECODER_H
+#define ITM_DECODER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @brief Decoder state.
+//!
+//! The decoder has no dependencies beyond the C library so it can be built
+//! on the host and fed with recorded SWO captures.
+typedef struct {
+    uint32_t port_mask;         /*!< Bitmask of stimulus ports to forward */
+    uint32_t dropped;           /*!< Payload bytes from DWT and masked ports */
+    uint32_t overflows;         /*!< Number of overflow packets seen */
+    uint8_t state;              /*!< Current parser state */
+    uint8_t remaining;          /*!< Payload bytes left in the current packet */
+    uint8_t forward;            /*!< Whether the current payload is forwarded */
+    uint8_t zeros;              /*!< Consecutive zero bytes, for sync detection */
+    uint8_t page;               /*!< Stimulus port page, ports 32 and up are never forwarded */
+} itm_decoder_t;
+
+//! @brief Reset the decoder and select the stimulus ports to forward.
+void itm_decoder_init(itm_decoder_t *decoder, uint32_t port_mask);
+
+//! @brief Decode a block of raw ITM trace data.
+//!
+//! Non-zero payload bytes of instrumentation packets on enabled stimulus
+//! ports are copied to @a out. Timestamp, DWT hardware source, extension and
+//! sync packets are consumed and discarded. Decoding stops early if @a out
+//! fills up, in which case the remaining input must be passed again later.
+//!
+//! @param decoder Decoder state.
+//! @param data Raw trace data.
+//! @param size Number of bytes in @a data.
+//! @param out Destination for forwarded payload bytes.
+//! @param out_size Size of @a out.
+//! @param out_len Set to the number of bytes written to @a out.
+//! @return Number of bytes consumed from @a data.
+uint32_t itm_decoder_process(itm_decoder_t *decoder, const uint8_t *data, uint32_t size,
+                             uint8_t *out, uint32_t out_size, uint32_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -24,83 +24,25 @@
 #include "compiler.h"
 #include "util.h"
 
-#define FALSE	0
-#define TRUE	!FALSE
-
-typedef unsigned long  crc;
-
 #define CRC_NAME			"CRC-32"
 #define POLYNOMIAL			0x04C11DB7
 #define INITIAL_REMAINDER	0xFFFFFFFF
 #define FINAL_XOR_VALUE		0xFFFFFFFF
-#define REFLECT_DATA		TRUE
-#define REFLECT_REMAINDER	TRUE
 #define CHECK_VALUE			0xCBF43926
 
 /*
- * Derive parameters from the standard-specific parameters in crc.h.
+ * CRC-32 reflects both the data and the remainder, so the division is
+ * done LSB first with the reflected polynomial (0xEDB88320). Processing
+ * four bits per table lookup is several times faster than the bitwise
+ * loop while keeping the table at 64 bytes, which matters for the
+ * bootloader builds.
  */
-#define WIDTH    (8 * sizeof(crc))
-#define TOPBIT   (1U << (WIDTH - 1))
-
-#if (REFLECT_DATA == TRUE)
-#undef  REFLECT_DATA
-#define REFLECT_DATA(X)			((unsigned char) reflect((X), 8))
-#else
-#undef  REFLECT_DATA
-#define REFLECT_DATA(X)			(X)
-#endif
-
-#if (REFLECT_REMAINDER == TRUE)
-#undef  REFLECT_REMAINDER
-#define REFLECT_REMAINDER(X)	((crc) reflect((X), WIDTH))
-#else
-#undef  REFLECT_REMAINDER
-#define REFLECT_REMAINDER(X)	(X)
-#endif
-
-
-/*********************************************************************
- *
- * Function:    reflect()
- *
- * Description: Reorder the bits of a binary sequence, by reflecting
- *				them about the middle position.
- *
- * Notes:		No checking is done that nBits <= 32.
- *
- * Returns:		The reflection of the original data.
- *
- *********************************************************************/
-static unsigned long
-reflect(unsigned long data, unsigned char nBits)
-{
-    // util_assert(nBits <= 32);
-    if (nBits == 32) {
-        // Use bit reverse instruction intrinsic. The CMSIS intrinsic also
-        // provides an implementation for cores that don't have the instruction.
-        return __RBIT(data);
-    }
-
-    unsigned long  reflection = 0x00000000;
-    unsigned char  bit;
-
-    /*
-     * Reflect the data about the center bit.
-     */
-    for (bit = 0; bit < nBits; ++bit) {
-        /*
-         * If the LSB bit is set, set the reflection of it.
-         */
-        if (data & 0x01) {
-            reflection |= (1 << ((nBits - 1) - bit));
-        }
-
-        data = (data >> 1);
-    }
-
-    return (reflection);
-}	/* reflect() */
+static const uint32_t crc_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
 
 
 /*********************************************************************
@@ -117,39 +59,7 @@ reflect(unsigned long data, unsigned char nBits)
 __WEAK uint32_t
 crc32(const void *data, int nBytes)
 {
-    crc            remainder = INITIAL_REMAINDER;
-    int            byte;
-    unsigned char  bit;
-    unsigned char const *message = data;
-
-    /*
-     * Perform modulo-2 division, a byte at a time.
-     */
-    for (byte = 0; byte < nBytes; ++byte) {
-        /*
-         * Bring the next byte into the remainder.
-         */
-        remainder ^= (REFLECT_DATA(message[byte]) << (WIDTH - 8));
-
-        /*
-         * Perform modulo-2 division, a bit at a time.
-         */
-        for (bit = 8; bit > 0; --bit) {
-            /*
-             * Try to divide the current data bit.
-             */
-            if (remainder & TOPBIT) {
-                remainder = (remainder << 1) ^ POLYNOMIAL;
-            } else {
-                remainder = (remainder << 1);
-            }
-        }
-    }
-
-    /*
-     * The final remainder is the CRC result.
-     */
-    return (REFLECT_REMAINDER(remainder) ^ FINAL_XOR_VALUE);
+    return crc32_continue(INITIAL_REMAINDER ^ FINAL_XOR_VALUE, data, nBytes);
 }   /* crc32() */
 
 /*********************************************************************
@@ -158,7 +68,8 @@ crc32(const void *data, int nBytes)
  *
  * Description: Compute the CRC of a given message.
  *
- * Notes:
+ * Notes:       prev_crc is the result of a previous call to crc32()
+ *              or crc32_continue().
  *
  * Returns:		The CRC of the message.
  *
@@ -166,37 +77,21 @@ crc32(const void *data, int nBytes)
 __WEAK uint32_t
 crc32_continue(uint32_t prev_crc, const void *data, int nBytes)
 {
-    crc            remainder = REFLECT_REMAINDER(prev_crc ^ FINAL_XOR_VALUE);
+    uint32_t       remainder = prev_crc ^ FINAL_XOR_VALUE;
     int            byte;
-    unsigned char  bit;
     unsigned char const *message = data;
 
     /*
-     * Perform modulo-2 division, a byte at a time.
+     * Perform modulo-2 division, a nibble at a time.
      */
     for (byte = 0; byte < nBytes; ++byte) {
-        /*
-         * Bring the next byte into the remainder.
-         */
-        remainder ^= (REFLECT_DATA(message[byte]) << (WIDTH - 8));
-
-        /*
-         * Perform modulo-2 division, a bit at a time.
-         */
-        for (bit = 8; bit > 0; --bit) {
-            /*
-             * Try to divide the current data bit.
-             */
-            if (remainder & TOPBIT) {
-                remainder = (remainder << 1) ^ POLYNOMIAL;
-            } else {
-                remainder = (remainder << 1);
-            }
-        }
+        remainder ^= message[byte];
+        remainder = (remainder >> 4) ^ crc_table[remainder & 0x0F];
+        remainder = (remainder >> 4) ^ crc_table[remainder & 0x0F];
     }
 
     /*
      * The final remainder is the CRC result.
      */
-    return (REFLECT_REMAINDER(remainder) ^ FINAL_XOR_VALUE);
+    return (remainder ^ FINAL_XOR_VALUE);
 }   /* crc32_continue() */
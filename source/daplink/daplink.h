@@ -68,6 +68,7 @@ COMPILER_ASSERT(DAPLINK_RAM_SHARED_START + DAPLINK_RAM_SHARED_SIZE == DAPLINK_RA
 #define DAPLINK_HIC_ID_M48SSIDAE    0x97969921
 #define DAPLINK_HIC_ID_PSOC5        0x2E127069
 #define DAPLINK_HIC_ID_NRF52820     0x6E052820 // 'n\x05\x28\x20'
+#define DAPLINK_HIC_ID_HOST_SIM     0x686F7374 // 'host'
 //@}
 
 #define DAPLINK_INFO_OFFSET         0x20
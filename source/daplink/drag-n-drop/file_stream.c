@@ -25,10 +25,47 @@
 #include "util.h"
 #include "intelhex.h"
 #include "flash_decoder.h"
+#include "flash_manager.h"
 #include "error.h"
 #include "cmsis_os2.h"
 #include "compiler.h"
 #include "validation.h"
+#include "crc.h"
+#include "target_board.h"
+#include "transfer_perf.h"
+
+// Compressed image container, see tools/dlz_pack.py
+#define DLZ_MAGIC               "DLZ1"
+#define DLZ_HEADER_SIZE         16
+#define DLZ_BLOCK_HEADER_SIZE   12
+#define DLZ_BLOCK_SIZE          512
+#define DLZ_FLAG_CONTIGUOUS     (1 << 0)
+// Keep compressed blocks as they came as well, for flash algos that expand
+// them on the target. HICs with the RAM for a second block set it.
+#ifndef DLZ_EXPAND_ON_TARGET
+#define DLZ_EXPAND_ON_TARGET    0
+#endif
+
+// UF2 blocks, see https://github.com/microsoft/uf2
+#define UF2_MAGIC_START0        0x0A324655
+#define UF2_MAGIC_START1        0x9E5D5157
+#define UF2_MAGIC_END           0x0AB16F30
+#define UF2_BLOCK_SIZE          512
+#define UF2_PAYLOAD_OFFSET      32
+#define UF2_PAYLOAD_MAX         476
+#define UF2_FLAG_NOT_MAIN_FLASH (1 << 0)
+#define UF2_FLAG_FILE_CONTAINER (1 << 12)
+#define UF2_FLAG_FAMILY_ID      (1 << 13)
+// Blocks of larger files are written more than once if the host repeats them
+#define UF2_TRACKED_BLOCKS      4096
+
+// 32 bit little endian ELF files. The ELF header and the program header
+// table must be within the lookahead at the start of the file.
+#define ELF_LOOKAHEAD_SIZE      512
+#define ELF_HEADER_SIZE         52
+#define ELF_PHDR_SIZE           32
+#define ELF_MAX_SEGMENTS        8
+#define ELF_PT_LOAD             1
 
 typedef enum {
     STREAM_STATE_CLOSED,
@@ -41,12 +78,15 @@ typedef bool (*stream_detect_cb_t)(const uint8_t *data, uint32_t size);
 typedef error_t (*stream_open_cb_t)(void *state);
 typedef error_t (*stream_write_cb_t)(void *state, const uint8_t *data, uint32_t size);
 typedef error_t (*stream_close_cb_t)(void *state);
+typedef void (*stream_size_cb_t)(uint32_t size);
 
 typedef struct {
     stream_detect_cb_t detect;
     stream_open_cb_t open;
     stream_write_cb_t write;
     stream_close_cb_t close;
+    stream_size_cb_t size;
+    bool self_addressed;
 } stream_t;
 
 typedef struct {
@@ -60,24 +100,105 @@ typedef struct {
     uint8_t bin_buffer[256];
 } hex_state_t;
 
+typedef enum {
+    DLZ_STATE_HEADER,
+    DLZ_STATE_BLOCK_HEADER,
+    DLZ_STATE_STORED,
+    DLZ_STATE_TOKEN,
+    DLZ_STATE_LITERAL_LENGTH,
+    DLZ_STATE_LITERALS,
+    DLZ_STATE_OFFSET_LOW,
+    DLZ_STATE_OFFSET_HIGH,
+    DLZ_STATE_MATCH_LENGTH,
+} dlz_decode_state_t;
+
+typedef struct {
+    dlz_decode_state_t decode_state;
+    uint8_t header[DLZ_HEADER_SIZE];
+    uint8_t header_pos;
+    uint8_t token;
+    uint32_t block_addr;
+    uint32_t block_crc;
+    uint32_t raw_size;
+    uint32_t comp_size;
+    uint32_t comp_left;
+    uint32_t length;
+    uint32_t offset;
+    uint32_t out_pos;
+    uint8_t out[DLZ_BLOCK_SIZE];
+#if DLZ_EXPAND_ON_TARGET
+    uint8_t comp[DLZ_BLOCK_SIZE];
+#endif
+} dlz_state_t;
+
+typedef struct {
+    uint32_t family_id;
+    uint32_t num_blocks;
+    uint32_t blocks_written;
+    uint32_t blocks_skipped;
+    uint32_t written[UF2_TRACKED_BLOCKS / 32];
+} uf2_state_t;
+
+typedef struct {
+    uint32_t offset;
+    uint32_t addr;
+    uint32_t size;
+} elf_segment_t;
+
+typedef struct {
+    bool table_parsed;
+    uint32_t pos;
+    uint32_t table_end;
+    uint32_t end;
+    uint32_t segment_count;
+    elf_segment_t segment[ELF_MAX_SEGMENTS];
+    uint8_t lookahead[ELF_LOOKAHEAD_SIZE];
+} elf_state_t;
+
 typedef union {
     bin_state_t bin;
     hex_state_t hex;
+    dlz_state_t dlz;
+    uf2_state_t uf2;
+    elf_state_t elf;
 } shared_state_t;
 
 static bool detect_bin(const uint8_t *data, uint32_t size);
 static error_t open_bin(void *state);
 static error_t write_bin(void *state, const uint8_t *data, uint32_t size);
 static error_t close_bin(void *state);
+static void size_bin(uint32_t size);
 
 static bool detect_hex(const uint8_t *data, uint32_t size);
 static error_t open_hex(void *state);
 static error_t write_hex(void *state, const uint8_t *data, uint32_t size);
 static error_t close_hex(void *state);
+static void size_hex(uint32_t size);
+
+static bool detect_dlz(const uint8_t *data, uint32_t size);
+static error_t open_dlz(void *state);
+static error_t write_dlz(void *state, const uint8_t *data, uint32_t size);
+static error_t close_dlz(void *state);
+static void size_dlz(uint32_t size);
+
+static bool detect_uf2(const uint8_t *data, uint32_t size);
+static error_t open_uf2(void *state);
+static error_t write_uf2(void *state, const uint8_t *data, uint32_t size);
+static error_t close_uf2(void *state);
+static void size_uf2(uint32_t size);
+
+static bool detect_elf(const uint8_t *data, uint32_t size);
+static error_t open_elf(void *state);
+static error_t write_elf(void *state, const uint8_t *data, uint32_t size);
+static error_t close_elf(void *state);
+static void size_elf(uint32_t size);
 
 stream_t stream[] = {
-    {detect_bin, open_bin, write_bin, close_bin},   // STREAM_TYPE_BIN
-    {detect_hex, open_hex, write_hex, close_hex},   // STREAM_TYPE_HEX
+    {detect_bin, open_bin, write_bin, close_bin, size_bin, false},  // STREAM_TYPE_BIN
+    {detect_hex, open_hex, write_hex, close_hex, size_hex, false},  // STREAM_TYPE_HEX
+    {detect_dlz, open_dlz, write_dlz, close_dlz, size_dlz, false},  // STREAM_TYPE_DLZ
+    {detect_uf2, open_uf2, write_uf2, close_uf2, size_uf2, true},   // STREAM_TYPE_UF2
+    {detect_elf, open_elf, write_elf, close_elf, size_elf, false},  // STREAM_TYPE_ELF
 };
 COMPILER_ASSERT(ARRAY_SIZE(stream) == STREAM_TYPE_COUNT);
 // STREAM_TYPE_NONE must not be included in count
@@ -119,6 +240,12 @@ stream_type_t stream_type_from_name(const vfs_filename_t filename)
         return STREAM_TYPE_BIN;
     } else if (0 == strncmp("HEX", &filename[8], 3)) {
         return STREAM_TYPE_HEX;
+    } else if (0 == strncmp("DLZ", &filename[8], 3)) {
+        return STREAM_TYPE_DLZ;
+    } else if (0 == strncmp("UF2", &filename[8], 3)) {
+        return STREAM_TYPE_UF2;
+    } else if ((0 == strncmp("ELF", &filename[8], 3)) || (0 == strncmp("AXF", &filename[8], 3))) {
+        return STREAM_TYPE_ELF;
     } else {
         return STREAM_TYPE_NONE;
     }
@@ -158,6 +285,7 @@ error_t stream_open(stream_type_t stream_type)
 error_t stream_write(const uint8_t *data, uint32_t size)
 {
     error_t status;
+    transfer_perf_phase_t phase;
 
     // Stream must be open already
     if (state != STREAM_STATE_OPEN) {
@@ -169,7 +297,10 @@ error_t stream_write(const uint8_t *data, uint32_t size)
     // set only if stream_open has been called
     stream_thread_assert();
     // Write to stream
+    phase = transfer_perf_phase(TRANSFER_PERF_DECODE);
+    transfer_perf_bytes(TRANSFER_PERF_DECODE, size);
     status = current_stream->write(&shared_state, data, size);
+    transfer_perf_phase(phase);
 
     if (ERROR_SUCCESS_DONE == status) {
         state = STREAM_STATE_END;
@@ -202,6 +333,34 @@ error_t stream_close(void)
     return status;
 }
 
+bool stream_is_self_addressed(stream_type_t stream_type)
+{
+    if (stream_type >= STREAM_TYPE_COUNT) {
+        return false;
+    }
+
+    return stream[stream_type].self_addressed;
+}
+
+void stream_set_file_size(stream_type_t stream_type, uint32_t size)
+{
+    if (stream_type >= STREAM_TYPE_COUNT) {
+        return;
+    }
+
+    stream[stream_type].size(size);
+}
+
+static uint32_t get_le32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint16_t get_le16(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8);
+}
+
 /* Binary file processing */
 
 static bool detect_bin(const uint8_t *data, uint32_t size)
@@ -285,6 +444,12 @@ static error_t close_bin(void *state)
     return status;
 }
 
+static void size_bin(uint32_t size)
+{
+    // Every byte of the file is written from the start address on
+    flash_manager_set_image_size(size, true);
+}
+
 /* Hex file processing */
 
 static bool detect_hex(const uint8_t *data, uint32_t size)
@@ -364,3 +529,579 @@ static error_t close_hex(void *state)
     status = flash_decoder_close();
     return status;
 }
+
+static void size_hex(uint32_t size)
+{
+    // Every data byte takes two hex digits, so the image holds less than
+    // half the file size. The records only arrive with the file, and may
+    // leave gaps, so this upper bound is passed as a non contiguous size.
+    // It only weighs sector against chip erase and never erases anything
+    // ahead of the data.
+    flash_manager_set_image_size(size / 2, false);
+}
+
+/* Compressed image processing
+ *
+ * The file is a 16 byte header (magic, start and end address of the image,
+ * flags) followed by blocks of at most DLZ_BLOCK_SIZE bytes. Each block has
+ * a 12 byte header (address, size, compressed size, CRC-32 of the data) and
+ * is either stored or LZ4 compressed on its own. A block of size 0 ends the
+ * image. All values are little endian.
+ *
+ * Blocks are always expanded here to check them. With DLZ_EXPAND_ON_TARGET
+ * compressed blocks are passed on as well, for flash algos that expand them
+ * on the target.
+ */
+
+static bool detect_dlz(const uint8_t *data, uint32_t size)
+{
+    return (size >= DLZ_HEADER_SIZE) && (0 == memcmp(data, DLZ_MAGIC, 4));
+}
+
+static error_t open_dlz(void *state)
+{
+    error_t status;
+    dlz_state_t *dlz_state = (dlz_state_t *)state;
+    memset(dlz_state, 0, sizeof(*dlz_state));
+    dlz_state->decode_state = DLZ_STATE_HEADER;
+    status = flash_decoder_open();
+    return status;
+}
+
+// Copy a match from the data decoded so far, the regions may overlap
+static error_t dlz_copy_match(dlz_state_t *dlz_state)
+{
+    uint32_t i;
+
+    if ((0 == dlz_state->offset) || (dlz_state->offset > dlz_state->out_pos) ||
+            (dlz_state->length > dlz_state->raw_size - dlz_state->out_pos)) {
+        return ERROR_DLZ_PARSER;
+    }
+
+    for (i = 0; i < dlz_state->length; i++) {
+        dlz_state->out[dlz_state->out_pos] = dlz_state->out[dlz_state->out_pos - dlz_state->offset];
+        dlz_state->out_pos++;
+    }
+
+    dlz_state->decode_state = DLZ_STATE_TOKEN;
+    return ERROR_SUCCESS;
+}
+
+// A sequence continues with a match unless the block ends after the literals
+static void dlz_literals_done(dlz_state_t *dlz_state)
+{
+    dlz_state->decode_state = dlz_state->comp_left ? DLZ_STATE_OFFSET_LOW : DLZ_STATE_TOKEN;
+}
+
+static error_t dlz_header_done(dlz_state_t *dlz_state)
+{
+    const uint8_t *header = dlz_state->header;
+
+    dlz_state->header_pos = 0;
+
+    if (DLZ_STATE_HEADER == dlz_state->decode_state) {
+        uint32_t start = get_le32(&header[4]);
+        uint32_t end = get_le32(&header[8]);
+
+        if (end < start) {
+            return ERROR_DLZ_PARSER;
+        }
+
+        // The extent of the image is known before any data
+        flash_manager_set_image_size(end - start, (header[12] & DLZ_FLAG_CONTIGUOUS) != 0);
+        dlz_state->decode_state = DLZ_STATE_BLOCK_HEADER;
+        return ERROR_SUCCESS;
+    }
+
+    dlz_state->block_addr = get_le32(&header[0]);
+    dlz_state->raw_size = header[4] | (header[5] << 8);
+    dlz_state->comp_size = header[6] | (header[7] << 8);
+    dlz_state->block_crc = get_le32(&header[8]);
+    dlz_state->comp_left = dlz_state->comp_size;
+    dlz_state->out_pos = 0;
+
+    if (0 == dlz_state->raw_size) {
+        return ERROR_SUCCESS_DONE;
+    }
+
+    if ((dlz_state->raw_size > DLZ_BLOCK_SIZE) || (0 == dlz_state->comp_size) ||
+            (dlz_state->comp_size > dlz_state->raw_size)) {
+        return ERROR_DLZ_PARSER;
+    }
+
+    // Blocks that do not compress are stored
+    dlz_state->decode_state = (dlz_state->comp_size == dlz_state->raw_size) ? DLZ_STATE_STORED : DLZ_STATE_TOKEN;
+    return ERROR_SUCCESS;
+}
+
+static error_t dlz_block_done(dlz_state_t *dlz_state)
+{
+    if ((dlz_state->out_pos != dlz_state->raw_size) ||
+            ((DLZ_STATE_STORED != dlz_state->decode_state) && (DLZ_STATE_TOKEN != dlz_state->decode_state))) {
+        return ERROR_DLZ_PARSER;
+    }
+
+    if (crc32(dlz_state->out, dlz_state->raw_size) != dlz_state->block_crc) {
+        return ERROR_DLZ_CKSUM;
+    }
+
+    dlz_state->decode_state = DLZ_STATE_BLOCK_HEADER;
+#if DLZ_EXPAND_ON_TARGET
+    if (dlz_state->comp_size < dlz_state->raw_size) {
+        return flash_decoder_write_compressed(dlz_state->block_addr, dlz_state->out, dlz_state->raw_size,
+                                              dlz_state->comp, dlz_state->comp_size);
+    }
+#endif
+    return flash_decoder_write(dlz_state->block_addr, dlz_state->out, dlz_state->raw_size);
+}
+
+static error_t write_dlz(void *state, const uint8_t *data, uint32_t size)
+{
+    error_t status = ERROR_SUCCESS;
+    dlz_state_t *dlz_state = (dlz_state_t *)state;
+    uint32_t header_size;
+    uint8_t byte;
+
+    while (size > 0) {
+        byte = *data++;
+        size--;
+
+        if ((DLZ_STATE_HEADER == dlz_state->decode_state) || (DLZ_STATE_BLOCK_HEADER == dlz_state->decode_state)) {
+            header_size = (DLZ_STATE_HEADER == dlz_state->decode_state) ? DLZ_HEADER_SIZE : DLZ_BLOCK_HEADER_SIZE;
+            dlz_state->header[dlz_state->header_pos++] = byte;
+
+            if (dlz_state->header_pos == header_size) {
+                status = dlz_header_done(dlz_state);
+            }
+
+            if (ERROR_SUCCESS != status) {
+                // ERROR_SUCCESS_DONE for the end of the image
+                return status;
+            }
+
+            continue;
+        }
+
+        dlz_state->comp_left--;
+#if DLZ_EXPAND_ON_TARGET
+        dlz_state->comp[dlz_state->comp_size - dlz_state->comp_left - 1] = byte;
+#endif
+
+        switch (dlz_state->decode_state) {
+            case DLZ_STATE_STORED:
+                dlz_state->out[dlz_state->out_pos++] = byte;
+                break;
+
+            case DLZ_STATE_TOKEN:
+                dlz_state->token = byte;
+                dlz_state->length = byte >> 4;
+
+                if (15 == dlz_state->length) {
+                    dlz_state->decode_state = DLZ_STATE_LITERAL_LENGTH;
+                } else if (dlz_state->length > 0) {
+                    dlz_state->decode_state = DLZ_STATE_LITERALS;
+                } else {
+                    dlz_literals_done(dlz_state);
+                }
+                break;
+
+            case DLZ_STATE_LITERAL_LENGTH:
+                dlz_state->length += byte;
+
+                if (255 != byte) {
+                    dlz_state->decode_state = DLZ_STATE_LITERALS;
+                }
+                break;
+
+            case DLZ_STATE_LITERALS:
+                if (dlz_state->out_pos >= dlz_state->raw_size) {
+                    return ERROR_DLZ_PARSER;
+                }
+
+                dlz_state->out[dlz_state->out_pos++] = byte;
+                dlz_state->length--;
+
+                if (0 == dlz_state->length) {
+                    dlz_literals_done(dlz_state);
+                }
+                break;
+
+            case DLZ_STATE_OFFSET_LOW:
+                dlz_state->offset = byte;
+                dlz_state->decode_state = DLZ_STATE_OFFSET_HIGH;
+                break;
+
+            case DLZ_STATE_OFFSET_HIGH:
+                dlz_state->offset |= byte << 8;
+                dlz_state->length = (dlz_state->token & 0xF) + 4;
+
+                if (0xF == (dlz_state->token & 0xF)) {
+                    dlz_state->decode_state = DLZ_STATE_MATCH_LENGTH;
+                } else {
+                    status = dlz_copy_match(dlz_state);
+                }
+                break;
+
+            case DLZ_STATE_MATCH_LENGTH:
+                dlz_state->length += byte;
+
+                if (255 != byte) {
+                    status = dlz_copy_match(dlz_state);
+                }
+                break;
+
+            default:
+                util_assert(0);
+                return ERROR_INTERNAL;
+        }
+
+        if ((ERROR_SUCCESS == status) && (0 == dlz_state->comp_left)) {
+            status = dlz_block_done(dlz_state);
+        }
+
+        if (ERROR_SUCCESS != status) {
+            return status;
+        }
+    }
+
+    return ERROR_SUCCESS;
+}
+
+static error_t close_dlz(void *state)
+{
+    error_t status;
+    status = flash_decoder_close();
+    return status;
+}
+
+static void size_dlz(uint32_t size)
+{
+    // The extent comes from the header of the file instead
+}
+
+/* UF2 file processing
+ *
+ * Each 512 byte block is a VFS sector holding up to 476 bytes of data and
+ * the address they go to, so blocks are written in the order the host sends
+ * them. Blocks that are not UF2, not for the main flash or for another
+ * family are skipped. When the target's family is not known the first family
+ * in the file is programmed. Blocks of other families are skipped before
+ * their block count is checked, each family has its own. All values are
+ * little endian.
+ */
+
+COMPILER_ASSERT(UF2_BLOCK_SIZE == VFS_SECTOR_SIZE);
+
+static bool uf2_block_valid(const uint8_t *block)
+{
+    return (get_le32(&block[0]) == UF2_MAGIC_START0) &&
+           (get_le32(&block[4]) == UF2_MAGIC_START1) &&
+           (get_le32(&block[UF2_BLOCK_SIZE - 4]) == UF2_MAGIC_END);
+}
+
+static bool detect_uf2(const uint8_t *data, uint32_t size)
+{
+    return (size >= UF2_BLOCK_SIZE) && uf2_block_valid(data);
+}
+
+static error_t open_uf2(void *state)
+{
+    error_t status;
+    uf2_state_t *uf2_state = (uf2_state_t *)state;
+    memset(uf2_state, 0, sizeof(*uf2_state));
+    uf2_state->family_id = get_uf2_family_id();
+    status = flash_decoder_open();
+    return status;
+}
+
+// Returns true the first time a block is seen
+static bool uf2_track_block(uf2_state_t *uf2_state, uint32_t block_no)
+{
+    uint32_t mask = 1UL << (block_no % 32);
+
+    if (uf2_state->num_blocks > UF2_TRACKED_BLOCKS) {
+        return true;
+    }
+
+    if (uf2_state->written[block_no / 32] & mask) {
+        return false;
+    }
+
+    uf2_state->written[block_no / 32] |= mask;
+    return true;
+}
+
+static error_t uf2_write_block(uf2_state_t *uf2_state, const uint8_t *block)
+{
+    uint32_t flags = get_le32(&block[8]);
+    uint32_t addr = get_le32(&block[12]);
+    uint32_t payload_size = get_le32(&block[16]);
+    uint32_t block_no = get_le32(&block[20]);
+    uint32_t num_blocks = get_le32(&block[24]);
+    uint32_t family_id = get_le32(&block[28]);
+
+    if (flags & (UF2_FLAG_NOT_MAIN_FLASH | UF2_FLAG_FILE_CONTAINER)) {
+        return ERROR_SUCCESS;
+    }
+
+    if (flags & UF2_FLAG_FAMILY_ID) {
+        if (0 == uf2_state->family_id) {
+            uf2_state->family_id = family_id;
+        }
+        if (family_id != uf2_state->family_id) {
+            uf2_state->blocks_skipped++;
+            return ERROR_SUCCESS;
+        }
+    }
+
+    if ((payload_size > UF2_PAYLOAD_MAX) || (block_no >= num_blocks)) {
+        return ERROR_UF2_PARSER;
+    }
+
+    if (0 == uf2_state->num_blocks) {
+        // Blocks usually carry the same amount of data
+        uf2_state->num_blocks = num_blocks;
+        flash_manager_set_image_size(num_blocks * payload_size, false);
+    } else if (num_blocks != uf2_state->num_blocks) {
+        return ERROR_UF2_PARSER;
+    }
+
+    if (!uf2_track_block(uf2_state, block_no)) {
+        return ERROR_SUCCESS;
+    }
+
+    uf2_state->blocks_written++;
+    return flash_decoder_write(addr, &block[UF2_PAYLOAD_OFFSET], payload_size);
+}
+
+static error_t write_uf2(void *state, const uint8_t *data, uint32_t size)
+{
+    error_t status = ERROR_SUCCESS;
+    uf2_state_t *uf2_state = (uf2_state_t *)state;
+
+    while (size >= UF2_BLOCK_SIZE) {
+        if (uf2_block_valid(data)) {
+            status = uf2_write_block(uf2_state, data);
+
+            if (ERROR_SUCCESS != status) {
+                // ERROR_SUCCESS_DONE if the decoder reached the end of the image
+                return status;
+            }
+        }
+
+        data += UF2_BLOCK_SIZE;
+        size -= UF2_BLOCK_SIZE;
+    }
+
+    if (uf2_state->num_blocks && (uf2_state->blocks_written >= uf2_state->num_blocks)) {
+        if (uf2_state->num_blocks <= UF2_TRACKED_BLOCKS) {
+            return ERROR_SUCCESS_DONE;
+        }
+        // Repeated blocks were counted as well
+        return ERROR_SUCCESS_DONE_OR_CONTINUE;
+    }
+
+    if (!uf2_state->num_blocks && uf2_state->blocks_skipped) {
+        // Let the transfer end on the file size, closing reports the family
+        return ERROR_SUCCESS_DONE_OR_CONTINUE;
+    }
+
+    return status;
+}
+
+static error_t close_uf2(void *state)
+{
+    error_t status;
+    uf2_state_t *uf2_state = (uf2_state_t *)state;
+    status = flash_decoder_close();
+
+    // Nothing was written, the blocks were all for another family
+    if (!uf2_state->num_blocks && uf2_state->blocks_skipped) {
+        status = ERROR_UF2_FAMILY;
+    }
+
+    return status;
+}
+
+static void size_uf2(uint32_t size)
+{
+    // The extent comes from the blocks instead
+}
+
+/* ELF file processing
+ *
+ * The ELF header and the program header table are buffered from the start
+ * of the file. After that the contents of every PT_LOAD segment is written
+ * to its physical address as it streams past, and the stream ends after
+ * the last one, so debug sections are never looked at. Data of segments
+ * that start within the lookahead, like the headers themselves, is written
+ * from the buffer once the table is known.
+ */
+
+static bool detect_elf(const uint8_t *data, uint32_t size)
+{
+    // ELFCLASS32 and ELFDATA2LSB
+    return (size >= ELF_HEADER_SIZE) && (0 == memcmp(data, "\x7F" "ELF", 4)) &&
+           (1 == data[4]) && (1 == data[5]);
+}
+
+static error_t open_elf(void *state)
+{
+    error_t status;
+    elf_state_t *elf_state = (elf_state_t *)state;
+    memset(elf_state, 0, sizeof(*elf_state));
+    status = flash_decoder_open();
+    return status;
+}
+
+static error_t elf_parse_table(elf_state_t *elf_state)
+{
+    const uint8_t *header = elf_state->lookahead;
+    uint32_t phoff = get_le32(&header[28]);
+    uint32_t phentsize = get_le16(&header[42]);
+    uint32_t phnum = get_le16(&header[44]);
+    uint32_t image_size = 0;
+    bool contiguous = true;
+    uint32_t i;
+
+    for (i = 0; i < phnum; i++) {
+        const uint8_t *phdr = &elf_state->lookahead[phoff + i * phentsize];
+        elf_segment_t *segment = &elf_state->segment[elf_state->segment_count];
+
+        // Segments without file contents are zero initialized at runtime
+        if ((get_le32(&phdr[0]) != ELF_PT_LOAD) || (0 == get_le32(&phdr[16]))) {
+            continue;
+        }
+
+        if (ELF_MAX_SEGMENTS == elf_state->segment_count) {
+            return ERROR_ELF_PARSER;
+        }
+
+        segment->offset = get_le32(&phdr[4]);
+        segment->addr = get_le32(&phdr[12]);
+        segment->size = get_le32(&phdr[16]);
+
+        if (segment->size > UINT32_MAX - segment->offset) {
+            return ERROR_ELF_PARSER;
+        }
+
+        if (elf_state->segment_count &&
+                (segment->addr != segment[-1].addr + segment[-1].size)) {
+            contiguous = false;
+        }
+
+        elf_state->end = MAX(elf_state->end, segment->offset + segment->size);
+        image_size += segment->size;
+        elf_state->segment_count++;
+    }
+
+    if (0 == elf_state->segment_count) {
+        return ERROR_ELF_PARSER;
+    }
+
+    flash_manager_set_image_size(image_size, contiguous);
+    elf_state->table_parsed = true;
+    return ERROR_SUCCESS;
+}
+
+// Write the parts of [offset, offset + size) of the file that are loaded
+static error_t elf_write_segments(elf_state_t *elf_state, uint32_t offset, const uint8_t *data, uint32_t size)
+{
+    error_t status;
+    uint32_t start;
+    uint32_t end;
+    uint32_t i;
+
+    for (i = 0; i < elf_state->segment_count; i++) {
+        const elf_segment_t *segment = &elf_state->segment[i];
+        start = MAX(offset, segment->offset);
+        end = MIN(offset + size, segment->offset + segment->size);
+
+        if (start >= end) {
+            continue;
+        }
+
+        status = flash_decoder_write(segment->addr + (start - segment->offset), data + (start - offset), end - start);
+
+        if (ERROR_SUCCESS != status) {
+            // ERROR_SUCCESS_DONE if the decoder reached the end of the image
+            return status;
+        }
+    }
+
+    return ERROR_SUCCESS;
+}
+
+static error_t write_elf(void *state, const uint8_t *data, uint32_t size)
+{
+    error_t status;
+    elf_state_t *elf_state = (elf_state_t *)state;
+
+    if (!elf_state->table_parsed) {
+        uint32_t copy_size = MIN(size, ELF_LOOKAHEAD_SIZE - elf_state->pos);
+        memcpy(&elf_state->lookahead[elf_state->pos], data, copy_size);
+        elf_state->pos += copy_size;
+        data += copy_size;
+        size -= copy_size;
+
+        if (elf_state->pos < ELF_HEADER_SIZE) {
+            return ERROR_SUCCESS;
+        }
+
+        if (0 == elf_state->table_end) {
+            uint32_t phoff = get_le32(&elf_state->lookahead[28]);
+            uint32_t phentsize = get_le16(&elf_state->lookahead[42]);
+            uint32_t phnum = get_le16(&elf_state->lookahead[44]);
+
+            if ((phentsize < ELF_PHDR_SIZE) || (phoff > ELF_LOOKAHEAD_SIZE) ||
+                    (phnum * phentsize > ELF_LOOKAHEAD_SIZE - phoff)) {
+                return ERROR_ELF_PARSER;
+            }
+
+            elf_state->table_end = phoff + phnum * phentsize;
+        }
+
+        if (elf_state->pos < elf_state->table_end) {
+            return ERROR_SUCCESS;
+        }
+
+        status = elf_parse_table(elf_state);
+
+        if (ERROR_SUCCESS != status) {
+            return status;
+        }
+
+        status = elf_write_segments(elf_state, 0, elf_state->lookahead, elf_state->pos);
+
+        if (ERROR_SUCCESS != status) {
+            return status;
+        }
+    }
+
+    status = elf_write_segments(elf_state, elf_state->pos, data, size);
+
+    if (ERROR_SUCCESS != status) {
+        return status;
+    }
+
+    elf_state->pos += size;
+
+    // Everything after the last segment is debug information
+    if (elf_state->pos >= elf_state->end) {
+        return ERROR_SUCCESS_DONE;
+    }
+
+    return ERROR_SUCCESS;
+}
+
+static error_t close_elf(void *state)
+{
+    error_t status;
+    status = flash_decoder_close();
+    return status;
+}
+
+static void size_elf(uint32_t size)
+{
+    // The extent comes from the program headers instead
+}
@@ -23,6 +23,7 @@
 #define FILE_STREAM_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "virtual_fs.h"
 #include "error.h"
@@ -36,6 +37,9 @@ typedef enum {
 
     STREAM_TYPE_BIN = STREAM_TYPE_START,
     STREAM_TYPE_HEX,
+    STREAM_TYPE_DLZ,
+    STREAM_TYPE_UF2,
+    STREAM_TYPE_ELF,
 
     // Add new stream types here
 
@@ -56,6 +60,13 @@ error_t stream_write(const uint8_t *data, uint32_t size);
 
 error_t stream_close(void);
 
+// True if every sector of the file carries its own address, so the
+// sectors can be written in any order
+bool stream_is_self_addressed(stream_type_t stream_type);
+
+// Size of the file given by its directory entry, used to plan the erase
+void stream_set_file_size(stream_type_t stream_type, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,7 @@
 #include "validation.h"
 #include "target_board.h"
 #include "cmsis_compiler.h"
+#include "transfer_perf.h"
 
 // Set to 1 to enable debugging
 #define DEBUG_FLASH_DECODER     0
@@ -59,6 +60,8 @@ static bool initial_addr_set;
 static bool flash_type_target_bin;
 
 static bool flash_decoder_is_at_end(uint32_t addr, const uint8_t *data, uint32_t size);
+static error_t flash_decoder_write_data(uint32_t addr, const uint8_t *data, uint32_t size,
+                                        const uint8_t *comp, uint32_t comp_size);
 
 __WEAK uint8_t board_detect_incompatible_image(const uint8_t *data, uint32_t size)
 {
@@ -231,6 +234,18 @@ error_t flash_decoder_open(void)
 }
 
 error_t flash_decoder_write(uint32_t addr, const uint8_t *data, uint32_t size)
+{
+    return flash_decoder_write_data(addr, data, size, NULL, 0);
+}
+
+error_t flash_decoder_write_compressed(uint32_t addr, const uint8_t *data, uint32_t size,
+                                       const uint8_t *comp, uint32_t comp_size)
+{
+    return flash_decoder_write_data(addr, data, size, comp, comp_size);
+}
+
+static error_t flash_decoder_write_data(uint32_t addr, const uint8_t *data, uint32_t size,
+                                        const uint8_t *comp, uint32_t comp_size)
 {
     error_t status;
     flash_decoder_printf("flash_decoder_write(addr=0x%x, size=0x%x)\r\n", addr, size);
@@ -267,6 +282,8 @@ error_t flash_decoder_write(uint32_t addr, const uint8_t *data, uint32_t size)
             data += copy_size;
             size -= copy_size;
             addr += copy_size;
+            // The compressed block no longer matches the rest
+            comp = copy_size ? NULL : comp;
 
             // If enough data has been buffered then determine the type
             if (flash_buf_pos >= sizeof(flash_buf)) {
@@ -306,7 +323,9 @@ error_t flash_decoder_write(uint32_t addr, const uint8_t *data, uint32_t size)
             flash_decoder_printf("    flash_start_addr=0x%x\r\n", flash_start_addr);
             // Initialize flash manager
             util_assert(!flash_initialized);
+            transfer_perf_phase_t phase = transfer_perf_phase(TRANSFER_PERF_ALGO);
             status = flash_manager_init(flash_intf);
+            transfer_perf_phase(phase);
             flash_decoder_printf("    flash_manager_init ret %i\r\n", status);
 
             if (ERROR_SUCCESS != status) {
@@ -332,7 +351,11 @@ error_t flash_decoder_write(uint32_t addr, const uint8_t *data, uint32_t size)
 
     // Write data as normal if flash has been initialized
     if (flash_initialized) {
-        status = flash_manager_data(addr, data, size);
+        if (comp) {
+            status = flash_manager_data_compressed(addr, data, size, comp, comp_size);
+        } else {
+            status = flash_manager_data(addr, data, size);
+        }
         flash_decoder_printf("    Writing data, addr=0x%x, size=0x%x, flash_manager_data ret %i\r\n",
                              addr, size, status);
 
@@ -367,7 +390,9 @@ error_t flash_decoder_close(void)
     state = DECODER_STATE_CLOSED;
 
     if (flash_initialized) {
+        transfer_perf_phase_t phase = transfer_perf_phase(TRANSFER_PERF_ALGO);
         status = flash_manager_uninit();
+        transfer_perf_phase(phase);
         flash_decoder_printf("    flash_manager_uninit ret %i\r\n", status);
     }
 
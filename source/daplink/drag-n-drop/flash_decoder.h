@@ -48,6 +48,10 @@ error_t flash_decoder_get_flash(flash_decoder_type_t type, uint32_t addr, bool a
 error_t flash_decoder_validate_target_image(flash_decoder_type_t type, const uint8_t *data, uint32_t size);
 error_t flash_decoder_open(void);
 error_t flash_decoder_write(uint32_t addr, const uint8_t *data, uint32_t size);
+// Like flash_decoder_write, with the data also as an LZ4 block of comp_size
+// bytes that may be expanded on the target
+error_t flash_decoder_write_compressed(uint32_t addr, const uint8_t *data, uint32_t size,
+                                       const uint8_t *comp, uint32_t comp_size);
 error_t flash_decoder_close(void);
 
 #ifdef __cplusplus
@@ -46,6 +46,12 @@ typedef uint32_t (*flash_program_page_min_size_cb_t)(uint32_t addr);
 typedef uint32_t (*flash_erase_sector_size_cb_t)(uint32_t addr);
 typedef uint8_t (*flash_busy_cb_t)(void);
 typedef error_t (*flash_algo_set_cb_t)(uint32_t addr);
+typedef error_t (*flash_intf_erase_range_cb_t)(uint32_t addr, uint32_t size);
+typedef error_t (*flash_intf_erase_sector_start_cb_t)(uint32_t addr);
+typedef uint8_t (*flash_intf_erase_pending_cb_t)(void);
+typedef error_t (*flash_intf_read_cb_t)(uint32_t addr, uint8_t *buf, uint32_t size);
+typedef error_t (*flash_intf_program_compressed_cb_t)(uint32_t addr, const uint8_t *buf, uint32_t size,
+                                                      const uint8_t *comp, uint32_t comp_size);
 
 typedef struct {
     flash_intf_init_cb_t init;
@@ -57,6 +63,19 @@ typedef struct {
     flash_erase_sector_size_cb_t erase_sector_size;
     flash_busy_cb_t flash_busy;
     flash_algo_set_cb_t flash_algo_set;
+    // Optional, erase all sectors in [addr, addr + size). Interfaces that
+    // provide it let flash_manager choose between chip and sector erase.
+    flash_intf_erase_range_cb_t erase_range;
+    // Optional, start erasing a sector without waiting for it. The next call
+    // of any other function waits for the erase and returns its error.
+    flash_intf_erase_sector_start_cb_t erase_sector_start;
+    flash_intf_erase_pending_cb_t erase_pending;
+    // Optional, read back flash to check that it is blank when flash_manager
+    // lost track of what this transfer programmed.
+    flash_intf_read_cb_t read;
+    // Optional, like program_page for the buf data, which comp_size bytes
+    // of comp hold as an LZ4 block. The interface may program either.
+    flash_intf_program_compressed_cb_t program_compressed;
 } flash_intf_t;
 
 // All flash interfaces.  Unsupported interfaces are NULL.
@@ -25,6 +25,8 @@
 #include "util.h"
 #include "error.h"
 #include "settings.h"
+#include "cmsis_os2.h"
+#include "transfer_perf.h"
 
 // Set to 1 to enable debugging
 #define DEBUG_FLASH_MANAGER     0
@@ -36,17 +38,60 @@
 #define flash_manager_printf(...)
 #endif
 
+// Erase time estimates used until erases have been measured. Mass erase
+// usually takes a few sector erases, whatever the size of the flash.
+#ifndef FLASH_MANAGER_SECTOR_ERASE_MS_PER_KB
+#define FLASH_MANAGER_SECTOR_ERASE_MS_PER_KB    10
+#endif
+#ifndef FLASH_MANAGER_CHIP_ERASE_MS
+#define FLASH_MANAGER_CHIP_ERASE_MS             500
+#endif
+
+// Number of separate erased and programmed ranges remembered. Data arriving
+// out of order leaves holes until the host fills them, the oldest range is
+// forgotten when there are more. Once a programmed range is forgotten every
+// page is checked blank before it is written. Data only goes to erased
+// sectors, so once an erased range is forgotten a sector in no range is only
+// written when it reads back blank, it is never erased.
+#ifndef FLASH_MANAGER_RANGES
+#define FLASH_MANAGER_RANGES                    8
+#endif
+
+// Largest block handed to program_page(), blocks never span a sector.
+// Larger blocks mean fewer flash algo calls, HICs with the RAM raise it in
+// their records. Must be a multiple of every program_page_min_size().
+#ifndef FLASH_MANAGER_BUF_SIZE
+#define FLASH_MANAGER_BUF_SIZE                  1024
+#endif
+
 typedef enum {
     STATE_CLOSED,
     STATE_OPEN,
     STATE_ERROR
 } state_t;
 
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+} addr_range_t;
+
+typedef struct {
+    addr_range_t range[FLASH_MANAGER_RANGES];
+    uint32_t count;
+    bool overflow;
+} range_list_t;
+
 // Target programming expects buffer
 // passed in to be 4 byte aligned
 __attribute__((aligned(4)))
-static uint8_t buf[1024];
+static uint8_t buf[FLASH_MANAGER_BUF_SIZE];
 static bool buf_empty;
+// Scratch space for reading flash back, buf may hold data
+__attribute__((aligned(4)))
+static uint8_t check_buf[64];
+// Part of the block with new data
+static uint32_t buf_dirty_start;
+static uint32_t buf_dirty_end;
 static bool current_sector_valid;
 static bool page_erase_enabled = false;
 static uint32_t current_write_block_addr;
@@ -57,9 +102,42 @@ static uint32_t last_addr;
 static const flash_intf_t *intf;
 static state_t state = STATE_CLOSED;
 
+// Erase planning. Sectors in the erased ranges are known to be erased,
+// every other sector is erased when it is first written.
+static bool erase_planned;
+static bool chip_erased;
+static range_list_t erased;
+// Blocks programmed by this transfer, they can not be programmed again
+static range_list_t programmed;
+// Value of erased flash, read from a sector erased by this transfer
+static uint8_t erased_value;
+static bool erased_value_known;
+static uint32_t image_size;
+static bool image_contiguous;
+// Sectors below this address are erased ahead of the data
+static uint32_t erase_ahead_end;
+
+// Erase times measured on this target, kept across transfers
+static uint32_t sector_erase_ms;
+static uint32_t sector_erase_bytes;
+static uint32_t chip_erase_ms;
+static bool chip_erase_measured;
+
 static bool flash_intf_valid(const flash_intf_t *flash_intf);
 static error_t flush_current_block(uint32_t addr);
 static error_t setup_next_sector(uint32_t addr);
+static error_t setup_data(uint32_t addr);
+static error_t program_current_block(void);
+static bool unit_programmed(uint32_t addr, uint32_t size);
+static error_t plan_erase(uint32_t addr);
+static error_t erase_chip(void);
+static error_t erase_range(uint32_t addr, uint32_t size);
+static error_t check_sector_blank(uint32_t addr, uint32_t size);
+static bool flash_is_blank(uint32_t addr, uint32_t size);
+static void learn_erased_value(uint32_t addr);
+static void erase_ahead(void);
+static addr_range_t *range_find(range_list_t *list, uint32_t start, uint32_t end);
+static void range_add(range_list_t *list, uint32_t start, uint32_t end);
 
 error_t flash_manager_init(const flash_intf_t *flash_intf)
 {
@@ -87,6 +165,14 @@ error_t flash_manager_init(const flash_intf_t *flash_intf)
     current_sector_addr = 0;
     current_sector_size = 0;
     last_addr = 0;
+    erase_planned = false;
+    chip_erased = false;
+    memset(&erased, 0, sizeof(erased));
+    memset(&programmed, 0, sizeof(programmed));
+    erased_value_known = false;
+    erase_ahead_end = 0;
+    // PAGE_ON.ACT and PAGE_OFF.ACT only change the RAM setting
+    page_erase_enabled = config_ram_get_page_erase();
     intf = flash_intf;
     // Initialize flash
     status = intf->init();
@@ -96,9 +182,9 @@ error_t flash_manager_init(const flash_intf_t *flash_intf)
         return status;
     }
 
-    if (!page_erase_enabled) {
+    if (!page_erase_enabled && !intf->erase_range) {
         // Erase flash and unint if there are errors
-        status = intf->erase_chip();
+        status = erase_chip();
         flash_manager_printf("    intf->erase_chip ret=%i\r\n", status);
 
         if (ERROR_SUCCESS != status) {
@@ -124,33 +210,10 @@ error_t flash_manager_data(uint32_t addr, const uint8_t *data, uint32_t size)
         return ERROR_INTERNAL;
     }
 
-    // Setup the current sector if it is not setup already
-    if (!current_sector_valid) {
-        status = setup_next_sector(addr);
-
-        if (ERROR_SUCCESS != status) {
-            state = STATE_ERROR;
-            return status;
-        }
-        current_sector_valid = true;
-        last_addr = addr;
-    }
-
-    //non-increasing address support
-    if (ROUND_DOWN(addr, current_write_block_size) != ROUND_DOWN(last_addr, current_write_block_size)) {
-        status = flush_current_block(addr);
-        if (ERROR_SUCCESS != status) {
-            state = STATE_ERROR;
-            return status;
-        }
-    }
-
-    if (ROUND_DOWN(addr, current_sector_size) != ROUND_DOWN(last_addr, current_sector_size)) {
-        status = setup_next_sector(addr);
-        if (ERROR_SUCCESS != status) {
-            state = STATE_ERROR;
-            return status;
-        }
+    status = setup_data(addr);
+    if (ERROR_SUCCESS != status) {
+        state = STATE_ERROR;
+        return status;
     }
 
     while (true) {
@@ -183,6 +246,12 @@ error_t flash_manager_data(uint32_t addr, const uint8_t *data, uint32_t size)
         size_left = current_write_block_size - pos;
         copy_size = MIN(size, size_left);
         memcpy(buf + pos, data, copy_size);
+        if (buf_empty) {
+            buf_dirty_start = pos;
+            buf_dirty_end = pos;
+        }
+        buf_dirty_start = MIN(buf_dirty_start, pos);
+        buf_dirty_end = MAX(buf_dirty_end, pos + copy_size);
         buf_empty = copy_size == 0;
         // Update variables
         addr += copy_size;
@@ -191,9 +260,70 @@ error_t flash_manager_data(uint32_t addr, const uint8_t *data, uint32_t size)
     }
 
     last_addr = addr;
+    erase_ahead();
     return status;
 }
 
+error_t flash_manager_data_compressed(uint32_t addr, const uint8_t *data, uint32_t size,
+                                      const uint8_t *comp, uint32_t comp_size)
+{
+    transfer_perf_phase_t phase;
+    uint32_t unit;
+    uint32_t pos;
+    error_t status;
+    flash_manager_printf("flash_manager_data_compressed(addr=0x%x size=0x%x comp_size=0x%x)\r\n", addr, size, comp_size);
+
+    if (state != STATE_OPEN) {
+        util_assert(0);
+        return ERROR_INTERNAL;
+    }
+
+    if (!intf->program_compressed || (0 == size)) {
+        return flash_manager_data(addr, data, size);
+    }
+
+    status = setup_data(addr);
+    if (ERROR_SUCCESS != status) {
+        state = STATE_ERROR;
+        return status;
+    }
+
+    // The block is programmed as it is, so it must be whole units in the
+    // current block
+    unit = intf->program_page_min_size(addr);
+    if ((addr % unit) || (size % unit) || (addr + size > current_write_block_addr + current_write_block_size)) {
+        return flash_manager_data(addr, data, size);
+    }
+
+    status = flush_current_block(addr);
+    if (ERROR_SUCCESS != status) {
+        state = STATE_ERROR;
+        return status;
+    }
+
+    for (pos = 0; pos < size; pos += unit) {
+        if (unit_programmed(addr + pos, unit)) {
+            state = STATE_ERROR;
+            return ERROR_OOO_FLASH;
+        }
+    }
+
+    phase = transfer_perf_phase(TRANSFER_PERF_PROGRAM);
+    transfer_perf_bytes(TRANSFER_PERF_PROGRAM, size);
+    status = intf->program_compressed(addr, data, size, comp, comp_size);
+    transfer_perf_phase(phase);
+    flash_manager_printf("    intf->program_compressed(addr=0x%x, size=0x%x) ret=%i\r\n", addr, size, status);
+    if (ERROR_SUCCESS != status) {
+        state = STATE_ERROR;
+        return status;
+    }
+
+    range_add(&programmed, addr, addr + size);
+    last_addr = addr + size;
+    erase_ahead();
+    return ERROR_SUCCESS;
+}
+
 error_t flash_manager_uninit(void)
 {
     error_t flash_uninit_error;
@@ -222,6 +352,8 @@ error_t flash_manager_uninit(void)
     current_sector_addr = 0;
     current_sector_size = 0;
     last_addr = 0;
+    image_size = 0;
+    image_contiguous = false;
     state = STATE_CLOSED;
 
     // Make sure an error from a page write or from an
@@ -243,6 +375,13 @@ void flash_manager_set_page_erase(bool enabled)
     page_erase_enabled = enabled;
 }
 
+void flash_manager_set_image_size(uint32_t size, bool contiguous)
+{
+    flash_manager_printf("flash_manager_set_image_size(size=0x%x, contiguous=%i)\r\n", size, contiguous);
+    image_size = size;
+    image_contiguous = contiguous;
+}
+
 static bool flash_intf_valid(const flash_intf_t *flash_intf)
 {
     // Check for all requried members
@@ -281,12 +420,54 @@ static bool flash_intf_valid(const flash_intf_t *flash_intf)
     return true;
 }
 
+// Plan the erase, and set up the sector and the block of the data at addr
+static error_t setup_data(uint32_t addr)
+{
+    error_t status;
+
+    // The first address of the image is known now
+    if (!erase_planned) {
+        status = plan_erase(addr);
+
+        if (ERROR_SUCCESS != status) {
+            return status;
+        }
+    }
+
+    // Setup the current sector if it is not setup already
+    if (!current_sector_valid) {
+        status = setup_next_sector(addr);
+
+        if (ERROR_SUCCESS != status) {
+            return status;
+        }
+        current_sector_valid = true;
+        last_addr = addr;
+    }
+
+    //non-increasing address support
+    if (ROUND_DOWN(addr, current_write_block_size) != current_write_block_addr) {
+        status = flush_current_block(addr);
+        if (ERROR_SUCCESS != status) {
+            return status;
+        }
+    }
+
+    if (ROUND_DOWN(addr, current_sector_size) != current_sector_addr) {
+        status = setup_next_sector(addr);
+        if (ERROR_SUCCESS != status) {
+            return status;
+        }
+    }
+
+    return ERROR_SUCCESS;
+}
+
 static error_t flush_current_block(uint32_t addr){
     // Write out current buffer if there is data in it
     error_t status = ERROR_SUCCESS;
     if (!buf_empty) {
-        status = intf->program_page(current_write_block_addr, buf, current_write_block_size);
-        flash_manager_printf("    intf->program_page(addr=0x%x, size=0x%x) ret=%i\r\n", current_write_block_addr, current_write_block_size, status);
+        status = program_current_block();
         buf_empty = true;
     }
 
@@ -323,23 +504,40 @@ static error_t setup_next_sector(uint32_t addr)
 
     //check flash algo every sector change, addresses with different flash algo should be sector aligned
     if (intf->flash_algo_set) {
+        transfer_perf_phase_t phase = transfer_perf_phase(TRANSFER_PERF_ALGO);
         status = intf->flash_algo_set(current_sector_addr);
+        transfer_perf_phase(phase);
         if (ERROR_SUCCESS != status) {
             intf->uninit();
             return status;
         }
     }
 
-    if (page_erase_enabled) {
-        // Erase the current sector
-        status = intf->erase_sector(current_sector_addr);
-        flash_manager_printf("    intf->erase_sector(addr=0x%x) ret=%i\r\n", current_sector_addr);
+    // Data in the sector means it was erased earlier
+    if (!chip_erased && !range_find(&erased, current_sector_addr, current_sector_addr + 1) &&
+            !range_find(&programmed, current_sector_addr, current_sector_addr + sector_size)) {
+        if (erased.overflow) {
+            // The sector may be in a forgotten range, erasing it could lose data
+            status = check_sector_blank(current_sector_addr, sector_size);
+        } else {
+            // Erase the current sector
+            status = erase_range(current_sector_addr, sector_size);
+            flash_manager_printf("    intf->erase_sector(addr=0x%x) ret=%i\r\n", current_sector_addr, status);
+        }
         if (ERROR_SUCCESS != status) {
             intf->uninit();
             return status;
         }
     }
 
+    // The first sector known to be erased and untouched tells what blank
+    // flash reads as. Sectors are only checked against a known value.
+    if (!erased_value_known && !programmed.overflow &&
+            (chip_erased || range_find(&erased, current_sector_addr, current_sector_addr + 1)) &&
+            !range_find(&programmed, current_sector_addr, current_sector_addr + sector_size)) {
+        learn_erased_value(current_sector_addr);
+    }
+
     // Clear out buffer in case block size changed
     memset(buf, 0xFF, current_write_block_size);
     flash_manager_printf("    setup_next_sector(addr=0x%x) sect_addr=0x%x, write_addr=0x%x,\r\n",
@@ -348,3 +546,322 @@ static error_t setup_next_sector(uint32_t addr)
                          current_write_block_size, current_sector_size, min_prog_size);
     return ERROR_SUCCESS;
 }
+
+// Program the units of the block that got data. A unit is only programmed
+// once, ECC and phrase programmed flash can not take a second write, so data
+// coming back to a programmed unit fails the transfer. Units left all 0xFF
+// are skipped like the padding between blocks.
+static error_t program_current_block(void)
+{
+    uint32_t unit = intf->program_page_min_size(current_write_block_addr);
+    uint32_t start = ROUND_DOWN(buf_dirty_start, unit);
+    uint32_t end = ROUND_UP(buf_dirty_end, unit);
+    uint32_t run = start;
+    uint32_t pos;
+    uint32_t addr;
+    uint32_t i;
+    transfer_perf_phase_t phase;
+    error_t status;
+
+    for (pos = start; pos <= end; pos += unit) {
+        addr = current_write_block_addr + pos;
+        if (pos < end) {
+            for (i = 0; (i < unit) && (0xFF == buf[pos + i]); i++);
+            if (i < unit) {
+                if (unit_programmed(addr, unit)) {
+                    flash_manager_printf("    program_current_block() unit 0x%x programmed already\r\n", addr);
+                    return ERROR_OOO_FLASH;
+                }
+                continue;
+            }
+        }
+
+        // Program the units with data up to here in one call
+        if (run < pos) {
+            phase = transfer_perf_phase(TRANSFER_PERF_PROGRAM);
+            transfer_perf_bytes(TRANSFER_PERF_PROGRAM, pos - run);
+            status = intf->program_page(current_write_block_addr + run, buf + run, pos - run);
+            transfer_perf_phase(phase);
+            flash_manager_printf("    intf->program_page(addr=0x%x, size=0x%x) ret=%i\r\n", current_write_block_addr + run, pos - run, status);
+            if (ERROR_SUCCESS != status) {
+                return status;
+            }
+            range_add(&programmed, current_write_block_addr + run, addr);
+        }
+        run = pos + unit;
+    }
+    return ERROR_SUCCESS;
+}
+
+// Whether this transfer may have programmed the unit already
+static bool unit_programmed(uint32_t addr, uint32_t size)
+{
+    return range_find(&programmed, addr, addr + size) || (programmed.overflow && !flash_is_blank(addr, size));
+}
+
+static uint32_t elapsed_ms(uint32_t start_tick)
+{
+    return (uint64_t)(osKernelGetTickCount() - start_tick) * 1000 / osKernelGetTickFreq();
+}
+
+static uint32_t estimate_sector_erase_ms(uint32_t size)
+{
+    // A few ticks of measurements are mostly rounding
+    if (sector_erase_ms >= 100) {
+        return (uint64_t)size * sector_erase_ms / sector_erase_bytes;
+    }
+    return ROUND_UP(size, 1024) / 1024 * FLASH_MANAGER_SECTOR_ERASE_MS_PER_KB;
+}
+
+static uint32_t estimate_chip_erase_ms(void)
+{
+    return chip_erase_measured ? chip_erase_ms : FLASH_MANAGER_CHIP_ERASE_MS;
+}
+
+// Pick chip or sector erase once the start of the image is known
+static error_t plan_erase(uint32_t addr)
+{
+    uint32_t chip_cost;
+    uint32_t sector_cost = 0;
+    uint32_t sector_size;
+    uint32_t start;
+    uint32_t end;
+    uint32_t image_end;
+
+    erase_planned = true;
+    image_end = (image_size > UINT32_MAX - addr) ? UINT32_MAX : addr + image_size;
+
+    // Sectors of a contiguous image can be erased while the host sends the data
+    if (intf->erase_sector_start && image_contiguous && (image_size > 0)) {
+        erase_ahead_end = image_end;
+    }
+
+    if (page_erase_enabled || chip_erased) {
+        return ERROR_SUCCESS;
+    }
+
+    // Sum the cost of the sectors the image covers until a chip erase is cheaper
+    chip_cost = estimate_chip_erase_ms();
+    sector_size = intf->erase_sector_size(addr);
+    start = sector_size ? ROUND_DOWN(addr, sector_size) : addr;
+    end = start;
+    while ((image_size > 0) && (end < image_end) && (sector_cost <= chip_cost)) {
+        sector_size = intf->erase_sector_size(end);
+        if (0 == sector_size) {
+            sector_cost = UINT32_MAX;
+            break;
+        }
+        sector_cost += estimate_sector_erase_ms(sector_size);
+        end += sector_size;
+    }
+    flash_manager_printf("    plan_erase(addr=0x%x) sectors 0x%x-0x%x cost=%i chip cost=%i\r\n",
+                         addr, start, end, sector_cost, chip_cost);
+
+    if ((0 == image_size) || (sector_cost > chip_cost)) {
+        return erase_chip();
+    }
+
+    if (image_contiguous && !erase_ahead_end) {
+        // Erase all sectors of the image in one go
+        return erase_range(start, end - start);
+    }
+
+    // The sectors are erased as they are written
+    return ERROR_SUCCESS;
+}
+
+static error_t erase_chip(void)
+{
+    uint32_t start_tick = osKernelGetTickCount();
+    transfer_perf_phase_t phase;
+    error_t status;
+
+    phase = transfer_perf_phase(TRANSFER_PERF_ERASE);
+    status = intf->erase_chip();
+    transfer_perf_phase(phase);
+    flash_manager_printf("    intf->erase_chip ret=%i\r\n", status);
+    if (ERROR_SUCCESS == status) {
+        chip_erase_ms = elapsed_ms(start_tick);
+        chip_erase_measured = true;
+        chip_erased = true;
+    }
+    return status;
+}
+
+static error_t erase_range(uint32_t addr, uint32_t size)
+{
+    uint32_t start_tick = osKernelGetTickCount();
+    transfer_perf_phase_t phase;
+    error_t status;
+
+    phase = transfer_perf_phase(TRANSFER_PERF_ERASE);
+    if (intf->erase_range) {
+        status = intf->erase_range(addr, size);
+    } else {
+        status = intf->erase_sector(addr);
+    }
+    transfer_perf_phase(phase);
+    flash_manager_printf("    erase_range(addr=0x%x, size=0x%x) ret=%i\r\n", addr, size, status);
+    if (ERROR_SUCCESS != status) {
+        return status;
+    }
+
+    sector_erase_ms += elapsed_ms(start_tick);
+    sector_erase_bytes += size;
+    transfer_perf_bytes(TRANSFER_PERF_ERASE, size);
+
+    range_add(&erased, addr, addr + size);
+    return ERROR_SUCCESS;
+}
+
+// A sector that reads back blank can be written without an erase. Any other
+// content may be data of this transfer, so the transfer fails.
+static error_t check_sector_blank(uint32_t addr, uint32_t size)
+{
+    if (!flash_is_blank(addr, size)) {
+        flash_manager_printf("    check_sector_blank(addr=0x%x) not blank\r\n", addr);
+        return ERROR_OOO_FLASH;
+    }
+
+    range_add(&erased, addr, addr + size);
+    return ERROR_SUCCESS;
+}
+
+static void learn_erased_value(uint32_t addr)
+{
+    uint32_t i;
+
+    if (!intf->read || (ERROR_SUCCESS != intf->read(addr, check_buf, 4))) {
+        return;
+    }
+    for (i = 1; (i < 4) && (check_buf[i] == check_buf[0]); i++);
+    if (4 == i) {
+        erased_value = check_buf[0];
+        erased_value_known = true;
+        flash_manager_printf("    learn_erased_value(addr=0x%x) erased=0x%x\r\n", addr, erased_value);
+    }
+}
+
+// Flash that can not be read back, or with no known erased value, is not
+// known to be blank
+static bool flash_is_blank(uint32_t addr, uint32_t size)
+{
+    uint32_t offset;
+    uint32_t chunk;
+    uint32_t i;
+
+    if (!intf->read || !erased_value_known) {
+        return false;
+    }
+
+    for (offset = 0; offset < size; offset += chunk) {
+        chunk = MIN(size - offset, sizeof(check_buf));
+        if (ERROR_SUCCESS != intf->read(addr + offset, check_buf, chunk)) {
+            return false;
+        }
+        for (i = 0; i < chunk; i++) {
+            if (check_buf[i] != erased_value) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Find a range overlapping [start, end)
+static addr_range_t *range_find(range_list_t *list, uint32_t start, uint32_t end)
+{
+    uint32_t i;
+
+    for (i = 0; i < list->count; i++) {
+        if ((start < list->range[i].end) && (list->range[i].start < end)) {
+            return &list->range[i];
+        }
+    }
+    return NULL;
+}
+
+// Sequential data keeps extending one range
+static void range_add(range_list_t *list, uint32_t start, uint32_t end)
+{
+    addr_range_t *range = list->range;
+    uint32_t i = 0;
+
+    // Merge every range this one touches, the result becomes the newest
+    while (i < list->count) {
+        if ((start <= range[i].end) && (range[i].start <= end)) {
+            start = MIN(start, range[i].start);
+            end = MAX(end, range[i].end);
+            list->count--;
+            memmove(&range[i], &range[i + 1], (list->count - i) * sizeof(range[0]));
+        } else {
+            i++;
+        }
+    }
+
+    if (ARRAY_SIZE(list->range) == list->count) {
+        list->overflow = true;
+        list->count--;
+        memmove(&range[0], &range[1], list->count * sizeof(range[0]));
+    }
+
+    range[list->count].start = start;
+    range[list->count].end = end;
+    list->count++;
+}
+
+// Erase the sectors of the image ahead of the data while the host is still
+// sending it, up to the end of the image. One erase runs at a time and only
+// once the buffered data is programmed, so the erase fills the time the
+// target would otherwise wait for the host.
+static void erase_ahead(void)
+{
+    addr_range_t *range;
+    uint32_t next_addr;
+    uint32_t sector_size;
+    transfer_perf_phase_t phase;
+    error_t status;
+
+    if (chip_erased || !current_sector_valid || !erase_ahead_end) {
+        return;
+    }
+
+    // Without the full history the next sector may hold data already
+    if (erased.overflow) {
+        return;
+    }
+
+    // Only extend the erased range the data is currently in
+    range = range_find(&erased, current_sector_addr, current_sector_addr + 1);
+    if (!range || (range->end >= erase_ahead_end)) {
+        return;
+    }
+    next_addr = range->end;
+
+    if (!buf_empty || intf->erase_pending()) {
+        return;
+    }
+
+    // On failure the sector is erased when it is first written instead
+    sector_size = intf->erase_sector_size(next_addr);
+    if (0 == sector_size) {
+        erase_ahead_end = 0;
+        return;
+    }
+
+    if (range_find(&programmed, next_addr, next_addr + sector_size)) {
+        return;
+    }
+
+    phase = transfer_perf_phase(TRANSFER_PERF_ERASE);
+    status = intf->erase_sector_start(next_addr);
+    transfer_perf_phase(phase);
+    flash_manager_printf("    intf->erase_sector_start(addr=0x%x) ret=%i\r\n", next_addr, status);
+    if (ERROR_SUCCESS != status) {
+        erase_ahead_end = 0;
+        return;
+    }
+
+    transfer_perf_bytes(TRANSFER_PERF_ERASE, sector_size);
+    range_add(&erased, next_addr, next_addr + sector_size);
+}
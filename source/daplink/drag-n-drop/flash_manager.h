@@ -33,8 +33,17 @@ extern "C" {
 
 error_t flash_manager_init(const flash_intf_t *flash_intf);
 error_t flash_manager_data(uint32_t addr, const uint8_t *data, uint32_t size);
+// Like flash_manager_data, with the data also as an LZ4 block of comp_size
+// bytes that the flash interface may expand on the target
+error_t flash_manager_data_compressed(uint32_t addr, const uint8_t *data, uint32_t size,
+                                      const uint8_t *comp, uint32_t comp_size);
 error_t flash_manager_uninit(void);
 void flash_manager_set_page_erase(bool enabled);
+// Bytes covered by the next image from its first address, 0 if unknown.
+// The size picks between chip and sector erase, so an upper bound will do.
+// Contiguous images are also erased ahead of the data up to that size, so
+// only an exact size may be marked contiguous.
+void flash_manager_set_image_size(uint32_t size, bool contiguous);
 
 #ifdef __cplusplus
 }
@@ -62,6 +62,7 @@ static bool sector_erase_allowed(uint32_t addr);
 static error_t intercept_page_write(uint32_t addr, const uint8_t *buf, uint32_t size);
 static error_t intercept_sector_erase(uint32_t addr);
 static error_t critical_erase_and_program(uint32_t addr, const uint8_t *data, uint32_t size);
+static void update_complete_crc(error_t status);
 static uint8_t target_flash_busy(void);
 
 static const flash_intf_t flash_intf = {
@@ -87,6 +88,7 @@ static bool current_page_set;
 static uint32_t current_page;
 static uint32_t current_page_write_size;
 static uint32_t crc;
+static bool crc_valid;
 static uint8_t sector_buf[DAPLINK_SECTOR_SIZE];
 
 static error_t init()
@@ -118,6 +120,7 @@ static error_t init()
     current_page = 0;
     current_page_write_size = 0;
     crc = 0;
+    crc_valid = true;
     memset(sector_buf, 0, sizeof(sector_buf));
     state = STATE_OPEN;
     return ERROR_SUCCESS;
@@ -156,6 +159,7 @@ static error_t program_page(uint32_t addr, const uint8_t *buf, uint32_t size)
     error_t status;
     uint32_t min_prog_size;
     uint32_t sector_size;
+    uint32_t crc_size;
     uint32_t updt_end = DAPLINK_ROM_UPDATE_START + DAPLINK_ROM_UPDATE_SIZE;
 
     if (state != STATE_OPEN) {
@@ -214,6 +218,18 @@ static error_t program_page(uint32_t addr, const uint8_t *buf, uint32_t size)
         return ERROR_IAP_WRITE;
     }
 
+    // The running CRC only describes the update region if it was written
+    // from the start. Sequential writes are enforced above.
+    if (!current_page_set && (addr != DAPLINK_ROM_UPDATE_START)) {
+        crc_valid = false;
+    }
+
+    if ((addr >= DAPLINK_ROM_UPDATE_START) && (addr < updt_end)) {
+        // The last word of the update region holds the image CRC
+        crc_size = MIN(size, updt_end - addr - 4);
+        crc = crc32_continue(crc, buf, crc_size);
+    }
+
     current_page_set = true;
     current_page = addr;
     current_page_write_size = size;
@@ -237,8 +253,8 @@ static error_t program_page(uint32_t addr, const uint8_t *buf, uint32_t size)
     }
 
     if (addr + size >= updt_end) {
-        // Something has been updated so recompute the crc
-        info_crc_compute();
+        // Something has been updated so refresh the crc
+        update_complete_crc(ERROR_SUCCESS);
         update_complete = true;
     }
 
@@ -369,7 +385,6 @@ static bool sector_erase_allowed(uint32_t addr)
 static error_t intercept_page_write(uint32_t addr, const uint8_t *buf, uint32_t size)
 {
     error_t status;
-    uint32_t crc_size;
     uint32_t updt_start = DAPLINK_ROM_UPDATE_START;
     uint32_t updt_end = DAPLINK_ROM_UPDATE_START + DAPLINK_ROM_UPDATE_SIZE;
 
@@ -387,8 +402,6 @@ static error_t intercept_page_write(uint32_t addr, const uint8_t *buf, uint32_t
     }
 
     /* Everything below here is interface specific */
-    crc_size = MIN(size, updt_end - addr - 4);
-    crc = crc32_continue(crc, buf, crc_size);
 
     // Intercept the data if it is in the first sector
     if ((addr >= updt_start) && (addr < updt_start + DAPLINK_SECTOR_SIZE)) {
@@ -424,8 +437,8 @@ static error_t intercept_page_write(uint32_t addr, const uint8_t *buf, uint32_t
             status = ERROR_SUCCESS;
         }
 
-        // The bootloader has been updated so recompute the crc
-        info_crc_compute();
+        // The bootloader has been updated so refresh the crc
+        update_complete_crc(status);
         update_complete = true;
         return status;
     }
@@ -499,6 +512,17 @@ static error_t critical_erase_and_program(uint32_t addr, const uint8_t *data, ui
     return ERROR_SUCCESS;
 }
 
+static void update_complete_crc(error_t status)
+{
+    // The CRC accumulated while programming matches the flash contents
+    // unless programming failed part way, so only read back in that case.
+    if (crc_valid && (ERROR_SUCCESS == status)) {
+        info_crc_set(DAPLINK_ROM_UPDATE_START, crc);
+    } else {
+        info_crc_compute();
+    }
+}
+
 static uint8_t target_flash_busy(void){
     return (state == STATE_OPEN);
 }
@@ -0,0 +1,186 @@
+/**
+ * @file    transfer_perf.c
+ * @brief   Implementation of transfer_perf.h
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "transfer_perf.h"
+#include "cmsis_os2.h"
+#include "DAP_config.h"     // for TIMESTAMP_GET
+#include "util.h"
+
+typedef struct {
+    uint64_t ticks;
+    uint32_t bytes;
+} phase_count_t;
+
+static const char *const phase_names[] = {
+    "USB idle",
+    "Decode",
+    "Algo download",
+    "Erase",
+    "SWD write",
+    "Program",
+    "Verify",
+};
+
+COMPILER_ASSERT(ARRAY_SIZE(phase_names) == TRANSFER_PERF_PHASE_COUNT);
+
+// Counters of the transfer in progress and of the last finished one
+static phase_count_t count[TRANSFER_PERF_PHASE_COUNT];
+static phase_count_t result[TRANSFER_PERF_PHASE_COUNT];
+static bool result_valid;
+static bool running;
+static transfer_perf_phase_t current_phase = TRANSFER_PERF_USB;
+static uint32_t phase_start;
+
+// The cycle counter where the core has one, the CMSIS-DAP timestamp or
+// else the RTOS tick
+#if defined(DWT)
+
+static void timer_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t timer_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+static uint32_t timer_freq(void)
+{
+    return SystemCoreClock;
+}
+
+#elif (TIMESTAMP_CLOCK != 0)
+
+static void timer_init(void)
+{
+}
+
+static uint32_t timer_get(void)
+{
+    return TIMESTAMP_GET();
+}
+
+static uint32_t timer_freq(void)
+{
+    return TIMESTAMP_CLOCK;
+}
+
+#else
+
+static void timer_init(void)
+{
+}
+
+static uint32_t timer_get(void)
+{
+    return osKernelGetTickCount();
+}
+
+static uint32_t timer_freq(void)
+{
+    return osKernelGetTickFreq();
+}
+
+#endif
+
+void transfer_perf_start(void)
+{
+    timer_init();
+    memset(count, 0, sizeof(count));
+    current_phase = TRANSFER_PERF_USB;
+    phase_start = timer_get();
+    running = true;
+}
+
+void transfer_perf_stop(void)
+{
+    if (!running) {
+        return;
+    }
+
+    transfer_perf_phase(TRANSFER_PERF_USB);
+    running = false;
+    memcpy(result, count, sizeof(result));
+    result_valid = true;
+}
+
+transfer_perf_phase_t transfer_perf_phase(transfer_perf_phase_t phase)
+{
+    transfer_perf_phase_t prev_phase = current_phase;
+    uint32_t now;
+
+    if (running) {
+        now = timer_get();
+        count[current_phase].ticks += now - phase_start;
+        phase_start = now;
+    }
+    current_phase = phase;
+    return prev_phase;
+}
+
+void transfer_perf_bytes(transfer_perf_phase_t phase, uint32_t bytes)
+{
+    if (running) {
+        count[phase].bytes += bytes;
+    }
+}
+
+const char *transfer_perf_phase_name(transfer_perf_phase_t phase)
+{
+    if (phase >= TRANSFER_PERF_PHASE_COUNT) {
+        return "Total";
+    }
+    return phase_names[phase];
+}
+
+bool transfer_perf_get(transfer_perf_phase_t phase, transfer_perf_counter_t *counter)
+{
+    uint64_t ticks = 0;
+    uint64_t time_us;
+    uint32_t i;
+
+    memset(counter, 0, sizeof(*counter));
+    if (!result_valid) {
+        return false;
+    }
+
+    if (phase < TRANSFER_PERF_PHASE_COUNT) {
+        ticks = result[phase].ticks;
+        counter->bytes = result[phase].bytes;
+    } else {
+        // The whole transfer, at the rate the image was programmed
+        for (i = 0; i < TRANSFER_PERF_PHASE_COUNT; i++) {
+            ticks += result[i].ticks;
+        }
+        counter->bytes = result[TRANSFER_PERF_PROGRAM].bytes;
+    }
+
+    time_us = ticks * 1000000 / timer_freq();
+    counter->time_us = MIN(time_us, UINT32_MAX);
+    if (time_us > 0) {
+        counter->bytes_per_s = MIN((uint64_t)counter->bytes * 1000000 / time_us, UINT32_MAX);
+    }
+    return true;
+}
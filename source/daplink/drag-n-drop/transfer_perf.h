@@ -0,0 +1,75 @@
+/**
+ * @file    transfer_perf.h
+ * @brief   Time spent in each phase of a drag-n-drop transfer
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRANSFER_PERF_H
+#define TRANSFER_PERF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Phases of a transfer. The time between two phase changes goes to the
+// phase that was current, so the phases add up to the transfer time.
+typedef enum {
+    TRANSFER_PERF_USB = 0,      // Waiting for the host to send the next sector
+    TRANSFER_PERF_DECODE,       // Handling the sectors and decoding the file
+    TRANSFER_PERF_ALGO,         // Target reset and flash algo download
+    TRANSFER_PERF_ERASE,        // Erasing, or waiting for a background erase
+    TRANSFER_PERF_SWD_WRITE,    // Copying data to the program buffer of the target
+    TRANSFER_PERF_PROGRAM,      // Running the program function of the flash algo
+    TRANSFER_PERF_VERIFY,       // Checking the programmed data
+    TRANSFER_PERF_PHASE_COUNT,
+} transfer_perf_phase_t;
+
+typedef struct {
+    uint32_t time_us;           // Time spent in the phase
+    uint32_t bytes;             // Bytes handled by the phase
+    uint32_t bytes_per_s;       // Rate while in the phase, 0 if not measured
+} transfer_perf_counter_t;
+
+// Clear the counters and start timing a transfer, in the USB phase
+void transfer_perf_start(void);
+
+// Stop timing, the counters of the transfer are kept for reading
+void transfer_perf_stop(void);
+
+// Switch to a phase and return the previous one. A function can switch
+// phases freely if its caller switches back once it returns.
+transfer_perf_phase_t transfer_perf_phase(transfer_perf_phase_t phase);
+
+// Count bytes handled by a phase
+void transfer_perf_bytes(transfer_perf_phase_t phase, uint32_t bytes);
+
+// Name of a phase for reports
+const char *transfer_perf_phase_name(transfer_perf_phase_t phase);
+
+// Counters of the last finished transfer, the whole transfer for
+// TRANSFER_PERF_PHASE_COUNT. Returns false if there was none.
+bool transfer_perf_get(transfer_perf_phase_t phase, transfer_perf_counter_t *counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -20,6 +20,7 @@
  */
 
 #include <ctype.h>
+#include <string.h>
 
 #include "daplink.h"
 #include DAPLINK_MAIN_HEADER
@@ -35,6 +36,7 @@
 #include "IO_Config.h"
 #include "file_stream.h"
 #include "error.h"
+#include "transfer_perf.h"
 
 // Set to 1 to enable debugging
 #define DEBUG_VFS_MANAGER     0
@@ -64,6 +66,26 @@ COMPILER_ASSERT(DISCONNECT_DELAY_TRANSFER_TIMEOUT_MS < MAX_EVENT_TIME_MS);
 COMPILER_ASSERT(DISCONNECT_DELAY_TRANSFER_IDLE_MS < MAX_EVENT_TIME_MS);
 COMPILER_ASSERT(DISCONNECT_DELAY_MS < MAX_EVENT_TIME_MS);
 
+// Number of sectors that can be held back when a host writes file data
+// ahead of the next expected sector. Each entry costs one VFS sector of RAM,
+// so HICs set this in their records according to their RAM budget.
+#ifndef VFS_OOO_SECTOR_COUNT
+#define VFS_OOO_SECTOR_COUNT 4
+#endif
+
+// Number of written sectors copied out of the USB buffer while they wait
+// for the thread set with vfs_mngr_set_thread(). One more waits in the USB
+// buffer itself. Each entry costs one VFS sector of RAM.
+#ifndef VFS_WRITE_QUEUE_COUNT
+#define VFS_WRITE_QUEUE_COUNT 0
+#endif
+#if defined(DAPLINK_BL)
+// The bootloader programs sectors on the USB thread
+#undef VFS_WRITE_QUEUE_COUNT
+#define VFS_WRITE_QUEUE_COUNT 0
+#endif
+#define WRITE_QUEUE_SIZE (VFS_WRITE_QUEUE_COUNT + 1)
+
 typedef enum {
     TRANSFER_NOT_STARTED,
     TRANSFER_IN_PROGRESS,
@@ -90,6 +112,11 @@ typedef struct {
     stream_type_t stream;           // Current stream or STREAM_TYPE_NONE is stream is closed.  This only gets reset remount
 } file_transfer_state_t;
 
+typedef struct {
+    vfs_sector_t sector;
+    const uint8_t *data;            // A copy, or the USB buffer for the newest sector
+} write_queue_entry_t;
+
 typedef enum {
     VFS_MNGR_STATE_DISCONNECTED,
     VFS_MNGR_STATE_RECONNECTING,
@@ -129,27 +156,57 @@ U8 *USBD_MSC_BlockBuf;
 uint32_t usb_buffer[VFS_SECTOR_SIZE / sizeof(uint32_t)];
 static error_t fail_reason = ERROR_SUCCESS;
 static file_transfer_state_t file_transfer_state;
+static vfs_mngr_stats_t transfer_stats;
+
+#if VFS_OOO_SECTOR_COUNT
+// Reassembly pool for sectors that arrived before the expected next sector
+static vfs_sector_t ooo_sector[VFS_OOO_SECTOR_COUNT];
+// Held before the stream started, not known to be part of the file yet
+static bool ooo_unconfirmed[VFS_OOO_SECTOR_COUNT];
+static uint32_t ooo_data[VFS_OOO_SECTOR_COUNT][VFS_SECTOR_SIZE / sizeof(uint32_t)];
+#endif
 
 // These variables can be access from multiple threads
 // so access to them must be synchronized
 static vfs_mngr_state_t vfs_state;
 static vfs_mngr_state_t vfs_state_next;
-static uint32_t time_usb_idle;
+static uint32_t idle_tick;          // Last write, or start of the state change
+
+// Sectors written by the USB thread, waiting for the process thread
+static write_queue_entry_t write_queue[WRITE_QUEUE_SIZE];
+static uint32_t write_queue_head;
+static uint32_t write_queue_tail;
+static bool write_queue_in_usb_buffer;  // The newest sector was not copied
+#if VFS_WRITE_QUEUE_COUNT
+static uint32_t write_queue_data[VFS_WRITE_QUEUE_COUNT][VFS_SECTOR_SIZE / sizeof(uint32_t)];
+static uint32_t write_queue_copies;
+#endif
 
 static osMutexId_t sync_mutex;
 static osThreadId_t sync_thread = 0;
+static osThreadId_t process_thread = 0;
+static const osMutexAttr_t sync_mutex_attr = {
+    .name = "vfs",
+    .attr_bits = osMutexRecursive | osMutexPrioInherit,
+};
 
 // Synchronization functions
 static void sync_init(void);
 static void sync_assert_usb_thread(void);
+static void sync_assert_process_thread(void);
 static void sync_lock(void);
 static void sync_unlock(void);
+static void sync_wake(void);
 
 static bool changing_state(void);
+static void set_state_next(vfs_mngr_state_t state);
+static uint32_t process_state(void);
+static void process_sector(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors);
 static void build_filesystem(void);
 static void file_change_handler(const vfs_filename_t filename, vfs_file_change_t change, vfs_file_t file, vfs_file_t new_file_data);
 static void file_data_handler(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors);
-static bool ready_for_state_change(void);
+static uint32_t state_change_delay_ms(void);
+static uint32_t ms_to_ticks(uint32_t ms);
 static void abort_remount(void);
 
 static void transfer_update_file_info(vfs_file_t file, uint32_t start_sector, uint32_t size, stream_type_t stream);
@@ -157,6 +214,12 @@ static void transfer_reset_file_info(void);
 static void transfer_stream_open(stream_type_t stream, uint32_t start_sector);
 static void transfer_stream_data(uint32_t sector, const uint8_t *data, uint32_t size);
 static void transfer_update_state(error_t status);
+static void transfer_sector_data(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors);
+static void transfer_addressed_data(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors);
+static void ooo_pool_reset(void);
+static bool ooo_pool_add(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors);
+static void ooo_pool_drain(void);
+static void ooo_pool_check_file(void);
 
 __WEAK void board_vfs_stream_closed_hook(void){}
 
@@ -166,10 +229,10 @@ void vfs_mngr_fs_enable(bool enable)
 
     if (enable) {
         if (VFS_MNGR_STATE_DISCONNECTED == vfs_state_next) {
-            vfs_state_next = VFS_MNGR_STATE_CONNECTED;
+            set_state_next(VFS_MNGR_STATE_CONNECTED);
         }
     } else {
-        vfs_state_next = VFS_MNGR_STATE_DISCONNECTED;
+        set_state_next(VFS_MNGR_STATE_DISCONNECTED);
     }
 
     sync_unlock();
@@ -181,7 +244,7 @@ void vfs_mngr_fs_remount(void)
 
     // Only start a remount if in the connected state and not in a transition
     if (!changing_state() && (VFS_MNGR_STATE_CONNECTED == vfs_state)) {
-        vfs_state_next = VFS_MNGR_STATE_RECONNECTING;
+        set_state_next(VFS_MNGR_STATE_RECONNECTING);
     }
 
     sync_unlock();
@@ -203,33 +266,75 @@ void vfs_mngr_init(bool enable)
     }
 }
 
-void vfs_mngr_periodic(uint32_t elapsed_ms)
+void vfs_mngr_set_thread(osThreadId_t thread)
 {
-    bool change_state;
+    process_thread = thread;
+}
+
+uint32_t vfs_mngr_process(void)
+{
+    write_queue_entry_t *entry = NULL;
+    bool queued;
+
+    sync_assert_process_thread();
+
+    sync_lock();
+    if (write_queue_head != write_queue_tail) {
+        entry = &write_queue[write_queue_tail % WRITE_QUEUE_SIZE];
+    }
+    sync_unlock();
+
+    if (NULL == entry) {
+        return process_state();
+    }
+
+    process_sector(entry->sector, entry->data, 1);
+
+    sync_lock();
+    write_queue_tail++;
+    queued = write_queue_head != write_queue_tail;
+    if (!queued) {
+        write_queue_in_usb_buffer = false;
+    }
+    sync_unlock();
+
+    if (queued) {
+        return 0;
+    }
+
+    // The USB thread may have held back a packet until the queue was empty
+    USBD_SignalHandler();
+
+    // State changes wait until the written sectors are processed
+    return process_state();
+}
+
+// Run the state machine, returns the ticks until it needs to run again
+static uint32_t process_state(void)
+{
+    uint32_t elapsed;
+    uint32_t delay;
     vfs_mngr_state_t vfs_state_local;
     vfs_mngr_state_t vfs_state_local_prev;
-    sync_assert_usb_thread();
     sync_lock();
 
     // Return immediately if the desired state has been reached
     if (!changing_state()) {
         sync_unlock();
-        return;
+        return osWaitForever;
     }
 
-    change_state = ready_for_state_change();
-
-    if (time_usb_idle < MAX_EVENT_TIME_MS) {
-        time_usb_idle += elapsed_ms;
-    }
+    elapsed = osKernelGetTickCount() - idle_tick;
+    delay = ms_to_ticks(state_change_delay_ms());
 
-    if (!change_state) {
+    // Wait until the delay has passed without a write
+    if (elapsed <= delay) {
         sync_unlock();
-        return;
+        return delay - elapsed + 1;
     }
 
-    vfs_mngr_printf("vfs_mngr_periodic()\r\n");
-    vfs_mngr_printf("   time_usb_idle=%i\r\n", time_usb_idle);
+    vfs_mngr_printf("vfs_mngr_process()\r\n");
+    vfs_mngr_printf("   idle ticks=%i\r\n", elapsed);
     vfs_mngr_printf("   transfer_state=%i\r\n", file_transfer_state.transfer_state);
     // Transistion to new state
     vfs_state_local_prev = vfs_state;
@@ -247,7 +352,7 @@ void vfs_mngr_periodic(uint32_t elapsed_ms)
     }
 
     vfs_state_local = vfs_state;
-    time_usb_idle = 0;
+    idle_tick = osKernelGetTickCount();
     sync_unlock();
     // Processing when leaving a state
     vfs_mngr_printf("    state %i->%i\r\n", vfs_state_local_prev, vfs_state_local);
@@ -286,27 +391,35 @@ void vfs_mngr_periodic(uint32_t elapsed_ms)
             break;
 
         case VFS_MNGR_STATE_CONNECTED:
+            // Reads of the USB thread must not see it half built
+            sync_lock();
             build_filesystem();
+            sync_unlock();
             USBD_MSC_MediaReady = 1;
             break;
     }
 
-    return;
+    // The next state may already be requested
+    return 0;
 }
 
 error_t vfs_mngr_get_transfer_status()
 {
-    sync_assert_usb_thread();
     return fail_reason;
 }
 
+const vfs_mngr_stats_t *vfs_mngr_get_stats(void)
+{
+    return &transfer_stats;
+}
+
 void usbd_msc_init(void)
 {
     sync_init();
     build_filesystem();
     vfs_state = VFS_MNGR_STATE_DISCONNECTED;
     vfs_state_next = VFS_MNGR_STATE_DISCONNECTED;
-    time_usb_idle = 0;
+    idle_tick = osKernelGetTickCount();
     USBD_MSC_MediaReady = 0;
 }
 
@@ -321,11 +434,16 @@ void usbd_msc_read_sect(uint32_t sector, uint8_t *buf, uint32_t num_of_sectors)
 
     // indicate msc activity
     main_blink_msc_led(MAIN_LED_FLASH);
+    // The process thread may be building the filesystem
+    sync_lock();
     vfs_read(sector, buf, num_of_sectors);
+    sync_unlock();
 }
 
 void usbd_msc_write_sect(uint32_t sector, uint8_t *buf, uint32_t num_of_sectors)
 {
+    write_queue_entry_t *entry;
+
     sync_assert_usb_thread();
 
     if (!USBD_MSC_MediaReady) {
@@ -335,7 +453,57 @@ void usbd_msc_write_sect(uint32_t sector, uint8_t *buf, uint32_t num_of_sectors)
     // Restart the disconnect counter on every packet
     // so the device does not detach in the middle of a
     // transfer.
-    time_usb_idle = 0;
+    sync_lock();
+    idle_tick = osKernelGetTickCount();
+    sync_unlock();
+
+    if (!process_thread) {
+        process_sector(sector, buf, num_of_sectors);
+        return;
+    }
+
+    // Sectors come one at a time, see build_filesystem()
+    util_assert(1 == num_of_sectors);
+    sync_lock();
+    entry = &write_queue[write_queue_head % WRITE_QUEUE_SIZE];
+    entry->sector = sector;
+    entry->data = buf;
+    write_queue_in_usb_buffer = true;
+#if VFS_WRITE_QUEUE_COUNT
+    // Copy it out unless every copy is still queued, the USB buffer
+    // is then held by usbd_msc_busy() until the queue is empty
+    if (write_queue_head - write_queue_tail < VFS_WRITE_QUEUE_COUNT) {
+        entry->data = (const uint8_t *)write_queue_data[write_queue_copies++ % VFS_WRITE_QUEUE_COUNT];
+        memcpy((uint8_t *)entry->data, buf, VFS_SECTOR_SIZE);
+        write_queue_in_usb_buffer = false;
+    }
+#endif
+    write_queue_head++;
+    sync_unlock();
+    sync_wake();
+}
+
+BOOL usbd_msc_busy(BOOL write_data)
+{
+    bool busy;
+
+    sync_lock();
+    if (write_data) {
+        // The data goes to the USB buffer
+        busy = write_queue_in_usb_buffer;
+    } else {
+        // Anything else, like a read, waits for the written sectors
+        busy = write_queue_head != write_queue_tail;
+    }
+    sync_unlock();
+
+    return busy ? __TRUE : __FALSE;
+}
+
+// Program a sector written over USB
+static void process_sector(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors)
+{
+    transfer_perf_phase_t phase;
 
     if (TRASNFER_FINISHED == file_transfer_state.transfer_state) {
         return;
@@ -343,17 +511,19 @@ void usbd_msc_write_sect(uint32_t sector, uint8_t *buf, uint32_t num_of_sectors)
 
     // indicate msc activity
     main_blink_msc_led(MAIN_LED_FLASH);
+    phase = transfer_perf_phase(TRANSFER_PERF_DECODE);
+    transfer_perf_bytes(TRANSFER_PERF_USB, num_of_sectors * VFS_SECTOR_SIZE);
     vfs_write(sector, buf, num_of_sectors);
-    if (TRASNFER_FINISHED == file_transfer_state.transfer_state) {
-        return;
+    if (TRASNFER_FINISHED != file_transfer_state.transfer_state) {
+        file_data_handler(sector, buf, num_of_sectors);
     }
-    file_data_handler(sector, buf, num_of_sectors);
+    transfer_perf_phase(phase);
 }
 
 static void sync_init(void)
 {
     sync_thread = osThreadGetId();
-    sync_mutex = osMutexNew(NULL);
+    sync_mutex = osMutexNew(&sync_mutex_attr);
 }
 
 static void sync_assert_usb_thread(void)
@@ -361,9 +531,14 @@ static void sync_assert_usb_thread(void)
     util_assert(osThreadGetId() == sync_thread);
 }
 
+static void sync_assert_process_thread(void)
+{
+    util_assert(osThreadGetId() == (process_thread ? process_thread : sync_thread));
+}
+
 static void sync_lock(void)
 {
-    osMutexAcquire(sync_mutex, 0);
+    osMutexAcquire(sync_mutex, osWaitForever);
 }
 
 static void sync_unlock(void)
@@ -371,15 +546,35 @@ static void sync_unlock(void)
     osMutexRelease(sync_mutex);
 }
 
+// Let the process thread know there is something to do
+static void sync_wake(void)
+{
+    if (process_thread) {
+        osThreadFlagsSet(process_thread, VFS_MNGR_FLAG_PROCESS);
+    }
+}
+
 static bool changing_state()
 {
     return vfs_state != vfs_state_next;
 }
 
+static void set_state_next(vfs_mngr_state_t state)
+{
+    // The delay of a state change starts with the request
+    if (!changing_state() && (state != vfs_state)) {
+        idle_tick = osKernelGetTickCount();
+    }
+
+    vfs_state_next = state;
+    sync_wake();
+}
+
 static void build_filesystem()
 {
     // Update anything that could have changed file system state
     file_transfer_state = default_transfer_state;
+    ooo_pool_reset();
     vfs_user_build_filesystem();
     vfs_set_file_change_callback(file_change_handler);
     // Set mass storage parameters
@@ -439,7 +634,6 @@ static void file_change_handler(const vfs_filename_t filename, vfs_file_change_t
 static void file_data_handler(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors)
 {
     stream_type_t stream;
-    uint32_t size;
 
     // this is the key for starting a file write - we dont care what file types are sent
     //  just look for something unique (NVIC table, hex, srec, etc) until root dir is updated
@@ -449,10 +643,20 @@ static void file_data_handler(uint32_t sector, const uint8_t *buf, uint32_t num_
 
         if (STREAM_TYPE_NONE != stream) {
             transfer_stream_open(stream, sector);
+        } else if (sector >= vfs_get_free_start_sector()) {
+            // Hosts with write back caching can flush parts of a file before
+            // its start. Keep this data until the directory entry shows
+            // whether it is part of the file.
+            ooo_pool_add(sector, buf, num_of_sectors);
         }
     }
 
     if (file_transfer_state.stream_started) {
+        if (stream_is_self_addressed(file_transfer_state.stream)) {
+            transfer_addressed_data(sector, buf, num_of_sectors);
+            return;
+        }
+
         // Ignore sectors coming before this file
         if (sector < file_transfer_state.start_sector) {
             return;
@@ -472,6 +676,12 @@ static void file_data_handler(uint32_t sector, const uint8_t *buf, uint32_t num_
 
                 file_transfer_state.last_ooo_sector =
                     MIN(file_transfer_state.last_ooo_sector, sector);
+            } else if (ooo_pool_add(sector, buf, num_of_sectors)) {
+                // Held back until the sectors before it have arrived. It can
+                // release one held since before the stream started.
+                vfs_mngr_printf("    sector ahead of file transfer, buffered\r\n");
+                ooo_pool_drain();
+                return;
             } else {
                 vfs_mngr_printf("    sector not part of file transfer\r\n");
             }
@@ -481,25 +691,217 @@ static void file_data_handler(uint32_t sector, const uint8_t *buf, uint32_t num_
             return;
         }
 
-        // This sector could be part of the file so record it
-        size = VFS_SECTOR_SIZE * num_of_sectors;
-        file_transfer_state.size_transferred += size;
-        file_transfer_state.file_next_sector = sector + num_of_sectors;
+        transfer_sector_data(sector, buf, num_of_sectors);
+        ooo_pool_drain();
+    }
+}
 
-        // If stream processing is done then discard the data
-        if (file_transfer_state.stream_finished) {
-            vfs_mngr_printf("vfs_manager file_data_handler\r\n    sector=%i, size=%i\r\n", sector, size);
-            vfs_mngr_printf("    discarding data - size transferred=0x%x, data=%x,%x,%x,%x,...\r\n",
-                            file_transfer_state.size_transferred, buf[0], buf[1], buf[2], buf[3]);
-            transfer_update_state(ERROR_SUCCESS);
+// Pass file data to the stream
+static void transfer_sector_data(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors)
+{
+    uint32_t size;
+
+    // This sector could be part of the file so record it
+    size = VFS_SECTOR_SIZE * num_of_sectors;
+    file_transfer_state.size_transferred += size;
+    file_transfer_state.file_next_sector = sector + num_of_sectors;
+
+    // If stream processing is done then discard the data
+    if (file_transfer_state.stream_finished) {
+        vfs_mngr_printf("vfs_manager file_data_handler\r\n    sector=%i, size=%i\r\n", sector, size);
+        vfs_mngr_printf("    discarding data - size transferred=0x%x, data=%x,%x,%x,%x,...\r\n",
+                        file_transfer_state.size_transferred, buf[0], buf[1], buf[2], buf[3]);
+        transfer_update_state(ERROR_SUCCESS);
+        return;
+    }
+
+    transfer_stream_data(sector, buf, size);
+}
+
+// Pass file data to the stream in the order it arrives. Every sector
+// carries its own address so there is nothing to reassemble.
+static void transfer_addressed_data(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors)
+{
+    uint32_t i;
+
+    for (i = 0; i < num_of_sectors; i++) {
+        const uint8_t *data = buf + i * VFS_SECTOR_SIZE;
+
+        // Sectors of other files are not part of the transfer
+        if (stream_start_identify(data, VFS_SECTOR_SIZE) != file_transfer_state.stream) {
+            continue;
+        }
+
+        // The file can start before the first sector that arrived
+        file_transfer_state.start_sector = MIN(file_transfer_state.start_sector, sector + i);
+        transfer_sector_data(sector + i, data, 1);
+
+        if (TRASNFER_FINISHED == file_transfer_state.transfer_state) {
             return;
         }
+    }
+}
+
+#if VFS_OOO_SECTOR_COUNT
+
+static void ooo_pool_reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < VFS_OOO_SECTOR_COUNT; i++) {
+        ooo_sector[i] = VFS_INVALID_SECTOR;
+    }
+}
+
+// Return the entry holding sector or VFS_OOO_SECTOR_COUNT if there is none
+static uint32_t ooo_pool_find(uint32_t sector)
+{
+    uint32_t i;
+
+    for (i = 0; i < VFS_OOO_SECTOR_COUNT; i++) {
+        if (ooo_sector[i] == sector) {
+            break;
+        }
+    }
+    return i;
+}
+
+static bool ooo_pool_entry_free(uint32_t i)
+{
+    // Entries before the next expected sector can no longer be used
+    return (VFS_INVALID_SECTOR == ooo_sector[i]) ||
+           (file_transfer_state.stream_started &&
+            (ooo_sector[i] < file_transfer_state.file_next_sector));
+}
+
+// Return a free entry or, if there is none, the one furthest ahead since it
+// is the least likely to be needed soon
+static uint32_t ooo_pool_victim(void)
+{
+    uint32_t i;
+    uint32_t slot = 0;
+
+    for (i = 0; i < VFS_OOO_SECTOR_COUNT; i++) {
+        if (ooo_pool_entry_free(i)) {
+            return i;
+        }
+        if (ooo_sector[i] > ooo_sector[slot]) {
+            slot = i;
+        }
+    }
+    return slot;
+}
+
+// Hold back sectors that cannot be streamed yet. Returns false if nothing
+// was stored.
+static bool ooo_pool_add(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors)
+{
+    uint32_t n;
+    uint32_t slot;
+
+    for (n = 0; n < num_of_sectors; n++, sector++, buf += VFS_SECTOR_SIZE) {
+        slot = ooo_pool_find(sector);
+
+        if (VFS_OOO_SECTOR_COUNT == slot) {
+            slot = ooo_pool_victim();
+
+            if (!ooo_pool_entry_free(slot)) {
+                if (ooo_sector[slot] < sector) {
+                    // Everything held back is closer than this sector
+                    return n > 0;
+                }
+                transfer_stats.ooo_dropped++;
+            }
+        }
+
+        ooo_sector[slot] = sector;
+        ooo_unconfirmed[slot] = !file_transfer_state.stream_started;
+        memcpy(ooo_data[slot], buf, VFS_SECTOR_SIZE);
+    }
+
+    return true;
+}
+
+// Feed held back sectors to the stream for as long as they are in order
+static void ooo_pool_drain(void)
+{
+    uint32_t slot;
+    uint32_t after;
+
+    while (TRASNFER_FINISHED != file_transfer_state.transfer_state) {
+        slot = ooo_pool_find(file_transfer_state.file_next_sector);
+        if (VFS_OOO_SECTOR_COUNT == slot) {
+            break;
+        }
+
+        // A sector held before the stream started waits for the directory
+        // entry, unless the stream already went on with the sector after it
+        if (ooo_unconfirmed[slot]) {
+            after = ooo_pool_find(file_transfer_state.file_next_sector + 1);
+            if ((VFS_OOO_SECTOR_COUNT == after) || ooo_unconfirmed[after]) {
+                break;
+            }
+        }
+
+        ooo_sector[slot] = VFS_INVALID_SECTOR;
+        transfer_stats.ooo_sectors++;
+        transfer_sector_data(file_transfer_state.file_next_sector, (uint8_t *)ooo_data[slot], 1);
+    }
+}
+
+// Sectors held before the stream started can belong to any file. Once the
+// directory entry gives the extent of the file keep the ones inside it and
+// drop the others.
+static void ooo_pool_check_file(void)
+{
+    uint32_t i;
+    vfs_sector_t start = file_transfer_state.file_start_sector;
+    uint32_t count = (file_transfer_state.file_size + VFS_SECTOR_SIZE - 1) / VFS_SECTOR_SIZE;
+
+    if ((VFS_INVALID_SECTOR == start) || (0 == count)) {
+        return;
+    }
+
+    for (i = 0; i < VFS_OOO_SECTOR_COUNT; i++) {
+        if ((VFS_INVALID_SECTOR == ooo_sector[i]) || !ooo_unconfirmed[i]) {
+            continue;
+        }
+        if ((ooo_sector[i] >= start) && (ooo_sector[i] - start < count)) {
+            ooo_unconfirmed[i] = false;
+        } else {
+            vfs_mngr_printf("    dropping sector %i held before the stream started\r\n", ooo_sector[i]);
+            ooo_sector[i] = VFS_INVALID_SECTOR;
+        }
+    }
 
-        transfer_stream_data(sector, buf, size);
+    if (file_transfer_state.stream_started) {
+        ooo_pool_drain();
     }
 }
 
-static bool ready_for_state_change(void)
+#else
+
+static void ooo_pool_reset(void)
+{
+}
+
+static bool ooo_pool_add(uint32_t sector, const uint8_t *buf, uint32_t num_of_sectors)
+{
+    return false;
+}
+
+static void ooo_pool_drain(void)
+{
+}
+
+static void ooo_pool_check_file(void)
+{
+}
+
+#endif
+
+// Time without writes before the pending state change may happen
+static uint32_t state_change_delay_ms(void)
 {
     uint32_t timeout_ms = INVALID_TIMEOUT_MS;
     util_assert(vfs_state != vfs_state_next);
@@ -540,7 +942,12 @@ static bool ready_for_state_change(void)
         timeout_ms = 0;
     }
 
-    return time_usb_idle > timeout_ms ? true : false;
+    return timeout_ms;
+}
+
+static uint32_t ms_to_ticks(uint32_t ms)
+{
+    return (ms * osKernelGetTickFreq() + 999) / 1000;
 }
 
 // Abort a remount if one is pending
@@ -618,7 +1025,15 @@ static void transfer_update_file_info(vfs_file_t file, uint32_t start_sector, ui
     file_transfer_state.file_size = size;
     vfs_mngr_printf("    updated size=%i\r\n", size);
 
+    if (size > 0) {
+        stream_set_file_size(file_transfer_state.stream, size);
+    }
+
     transfer_update_state(ERROR_SUCCESS);
+
+    if (TRASNFER_FINISHED != file_transfer_state.transfer_state) {
+        ooo_pool_check_file();
+    }
 }
 
 // Reset the transfer information or error if transfer is already in progress
@@ -633,6 +1048,7 @@ static void transfer_reset_file_info()
         file_transfer_state.file_size = 0;
     }else{
           file_transfer_state = default_transfer_state;
+          ooo_pool_reset();
           abort_remount();
     }
 
@@ -680,6 +1096,7 @@ static void transfer_stream_open(stream_type_t stream, uint32_t start_sector)
     }
 
     // Open stream
+    transfer_perf_start();
     status = stream_open(stream);
     vfs_mngr_printf("    stream_open stream=%i ret %i\r\n", stream, status);
 
@@ -714,6 +1131,7 @@ static void transfer_stream_data(uint32_t sector, const uint8_t *data, uint32_t
         // Override status so ERROR_SUCCESS_DONE
         // does not get passed into transfer_update_state
         status = stream_close();
+        transfer_perf_stop();
         vfs_mngr_printf("    stream_close ret=%i\r\n", status);
         file_transfer_state.stream_open = false;
         file_transfer_state.stream_finished = true;
@@ -830,8 +1248,17 @@ static void transfer_update_state(error_t status)
             }
         }
 
+        // Also when the stream did not finish, like on an error
+        transfer_perf_stop();
+
         // Set the fail reason
         fail_reason = local_status;
+        if (transfer_started) {
+            transfer_stats.transfers++;
+            if (ERROR_SUCCESS == local_status) {
+                transfer_stats.transfers_ok++;
+            }
+        }
         vfs_mngr_printf("    Transfer finished, status: %i=%s\r\n", fail_reason, error_get_string(fail_reason));
     }
 
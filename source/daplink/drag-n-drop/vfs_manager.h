@@ -25,6 +25,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "cmsis_os2.h"
 #include "virtual_fs.h"
 #include "error.h"
 
@@ -32,6 +33,17 @@
 extern "C" {
 #endif
 
+// Thread flag of the thread set with vfs_mngr_set_thread()
+#define VFS_MNGR_FLAG_PROCESS   (1 << 0)
+
+// Drag-n-drop transfer statistics since power up
+typedef struct {
+    uint32_t transfers;         // Number of finished transfers
+    uint32_t transfers_ok;      // Transfers that finished without an error
+    uint32_t ooo_sectors;       // Sectors held back and programmed once in order
+    uint32_t ooo_dropped;       // Held back sectors that were pushed out of the pool
+} vfs_mngr_stats_t;
+
 /* Callable from anywhere */
 
 // Enable or disable the virtual filesystem
@@ -40,6 +52,19 @@ void vfs_mngr_fs_enable(bool enabled);
 // Remount the virtual filesystem
 void vfs_mngr_fs_remount(void);
 
+// Return the status of the last transfer or ERROR_SUCCESS
+// if none have been performed yet
+error_t vfs_mngr_get_transfer_status(void);
+
+// Return the transfer statistics
+const vfs_mngr_stats_t *vfs_mngr_get_stats(void);
+
+// Process written sectors and state changes on another thread than USB.
+// It calls vfs_mngr_process() whenever it gets VFS_MNGR_FLAG_PROCESS or the
+// timeout returned by the previous call expires.
+// Notes: Must be called before usbd_init()
+void vfs_mngr_set_thread(osThreadId_t thread);
+
 
 /* Callable only from the thread running the virtual fs */
 
@@ -48,13 +73,12 @@ void vfs_mngr_fs_remount(void);
 // Notes: Must only be called from the thread runnning USB
 void vfs_mngr_init(bool enabled);
 
-// Run the vfs manager state machine
-// Notes: Must only be called from the thread runnning USB
-void vfs_mngr_periodic(uint32_t elapsed_ms);
-
-// Return the status of the last transfer or ERROR_SUCCESS
-// if none have been performed yet
-error_t vfs_mngr_get_transfer_status(void);
+// Process a written sector or run the vfs manager state machine.
+// Returns the ticks until it must be called again, 0 if there is more
+// to do right away or osWaitForever if only an event can change anything.
+// Notes: Must only be called from the thread set with vfs_mngr_set_thread(),
+// or the thread running USB if there is none
+uint32_t vfs_mngr_process(void);
 
 
 /* Use functions */
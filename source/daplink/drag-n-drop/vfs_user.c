@@ -38,6 +38,7 @@
 #include "cortex_m.h"
 #include "target_board.h"
 #include "flash_manager.h"
+#include "transfer_perf.h"
 
 //! @brief Size in bytes of the virtual disk.
 //!
@@ -70,6 +71,7 @@ typedef enum _magic_file {
     kImageCheckOffConfigFile,   //!< Disable Incompatible target image detection.
     kPageEraseActionFile,       //!< Enable page programming and sector erase for drag and drop.
     kChipEraseActionFile,       //!< Enable page programming and chip erase for drag and drop.
+    kCdcLatencyConfigFile,      //!< Set the virtual COM port latency timer, "LAT_<ms> CFG".
 } magic_file_t;
 
 //! @brief Mapping from filename string to magic file enum.
@@ -100,18 +102,23 @@ static const magic_file_info_t s_magic_file_info[] = {
         { "PAGE_OFFACT", kChipEraseActionFile       },
     };
 
+//! @brief Prefix of the latency config file, followed by the latency in ms.
+static const char cdc_latency_file_prefix[] = "LAT_";
+
 static char assert_buf[64 + 1];
 static uint16_t assert_line;
 static assert_source_t assert_source;
 static uint32_t remount_count;
 
 static uint32_t get_file_size(vfs_read_cb_t read_func);
+static bool parse_cdc_latency_file(const vfs_filename_t filename, uint8_t *latency_ms);
 
 static uint32_t read_file_mbed_htm(uint32_t sector_offset, uint8_t *data, uint32_t num_sectors);
 static uint32_t read_file_details_txt(uint32_t sector_offset, uint8_t *data, uint32_t num_sectors);
 static uint32_t read_file_fail_txt(uint32_t sector_offset, uint8_t *data, uint32_t num_sectors);
 static uint32_t read_file_assert_txt(uint32_t sector_offset, uint8_t *data, uint32_t num_sectors);
 static uint32_t read_file_need_bl_txt(uint32_t sector_offset, uint8_t *data, uint32_t num_sectors);
+static uint32_t read_file_perf_txt(uint32_t sector_offset, uint8_t *data, uint32_t num_sectors);
 
 static uint32_t update_details_txt_file(uint8_t *data, uint32_t datasize, uint32_t start);
 static void erase_target(void);
@@ -124,6 +131,7 @@ void vfs_user_build_filesystem()
 {
     uint32_t file_size;
     vfs_file_t file_handle;
+    transfer_perf_counter_t perf;
     // Setup the filesystem based on target parameters
     vfs_init(get_daplink_drive_name(), VFS_DISK_SIZE);
     // MBED.HTM
@@ -139,6 +147,12 @@ void vfs_user_build_filesystem()
         vfs_create_file("FAIL    TXT", read_file_fail_txt, 0, file_size);
     }
 
+    // PERF.TXT
+    if (transfer_perf_get(TRANSFER_PERF_PHASE_COUNT, &perf)) {
+        file_size = get_file_size(read_file_perf_txt);
+        vfs_create_file("PERF    TXT", read_file_perf_txt, 0, file_size);
+    }
+
     // ASSERT.TXT
     if (config_ram_get_assert(assert_buf, sizeof(assert_buf), &assert_line, &assert_source)) {
         file_size = get_file_size(read_file_assert_txt);
@@ -200,6 +214,7 @@ void vfs_user_file_change_handler(const vfs_filename_t filename, vfs_file_change
     else if (VFS_FILE_CREATED == change) {
         bool do_remount = true; // Almost all magic files cause a remount.
         int32_t which_magic_file = -1;
+        uint8_t cdc_latency = 0;
 
         // Let the hook examine the filename. If it returned false then look for the standard
         // magic files.
@@ -210,6 +225,9 @@ void vfs_user_file_change_handler(const vfs_filename_t filename, vfs_file_change
                     which_magic_file = s_magic_file_info[i].which;
                 }
             }
+            if ((which_magic_file == -1) && parse_cdc_latency_file(filename, &cdc_latency)) {
+                which_magic_file = kCdcLatencyConfigFile;
+            }
 
             // Check if we matched a magic filename and handle it.
             if (which_magic_file != -1) {
@@ -268,6 +286,9 @@ void vfs_user_file_change_handler(const vfs_filename_t filename, vfs_file_change
                     case kChipEraseActionFile:
                         config_ram_set_page_erase(false);
                         break;
+                    case kCdcLatencyConfigFile:
+                        config_set_cdc_latency(cdc_latency);
+                        break;
                     default:
                         util_assert(false);
                 }
@@ -315,6 +336,34 @@ static uint32_t get_file_size(vfs_read_cb_t read_func)
     return read_func(0, NULL, 0);
 }
 
+// Get the latency from a "LAT_<ms> CFG" file name, like "LAT_16  CFG"
+static bool parse_cdc_latency_file(const vfs_filename_t filename, uint8_t *latency_ms)
+{
+    uint32_t pos = sizeof(cdc_latency_file_prefix) - 1;
+    uint32_t value = 0;
+
+    if (memcmp(filename, cdc_latency_file_prefix, pos) || memcmp(&filename[8], "CFG", 3)) {
+        return false;
+    }
+
+    for (; (pos < 8) && isdigit((unsigned char)filename[pos]); pos++) {
+        value = value * 10 + (filename[pos] - '0');
+    }
+
+    // Needs a number, padded with spaces
+    if ((pos == sizeof(cdc_latency_file_prefix) - 1) || (value > UINT8_MAX)) {
+        return false;
+    }
+    for (; pos < 8; pos++) {
+        if (filename[pos] != ' ') {
+            return false;
+        }
+    }
+
+    *latency_ms = value;
+    return true;
+}
+
 #ifndef EXPANSION_BUFFER_SIZE
 #define EXPANSION_BUFFER_SIZE 128
 #endif
@@ -503,6 +552,48 @@ static uint32_t read_file_need_bl_txt(uint32_t sector_offset, uint8_t *data, uin
     return size;
 }
 
+// One line of PERF.TXT, like "Program: 1500000 us, 65536 bytes, 43690 bytes/s"
+static uint32_t perf_line_in_region(uint8_t *buf, uint32_t size, uint32_t start, uint32_t pos, transfer_perf_phase_t phase)
+{
+    transfer_perf_counter_t counter;
+    char number[11];
+    uint32_t l;
+
+    transfer_perf_get(phase, &counter);
+    l = util_write_string_in_region(buf, size, start, pos, transfer_perf_phase_name(phase));
+    l += util_write_in_region(buf, size, start, pos + l, ": ", 2);
+    l += util_write_in_region(buf, size, start, pos + l, number, util_write_uint32(number, counter.time_us));
+    l += util_write_string_in_region(buf, size, start, pos + l, " us, ");
+    l += util_write_in_region(buf, size, start, pos + l, number, util_write_uint32(number, counter.bytes));
+    l += util_write_string_in_region(buf, size, start, pos + l, " bytes, ");
+    l += util_write_in_region(buf, size, start, pos + l, number, util_write_uint32(number, counter.bytes_per_s));
+    l += util_write_string_in_region(buf, size, start, pos + l, " bytes/s\r\n");
+    return l;
+}
+
+// File callback to be used with vfs_add_file to return file contents
+static uint32_t read_file_perf_txt(uint32_t sector_offset, uint8_t *buf, uint32_t num_sectors)
+{
+    uint32_t start = sector_offset * VFS_SECTOR_SIZE;
+    uint32_t size = num_sectors * VFS_SECTOR_SIZE;
+    uint32_t pos = 0;
+    uint32_t phase;
+
+    if ((sector_offset != 0) && (buf != NULL)) {
+        return 0;
+    }
+
+    pos += util_write_string_in_region(buf, size, start, pos,
+        "# Time spent in each phase of the last transfer\r\n");
+    for (phase = 0; phase < TRANSFER_PERF_PHASE_COUNT; phase++) {
+        pos += perf_line_in_region(buf, size, start, pos, (transfer_perf_phase_t)phase);
+    }
+    // The total rate is the one of the programmed image
+    pos += perf_line_in_region(buf, size, start, pos, TRANSFER_PERF_PHASE_COUNT);
+
+    return pos;
+}
+
 #if defined(__CC_ARM)
 #define COMPILER_DESCRIPTION "armcc"
 #elif (defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050))
@@ -535,6 +626,7 @@ static uint32_t update_details_txt_file(uint8_t *buf, uint32_t size, uint32_t st
     pos += setting_in_region(buf, size, start, pos, "Overflow detection", config_get_overflow_detect());
     pos += setting_in_region(buf, size, start, pos, "Incompatible image detection", config_get_detect_incompatible_target());
     pos += setting_in_region(buf, size, start, pos, "Page erasing", config_ram_get_page_erase());
+    pos += uint32_field_in_region(buf, size, start, pos, "CDC latency (ms)", config_get_cdc_latency());
 
     // Current mode and version
 #if defined(DAPLINK_BL)
@@ -599,6 +691,11 @@ static uint32_t update_details_txt_file(uint8_t *buf, uint32_t size, uint32_t st
     // Number of remounts that have occurred
     pos += uint32_field_in_region(buf, size, start, pos, "Remount count", remount_count);
 
+    // Share of transfers that succeeded and how much reordering was needed
+    pos += uint32_field_in_region(buf, size, start, pos, "Transfer count", vfs_mngr_get_stats()->transfers);
+    pos += uint32_field_in_region(buf, size, start, pos, "Transfers succeeded", vfs_mngr_get_stats()->transfers_ok);
+    pos += uint32_field_in_region(buf, size, start, pos, "Reordered sectors", vfs_mngr_get_stats()->ooo_sectors);
+
     //Target URL
     pos += expand_string_in_region(buf, size, start, pos, "URL: @R\r\n");
 
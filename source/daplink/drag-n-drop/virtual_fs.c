@@ -395,6 +395,17 @@ uint32_t vfs_get_total_size()
     return size;
 }
 
+vfs_sector_t vfs_get_free_start_sector()
+{
+    uint32_t i;
+    uint32_t size = 0;
+
+    for (i = 0; i < virtual_media_idx; i++) {
+        size += virtual_media[i].length;
+    }
+    return size / VFS_SECTOR_SIZE;
+}
+
 vfs_file_t vfs_create_file(const vfs_filename_t filename, vfs_read_cb_t read_cb, vfs_write_cb_t write_cb, uint32_t len)
 {
     uint32_t first_cluster;
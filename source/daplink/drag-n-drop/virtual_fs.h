@@ -74,6 +74,10 @@ void vfs_init(const vfs_filename_t drive_name, uint32_t disk_size);
 // Get the total size of the virtual filesystem
 uint32_t vfs_get_total_size(void);
 
+// Get the first sector after the filesystem structures and the files added
+// with vfs_create_file.  Sectors from here on only hold data written by the host.
+vfs_sector_t vfs_get_free_start_sector(void);
+
 // Add a file to the virtual FS and return a handle to this file.
 // This must be called before vfs_read or vfs_write are called.
 // Adding a new file after vfs_read or vfs_write have been called results in undefined behavior.
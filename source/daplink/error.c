@@ -124,6 +124,21 @@ static const char *const error_message[] = {
     "",
     // ERROR_BL_UPDT_BAD_CRC
     "The bootloader CRC did not pass.",
+    // ERROR_DLZ_CKSUM
+    "The compressed image cannot be decoded. Checksum calculation failure occurred.",
+    // ERROR_DLZ_PARSER
+    "The compressed image cannot be decoded. Parser logic failure occurred.",
+    // ERROR_UF2_PARSER
+    "The UF2 file cannot be decoded. Parser logic failure occurred.",
+    // ERROR_UF2_FAMILY
+    "The UF2 file does not contain an image for this target family.",
+    // ERROR_ELF_PARSER
+    "The ELF file cannot be decoded. Parser logic failure occurred.",
+
+    /* Flash manager errors */
+
+    // ERROR_OOO_FLASH
+    "The file was sent in too scattered an order to program it without erasing or programming data twice.",
 
 };
 
@@ -230,6 +245,24 @@ static error_type_t error_type[] = {
     ERROR_TYPE_INTERFACE,
     // ERROR_BL_UPDT_BAD_CRC
     ERROR_TYPE_INTERFACE,
+
+    /* File stream errors */
+
+    // ERROR_DLZ_CKSUM
+    ERROR_TYPE_USER | ERROR_TYPE_TRANSIENT,
+    // ERROR_DLZ_PARSER
+    ERROR_TYPE_USER | ERROR_TYPE_TRANSIENT,
+    // ERROR_UF2_PARSER
+    ERROR_TYPE_USER | ERROR_TYPE_TRANSIENT,
+    // ERROR_UF2_FAMILY
+    ERROR_TYPE_USER | ERROR_TYPE_TRANSIENT,
+    // ERROR_ELF_PARSER
+    ERROR_TYPE_USER | ERROR_TYPE_TRANSIENT,
+
+    /* Flash manager errors */
+
+    // ERROR_OOO_FLASH
+    ERROR_TYPE_TRANSIENT,
 };
 
 COMPILER_ASSERT(ERROR_COUNT == ARRAY_SIZE(error_type));
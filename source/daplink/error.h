@@ -81,6 +81,16 @@ typedef enum {
     ERROR_IAP_NO_INTERCEPT,
     ERROR_BL_UPDT_BAD_CRC,
 
+    /* File stream errors */
+    ERROR_DLZ_CKSUM,
+    ERROR_DLZ_PARSER,
+    ERROR_UF2_PARSER,
+    ERROR_UF2_FAMILY,
+    ERROR_ELF_PARSER,
+
+    /* Flash manager errors */
+    ERROR_OOO_FLASH,
+
     // Add new values here
 
     ERROR_COUNT
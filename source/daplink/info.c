@@ -301,6 +301,18 @@ void info_crc_compute()
     }
 }
 
+void info_crc_set(uint32_t region_start, uint32_t crc)
+{
+    if ((DAPLINK_ROM_BL_SIZE > 0) && (DAPLINK_ROM_BL_START == region_start)) {
+        crc_bootloader = crc;
+    } else if ((DAPLINK_ROM_IF_SIZE > 0) && (DAPLINK_ROM_IF_START == region_start)) {
+        crc_interface = crc;
+    } else {
+        // Unknown region, fall back to reading everything back
+        info_crc_compute();
+    }
+}
+
 // Get version info as an integer
 uint32_t info_get_bootloader_version(void)
 {
@@ -32,6 +32,8 @@ extern "C" {
 void info_init(void);
 void info_set_uuid_target(uint32_t *uuid_data);
 void info_crc_compute(void);
+// Set the CRC of the image starting at region_start after it was programmed
+void info_crc_set(uint32_t region_start, uint32_t crc);
 
 
 // Get the 48 digit unique ID as a null terminated string.
@@ -39,6 +39,8 @@
 #include "sdk.h"
 #include "target_family.h"
 #include "target_board.h"
+#include "swd_sched.h"
+#include "itm_bridge.h"
 
 #ifdef DRAG_N_DROP_SUPPORT
 #include "vfs_manager.h"
@@ -77,11 +79,15 @@ void __libc_init_array (void) {}
 #define FLAGS_MAIN_POWERDOWN    (1 << 4)
 #define FLAGS_MAIN_DISABLEDEBUG (1 << 5)
 #define FLAGS_MAIN_PROC_USB     (1 << 9)
-// Used by cdc when an event occurs
+// Used by cdc when an event occurs, without a cdc task
 #define FLAGS_MAIN_CDC_EVENT    (1 << 11)
 // Used by msd when flashing a new binary
 #define FLAGS_LED_BLINK_30MS    (1 << 6)
 
+// Event flags for cdc task
+// Used by cdc when an event occurs
+#define FLAGS_CDC_EVENT         (1 << 0)
+
 // Timing constants (in 90mS ticks)
 // Delay before a USB device connect may occur (~1 sec)
 #define USB_CONNECT_DELAY       (11)
@@ -128,6 +134,44 @@ static const osTimerAttr_t k_timer_30ms_attr = {
         .cb_mem = s_timer_30ms_cb,
         .cb_size = sizeof(s_timer_30ms_cb),
     };
+
+#if SPLIT_MAIN_TASK
+static uint32_t s_cdc_thread_cb[WORDS(sizeof(osRtxThread_t))];
+#ifdef DRAG_N_DROP_SUPPORT
+static uint32_t s_vfs_thread_cb[WORDS(sizeof(osRtxThread_t))];
+#endif
+#endif
+#endif
+
+#if SPLIT_MAIN_TASK
+// Reference to the cdc task, bridging the virtual COM port
+static osThreadId_t cdc_task_id;
+static uint64_t s_cdc_task_stack[CDC_TASK_STACK / sizeof(uint64_t)];
+static const osThreadAttr_t k_cdc_thread_attr = {
+        .name = "cdc",
+#ifndef USE_LEGACY_CMSIS_RTOS
+        .cb_mem = s_cdc_thread_cb,
+        .cb_size = sizeof(s_cdc_thread_cb),
+#endif
+        .stack_mem = s_cdc_task_stack,
+        .stack_size = sizeof(s_cdc_task_stack),
+        .priority = CDC_TASK_PRIORITY,
+    };
+
+#ifdef DRAG_N_DROP_SUPPORT
+// The vfs task programs the drag-n-drop files
+static uint64_t s_vfs_task_stack[VFS_TASK_STACK / sizeof(uint64_t)];
+static const osThreadAttr_t k_vfs_thread_attr = {
+        .name = "vfs",
+#ifndef USE_LEGACY_CMSIS_RTOS
+        .cb_mem = s_vfs_thread_cb,
+        .cb_size = sizeof(s_vfs_thread_cb),
+#endif
+        .stack_mem = s_vfs_task_stack,
+        .stack_size = sizeof(s_vfs_task_stack),
+        .priority = VFS_TASK_PRIORITY,
+    };
+#endif
 #endif
 
 // USB busy LED state; when TRUE the LED will flash once using 30mS clock tick
@@ -245,7 +289,11 @@ void main_disable_debug_event(void)
 // Start CDC processing
 void main_cdc_send_event(void)
 {
+#if SPLIT_MAIN_TASK
+    osThreadFlagsSet(cdc_task_id, FLAGS_CDC_EVENT);
+#else
     osThreadFlagsSet(main_task_id, FLAGS_MAIN_CDC_EVENT);
+#endif
     return;
 }
 
@@ -261,6 +309,35 @@ void USBD_SignalHandler()
 
 extern void cdc_process_event(void);
 
+#if SPLIT_MAIN_TASK
+static void cdc_task(void * arg)
+{
+    while (1) {
+        osThreadFlagsWait(FLAGS_CDC_EVENT, osFlagsWaitAny, osWaitForever);
+        cdc_process_event();
+    }
+}
+
+#ifdef DRAG_N_DROP_SUPPORT
+static void vfs_task(void * arg)
+{
+    uint32_t timeout = osWaitForever;
+
+    while (1) {
+        if (timeout) {
+            osThreadFlagsWait(VFS_MNGR_FLAG_PROCESS, osFlagsWaitAny, timeout);
+        }
+
+        // Only held for one sector or state change, so CMSIS-DAP commands
+        // get the link in between
+        swd_sched_lock();
+        timeout = vfs_mngr_process();
+        swd_sched_unlock();
+    }
+}
+#endif
+#endif
+
 void main_task(void * arg)
 {
     // State processing
@@ -278,6 +355,9 @@ void main_task(void * arg)
 
     // Initialize settings - required for asserts to work
     config_init();
+    // The link and the SWO trace are shared by the tasks started below
+    swd_sched_init();
+    itm_bridge_init();
 
 #ifdef USE_LEGACY_CMSIS_RTOS
     // Get a reference to this task
@@ -321,6 +401,13 @@ void main_task(void * arg)
     info_init();
     // Update bootloader if it is out of date
     bootloader_check_and_update();
+#if SPLIT_MAIN_TASK
+    // CDC bridging and drag-n-drop programming run next to USB
+    cdc_task_id = osThreadNew(cdc_task, NULL, &k_cdc_thread_attr);
+#ifdef DRAG_N_DROP_SUPPORT
+    vfs_mngr_set_thread(osThreadNew(vfs_task, NULL, &k_vfs_thread_attr));
+#endif
+#endif
     // USB
     usbd_init();
 #ifdef DRAG_N_DROP_SUPPORT
@@ -355,6 +442,10 @@ void main_task(void * arg)
                 osDelay(1);
             }
             USBD_Handler();
+#ifdef DRAG_N_DROP_SUPPORT
+            // Mass storage packets held back while the vfs task caught up
+            USBD_MSC_Resume();
+#endif
         }
 
         if (flags & FLAGS_MAIN_RESET) {
@@ -384,15 +475,15 @@ void main_task(void * arg)
         if (flags & FLAGS_MAIN_CDC_EVENT) {
             cdc_process_event();
         }
-        
+
         if (flags & FLAGS_BOARD_EVENT) {
             board_custom_event();
         }
 
         if (flags & FLAGS_MAIN_90MS) {
-            // Update USB busy status
-#ifdef DRAG_N_DROP_SUPPORT
-            vfs_mngr_periodic(90); // FLAGS_MAIN_90MS
+#if !SPLIT_MAIN_TASK && defined(DRAG_N_DROP_SUPPORT)
+            // Poll the vfs state machine
+            vfs_mngr_process();
 #endif
             // Update USB connect status
             switch (usb_state) {
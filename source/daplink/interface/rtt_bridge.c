@@ -0,0 +1,438 @@
+/**
+ * @file    rtt_bridge.c
+ * @brief   Bridge a target SEGGER RTT channel to the virtual COM port
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "cmsis_os2.h"
+#include "DAP_config.h"
+#include "DAP.h"
+#include "swd_host.h"
+#include "swd_sched.h"
+#include "target_config.h"
+#include "target_board.h"
+#include "util.h"
+#include "circ_buf.h"
+#include "rtt_bridge.h"
+
+// Layout of the target's SEGGER_RTT_CB, all fields are 32-bit words
+#define RTT_ID_SIZE             16
+#define RTT_CB_HEADER_SIZE      (RTT_ID_SIZE + 8)   // acID, MaxNumUpBuffers, MaxNumDownBuffers
+#define RTT_BUF_DESC_SIZE       24                  // sName, pBuffer, SizeOfBuffer, WrOff, RdOff, Flags
+#define RTT_DESC_BUFFER         1
+#define RTT_DESC_SIZE           2
+#define RTT_DESC_WROFF          3
+#define RTT_DESC_RDOFF          4
+
+// Sanity limits used to reject stale or corrupted control blocks
+#define RTT_MAX_NUM_BUFFERS     16
+
+// Scan chunk size, must be a multiple of 4
+#define RTT_SCAN_CHUNK_SIZE     256
+
+// Chunks scanned per poll, keeps the link free for the host debugger
+#define RTT_SCAN_CHUNKS_PER_POLL    4
+
+// Polling intervals in ms
+#define RTT_POLL_INTERVAL       10
+#define RTT_RETRY_INTERVAL      1000
+
+static const char rtt_id[RTT_ID_SIZE] = "SEGGER RTT";
+
+// Set by rtt_bridge_enable() on any thread, applied by the thread that
+// polls the bridge once request_count changes
+static volatile bool enable_requested = false;
+static volatile uint32_t request_count = 0;
+static uint32_t applied_count = 0;
+
+static bool enabled = false;
+static bool attached = false;
+// Disabled, the link may still be up
+static bool release_pending = false;
+static uint32_t cb_addr = 0;
+static uint32_t up_desc_addr;
+static uint32_t down_desc_addr;
+static uint32_t next_poll;
+
+// Host to target data waiting for room in the down buffer
+static circ_buf_t down_buf;
+static uint8_t down_data[64];
+
+// Scan buffer, with room for an ID straddling two chunks
+static uint8_t scan_buf[RTT_SCAN_CHUNK_SIZE + RTT_ID_SIZE];
+
+// Scan position, a scan takes several polls
+static uint32_t scan_region = 0;
+static uint32_t scan_addr = 0;
+static uint32_t scan_carry = 0;
+
+static uint32_t ms_to_ticks(uint32_t ms)
+{
+    uint32_t ticks = ms * osKernelGetTickFreq() / 1000;
+    return ticks ? ticks : 1;
+}
+
+static void schedule_poll(uint32_t ms)
+{
+    next_poll = osKernelGetTickCount() + ms_to_ticks(ms);
+}
+
+static bool poll_due(void)
+{
+    return (int32_t)(osKernelGetTickCount() - next_poll) >= 0;
+}
+
+// While the host debugger owns the port the link is already up, and must
+// stay that way
+static bool host_owns_port(void)
+{
+    return DAP_Data.debug_port != DAP_PORT_DISABLED;
+}
+
+// Only called in a background group, so no other user is on the link
+static void release_link(void)
+{
+    if (!host_owns_port()) {
+        swd_off();
+    }
+}
+
+static bool cb_valid(uint32_t addr)
+{
+    uint32_t header[RTT_CB_HEADER_SIZE / 4];
+
+    if (!swd_read_memory(addr, (uint8_t *)header, sizeof(header))) {
+        return false;
+    }
+    if (memcmp(header, rtt_id, RTT_ID_SIZE) != 0) {
+        return false;
+    }
+    if ((header[4] == 0) || (header[4] > RTT_MAX_NUM_BUFFERS) ||
+        (header[5] == 0) || (header[5] > RTT_MAX_NUM_BUFFERS)) {
+        return false;
+    }
+
+    up_desc_addr = addr + RTT_CB_HEADER_SIZE;
+    down_desc_addr = up_desc_addr + header[4] * RTT_BUF_DESC_SIZE;
+    return true;
+}
+
+static void scan_restart(void)
+{
+    scan_region = 0;
+    scan_addr = 0;
+    scan_carry = 0;
+}
+
+static bool scan_done(void)
+{
+    return scan_region >= MAX_REGIONS;
+}
+
+static void scan_next_region(void)
+{
+    scan_region++;
+    scan_addr = 0;
+    scan_carry = 0;
+}
+
+// Scan the next chunk of target RAM for the control block
+static bool scan_chunk(void)
+{
+    region_info_t *region;
+    uint32_t size = 0;
+    uint32_t i;
+
+    for (; !scan_done(); scan_next_region()) {
+        region = &g_board_info.target_cfg->ram_regions[scan_region];
+        scan_addr = MAX(scan_addr, ROUND_UP(region->start, 4));
+        if (scan_addr < region->end) {
+            size = MIN(RTT_SCAN_CHUNK_SIZE, region->end - scan_addr) & ~3UL;
+        }
+        if (size) {
+            break;
+        }
+    }
+    if (scan_done()) {
+        return false;
+    }
+
+    if (!swd_read_memory(scan_addr, &scan_buf[scan_carry], size)) {
+        scan_next_region();
+        return false;
+    }
+    for (i = 0; i + RTT_ID_SIZE <= scan_carry + size; i += 4) {
+        if ((0 == memcmp(&scan_buf[i], rtt_id, RTT_ID_SIZE)) &&
+                cb_valid(scan_addr - scan_carry + i)) {
+            cb_addr = scan_addr - scan_carry + i;
+            return true;
+        }
+    }
+    // Keep the tail so an ID crossing the chunk boundary is found
+    scan_carry = scan_carry + size - i;
+    memmove(scan_buf, &scan_buf[i], scan_carry);
+    scan_addr += size;
+    return false;
+}
+
+// Look for the control block. A scan of the RAM regions is spread over
+// several calls, check scan_done() when nothing is found.
+static bool find_cb(void)
+{
+    uint32_t i;
+
+    // Fast path: the control block usually stays put across target resets
+    if (cb_addr) {
+        if (cb_valid(cb_addr)) {
+            return true;
+        }
+        cb_addr = 0;
+        scan_restart();
+    }
+
+    if (!g_board_info.target_cfg) {
+        scan_region = MAX_REGIONS;
+        return false;
+    }
+    for (i = 0; (i < RTT_SCAN_CHUNKS_PER_POLL) && !scan_done(); i++) {
+        if (scan_chunk()) {
+            scan_restart();
+            return true;
+        }
+    }
+    return false;
+}
+
+static void detach(void)
+{
+    attached = false;
+    release_link();
+    schedule_poll(RTT_RETRY_INTERVAL);
+}
+
+static bool attach(void)
+{
+    if (attached) {
+        return true;
+    }
+
+    // Power up the debug port without halting or resetting the core
+    if (!host_owns_port() && !swd_connect_debug()) {
+        detach();
+        return false;
+    }
+    if (!find_cb()) {
+        if (scan_done()) {
+            scan_restart();
+            detach();
+        } else {
+            // Go on with the scan on the next poll
+            release_link();
+            schedule_poll(RTT_POLL_INTERVAL);
+        }
+        return false;
+    }
+    attached = true;
+    return true;
+}
+
+// Move pending host data into the target's down buffer 0
+static bool flush_down(void)
+{
+    uint32_t desc[RTT_BUF_DESC_SIZE / 4];
+    const uint8_t *data;
+    uint32_t rd;
+    uint32_t wr;
+    uint32_t n;
+
+    data = circ_buf_peek(&down_buf, &n);
+    if (0 == n) {
+        return true;
+    }
+
+    if (!swd_read_memory(down_desc_addr, (uint8_t *)desc, sizeof(desc))) {
+        return false;
+    }
+
+    rd = desc[RTT_DESC_RDOFF];
+    wr = desc[RTT_DESC_WROFF];
+    if ((rd >= desc[RTT_DESC_SIZE]) || (wr >= desc[RTT_DESC_SIZE])) {
+        return false;
+    }
+
+    // Contiguous free space, one slot is kept empty to tell full from empty
+    if (rd > wr) {
+        n = MIN(n, rd - wr - 1);
+    } else {
+        n = MIN(n, desc[RTT_DESC_SIZE] - wr - ((rd == 0) ? 1 : 0));
+    }
+    if (0 == n) {
+        return true;
+    }
+
+    if (!swd_write_memory(desc[RTT_DESC_BUFFER] + wr, (uint8_t *)data, n)) {
+        return false;
+    }
+
+    wr += n;
+    if (wr == desc[RTT_DESC_SIZE]) {
+        wr = 0;
+    }
+    if (!swd_write_word(down_desc_addr + RTT_DESC_WROFF * 4, wr)) {
+        return false;
+    }
+
+    circ_buf_pop_n(&down_buf, n);
+    return true;
+}
+
+void rtt_bridge_enable(bool enable)
+{
+    enable_requested = enable;
+    request_count++;
+}
+
+static void apply_request(void)
+{
+    uint32_t count = request_count;
+    bool enable;
+
+    if (count == applied_count) {
+        return;
+    }
+    applied_count = count;
+    enable = enable_requested;
+
+    // The link is given back by rtt_bridge_read() in a background group
+    if (enabled && !enable) {
+        release_pending = true;
+    } else if (enable) {
+        release_pending = false;
+    }
+    enabled = enable;
+    attached = false;
+    scan_restart();
+    circ_buf_init(&down_buf, down_data, sizeof(down_data));
+    next_poll = osKernelGetTickCount();
+}
+
+bool rtt_bridge_is_enabled(void)
+{
+    apply_request();
+    return enabled || release_pending;
+}
+
+static uint32_t poll_target(uint8_t *buf, uint32_t size)
+{
+    uint32_t desc[RTT_BUF_DESC_SIZE / 4];
+    uint32_t rd;
+    uint32_t wr;
+    uint32_t n;
+
+    if (!attach()) {
+        return 0;
+    }
+
+    if (!flush_down() ||
+            !swd_read_memory(up_desc_addr, (uint8_t *)desc, sizeof(desc))) {
+        detach();
+        return 0;
+    }
+
+    rd = desc[RTT_DESC_RDOFF];
+    wr = desc[RTT_DESC_WROFF];
+    if ((rd >= desc[RTT_DESC_SIZE]) || (wr >= desc[RTT_DESC_SIZE])) {
+        // Control block was overwritten, look for it again
+        detach();
+        return 0;
+    }
+    if (rd == wr) {
+        schedule_poll(RTT_POLL_INTERVAL);
+        return 0;
+    }
+
+    // Only the contiguous part, the wrapped part is read on the next call
+    n = (wr > rd) ? (wr - rd) : (desc[RTT_DESC_SIZE] - rd);
+    n = MIN(n, size);
+    if (!swd_read_memory(desc[RTT_DESC_BUFFER] + rd, buf, n)) {
+        detach();
+        return 0;
+    }
+
+    rd += n;
+    if (rd == desc[RTT_DESC_SIZE]) {
+        rd = 0;
+    }
+    if (!swd_write_word(up_desc_addr + RTT_DESC_RDOFF * 4, rd)) {
+        detach();
+        return 0;
+    }
+
+    return n;
+}
+
+uint32_t rtt_bridge_read(uint8_t *buf, uint32_t size)
+{
+    uint32_t n;
+
+    apply_request();
+    if (release_pending) {
+        // Left up for the host debugger, or released once nobody else
+        // uses the link
+        if (host_owns_port()) {
+            release_pending = false;
+        } else if (swd_sched_begin(SWD_SCHED_BACKGROUND)) {
+            release_link();
+            release_pending = false;
+            swd_sched_end(SWD_SCHED_BACKGROUND);
+        }
+    }
+
+    if (!enabled || !poll_due()) {
+        return 0;
+    }
+
+    // Only take the link in the gaps left by the host debugger and
+    // drag-and-drop. Attach again afterwards, drag-and-drop resets the
+    // target and turns the link off.
+    if (!swd_sched_begin(SWD_SCHED_BACKGROUND)) {
+        attached = false;
+        return 0;
+    }
+    n = poll_target(buf, size);
+    swd_sched_end(SWD_SCHED_BACKGROUND);
+
+    return n;
+}
+
+uint32_t rtt_bridge_write_free(void)
+{
+    apply_request();
+    return enabled ? circ_buf_count_free(&down_buf) : 0;
+}
+
+uint32_t rtt_bridge_write(const uint8_t *buf, uint32_t size)
+{
+    apply_request();
+    if (!enabled) {
+        return 0;
+    }
+    return circ_buf_write(&down_buf, buf, size);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file    rtt_bridge.h
+ * @brief   Bridge a target SEGGER RTT channel to the virtual COM port
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RTT_BRIDGE_H
+#define RTT_BRIDGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @brief Enable or disable the RTT bridge.
+//!
+//! While enabled, the virtual COM port is connected to RTT channel 0 of the
+//! target instead of the target UART. The control block is located lazily by
+//! scanning the target RAM regions.
+//!
+//! May be called from any thread. The change is applied by the next call of
+//! the other functions, which must all come from the same thread.
+void rtt_bridge_enable(bool enable);
+
+//! @brief Check whether the RTT bridge is enabled.
+//!
+//! Stays true after the bridge is disabled until rtt_bridge_read() has
+//! given back the SWD link.
+bool rtt_bridge_is_enabled(void);
+
+//! @brief Poll the target and read data from its up buffer 0.
+//!
+//! Pending data queued with rtt_bridge_write() is moved to the target's
+//! down buffer 0 as part of the same poll.
+//!
+//! @return Number of bytes written to @a buf.
+uint32_t rtt_bridge_read(uint8_t *buf, uint32_t size);
+
+//! @brief Space left for data queued with rtt_bridge_write().
+uint32_t rtt_bridge_write_free(void);
+
+//! @brief Queue data for the target's down buffer 0.
+//! @return Number of bytes queued.
+uint32_t rtt_bridge_write(const uint8_t *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -46,6 +46,14 @@
 #define MAX_SWD_RETRY 100//10
 #define MAX_TIMEOUT   1000000  // Timeout for syscalls on target
 
+// DPs of a multi-drop bus whose state is kept while another one is selected
+#ifndef SWD_MULTIDROP_DP_COUNT
+#define SWD_MULTIDROP_DP_COUNT 4
+#endif
+
+// Write of the DPv2 TARGETSEL register, address 0xC
+#define SWD_TARGETSEL_REQUEST 0x99
+
 // Use the CMSIS-Core definition if available.
 #if !defined(SCB_AIRCR_PRIGROUP_Pos)
 #define SCB_AIRCR_PRIGROUP_Pos              8U                                            /*!< SCB AIRCR: PRIGROUP Position */
@@ -62,11 +70,23 @@ typedef struct {
     uint32_t xpsr;
 } DEBUG_STATE;
 
+typedef struct {
+    uint32_t target_sel;        // TARGETSEL of the DP, 0 if the entry is free
+    DAP_STATE state;
+    uint8_t powered;            // Connected by swd_connect_debug()
+} DP_CACHE;
+
 static SWD_CONNECT_TYPE reset_connect = CONNECT_NORMAL;
 
 static DAP_STATE dap_state;
 static uint32_t  soft_reset = SYSRESETREQ;
 
+// DP on the wire, 0 when there is a single DP without TARGETSEL
+static uint32_t target_sel = 0;
+static uint8_t  target_selected = 1;
+static DP_CACHE dp_cache[SWD_MULTIDROP_DP_COUNT];
+static uint8_t  dp_cache_next = 0;
+
 static uint32_t swd_get_apsel(uint32_t adr)
 {
     uint32_t apsel = target_get_apsel();
@@ -106,6 +126,51 @@ uint8_t swd_transfer_retry(uint32_t req, uint32_t *data)
     return ack;
 }
 
+void swd_invalidate_dap_state(void)
+{
+    uint32_t i;
+
+    dap_state.select = 0xffffffff;
+    dap_state.csw = 0xffffffff;
+
+    for (i = 0; i < SWD_MULTIDROP_DP_COUNT; i++) {
+        dp_cache[i].state.select = 0xffffffff;
+        dp_cache[i].state.csw = 0xffffffff;
+    }
+
+    // Someone else may have selected another DP of the bus
+    if (target_sel != 0) {
+        target_selected = 0;
+    }
+}
+
+// Cache entry of a DP, a new entry replaces the oldest one if add is set
+static DP_CACHE *dp_cache_get(uint32_t sel, uint8_t add)
+{
+    DP_CACHE *entry;
+    uint32_t i;
+
+    if (sel == 0) {
+        return NULL;
+    }
+
+    for (i = 0; i < SWD_MULTIDROP_DP_COUNT; i++) {
+        if (dp_cache[i].target_sel == sel) {
+            return &dp_cache[i];
+        }
+    }
+
+    if (!add) {
+        return NULL;
+    }
+
+    entry = &dp_cache[dp_cache_next];
+    dp_cache_next = (dp_cache_next + 1) % SWD_MULTIDROP_DP_COUNT;
+    entry->target_sel = sel;
+    entry->powered = 0;
+    return entry;
+}
+
 void swd_set_soft_reset(uint32_t soft_reset_type)
 {
     soft_reset = soft_reset_type;
@@ -688,10 +753,10 @@ static uint8_t swd_wait_until_halted(void)
     return 0;
 }
 
-uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, flash_algo_return_t return_type)
+uint8_t swd_flash_syscall_start(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4)
 {
     DEBUG_STATE state = {{0}, 0};
-    // Call flash algorithm function on target and wait for result.
+    // Call flash algorithm function on target without waiting for it.
     state.r[0]     = arg1;                   // R0: Argument 1
     state.r[1]     = arg2;                   // R1: Argument 2
     state.r[2]     = arg3;                   // R2: Argument 3
@@ -702,15 +767,29 @@ uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t e
     state.r[15]    = entry;                        // PC: Entry Point
     state.xpsr     = 0x01000000;          // xPSR: T = 1, ISR = 0
 
-    if (!swd_write_debug_state(&state)) {
+    return swd_write_debug_state(&state);
+}
+
+uint8_t swd_flash_syscall_halted(void)
+{
+    uint32_t val;
+
+    if (!swd_read_word(DBG_HCSR, &val)) {
         return 0;
     }
 
+    return (val & S_HALT) ? 1 : 0;
+}
+
+uint8_t swd_flash_syscall_result(uint32_t arg1, uint32_t arg2, flash_algo_return_t return_type)
+{
+    uint32_t r0;
+
     if (!swd_wait_until_halted()) {
         return 0;
     }
 
-    if (!swd_read_core_register(0, &state.r[0])) {
+    if (!swd_read_core_register(0, &r0)) {
         return 0;
     }
 
@@ -721,13 +800,13 @@ uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t e
 
     if ( return_type == FLASHALGO_RETURN_POINTER ) {
         // Flash verify functions return pointer to byte following the buffer if successful.
-        if (state.r[0] != (arg1 + arg2)) {
+        if (r0 != (arg1 + arg2)) {
             return 0;
         }
     }
     else {
         // Flash functions return 0 if successful.
-        if (state.r[0] != 0) {
+        if (r0 != 0) {
             return 0;
         }
     }
@@ -735,6 +814,16 @@ uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t e
     return 1;
 }
 
+uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, flash_algo_return_t return_type)
+{
+    // Call flash algorithm function on target and wait for result.
+    if (!swd_flash_syscall_start(sysCallParam, entry, arg1, arg2, arg3, arg4)) {
+        return 0;
+    }
+
+    return swd_flash_syscall_result(arg1, arg2, return_type);
+}
+
 // SWD Reset
 static uint8_t swd_reset(void)
 {
@@ -775,6 +864,49 @@ static uint8_t swd_read_idcode(uint32_t *id)
     return 1;
 }
 
+// Wake up dormant DPs in SWD: selection alert and SWD activation code
+static uint8_t swd_dormant_to_swd(void)
+{
+    static const uint8_t alert[] = {
+        0xFF,
+        0x92, 0xF3, 0x09, 0x62, 0x95, 0x2D, 0x85, 0x86,
+        0xE9, 0xAF, 0xDD, 0xE3, 0xA2, 0x0E, 0xBC, 0x19,
+        0xA0, 0x01,     // 4 cycles low, activation code 0x1A
+    };
+
+    SWJ_Sequence(8 + 128 + 12, alert);
+    return 1;
+}
+
+// SWD TARGETSEL write. Right after a line reset no DP is selected, so none
+// drives the ACK and the write is sent as sequences.
+static uint8_t swd_write_targetsel(uint32_t val)
+{
+    uint8_t tmp_in[5];
+    uint8_t tmp_out[1];
+    uint32_t parity;
+
+    tmp_in[0] = 0x00;
+    SWJ_Sequence(8, tmp_in);
+    tmp_in[0] = SWD_TARGETSEL_REQUEST;
+    SWJ_Sequence(8, tmp_in);
+
+    // Turnaround, ACK and turnaround
+    PIN_SWDIO_OUT_DISABLE();
+    SWD_Sequence(SWD_SEQUENCE_DIN | (2 * DAP_Data.swd_conf.turnaround + 3), NULL, tmp_out);
+    PIN_SWDIO_OUT_ENABLE();
+
+    parity = val ^ (val >> 16);
+    parity ^= parity >> 8;
+    parity ^= parity >> 4;
+    parity ^= parity >> 2;
+    parity ^= parity >> 1;
+    int2array(tmp_in, val, 4);
+    tmp_in[4] = parity & 1;
+    SWJ_Sequence(33, tmp_in);
+    return 1;
+}
+
 
 uint8_t JTAG2SWD()
 {
@@ -792,15 +924,75 @@ uint8_t JTAG2SWD()
         return 0;
     }
 
+    if (target_sel != 0) {
+        // Multi-drop DPs may be dormant. Send all of them to dormant state
+        // and wake them up, then select ours.
+        if (!swd_switch(0xE3BC)) {
+            return 0;
+        }
+
+        if (!swd_dormant_to_swd()) {
+            return 0;
+        }
+
+        if (!swd_reset()) {
+            return 0;
+        }
+
+        if (!swd_write_targetsel(target_sel)) {
+            return 0;
+        }
+    }
+
     if (!swd_read_idcode(&tmp)) {
         return 0;
     }
 
+    target_selected = 1;
     return 1;
 }
 
-uint8_t swd_init_debug(void)
+uint8_t swd_select_target(uint32_t sel)
+{
+    DP_CACHE *entry;
+    uint32_t tmp = 0;
+
+    if ((sel == target_sel) && target_selected) {
+        return 1;
+    }
+
+    // Keep the state of the DP we leave
+    entry = dp_cache_get(target_sel, 0);
+    if (entry) {
+        entry->state = dap_state;
+    }
+
+    target_sel = sel;
+    target_selected = 0;
+    entry = dp_cache_get(sel, 0);
+
+    // A DP connected before only needs to be selected again. Its SELECT is
+    // written again, the AP registers are as it was left.
+    if (entry && entry->powered) {
+        dap_state.select = 0xffffffff;
+        dap_state.csw = entry->state.csw;
+
+        if (swd_reset() && swd_write_targetsel(sel) && swd_read_idcode(&tmp) &&
+                swd_clear_errors() && swd_write_dp(DP_SELECT, 0) && swd_read_dp(DP_CTRL_STAT, &tmp) &&
+                ((tmp & (CDBGPWRUPACK | CSYSPWRUPACK)) == (CDBGPWRUPACK | CSYSPWRUPACK))) {
+            target_selected = 1;
+            return 1;
+        }
+
+        entry->powered = 0;
+    }
+
+    return swd_init_debug();
+}
+
+uint8_t swd_connect_debug(void)
 {
+    DP_CACHE *entry;
     uint32_t tmp = 0;
     int i = 0;
     int timeout = 100;
@@ -808,6 +1000,70 @@ uint8_t swd_init_debug(void)
     dap_state.select = 0xffffffff;
     dap_state.csw = 0xffffffff;
 
+    swd_init();
+    // call a target dependant function
+    // this function can do several stuff before really
+    // initing the debug
+    if (g_target_family && g_target_family->target_before_init_debug) {
+        g_target_family->target_before_init_debug();
+    }
+
+    if (!JTAG2SWD()) {
+        return 0;
+    }
+
+    if (!swd_clear_errors()) {
+        return 0;
+    }
+
+    if (!swd_write_dp(DP_SELECT, 0)) {
+        return 0;
+    }
+
+    // Power up
+    if (!swd_write_dp(DP_CTRL_STAT, CSYSPWRUPREQ | CDBGPWRUPREQ)) {
+        return 0;
+    }
+
+    for (i = 0; i < timeout; i++) {
+        if (!swd_read_dp(DP_CTRL_STAT, &tmp)) {
+            return 0;
+        }
+        if ((tmp & (CDBGPWRUPACK | CSYSPWRUPACK)) == (CDBGPWRUPACK | CSYSPWRUPACK)) {
+            // Break from loop if powerup is complete
+            break;
+        }
+    }
+    if (i == timeout) {
+        // Unable to powerup DP
+        return 0;
+    }
+
+    if (!swd_write_dp(DP_CTRL_STAT, CSYSPWRUPREQ | CDBGPWRUPREQ | TRNNORMAL | MASKLANE)) {
+        return 0;
+    }
+
+    // call a target dependant function:
+    // some target can enter in a lock state
+    // this function can unlock these targets
+    if (g_target_family && g_target_family->target_unlock_sequence) {
+        g_target_family->target_unlock_sequence();
+    }
+
+    if (!swd_write_dp(DP_SELECT, 0)) {
+        return 0;
+    }
+
+    entry = dp_cache_get(target_sel, 1);
+    if (entry) {
+        entry->powered = 1;
+    }
+
+    return 1;
+}
+
+uint8_t swd_init_debug(void)
+{
     int8_t retries = 4;
     int8_t do_abort = 0;
     do {
@@ -820,70 +1076,11 @@ uint8_t swd_init_debug(void)
             osDelay(2);
             do_abort = 0;
         }
-        swd_init();
-        // call a target dependant function
-        // this function can do several stuff before really
-        // initing the debug
-        if (g_target_family && g_target_family->target_before_init_debug) {
-            g_target_family->target_before_init_debug();
-        }
-
-        if (!JTAG2SWD()) {
-            do_abort = 1;
-            continue;
-        }
 
-        if (!swd_clear_errors()) {
-            do_abort = 1;
-            continue;
-        }
-
-        if (!swd_write_dp(DP_SELECT, 0)) {
-            do_abort = 1;
-            continue;
-
-        }
-
-        // Power up
-        if (!swd_write_dp(DP_CTRL_STAT, CSYSPWRUPREQ | CDBGPWRUPREQ)) {
-            do_abort = 1;
-            continue;
-        }
-
-        for (i = 0; i < timeout; i++) {
-            if (!swd_read_dp(DP_CTRL_STAT, &tmp)) {
-                do_abort = 1;
-                break;
-            }
-            if ((tmp & (CDBGPWRUPACK | CSYSPWRUPACK)) == (CDBGPWRUPACK | CSYSPWRUPACK)) {
-                // Break from loop if powerup is complete
-                break;
-            }
-        }
-        if ((i == timeout) || (do_abort == 1)) {
-            // Unable to powerup DP
-            do_abort = 1;
-            continue;
-        }
-
-        if (!swd_write_dp(DP_CTRL_STAT, CSYSPWRUPREQ | CDBGPWRUPREQ | TRNNORMAL | MASKLANE)) {
-            do_abort = 1;
-            continue;
-        }
-
-        // call a target dependant function:
-        // some target can enter in a lock state
-        // this function can unlock these targets
-        if (g_target_family && g_target_family->target_unlock_sequence) {
-            g_target_family->target_unlock_sequence();
-        }
-
-        if (!swd_write_dp(DP_SELECT, 0)) {
-            do_abort = 1;
-            continue;
+        if (swd_connect_debug()) {
+            return 1;
         }
-
-        return 1;
+        do_abort = 1;
 
     } while (--retries > 0);
 
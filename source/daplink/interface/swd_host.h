@@ -49,6 +49,7 @@ typedef enum {
 uint8_t swd_init(void);
 uint8_t swd_off(void);
 uint8_t swd_init_debug(void);
+uint8_t swd_connect_debug(void);
 uint8_t swd_clear_errors(void);
 uint8_t swd_read_dp(uint8_t adr, uint32_t *val);
 uint8_t swd_write_dp(uint8_t adr, uint32_t val);
@@ -63,13 +64,22 @@ uint8_t swd_write_memory(uint32_t address, uint8_t *data, uint32_t size);
 uint8_t swd_read_core_register(uint32_t n, uint32_t *val);
 uint8_t swd_write_core_register(uint32_t n, uint32_t val);
 uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, flash_algo_return_t return_type);
+// swd_flash_syscall_exec() in steps, so the link is free while the algo runs
+uint8_t swd_flash_syscall_start(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4);
+uint8_t swd_flash_syscall_halted(void);
+uint8_t swd_flash_syscall_result(uint32_t arg1, uint32_t arg2, flash_algo_return_t return_type);
 uint8_t swd_set_target_state_hw(target_state_t state);
 uint8_t swd_set_target_state_sw(target_state_t state);
 uint8_t swd_transfer_retry(uint32_t req, uint32_t *data);
+// Forget the cached DP SELECT and AP CSW after someone else used the link
+void swd_invalidate_dap_state(void);
 void int2array(uint8_t *res, uint32_t data, uint8_t len);
 void swd_set_reset_connect(SWD_CONNECT_TYPE type);
 void swd_set_soft_reset(uint32_t soft_reset_type);
 uint8_t JTAG2SWD(void);
+// Select a DP of a multi-drop bus by its TARGETSEL value, 0 for a single DP
+// on the wire. A DP connected before is selected again without the power up.
+uint8_t swd_select_target(uint32_t target_sel);
 
 #ifdef __cplusplus
 }
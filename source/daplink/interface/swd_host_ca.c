@@ -109,6 +109,12 @@ uint8_t swd_transfer_retry(uint32_t req, uint32_t *data)
     return ack;
 }
 
+void swd_invalidate_dap_state(void)
+{
+    dap_state.select = 0xffffffff;
+    dap_state.csw = 0xffffffff;
+}
+
 void swd_set_soft_reset(uint32_t soft_reset_type)
 {
     soft_reset = soft_reset_type;
@@ -620,10 +626,10 @@ static uint8_t swd_wait_until_halted(void)
     return 0;
 }
 
-uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, flash_algo_return_t return_type)
+uint8_t swd_flash_syscall_start(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4)
 {
     DEBUG_STATE state = {{0}, 0};
-    // Call flash algorithm function on target and wait for result.
+    // Call flash algorithm function on target without waiting for it.
     state.r[0]     = arg1;                   // R0: Argument 1
     state.r[1]     = arg2;                   // R1: Argument 2
     state.r[2]     = arg3;                   // R2: Argument 3
@@ -634,10 +640,24 @@ uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t e
     state.r[15]    = entry;                        // PC: Entry Point
     state.xpsr     = 0x00000000;          // xPSR: T = 1, ISR = 0
 
-    if (!swd_write_debug_state(&state)) {
+    return swd_write_debug_state(&state);
+}
+
+uint8_t swd_flash_syscall_halted(void)
+{
+    uint32_t val;
+
+    if (!swd_read_word(DBGDSCR, &val)) {
         return 0;
     }
 
+    return ((val & DBGDSCR_HALTED) == DBGDSCR_HALTED) ? 1 : 0;
+}
+
+uint8_t swd_flash_syscall_result(uint32_t arg1, uint32_t arg2, flash_algo_return_t return_type)
+{
+    uint32_t r0;
+
     if (!swd_wait_until_halted()) {
         return 0;
     }
@@ -646,19 +666,19 @@ uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t e
         return 0;
     }
 
-    if (!swd_read_core_register(0, &state.r[0])) {
+    if (!swd_read_core_register(0, &r0)) {
         return 0;
     }
 
     if ( return_type == FLASHALGO_RETURN_POINTER ) {
         // Flash verify functions return pointer to byte following the buffer if successful.
-        if (state.r[0] != (arg1 + arg2)) {
+        if (r0 != (arg1 + arg2)) {
             return 0;
         }
     }
     else {
         // Flash functions return 0 if successful.
-        if (state.r[0] != 0) {
+        if (r0 != 0) {
             return 0;
         }
     }
@@ -666,6 +686,16 @@ uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t e
     return 1;
 }
 
+uint8_t swd_flash_syscall_exec(const program_syscall_t *sysCallParam, uint32_t entry, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, flash_algo_return_t return_type)
+{
+    // Call flash algorithm function on target and wait for result.
+    if (!swd_flash_syscall_start(sysCallParam, entry, arg1, arg2, arg3, arg4)) {
+        return 0;
+    }
+
+    return swd_flash_syscall_result(arg1, arg2, return_type);
+}
+
 // SWD Reset
 static uint8_t swd_reset(void)
 {
@@ -730,6 +760,12 @@ uint8_t JTAG2SWD()
     return 1;
 }
 
+uint8_t swd_select_target(uint32_t target_sel)
+{
+    // No multi-drop support on this architecture
+    return (target_sel == 0);
+}
+
 uint8_t swd_init_debug(void)
 {
     uint32_t tmp = 0;
@@ -792,6 +828,12 @@ uint8_t swd_init_debug(void)
     return 1;
 }
 
+uint8_t swd_connect_debug(void)
+{
+    // swd_init_debug() never resets the target on this architecture
+    return swd_init_debug();
+}
+
 uint8_t swd_uninit_debug(void)
 {
     return 1;
@@ -0,0 +1,225 @@
+/**
+ * @file    swd_sched.c
+ * @brief   Share the SWD link between CMSIS-DAP, drag-and-drop and pollers
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cmsis_os2.h"
+#include "DAP_config.h"
+#include "DAP.h"
+#include "swd_host.h"
+#include "swd_sched.h"
+
+// Quiet time after a CMSIS-DAP command before background groups may run.
+// Keeps pollers out of the way while the host debugger is busy.
+#ifndef SWD_SCHED_INTERACTIVE_HOLDOFF_MS
+#define SWD_SCHED_INTERACTIVE_HOLDOFF_MS    5
+#endif
+
+#define CLASS_NONE              SWD_SCHED_CLASS_COUNT
+#define CLASS_BIT(cls)          (1UL << (cls))
+
+// AP IDR class field, a MEM-AP is the only AP with CSW and TAR
+#define AP_IDR_CLASS_MASK       0x0001E000
+#define AP_IDR_CLASS_MEM_AP     0x00010000
+
+typedef struct {
+    bool valid;
+    bool mem_ap;
+    uint32_t select;
+    uint32_t csw;
+    uint32_t tar;
+} link_context_t;
+
+static link_context_t context[SWD_SCHED_CLASS_COUNT];
+
+// Class whose context is on the wire
+static uint32_t owner = CLASS_NONE;
+// Classes between swd_sched_begin() and swd_sched_end()
+static uint32_t open_classes = 0;
+
+// Last value written to DP SELECT, it is write only
+static bool select_known = false;
+static uint32_t select_value;
+
+static uint32_t interactive_tick;
+
+static osMutexId_t link_mutex;
+static const osMutexAttr_t k_link_mutex_attr = {
+    .name = "swd",
+    .attr_bits = osMutexRecursive | osMutexPrioInherit,
+};
+
+static bool write_select(uint32_t select)
+{
+    if (select_known && (select_value == select)) {
+        return true;
+    }
+    return swd_transfer_retry(SWD_REG_DP | SWD_REG_W | SWD_REG_ADR(DP_SELECT), &select) == DAP_TRANSFER_OK;
+}
+
+static bool read_ap(uint32_t select, uint32_t adr, uint32_t *val)
+{
+    // AP reads are posted, the value comes with the RDBUFF read
+    return write_select(select) &&
+           (swd_transfer_retry(SWD_REG_AP | SWD_REG_R | SWD_REG_ADR(adr), NULL) == DAP_TRANSFER_OK) &&
+           (swd_transfer_retry(SWD_REG_DP | SWD_REG_R | SWD_REG_ADR(DP_RDBUFF), val) == DAP_TRANSFER_OK);
+}
+
+static bool write_ap(uint32_t select, uint32_t adr, uint32_t val)
+{
+    return write_select(select) &&
+           (swd_transfer_retry(SWD_REG_AP | SWD_REG_W | SWD_REG_ADR(adr), &val) == DAP_TRANSFER_OK);
+}
+
+static void context_save(link_context_t *ctx)
+{
+    uint32_t ap = select_value & APSEL;
+    uint32_t idr;
+
+    ctx->valid = false;
+    if (!select_known) {
+        return;
+    }
+
+    ctx->select = select_value;
+    ctx->mem_ap = read_ap(ap | (AP_IDR & APBANKSEL), AP_IDR, &idr) &&
+                  ((idr & AP_IDR_CLASS_MASK) == AP_IDR_CLASS_MEM_AP);
+    if (ctx->mem_ap && !(read_ap(ap, AP_CSW, &ctx->csw) && read_ap(ap, AP_TAR, &ctx->tar))) {
+        return;
+    }
+    ctx->valid = true;
+}
+
+static void context_restore(const link_context_t *ctx)
+{
+    uint32_t ap = ctx->select & APSEL;
+
+    if (!ctx->valid) {
+        return;
+    }
+
+    // A failure shows up in the next transfer of the class itself
+    if (ctx->mem_ap) {
+        write_ap(ap, AP_CSW, ctx->csw);
+        write_ap(ap, AP_TAR, ctx->tar);
+    }
+    write_select(ctx->select);
+}
+
+// The host debugger only has a context while it owns the SWD port
+static bool class_has_link(uint32_t cls)
+{
+    return (cls != SWD_SCHED_INTERACTIVE) || (DAP_Data.debug_port == DAP_PORT_SWD);
+}
+
+static bool background_allowed(void)
+{
+    uint32_t holdoff = SWD_SCHED_INTERACTIVE_HOLDOFF_MS * osKernelGetTickFreq() / 1000;
+
+    if (open_classes & (CLASS_BIT(SWD_SCHED_INTERACTIVE) | CLASS_BIT(SWD_SCHED_BULK))) {
+        return false;
+    }
+    // The pollers use SWD, which would break a JTAG session
+    if (DAP_Data.debug_port == DAP_PORT_JTAG) {
+        return false;
+    }
+    return (osKernelGetTickCount() - interactive_tick) > holdoff;
+}
+
+void swd_sched_init(void)
+{
+    link_mutex = osMutexNew(&k_link_mutex_attr);
+}
+
+void swd_sched_lock(void)
+{
+    osMutexAcquire(link_mutex, osWaitForever);
+}
+
+void swd_sched_unlock(void)
+{
+    osMutexRelease(link_mutex);
+}
+
+bool swd_sched_begin(swd_sched_class_t cls)
+{
+    if (cls == SWD_SCHED_BACKGROUND) {
+        // Pollers never wait for the link
+        if (osMutexAcquire(link_mutex, 0) != osOK) {
+            return false;
+        }
+        if (!background_allowed()) {
+            osMutexRelease(link_mutex);
+            return false;
+        }
+    } else if (cls == SWD_SCHED_INTERACTIVE) {
+        swd_sched_lock();
+    }
+
+    if (!class_has_link(cls)) {
+        context[cls].valid = false;
+    }
+
+    // Set first, the SELECT writes below are part of the group
+    open_classes |= CLASS_BIT(cls);
+
+    if (owner != cls) {
+        if ((owner != CLASS_NONE) && class_has_link(owner)) {
+            context_save(&context[owner]);
+        }
+        context_restore(&context[cls]);
+        // swd_host caches SELECT and CSW, they may belong to someone else now
+        swd_invalidate_dap_state();
+        owner = cls;
+    }
+
+    return true;
+}
+
+void swd_sched_end(swd_sched_class_t cls)
+{
+    open_classes &= ~CLASS_BIT(cls);
+
+    if (cls == SWD_SCHED_INTERACTIVE) {
+        interactive_tick = osKernelGetTickCount();
+    } else if (owner == cls) {
+        // Drag-and-drop and the pollers set up the link again for every
+        // session or poll through swd_host, so there is nothing to keep
+        context[cls].valid = false;
+        owner = CLASS_NONE;
+    }
+
+    if (cls != SWD_SCHED_BULK) {
+        swd_sched_unlock();
+    }
+}
+
+void swd_sched_select_written(uint32_t select)
+{
+    select_known = true;
+    select_value = select;
+
+    // Someone outside of any group, like the reset logic, took the link
+    if (open_classes == 0) {
+        if (owner != CLASS_NONE) {
+            context[owner].valid = false;
+        }
+        owner = CLASS_NONE;
+    }
+}
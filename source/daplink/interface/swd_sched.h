@@ -0,0 +1,78 @@
+/**
+ * @file    swd_sched.h
+ * @brief   Share the SWD link between CMSIS-DAP, drag-and-drop and pollers
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SWD_SCHED_H
+#define SWD_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @brief Users of the SWD link, highest priority first.
+typedef enum {
+    SWD_SCHED_INTERACTIVE = 0,  //!< CMSIS-DAP commands from the host debugger
+    SWD_SCHED_BULK,             //!< Drag-and-drop programming
+    SWD_SCHED_BACKGROUND,       //!< Pollers like the RTT bridge
+    SWD_SCHED_CLASS_COUNT,
+} swd_sched_class_t;
+
+//! @brief Create the link mutex, before other threads use the link.
+void swd_sched_init(void);
+
+//! @brief Take the link for the calling thread.
+//!
+//! Recursive. Interactive groups take it themselves, other users of the
+//! link, like the drag-n-drop thread or target_set_state(), hold it around
+//! their work so it is never driven by two threads at once.
+void swd_sched_lock(void);
+
+//! @brief Give back the link taken with swd_sched_lock().
+void swd_sched_unlock(void);
+
+//! @brief Start a group of transfers.
+//!
+//! Groups of different classes can follow each other in any order. When the
+//! class changes, the DP SELECT and the MEM-AP CSW and TAR of the previous
+//! class are saved and the ones of @a cls restored, so each class finds the
+//! link the way it left it.
+//!
+//! Background groups are refused while a higher class uses the link, has
+//! used it recently, or another thread holds it, so they only fill the gaps.
+//!
+//! @return True if the group may run.
+bool swd_sched_begin(swd_sched_class_t cls);
+
+//! @brief End the group, or for bulk the programming session, of a class.
+void swd_sched_end(swd_sched_class_t cls);
+
+//! @brief Report a DP SELECT write done on the wire.
+//!
+//! Called by SWD_Transfer(), since SELECT cannot be read back.
+void swd_sched_select_written(uint32_t select);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
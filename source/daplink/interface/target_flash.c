@@ -22,20 +22,35 @@
  */
 #ifdef DRAG_N_DROP_SUPPORT
 #include <string.h>
+#include <stddef.h>
 
 #include "target_config.h"
 #include "gpio.h"
 #include "target_config.h"
 #include "intelhex.h"
 #include "swd_host.h"
+#include "swd_sched.h"
 #include "flash_intf.h"
 #include "util.h"
 #include "settings.h"
 #include "target_family.h"
 #include "target_board.h"
+#include "transfer_perf.h"
+#include "crc.h"
 
 #define DEFAULT_PROGRAM_PAGE_MIN_SIZE   (256u)
 
+// Words of an algo still in target RAM read back besides its entry points
+#define ALGO_RESIDENT_SAMPLES           (8u)
+
+// post_build_script.py packs program_target_t as 17 words, update
+// program_target_fmt there if it changes. algo_blob is the only pointer.
+COMPILER_ASSERT(sizeof(program_target_t) == 16 * sizeof(uint32_t) + sizeof(uint32_t *));
+// It packs target_cfg_t right after it, 127 words: 103 words of values and
+// 24 pointers, the sector list, one algo per region, the board ID and the
+// two target strings
+COMPILER_ASSERT(sizeof(target_cfg_t) == 103 * sizeof(uint32_t) + 24 * sizeof(void *));
+
 typedef enum {
     STATE_CLOSED,
     STATE_OPEN,
@@ -51,6 +66,12 @@ static uint32_t target_flash_program_page_min_size(uint32_t addr);
 static uint32_t target_flash_erase_sector_size(uint32_t addr);
 static uint8_t target_flash_busy(void);
 static error_t target_flash_set(uint32_t addr);
+static error_t target_flash_erase_range(uint32_t addr, uint32_t size);
+static error_t target_flash_erase_sector_start(uint32_t addr);
+static uint8_t target_flash_erase_pending(void);
+static error_t target_flash_read(uint32_t addr, uint8_t *buf, uint32_t size);
+static error_t target_flash_program_compressed(uint32_t addr, const uint8_t *buf, uint32_t size,
+                                               const uint8_t *comp, uint32_t comp_size);
 
 static const flash_intf_t flash_intf = {
     target_flash_init,
@@ -62,6 +83,11 @@ static const flash_intf_t flash_intf = {
     target_flash_erase_sector_size,
     target_flash_busy,
     target_flash_set,
+    target_flash_erase_range,
+    target_flash_erase_sector_start,
+    target_flash_erase_pending,
+    target_flash_read,
+    target_flash_program_compressed,
 };
 
 static state_t state = STATE_CLOSED;
@@ -79,6 +105,19 @@ static region_info_t * default_region = NULL;
 //saved flash start from flash algo
 static uint32_t flash_start = 0;
 
+//saved DP of the region from flash algo, and the DP in use
+static uint32_t flash_target_sel = 0;
+static uint32_t current_target_sel = 0;
+
+//sector erase left running by target_flash_erase_sector_start
+static bool erase_started = false;
+
+//program buffer size of the current flash algo in target RAM
+static uint32_t program_buffer_size = 0;
+
+//signature of the flash algo downloaded last, 0 if there is none
+static uint32_t algo_signature = 0;
+
 static program_target_t * get_flash_algo(uint32_t addr)
 {
     region_info_t * flash_region = g_board_info.target_cfg->flash_regions;
@@ -86,6 +125,7 @@ static program_target_t * get_flash_algo(uint32_t addr)
     for (; flash_region->start != 0 || flash_region->end != 0; ++flash_region) {
         if (addr >= flash_region->start && addr <= flash_region->end) {
             flash_start = flash_region->start; //save the flash start
+            flash_target_sel = flash_region->target_sel; //save the DP of the region
             if (flash_region->flash_algo) {
                 return flash_region->flash_algo;
             }else{
@@ -97,16 +137,89 @@ static program_target_t * get_flash_algo(uint32_t addr)
     //could not find a flash algo for the region; use default
     if (default_region) {
         flash_start = default_region->start;
+        flash_target_sel = default_region->target_sel;
         return default_region->flash_algo;
     } else {
         return NULL;
     }
 }
 
+// Take the link for drag-n-drop, on the DP of the current region
+static void bulk_begin(void)
+{
+    swd_sched_begin(SWD_SCHED_BULK);
+    // The host debugger may have selected another DP of a multi-drop bus.
+    // A failure shows up in the transfers that follow.
+    swd_select_target(current_target_sel);
+}
+
+// Set the state of every target of a multi-drop bus, each one once. A
+// single target with regions without target_sel is set as is.
+static uint8_t target_set_state_all(target_state_t state)
+{
+    region_info_t * flash_region = g_board_info.target_cfg->flash_regions;
+    region_info_t * prev_region;
+    uint8_t multidrop = 0;
+    uint8_t ret = 1;
+
+    for (; flash_region->start != 0 || flash_region->end != 0; ++flash_region) {
+        if (flash_region->target_sel == 0) {
+            continue;
+        }
+        multidrop = 1;
+
+        prev_region = g_board_info.target_cfg->flash_regions;
+        while ((prev_region != flash_region) && (prev_region->target_sel != flash_region->target_sel)) {
+            ++prev_region;
+        }
+        if (prev_region != flash_region) {
+            continue;
+        }
+
+        if (!swd_select_target(flash_region->target_sel) || !target_set_state(state)) {
+            ret = 0;
+        }
+    }
+
+    if (!multidrop) {
+        return target_set_state(state);
+    }
+
+    // Back to the DP drag-n-drop was using
+    swd_select_target(current_target_sel);
+    return ret;
+}
+
+static error_t erase_wait(void)
+{
+    transfer_perf_phase_t phase;
+    uint32_t done;
+
+    if (!erase_started) {
+        return ERROR_SUCCESS;
+    }
+
+    erase_started = false;
+    phase = transfer_perf_phase(TRANSFER_PERF_ERASE);
+    done = swd_flash_syscall_result(0, 0, FLASHALGO_RETURN_BOOL);
+    transfer_perf_phase(phase);
+    if (0 == done) {
+        return ERROR_ERASE_SECTOR;
+    }
+
+    return ERROR_SUCCESS;
+}
+
 static error_t flash_func_start(flash_func_t func)
 {
     program_target_t * flash = current_flash_algo;
 
+    // The core must be done with a background erase before it runs anything else
+    error_t status = erase_wait();
+    if (status != ERROR_SUCCESS) {
+        return status;
+    }
+
     if (last_flash_func != func)
     {
         // Finish the currently active function.
@@ -129,24 +242,138 @@ static error_t flash_func_start(flash_func_t func)
     return ERROR_SUCCESS;
 }
 
+// Size of the algo code, the RW data from the static base on changes when
+// the algo runs
+static uint32_t flash_algo_code_size(const program_target_t *algo)
+{
+    uint32_t static_base = algo->sys_call_s.static_base;
+
+    if ((static_base > algo->algo_start) && (static_base < algo->algo_start + algo->algo_size)) {
+        return ROUND_DOWN(static_base - algo->algo_start, 4);
+    }
+
+    return algo->algo_size;
+}
+
+// ProgramPages takes any multiple of the generated buffer size, so the
+// buffer can grow up to the end of the target RAM region it starts in
+static uint32_t flash_algo_buffer_size(const program_target_t *algo)
+{
+    const region_info_t *region;
+    uint32_t i;
+
+    if (!algo->program_pages) {
+        return algo->program_buffer_size;
+    }
+
+    for (i = 0; i < MAX_REGIONS; i++) {
+        region = &g_board_info.target_cfg->ram_regions[i];
+        if ((algo->program_buffer >= region->start) && (algo->program_buffer < region->end)) {
+            return MAX(algo->program_buffer_size,
+                       ROUND_DOWN(region->end - algo->program_buffer, algo->program_buffer_size));
+        }
+    }
+
+    return algo->program_buffer_size;
+}
+
+// CRC of everything that makes an algo: its entry points, addresses and
+// sizes, and its code. The blob pointer is a probe address and left out.
+static uint32_t flash_algo_signature(const program_target_t *algo, uint32_t code_size)
+{
+    uint32_t crc;
+
+    crc = crc32(algo, offsetof(program_target_t, algo_blob));
+    crc = crc32_continue(crc, &algo->program_buffer_size,
+                         sizeof(*algo) - offsetof(program_target_t, program_buffer_size));
+    return crc32_continue(crc, algo->algo_blob, code_size);
+}
+
+static bool flash_algo_word_resident(const program_target_t *algo, uint32_t offset)
+{
+    uint32_t word;
+
+    offset = ROUND_DOWN(offset, 4);
+    return swd_read_word(algo->algo_start + offset, &word) && (word == algo->algo_blob[offset / 4]);
+}
+
+// The target RAM usually still holds the algo of an earlier transfer unless
+// the application ran over it. It must be the algo downloaded last, and its
+// entry points and a few words spread over its code must read back the same
+// as the blob. Reading all of it back takes about as long as downloading it.
+static bool flash_algo_resident(const program_target_t *algo, uint32_t code_size)
+{
+    const uint32_t entries[] = {
+        algo->init, algo->uninit, algo->erase_chip, algo->erase_sector,
+        algo->program_page, algo->verify, algo->program_pages, algo->program_compressed,
+    };
+    uint32_t offset;
+    uint32_t i;
+
+    if ((code_size < 4) || (algo_signature != flash_algo_signature(algo, code_size))) {
+        return false;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(entries); i++) {
+        offset = (entries[i] & ~1u) - algo->algo_start;
+        if ((entries[i] != 0) && (offset < code_size) && !flash_algo_word_resident(algo, offset)) {
+            return false;
+        }
+    }
+
+    for (i = 0; i < ALGO_RESIDENT_SAMPLES; i++) {
+        offset = (uint64_t)(code_size - 4) * i / (ALGO_RESIDENT_SAMPLES - 1);
+        if (!flash_algo_word_resident(algo, offset)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static error_t target_flash_set(uint32_t addr)
 {
     program_target_t * new_flash_algo = get_flash_algo(addr);
     if (new_flash_algo == NULL) {
         return ERROR_ALGO_MISSING;
     }
-    if(current_flash_algo != new_flash_algo){
+    if((current_flash_algo != new_flash_algo) || (current_target_sel != flash_target_sel)){
         //run uninit to last func
         error_t status = flash_func_start(FLASH_FUNC_NOP);
         if (status != ERROR_SUCCESS) {
             return status;
         }
-        // Download flash programming algorithm to target
-        if (0 == swd_write_memory(new_flash_algo->algo_start, (uint8_t *)new_flash_algo->algo_blob, new_flash_algo->algo_size)) {
+        // Another DP of a multi-drop bus, connected by target_flash_init()
+        if (current_target_sel != flash_target_sel) {
+            current_flash_algo = NULL;
+            current_target_sel = flash_target_sel;
+            if (!swd_select_target(current_target_sel)) {
+                return ERROR_RESET;
+            }
+        }
+        // Download flash programming algorithm to target, or only its
+        // RW data if the code is still there
+        transfer_perf_phase_t phase = transfer_perf_phase(TRANSFER_PERF_ALGO);
+        uint32_t offset = flash_algo_code_size(new_flash_algo);
+        bool loaded = true;
+        if (!flash_algo_resident(new_flash_algo, offset)) {
+            algo_signature = 0;
+            offset = 0;
+        }
+        if (offset < new_flash_algo->algo_size) {
+            loaded = swd_write_memory(new_flash_algo->algo_start + offset,
+                                      (uint8_t *)new_flash_algo->algo_blob + offset,
+                                      new_flash_algo->algo_size - offset);
+            transfer_perf_bytes(TRANSFER_PERF_ALGO, new_flash_algo->algo_size - offset);
+        }
+        transfer_perf_phase(phase);
+        if (!loaded) {
             return ERROR_ALGO_DL;
         }
+        algo_signature = flash_algo_signature(new_flash_algo, flash_algo_code_size(new_flash_algo));
 
         current_flash_algo = new_flash_algo;
+        program_buffer_size = flash_algo_buffer_size(new_flash_algo);
 
     }
     return ERROR_SUCCESS;
@@ -159,7 +386,15 @@ static error_t target_flash_init()
 
         current_flash_algo = NULL;
 
-        if (0 == target_set_state(RESET_PROGRAM)) {
+        erase_started = false;
+
+        current_target_sel = g_board_info.target_cfg->flash_regions[0].target_sel;
+
+        // Drag-and-drop holds the link until target_flash_uninit()
+        swd_sched_begin(SWD_SCHED_BULK);
+
+        if (0 == target_set_state_all(RESET_PROGRAM)) {
+            swd_sched_end(SWD_SCHED_BULK);
             return ERROR_RESET;
         }
 
@@ -183,29 +418,78 @@ static error_t target_flash_init()
 static error_t target_flash_uninit(void)
 {
     if (g_board_info.target_cfg) {
+        bulk_begin();
         error_t status = flash_func_start(FLASH_FUNC_NOP);
         if (status != ERROR_SUCCESS) {
+            swd_sched_end(SWD_SCHED_BULK);
             return status;
         }
         if (config_get_auto_rst()) {
             // Resume the target if configured to do so
-            target_set_state(RESET_RUN);
+            target_set_state_all(RESET_RUN);
         } else {
             // Leave the target halted until a reset occurs
-            target_set_state(RESET_PROGRAM);
+            target_set_state_all(RESET_PROGRAM);
         }
         // Check to see if anything needs to be done after programming.
         // This is usually a no-op for most targets.
-        target_set_state(POST_FLASH_RESET);
+        target_set_state_all(POST_FLASH_RESET);
 
         state = STATE_CLOSED;
         swd_off();
+        swd_sched_end(SWD_SCHED_BULK);
         return ERROR_SUCCESS;
     } else {
         return ERROR_FAILURE;
     }
 }
 
+// Check the size bytes at addr against buf, which the program buffer
+// also holds for the verify function of the algo
+static error_t target_flash_verify(program_target_t *flash, uint32_t addr, const uint8_t *buf, uint32_t size)
+{
+    error_t status;
+
+    transfer_perf_phase(TRANSFER_PERF_VERIFY);
+    transfer_perf_bytes(TRANSFER_PERF_VERIFY, size);
+    if (flash->verify != 0) {
+        status = flash_func_start(FLASH_FUNC_VERIFY);
+        if (status != ERROR_SUCCESS) {
+            return status;
+        }
+        flash_algo_return_t return_type;
+        if ((flash->algo_flags & kAlgoVerifyReturnsAddress) != 0) {
+            return_type = FLASHALGO_RETURN_POINTER;
+        } else {
+            return_type = FLASHALGO_RETURN_BOOL;
+        }
+        if (!swd_flash_syscall_exec(&flash->sys_call_s,
+                                    flash->verify,
+                                    addr,
+                                    size,
+                                    flash->program_buffer,
+                                    0,
+                                    return_type)) {
+            return ERROR_WRITE_VERIFY;
+        }
+    } else {
+        while (size > 0) {
+            uint8_t rb_buf[16];
+            uint32_t verify_size = MIN(size, sizeof(rb_buf));
+            if (!swd_read_memory(addr, rb_buf, verify_size)) {
+                return ERROR_ALGO_DATA_SEQ;
+            }
+            if (memcmp(buf, rb_buf, verify_size) != 0) {
+                return ERROR_WRITE_VERIFY;
+            }
+            addr += verify_size;
+            buf += verify_size;
+            size -= verify_size;
+        }
+    }
+    return ERROR_SUCCESS;
+}
+
 static error_t target_flash_program_page(uint32_t addr, const uint8_t *buf, uint32_t size)
 {
     if (g_board_info.target_cfg) {
@@ -216,6 +500,8 @@ static error_t target_flash_program_page(uint32_t addr, const uint8_t *buf, uint
             return ERROR_INTERNAL;
         }
 
+        bulk_begin();
+
         // check if security bits were set
         if (g_target_family && g_target_family->security_bits_set){
             if (1 == g_target_family->security_bits_set(addr, (uint8_t *)buf, size)) {
@@ -223,23 +509,45 @@ static error_t target_flash_program_page(uint32_t addr, const uint8_t *buf, uint
             }
         }
 
+        // Load the first page while the core finishes a background erase
+        bool page_loaded = false;
+        if (erase_started) {
+            transfer_perf_phase(TRANSFER_PERF_SWD_WRITE);
+            transfer_perf_bytes(TRANSFER_PERF_SWD_WRITE, MIN(size, program_buffer_size));
+            if (!swd_write_memory(flash->program_buffer, (uint8_t *)buf, MIN(size, program_buffer_size))) {
+                return ERROR_ALGO_DATA_SEQ;
+            }
+            page_loaded = true;
+        }
+
+        // The caller of program_page() switches back to its own phase
+        transfer_perf_phase(TRANSFER_PERF_PROGRAM);
         status = flash_func_start(FLASH_FUNC_PROGRAM);
 
         if (status != ERROR_SUCCESS) {
             return status;
         }
 
+        // Without the wrapper the program buffer holds a single page
+        uint32_t program_func = flash->program_pages ? flash->program_pages : flash->program_page;
+
         while (size > 0) {
-            uint32_t write_size = MIN(size, flash->program_buffer_size);
+            uint32_t write_size = MIN(size, program_buffer_size);
 
             // Write page to buffer
-            if (!swd_write_memory(flash->program_buffer, (uint8_t *)buf, write_size)) {
-                return ERROR_ALGO_DATA_SEQ;
+            if (!page_loaded) {
+                transfer_perf_phase(TRANSFER_PERF_SWD_WRITE);
+                transfer_perf_bytes(TRANSFER_PERF_SWD_WRITE, write_size);
+                if (!swd_write_memory(flash->program_buffer, (uint8_t *)buf, write_size)) {
+                    return ERROR_ALGO_DATA_SEQ;
+                }
             }
+            page_loaded = false;
 
             // Run flash programming
+            transfer_perf_phase(TRANSFER_PERF_PROGRAM);
             if (!swd_flash_syscall_exec(&flash->sys_call_s,
-                                        flash->program_page,
+                                        program_func,
                                         addr,
                                         write_size,
                                         flash->program_buffer,
@@ -250,42 +558,9 @@ static error_t target_flash_program_page(uint32_t addr, const uint8_t *buf, uint
 
             if (config_get_automation_allowed()) {
                 // Verify data flashed if in automation mode
-                if (flash->verify != 0) {
-                    status = flash_func_start(FLASH_FUNC_VERIFY);
-                    if (status != ERROR_SUCCESS) {
-                        return status;
-                    }
-                    flash_algo_return_t return_type;
-                    if ((flash->algo_flags & kAlgoVerifyReturnsAddress) != 0) {
-                        return_type = FLASHALGO_RETURN_POINTER;
-                    } else {
-                        return_type = FLASHALGO_RETURN_BOOL;
-                    }
-                    if (!swd_flash_syscall_exec(&flash->sys_call_s,
-                                        flash->verify,
-                                        addr,
-                                        write_size,
-                                        flash->program_buffer,
-                                        0,
-                                        return_type)) {
-                        return ERROR_WRITE_VERIFY;
-                    }
-                } else {
-                    while (write_size > 0) {
-                        uint8_t rb_buf[16];
-                        uint32_t verify_size = MIN(write_size, sizeof(rb_buf));
-                        if (!swd_read_memory(addr, rb_buf, verify_size)) {
-                            return ERROR_ALGO_DATA_SEQ;
-                        }
-                        if (memcmp(buf, rb_buf, verify_size) != 0) {
-                            return ERROR_WRITE_VERIFY;
-                        }
-                        addr += verify_size;
-                        buf += verify_size;
-                        size -= verify_size;
-                        write_size -= verify_size;
-                    }
-                    continue;
+                status = target_flash_verify(flash, addr, buf, write_size);
+                if (status != ERROR_SUCCESS) {
+                    return status;
                 }
             }
             addr += write_size;
@@ -301,6 +576,60 @@ static error_t target_flash_program_page(uint32_t addr, const uint8_t *buf, uint
     }
 }
 
+// The algo expands the block in target RAM, only the compressed data goes
+// over SWD. It goes right after the space it expands to in the program
+// buffer, so automation mode verifies the expanded data like a page.
+static error_t target_flash_program_compressed(uint32_t addr, const uint8_t *buf, uint32_t size,
+                                               const uint8_t *comp, uint32_t comp_size)
+{
+    program_target_t *flash = current_flash_algo;
+    uint32_t comp_addr;
+    error_t status;
+
+    if (!flash || !flash->program_compressed || (ROUND_UP(size, 4) + comp_size > program_buffer_size)) {
+        return target_flash_program_page(addr, buf, size);
+    }
+
+    bulk_begin();
+
+    // check if security bits were set
+    if (g_target_family && g_target_family->security_bits_set){
+        if (1 == g_target_family->security_bits_set(addr, (uint8_t *)buf, size)) {
+            return ERROR_SECURITY_BITS;
+        }
+    }
+
+    // Load the block while the core finishes a background erase
+    comp_addr = flash->program_buffer + ROUND_UP(size, 4);
+    transfer_perf_phase(TRANSFER_PERF_SWD_WRITE);
+    transfer_perf_bytes(TRANSFER_PERF_SWD_WRITE, comp_size);
+    if (!swd_write_memory(comp_addr, (uint8_t *)comp, comp_size)) {
+        return ERROR_ALGO_DATA_SEQ;
+    }
+
+    transfer_perf_phase(TRANSFER_PERF_PROGRAM);
+    status = flash_func_start(FLASH_FUNC_PROGRAM);
+    if (status != ERROR_SUCCESS) {
+        return status;
+    }
+
+    if (!swd_flash_syscall_exec(&flash->sys_call_s,
+                                flash->program_compressed,
+                                addr,
+                                size,
+                                comp_addr,
+                                comp_size,
+                                FLASHALGO_RETURN_BOOL)) {
+        return ERROR_WRITE;
+    }
+
+    if (config_get_automation_allowed()) {
+        return target_flash_verify(flash, addr, buf, size);
+    }
+
+    return ERROR_SUCCESS;
+}
+
 static error_t target_flash_erase_sector(uint32_t addr)
 {
     if (g_board_info.target_cfg) {
@@ -311,6 +640,8 @@ static error_t target_flash_erase_sector(uint32_t addr)
             return ERROR_INTERNAL;
         }
 
+        bulk_begin();
+
         // Check to make sure the address is on a sector boundary
         if ((addr % target_flash_erase_sector_size(addr)) != 0) {
             return ERROR_ERASE_SECTOR;
@@ -332,12 +663,136 @@ static error_t target_flash_erase_sector(uint32_t addr)
     }
 }
 
+static error_t target_flash_erase_range(uint32_t addr, uint32_t size)
+{
+    if (g_board_info.target_cfg) {
+        error_t status = ERROR_SUCCESS;
+        uint32_t end = addr + size;
+
+        bulk_begin();
+        while (addr < end) {
+            uint32_t erase_size = target_flash_erase_sector_size(addr);
+
+            if (0 == erase_size) {
+                return ERROR_ERASE_SECTOR;
+            }
+
+            status = target_flash_set(addr);
+            if (status != ERROR_SUCCESS) {
+                return status;
+            }
+
+            if (current_flash_algo->algo_flags & kAlgoEraseSectorRange) {
+                // One call erases the rest of the range covered by this algo
+                region_info_t * flash_region = g_board_info.target_cfg->flash_regions;
+                erase_size = end - addr;
+                for (; flash_region->start != 0 || flash_region->end != 0; ++flash_region) {
+                    if ((addr >= flash_region->start) && (addr < flash_region->end)) {
+                        erase_size = MIN(end, flash_region->end) - addr;
+                        break;
+                    }
+                }
+
+                if ((addr % target_flash_erase_sector_size(addr)) != 0) {
+                    return ERROR_ERASE_SECTOR;
+                }
+
+                status = flash_func_start(FLASH_FUNC_ERASE);
+                if (status != ERROR_SUCCESS) {
+                    return status;
+                }
+
+                if (0 == swd_flash_syscall_exec(&current_flash_algo->sys_call_s, current_flash_algo->erase_sector, addr, erase_size, 0, 0, FLASHALGO_RETURN_BOOL)) {
+                    return ERROR_ERASE_SECTOR;
+                }
+            } else {
+                status = target_flash_erase_sector(addr);
+                if (status != ERROR_SUCCESS) {
+                    return status;
+                }
+            }
+
+            addr += erase_size;
+        }
+
+        return ERROR_SUCCESS;
+    } else {
+        return ERROR_FAILURE;
+    }
+}
+
+static error_t target_flash_erase_sector_start(uint32_t addr)
+{
+    if (g_board_info.target_cfg) {
+        error_t status = ERROR_SUCCESS;
+        program_target_t * flash = current_flash_algo;
+        uint32_t current_flash_start = flash_start;
+        bool same_region;
+
+        // Switching algos would break the sector being programmed
+        same_region = flash && (get_flash_algo(addr) == flash) && (flash_start == current_flash_start);
+        flash_start = current_flash_start;
+        if (!same_region) {
+            return ERROR_ALGO_MISSING;
+        }
+
+        // Check to make sure the address is on a sector boundary
+        if ((addr % target_flash_erase_sector_size(addr)) != 0) {
+            return ERROR_ERASE_SECTOR;
+        }
+
+        bulk_begin();
+        status = flash_func_start(FLASH_FUNC_ERASE);
+
+        if (status != ERROR_SUCCESS) {
+            return status;
+        }
+
+        if (0 == swd_flash_syscall_start(&flash->sys_call_s, flash->erase_sector, addr, 0, 0, 0)) {
+            return ERROR_ERASE_SECTOR;
+        }
+
+        erase_started = true;
+        return ERROR_SUCCESS;
+    } else {
+        return ERROR_FAILURE;
+    }
+}
+
+static uint8_t target_flash_erase_pending(void)
+{
+    if (!erase_started) {
+        return 0;
+    }
+
+    bulk_begin();
+    return !swd_flash_syscall_halted();
+}
+
+static error_t target_flash_read(uint32_t addr, uint8_t *buf, uint32_t size)
+{
+    bulk_begin();
+
+    // The flash cannot be read while the core erases it
+    error_t status = erase_wait();
+    if (status != ERROR_SUCCESS) {
+        return status;
+    }
+
+    if (!swd_read_memory(addr, buf, size)) {
+        return ERROR_ALGO_DATA_SEQ;
+    }
+
+    return ERROR_SUCCESS;
+}
+
 static error_t target_flash_erase_chip(void)
 {
     if (g_board_info.target_cfg){
         error_t status = ERROR_SUCCESS;
         region_info_t * flash_region = g_board_info.target_cfg->flash_regions;
 
+        bulk_begin();
         for (; flash_region->start != 0 || flash_region->end != 0; ++flash_region) {
             program_target_t *new_flash_algo = get_flash_algo(flash_region->start);
             if ((new_flash_algo != NULL) && ((new_flash_algo->algo_flags & kAlgoSkipChipErase) != 0)) {
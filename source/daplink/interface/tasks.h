@@ -30,4 +30,24 @@
 #endif
 #define MAIN_TASK_PRIORITY  (osPriorityNormal)
 
+// Run CDC bridging and drag-n-drop programming on their own threads, so a
+// flash erase does not stall the virtual COM port. Their stacks are only
+// worth it on HICs with RAM to spare, the others keep everything on the
+// main task.
+#ifndef SPLIT_MAIN_TASK
+#define SPLIT_MAIN_TASK     (0)
+#endif
+
+// Moves data between the virtual COM port and the UART or RTT
+#ifndef CDC_TASK_STACK
+#define CDC_TASK_STACK      (384)
+#endif
+#define CDC_TASK_PRIORITY   (osPriorityBelowNormal)
+
+// Programs drag-n-drop files, so it goes as deep as the flash algo calls
+#ifndef VFS_TASK_STACK
+#define VFS_TASK_STACK      (MAIN_TASK_STACK)
+#endif
+#define VFS_TASK_PRIORITY   (osPriorityLow)
+
 #endif
@@ -43,10 +43,12 @@ void config_set_auto_rst(bool on);
 void config_set_automation_allowed(bool on);
 void config_set_overflow_detect(bool on);
 void config_set_detect_incompatible_target(bool on);
+void config_set_cdc_latency(uint8_t latency_ms);
 bool config_get_auto_rst(void);
 bool config_get_automation_allowed(void);
 bool config_get_overflow_detect(void);
 bool config_get_detect_incompatible_target(void);
+uint8_t config_get_cdc_latency(void);
 
 // Get/set settings residing in shared ram
 void config_ram_set_hold_in_bl(bool hold);
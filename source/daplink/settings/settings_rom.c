@@ -20,16 +20,39 @@
  */
 
 #include <string.h>
+#include <stddef.h>
 
 #include "settings.h"
 #include "target_config.h"
 #include "compiler.h"
 #include "cortex_m.h"
 #include "flash_hal.h"
+#include "daplink_addr.h"
+#include "crc.h"
 
-// 'kvld' in hex - key valid
+// 'kvld' in hex - key valid, a record without a check
 #define CFG_KEY             0x6b766c64
+// 'kvlc' in hex - key of a record followed by the CRC of its size bytes.
+// Programming stops at either key before all its bits are cleared, so an
+// interrupted write never reads as the other key.
+#define CFG_KEY_CHECKED     0x6b766c63
+#define CFG_KEY_ERASED      0xFFFFFFFF
+
+// Bytes handed to the flash for a record, parts whose ProgramPage always
+// writes a whole page need it to be that page
+#ifndef SECTOR_BUFFER_SIZE
 #define SECTOR_BUFFER_SIZE  16
+#endif
+
+// The settings are a log of records in cfgrom. A change appends a record
+// and the region is only erased when the log is full, the last valid
+// record is the current one. The first record has the layout of the former
+// single record, so existing cfgrom contents read as a log of one.
+// Records are a multiple of what the flash of the HIC can program on its own.
+#ifndef CFG_RECORD_SIZE
+#define CFG_RECORD_SIZE     SECTOR_BUFFER_SIZE
+#endif
+#define CFG_RECORD_COUNT    (DAPLINK_ROM_CONFIG_USER_SIZE / CFG_RECORD_SIZE)
 
 // WARNING - THIS STRUCTURE RESIDES IN NON-VOLATILE STORAGE!
 // Be careful with changes:
@@ -45,55 +68,126 @@ typedef struct __attribute__((__packed__)) cfg_setting {
     uint8_t automation_allowed;
     uint8_t overflow_detect;
     uint8_t detect_incompatible_target;
+    uint8_t cdc_latency;
 
     // Add new members here
 
 } cfg_setting_t;
 
 // Make sure FORMAT in generate_config.py is updated if size changes
-COMPILER_ASSERT(sizeof(cfg_setting_t) == 10);
+COMPILER_ASSERT(sizeof(cfg_setting_t) == 11);
 
-// Sector buffer must be as big or bigger than settings
-COMPILER_ASSERT(sizeof(cfg_setting_t) < SECTOR_BUFFER_SIZE);
+// Sector buffer must be as big or bigger than settings and their CRC
+COMPILER_ASSERT(sizeof(cfg_setting_t) + sizeof(uint32_t) <= SECTOR_BUFFER_SIZE);
 // Sector buffer must be a multiple of 4 bytes at least.
 // ProgramPage for some interfaces, like the k20dx, require that
 // the data is a multiple of 4 bytes, otherwise programming will
 // fail.  Assert 8 byte alignement just to be safe.
 COMPILER_ASSERT(SECTOR_BUFFER_SIZE % 8 == 0);
 
+// The whole buffer goes into a record, and the log fills the erase sectors
+COMPILER_ASSERT(SECTOR_BUFFER_SIZE <= CFG_RECORD_SIZE);
+COMPILER_ASSERT(DAPLINK_ROM_CONFIG_USER_SIZE % CFG_RECORD_SIZE == 0);
+COMPILER_ASSERT(DAPLINK_ROM_CONFIG_USER_SIZE % DAPLINK_SECTOR_SIZE == 0);
+
+typedef union cfg_record {
+    cfg_setting_t setting;
+    uint8_t data[CFG_RECORD_SIZE];
+} cfg_record_t;
+
 // Configuration ROM
 #if defined(__CC_ARM)
-static volatile cfg_setting_t config_rom __attribute__((section("cfgrom"),zero_init));
+static volatile cfg_record_t config_rom[CFG_RECORD_COUNT] __attribute__((section("cfgrom"),zero_init));
 #else
-static volatile cfg_setting_t config_rom __attribute__((section("cfgrom")));
+static volatile cfg_record_t config_rom[CFG_RECORD_COUNT] __attribute__((section("cfgrom")));
 #endif
 // Ram copy of ROM config
 static cfg_setting_t config_rom_copy;
+// Index of the current record, CFG_RECORD_COUNT if there is none, and of
+// the first free one. Found once by config_rom_init().
+static uint32_t config_rom_cur = CFG_RECORD_COUNT;
+static uint32_t config_rom_next = CFG_RECORD_COUNT;
+// Buffer for data to flash
+static uint8_t write_buffer[SECTOR_BUFFER_SIZE] __ALIGNED(4);
 
 // Configuration defaults in flash
 static const cfg_setting_t config_default = {
+    .key = CFG_KEY_CHECKED,
     .auto_rst = 1,
     .automation_allowed = 1,
     .overflow_detect = 1,
-    .detect_incompatible_target = 0
+    .detect_incompatible_target = 0,
+    .cdc_latency = 0
 };
 
+static bool record_is_readable(uint32_t idx)
+{
+    return flash_is_readable((uint32_t)&config_rom[idx], sizeof(config_rom[idx]));
+}
+
+// CRC of the settings a record holds, it is stored right after them
+static uint32_t record_crc(const volatile cfg_record_t *record)
+{
+    return crc32((const void *)record->data, record->setting.size);
+}
+
+static bool record_is_valid(uint32_t idx)
+{
+    const volatile cfg_record_t *record = &config_rom[idx];
+    uint32_t crc;
+
+    if (CFG_KEY_CHECKED == record->setting.key) {
+        if ((record->setting.size < offsetof(cfg_setting_t, auto_rst)) ||
+                (record->setting.size > CFG_RECORD_SIZE - sizeof(crc))) {
+            return false;
+        }
+        memcpy(&crc, (const void *)&record->data[record->setting.size], sizeof(crc));
+        return crc == record_crc(record);
+    }
+
+    // Only the former single record, or one written by generate_config.py,
+    // has no check
+    return (0 == idx) && (CFG_KEY == record->setting.key);
+}
+
+// Find the current record and the end of the log
+static void scan_cfg(void)
+{
+    uint32_t i;
+
+    config_rom_cur = CFG_RECORD_COUNT;
+    config_rom_next = 0;
+    for (i = 0; i < CFG_RECORD_COUNT; i++) {
+        // Some parts cannot read erased flash
+        if (!record_is_readable(i)) {
+            continue;
+        }
+        if (record_is_valid(i)) {
+            config_rom_cur = i;
+            config_rom_next = i + 1;
+        } else if (CFG_KEY_ERASED != config_rom[i].setting.key) {
+            // Interrupted write, the previous record stays the current one
+            config_rom_next = i + 1;
+        }
+    }
+}
+
 // Check if the configuration in flash needs to be updated
 static bool config_needs_update()
 {
-    // Update if cfgrom cannot be read (needs to be programmed).
-    if (!flash_is_readable((uint32_t)&config_rom, sizeof(config_rom))) {
+    // Update if there is no valid record
+    if (config_rom_cur >= CFG_RECORD_COUNT) {
         return true;
     }
 
-    // Update if the key is invalid
-    if (CFG_KEY != config_rom.key) {
+    // Update if the record has no check
+    if (config_rom[config_rom_cur].setting.key != CFG_KEY_CHECKED) {
         return true;
     }
 
-    // Update if the config key is valid but
+    // Update if the record is valid but
     // has a smaller size.
-    if (config_rom.size < sizeof(config_rom)) {
+    if (config_rom[config_rom_cur].setting.size < sizeof(cfg_setting_t)) {
         return true;
     }
 
@@ -102,27 +196,55 @@ static bool config_needs_update()
     return false;
 }
 
-// Reprogram the new settings if flash writing is allowed
-static void program_cfg(cfg_setting_t *new_cfg)
+static bool erase_cfg(void)
 {
-    uint32_t status;
     uint32_t addr;
 
-    addr = (uint32_t)&config_rom;
-    status = flash_erase_sector(addr);
-    if (status != 0) {
-        return;
+    for (addr = 0; addr < sizeof(config_rom); addr += DAPLINK_SECTOR_SIZE) {
+        if (flash_erase_sector((uint32_t)config_rom + addr) != 0) {
+            return false;
+        }
     }
+    return true;
+}
 
-    // Buffer for data to flash
-    uint8_t write_buffer[SECTOR_BUFFER_SIZE] __ALIGNED(4);
+static bool program_record(uint32_t idx, cfg_setting_t *new_cfg)
+{
+    uint32_t crc = crc32(new_cfg, sizeof(cfg_setting_t));
 
     memset(write_buffer, 0xFF, sizeof(write_buffer));
     memcpy(write_buffer, new_cfg, sizeof(cfg_setting_t));
-    status = flash_program_page(addr, sizeof(write_buffer), write_buffer);
-    if (status != 0) {
+    memcpy(&write_buffer[sizeof(cfg_setting_t)], &crc, sizeof(crc));
+    if (flash_program_page((uint32_t)&config_rom[idx], sizeof(write_buffer), write_buffer) != 0) {
+        return false;
+    }
+
+    // A record that was not clean does not read back
+    return record_is_readable(idx) &&
+           (memcmp((void *)&config_rom[idx], write_buffer, sizeof(cfg_setting_t) + sizeof(crc)) == 0);
+}
+
+// Append the new settings to the log if flash writing is allowed
+static void program_cfg(cfg_setting_t *new_cfg)
+{
+    // Nothing to do if they are in flash already
+    if ((config_rom_cur < CFG_RECORD_COUNT) &&
+            (memcmp((void *)&config_rom[config_rom_cur], new_cfg, sizeof(cfg_setting_t)) == 0)) {
         return;
     }
+
+    if ((config_rom_next >= CFG_RECORD_COUNT) || !program_record(config_rom_next, new_cfg)) {
+        // Log full, start over with only the new record
+        config_rom_cur = CFG_RECORD_COUNT;
+        config_rom_next = CFG_RECORD_COUNT;
+        if (!erase_cfg() || !program_record(0, new_cfg)) {
+            return;
+        }
+        config_rom_next = 0;
+    }
+
+    config_rom_cur = config_rom_next;
+    config_rom_next++;
 }
 
 void config_rom_init()
@@ -132,17 +254,16 @@ void config_rom_init()
     // Fill in the ram copy with the defaults
     memcpy(&config_rom_copy, &config_default, sizeof(config_rom_copy));
 
-    if (flash_is_readable((uint32_t)&config_rom, sizeof(config_rom))) {
-        // Read settings from flash if the key is valid
-        if (CFG_KEY == config_rom.key) {
-            uint32_t size = MIN(config_rom.size, sizeof(config_rom));
-            memcpy(&config_rom_copy, (void *)&config_rom, size);
-        }
+    scan_cfg();
+    // Read settings from the current record
+    if (config_rom_cur < CFG_RECORD_COUNT) {
+        uint32_t size = MIN(config_rom[config_rom_cur].setting.size, sizeof(config_rom_copy));
+        memcpy(&config_rom_copy, (void *)&config_rom[config_rom_cur], size);
     }
 
-    // Fill in special values
-    config_rom_copy.key = CFG_KEY;
-    config_rom_copy.size = sizeof(config_rom);
+    // Fill in special values, a record without a check is written again
+    config_rom_copy.key = CFG_KEY_CHECKED;
+    config_rom_copy.size = sizeof(config_rom_copy);
 
     // Write settings back to flash if they are out of date
     // Note - program_cfg only programs data in bootloader mode
@@ -177,6 +298,12 @@ void config_set_detect_incompatible_target(bool on)
     program_cfg(&config_rom_copy);
 }
 
+void config_set_cdc_latency(uint8_t latency_ms)
+{
+    config_rom_copy.cdc_latency = latency_ms;
+    program_cfg(&config_rom_copy);
+}
+
 bool config_get_auto_rst()
 {
     return config_rom_copy.auto_rst;
@@ -196,3 +323,8 @@ bool config_get_detect_incompatible_target()
 {
     return config_rom_copy.detect_incompatible_target;
 }
+
+uint8_t config_get_cdc_latency()
+{
+    return config_rom_copy.cdc_latency;
+}
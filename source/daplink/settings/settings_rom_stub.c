@@ -46,6 +46,11 @@ void config_set_detect_incompatible_target(bool on)
     // Do nothing
 }
 
+void config_set_cdc_latency(uint8_t latency_ms)
+{
+    // Do nothing
+}
+
 bool config_get_auto_rst()
 {
     return false;
@@ -65,3 +70,8 @@ bool config_get_detect_incompatible_target()
 {
     return false;
 }
+
+uint8_t config_get_cdc_latency()
+{
+    return 0;
+}
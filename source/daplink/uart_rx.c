@@ -0,0 +1,55 @@
+/**
+ * @file    uart_rx.c
+ * @brief   Receive path shared by the HIC UART drivers
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "uart.h"
+#include "util.h"
+#include "settings.h" // for config_get_overflow_detect
+
+#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
+#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
+
+uint32_t uart_rx_block_write(circ_buf_t *read_buffer, const uint8_t *data, uint32_t size)
+{
+    uint32_t free = circ_buf_count_free(read_buffer);
+    uint32_t cnt;
+
+    if (config_get_overflow_detect()) {
+        // Keep room for the message, it goes in once when the buffer fills
+        // up and the newest data is dropped until there is space again
+        cnt = (free > RX_OVRF_MSG_SIZE) ? MIN(size, free - RX_OVRF_MSG_SIZE) : 0;
+        circ_buf_write(read_buffer, data, cnt);
+        if ((cnt < size) && (free - cnt == RX_OVRF_MSG_SIZE)) {
+            circ_buf_write(read_buffer, (const uint8_t *)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
+        }
+        return cnt;
+    }
+
+    // Drop the oldest data to make room
+    cnt = circ_buf_count_used(read_buffer) + free;
+    if (size > cnt) {
+        data += size - cnt;
+        size = cnt;
+    }
+    if (size > free) {
+        circ_buf_pop_n(read_buffer, size - free);
+    }
+    return circ_buf_write(read_buffer, data, size);
+}
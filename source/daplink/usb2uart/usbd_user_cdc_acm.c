@@ -24,24 +24,46 @@
 #include "daplink.h"
 #include DAPLINK_MAIN_HEADER
 #include "uart.h"
+#include "itm_bridge.h"
+#include "rtt_bridge.h"
 #ifdef DRAG_N_DROP_SUPPORT
 #include "flash_intf.h"
 #endif
 #include "target_family.h"
+#include "settings.h"
 
-UART_Configuration UART_Config;
+// CDC ACM instances below UART_COUNT bridge the UART with the same number.
+// The instance after them, if the USB configuration has one, is the trace
+// port with RTT channel 0 and the ITM output of the target. Without a trace
+// port, RTT replaces UART 0 and ITM output is mixed into it.
+#define CDC_TRACE_PORT  UART_COUNT
+
+UART_Configuration UART_Config[UART_COUNT];
+
+static bool is_uart_port(uint8_t instance)
+{
+    return instance < UART_COUNT;
+}
+
+static bool has_trace_port(void)
+{
+    return usbd_cdc_acm_num > CDC_TRACE_PORT;
+}
 
 /** @brief  Vitual COM Port initialization
  *
  *  The function inititalizes the hardware resources of the port used as
  *  the Virtual COM Port.
  *
+ *  @param [in] instance CDC ACM instance.
  *  @return 0 Function failed.
  *  @return 1 Function succeeded.
  */
-int32_t USBD_CDC_ACM_PortInitialize(void)
+int32_t USBD_CDC_ACM_PortInitialize(uint8_t instance)
 {
-    uart_initialize();
+    if (is_uart_port(instance)) {
+        uart_initialize(instance);
+    }
     main_cdc_send_event();
     return 1;
 }
@@ -51,12 +73,15 @@ int32_t USBD_CDC_ACM_PortInitialize(void)
  *  The function uninititalizes/releases the hardware resources of the port used
  *  as the Virtual COM Port.
  *
+ *  @param [in] instance CDC ACM instance.
  *  @return 0 Function failed.
  *  @return 1 Function succeeded.
  */
-int32_t USBD_CDC_ACM_PortUninitialize(void)
+int32_t USBD_CDC_ACM_PortUninitialize(uint8_t instance)
 {
-    uart_uninitialize();
+    if (is_uart_port(instance)) {
+        uart_uninitialize(instance);
+    }
     return 1;
 }
 
@@ -65,32 +90,43 @@ int32_t USBD_CDC_ACM_PortUninitialize(void)
  *  The function resets the internal states of the port used
  *  as the Virtual COM Port.
  *
+ *  @param [in] instance CDC ACM instance.
  *  @return 0 Function failed.
  *  @return 1 Function succeeded.
  */
-int32_t USBD_CDC_ACM_PortReset(void)
+int32_t USBD_CDC_ACM_PortReset(uint8_t instance)
 {
-    uart_reset();
+    if (is_uart_port(instance)) {
+        uart_reset(instance);
+    }
     return 1;
 }
 
 /** @brief  Virtual COM Port change communication settings
  *
  *  The function changes communication settings of the port used as the
- *  Virtual COM Port.
+ *  Virtual COM Port. The trace port has no line, its settings are ignored.
  *
+ *  @param [in] instance CDC ACM instance.
  *  @param [in] line_coding Pointer to the loaded CDC_LINE_CODING structure.
  *  @return 0 Function failed.
  *  @return 1 Function succeeded.
  */
-int32_t USBD_CDC_ACM_PortSetLineCoding(CDC_LINE_CODING *line_coding)
+int32_t USBD_CDC_ACM_PortSetLineCoding(uint8_t instance, CDC_LINE_CODING *line_coding)
 {
-    UART_Config.Baudrate    = line_coding->dwDTERate;
-    UART_Config.DataBits    = (UART_DataBits) line_coding->bDataBits;
-    UART_Config.Parity      = (UART_Parity)   line_coding->bParityType;
-    UART_Config.StopBits    = (UART_StopBits) line_coding->bCharFormat;
-    UART_Config.FlowControl = UART_FLOW_CONTROL_NONE;
-    return uart_set_configuration(&UART_Config);
+    UART_Configuration *config;
+
+    if (!is_uart_port(instance)) {
+        return 1;
+    }
+
+    config = &UART_Config[instance];
+    config->Baudrate    = line_coding->dwDTERate;
+    config->DataBits    = (UART_DataBits) line_coding->bDataBits;
+    config->Parity      = (UART_Parity)   line_coding->bParityType;
+    config->StopBits    = (UART_StopBits) line_coding->bCharFormat;
+    config->FlowControl = UART_FLOW_CONTROL_NONE;
+    return uart_set_configuration(instance, config);
 }
 
 /** @brief  Vitual COM Port retrieve communication settings
@@ -98,23 +134,34 @@ int32_t USBD_CDC_ACM_PortSetLineCoding(CDC_LINE_CODING *line_coding)
  * The function retrieves communication settings of the port used as the
  *  Virtual COM Port.
  *
+ *  @param [in] instance CDC ACM instance.
  *  @param [in] line_coding Pointer to the CDC_LINE_CODING structure.
  *  @return 0 Function failed.
  *  @return 1 Function succeeded.
  */
-int32_t USBD_CDC_ACM_PortGetLineCoding(CDC_LINE_CODING *line_coding)
+int32_t USBD_CDC_ACM_PortGetLineCoding(uint8_t instance, CDC_LINE_CODING *line_coding)
 {
-    line_coding->dwDTERate   = UART_Config.Baudrate;
-    line_coding->bDataBits   = UART_Config.DataBits;
-    line_coding->bParityType = UART_Config.Parity;
-    line_coding->bCharFormat = UART_Config.StopBits;
+    if (!is_uart_port(instance)) {
+        // Keep what the host set
+        return (1);
+    }
+
+    line_coding->dwDTERate   = UART_Config[instance].Baudrate;
+    line_coding->bDataBits   = UART_Config[instance].DataBits;
+    line_coding->bParityType = UART_Config[instance].Parity;
+    line_coding->bCharFormat = UART_Config[instance].StopBits;
     return (1);
 }
 
 static U32 start_break_time = 0;
-int32_t USBD_CDC_ACM_SendBreak(uint16_t dur)
+int32_t USBD_CDC_ACM_SendBreak(uint8_t instance, uint16_t dur)
 {
     uint32_t end_break_time;
+
+    // Only a break on the first port resets the target
+    if (instance != 0) {
+        return (1);
+    }
 #ifdef DRAG_N_DROP_SUPPORT
     if (!flash_intf_target->flash_busy())
 #endif
@@ -142,54 +189,129 @@ int32_t USBD_CDC_ACM_SendBreak(uint16_t dur)
  *  The function sets control line state on the port used as the
  *  Virtual COM Port.
  *
+ *  @param [in] instance CDC ACM instance.
  *  @param [in] ctrl_bmp Control line settings
  *      bitmap (0. bit - DTR state, 1. bit - RTS state).
  *  @return 0 Function failed.
  *  @return 1 Function succeeded.
  */
-int32_t USBD_CDC_ACM_PortSetControlLineState(uint16_t ctrl_bmp)
+int32_t USBD_CDC_ACM_PortSetControlLineState(uint8_t instance, uint16_t ctrl_bmp)
 {
-    uart_set_control_line_state(ctrl_bmp);
+    if (is_uart_port(instance)) {
+        uart_set_control_line_state(instance, ctrl_bmp);
+    }
     return (1);
 }
 
-void cdc_process_event()
+/** @brief  Virtual COM Port poll
+ *
+ *  Called every USB frame once configured, wakes up the CDC processing.
+ */
+void USBD_CDC_ACM_PortPoll(void)
+{
+    main_cdc_send_event();
+}
+
+/** @brief  Virtual COM Port latency timer
+ *
+ *  Like the latency timer of FTDI chips, a partial packet to the host is held
+ *  back until it is full or this many milliseconds have passed.
+ *
+ *  @param [in] instance CDC ACM instance.
+ *  @return Latency in ms, 0 sends the data in the next frame.
+ */
+uint8_t USBD_CDC_ACM_PortGetLatency(uint8_t instance)
+{
+    return config_get_cdc_latency();
+}
+
+// Move data between one CDC ACM instance and its UART or the trace sources
+static bool cdc_process_port(uint8_t instance)
 {
     int32_t len_data = 0;
+    int32_t free_data;
     uint8_t data[64];
+    bool busy = false;
+    bool uart = is_uart_port(instance);
+    bool trace = has_trace_port() ? (instance == CDC_TRACE_PORT) : (instance == 0);
+    bool rtt = trace && rtt_bridge_is_enabled();
 
-    len_data = USBD_CDC_ACM_DataFree();
+    len_data = USBD_CDC_ACM_DataFree(instance);
 
     if (len_data > sizeof(data)) {
         len_data = sizeof(data);
     }
 
-    if (len_data) {
-        len_data = uart_read_data(data, len_data);
+    if (rtt) {
+        // RTT channel 0 replaces the target UART
+        len_data = rtt_bridge_read(data, len_data);
+    } else if (uart && len_data) {
+        len_data = uart_read_data(instance, data, len_data);
+    } else {
+        len_data = 0;
+    }
+
+    // Fill the rest of the packet with decoded ITM output
+    if (trace && (len_data < sizeof(data)) && itm_bridge_is_active()) {
+        free_data = USBD_CDC_ACM_DataFree(instance) - len_data;
+        if (free_data > sizeof(data) - len_data) {
+            free_data = sizeof(data) - len_data;
+        }
+        if (free_data > 0) {
+            len_data += itm_bridge_read(&data[len_data], free_data);
+        }
     }
 
     if (len_data) {
-        if (USBD_CDC_ACM_DataSend(data , len_data)) {
+        if (USBD_CDC_ACM_DataSend(instance, data , len_data)) {
             main_blink_cdc_led(MAIN_LED_FLASH);
+            busy = true;
         }
     }
 
-    len_data = uart_write_free();
+    if (rtt) {
+        len_data = rtt_bridge_write_free();
+    } else if (uart) {
+        len_data = uart_write_free(instance);
+    } else {
+        // Nothing to write to, drop what the host sends
+        len_data = sizeof(data);
+    }
 
     if (len_data > sizeof(data)) {
         len_data = sizeof(data);
     }
 
     if (len_data) {
-        len_data = USBD_CDC_ACM_DataRead(data, len_data);
+        len_data = USBD_CDC_ACM_DataRead(instance, data, len_data);
     }
 
     if (len_data) {
-        if (uart_write_data(data, len_data)) {
+        if (rtt) {
+            len_data = rtt_bridge_write(data, len_data);
+        } else if (uart) {
+            len_data = uart_write_data(instance, data, len_data);
+        }
+        if (len_data) {
             main_blink_cdc_led(MAIN_LED_FLASH);
+            busy = true;
         }
     }
 
-    // Always process events
-    main_cdc_send_event();
+    return busy;
+}
+
+void cdc_process_event()
+{
+    uint8_t instance;
+    bool busy = false;
+
+    for (instance = 0; instance < usbd_cdc_acm_num; instance++) {
+        busy |= cdc_process_port(instance);
+    }
+
+    // Go on while data moves, otherwise wait for the next frame
+    if (busy) {
+        main_cdc_send_event();
+    }
 }
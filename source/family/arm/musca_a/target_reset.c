@@ -128,7 +128,7 @@ static uint8_t musca_a_target_set_state(target_state_t state)
         // Wait 10ms
         delay(10);
 
-        uart_reset();
+        uart_reset(0);
 
         return 1;
     }
@@ -133,7 +133,7 @@ static uint8_t musca_b_target_set_state(target_state_t state)
         // Wait 10ms
         delay(10);
 
-        uart_reset();
+        uart_reset(0);
 
         return 1;
     }
@@ -108,6 +108,7 @@ static uint8_t lpc55s6x_target_set_state(target_state_t state)
 const target_family_descriptor_t g_target_family_lpc55S6X = {
     .family_id = kNXP_LPC55xx_FamilyID, //ID not maching the predefined family ids
     .target_set_state = lpc55s6x_target_set_state,
+    .uf2_family_id = UF2_FAMILY_ID_LPC55,
 };
 
 const target_family_descriptor_t *g_target_family = &g_target_family_lpc55S6X;
@@ -112,7 +112,11 @@ static const uint32_t MIMXRT106x_QSPI_4KB_SEC_flash_prog_blob[] = {
     0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
     0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
     0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
-    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+
+    // ProgramPages, calls ProgramPage for every page of the program buffer
+    0x4604b5f0, 0x4616460d, 0xd00e2d00, 0x428d4908, 0x4629d200, 0x4620460f, 0x4b064632, 0x28004798,
+    0x19e4d104, 0x1bed19f6, 0x2000e7ee, 0x46c0bdf0, 0x00000100, 0x20000157
 };
 
 // Start address of flash
@@ -157,5 +161,9 @@ static const program_target_t flash = {
     // address of prog_blob
     MIMXRT106x_QSPI_4KB_SEC_flash_prog_blob,
     // ram_to_flash_bytes_to_be_written
-    0x00000100
+    0x00001000,
+    // algo_flags
+    0x00000000,
+    // ProgramPages
+    0x20000b41
 };
@@ -41,13 +41,17 @@ target_cfg_t target_device = {
 #include "uart.h"
 static UART_Configuration UART_Config;
 
-int32_t USBD_CDC_ACM_SetLineCoding(void)
+int32_t USBD_CDC_ACM_SetLineCoding(uint8_t instance)
 {
+    if (instance != 0) {
+        return 1;
+    }
+
     UART_Config.Baudrate    = 38400;
     UART_Config.DataBits    = UART_DATA_BITS_8;
     UART_Config.Parity      = UART_PARITY_NONE;
     UART_Config.StopBits    = UART_STOP_BITS_1;
     UART_Config.FlowControl = UART_FLOW_CONTROL_NONE;
 
-    return uart_set_configuration(&UART_Config);
+    return uart_set_configuration(0, &UART_Config);
 }
@@ -97,7 +97,7 @@ void PIOA_IRQHandler(void)
     uint32_t interrupts = PIOA->PIO_ISR;
 
     if ((interrupts >> 9) & 1) { //CTS
-        uart_software_flow_control();
+        uart_software_flow_control(0);
     }
 }
 
@@ -26,13 +26,17 @@
 #include "circ_buf.h"
 #include "cortex_m.h"
 #include "util.h"
-#include "settings.h" // for config_get_overflow_detect
 
 #define  BUFFER_SIZE  512
 #define _CPU_CLK_HZ   SystemCoreClock
 
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
+// Received data goes by PDC into two halves of a block, the interrupt
+// comes when a half is full. The UART has no receive timeout, the data
+// of a half that is not full yet is taken by uart_read_data().
+#define RX_PDC_SIZE         (UART_RX_BLOCK_SIZE / 2)
+// Deassert RTS when less than this is free, the PDC may still deliver
+// the rest of its buffers
+#define RX_READY_MIN_FREE   (UART_RX_BLOCK_SIZE)
 
 
 #define I8   int8_t
@@ -52,6 +56,7 @@
 #define UART_TXRDY_FLAG       (1uL << 1)              // Tx RDY Status flag
 #define UART_TXEMPTY_FLAG     (1uL << 9)              // Tx EMPTY Status flag
 #define UART_ENDTX_FLAG       (1uL << 4)              // Tx end flag
+#define UART_ENDRX_FLAG       (1uL << 3)              // Rx end flag
 #define UART_RX_ERR_FLAGS     (0xE0)                  // Parity, framing, overrun error
 #define UART_TX_INT_FLAG      UART_TXEMPTY_FLAG
 #define PIO_UART_PIN_MASK     ((1uL << UART_RX_PIN) | (1uL << UART_TX_PIN))
@@ -124,6 +129,9 @@ static U8         _FlowControl;
 static U8         _UARTChar0;   // Use static here since PDC starts transferring the byte when we already left this function
 static U32        _TxInProgress;
 static U8         _FlowControlEnabled = 1;
+static U8         _RxPdcBuf[2][RX_PDC_SIZE];
+static U32        _RxPdcCur;    // Half the PDC is filling
+static U32        _RxPdcTaken;  // Bytes of it already in read_buffer
 
 static U32 _DetermineDivider(U32 Baudrate)
 {
@@ -178,6 +186,53 @@ static void _ResetBuffers(void)
     _TxInProgress       = 0;
 }
 
+static void _RxPdcStart(void)
+{
+    UART_PDC_PTCR = (1 << 1);               // Disable reception
+    _RxPdcCur     = 0;
+    _RxPdcTaken   = 0;
+    UART_PDC_RPR  = (U32)_RxPdcBuf[0];
+    UART_PDC_RCR  = RX_PDC_SIZE;
+    UART_PDC_RNPR = (U32)_RxPdcBuf[1];
+    UART_PDC_RNCR = RX_PDC_SIZE;
+    UART_PDC_PTCR = (1 << 0);               // Enable reception
+}
+
+static void _RxPdcStop(void)
+{
+    UART_PDC_PTCR = (1 << 1);               // Disable reception
+}
+
+static void set_rx_ready(int ready);
+
+//
+// Move received data to read_buffer. Called with the UART interrupt disabled.
+//
+static void _RxPdcFlush(void)
+{
+    U32 pos;
+
+    if (UART_SR & UART_ENDRX_FLAG) {
+        // Current half is full, the PDC went on with the next one
+        uart_rx_block_write(&read_buffer, &_RxPdcBuf[_RxPdcCur][_RxPdcTaken], RX_PDC_SIZE - _RxPdcTaken);
+        // Queue it again after the next one, clears ENDRX
+        UART_PDC_RNPR = (U32)_RxPdcBuf[_RxPdcCur];
+        UART_PDC_RNCR = RX_PDC_SIZE;
+        _RxPdcCur ^= 1;
+        _RxPdcTaken = 0;
+    }
+
+    pos = UART_PDC_RPR - (U32)_RxPdcBuf[_RxPdcCur];
+    if ((pos <= RX_PDC_SIZE) && (pos > _RxPdcTaken)) {
+        uart_rx_block_write(&read_buffer, &_RxPdcBuf[_RxPdcCur][_RxPdcTaken], pos - _RxPdcTaken);
+        _RxPdcTaken = pos;
+    }
+
+    if (circ_buf_count_free(&read_buffer) < RX_READY_MIN_FREE) {
+        set_rx_ready(0);
+    }
+}
+
 static int get_tx_ready()
 {
     if (!_FlowControlEnabled) {
@@ -205,11 +260,11 @@ void UART_IntrDis(void)
     NVIC_DisableIRQ(UART_IRQn);           // Enable USB interrupt
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-void uart_software_flow_control()
+void uart_software_flow_control(uint8_t instance)
 {
     int v;
 
@@ -228,7 +283,7 @@ void uart_software_flow_control()
     }
 }
 
-int32_t uart_initialize(void)
+int32_t uart_initialize(uint8_t instance)
 {
     //
     // Initially, disable UART interrupt
@@ -264,11 +319,12 @@ int32_t uart_initialize(void)
     // Reset all status variables
     //
     _ResetBuffers();
+    _RxPdcStart();
     //
     // Enable UART Tx/Rx interrupts
     //
     UART_IER   = (0)
-                 | (1 <<  0)                  // Enable Rx Interrupt
+                 | (1 <<  3)                  // Enable ENDRx Interrupt
                  | (0 <<  9)                  // Initially disable TxEmpty Interrupt
                  | (0 <<  4)                  // Initially disable ENDTx Interrupt
                  ;
@@ -290,21 +346,22 @@ int32_t uart_initialize(void)
     return 1;  // O.K. ???
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     UART_IntrDis();
     UART_IDR   = (0xFFFFFFFF);              // Disable all interrupts
+    _RxPdcStop();
     _ResetBuffers();
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
-    uart_initialize();
+    uart_initialize(instance);
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     //
     // UART always works with no parity, 1-stop bit
@@ -317,6 +374,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
                  | (1 <<  7)                  // TXDIS: Disable transmitter
                  | (1 <<  8)                  // RSTSTA: Reset status/error bits
                  ;
+    _RxPdcStop();
     _FlowControl = config->FlowControl;
     _SetBaudrate(config->Baudrate);
     UART_CR    = (0)
@@ -329,17 +387,18 @@ int32_t uart_set_configuration(UART_Configuration *config)
                  | (1 <<  8)                  // RSTSTA: Reset status/error bits
                  ;
     UART_IER   = (0)
-                 | (1 <<  0)                  // Enable Rx Interrupt
+                 | (1 <<  3)                  // Enable ENDRx Interrupt
                  | (0 <<  9)                  // Initially disable TxEmpty Interrupt
                  | (0 <<  4)                  // Initially disable ENDTx Interrupt
                  ;
     _ResetBuffers();
+    _RxPdcStart();
     UART_IntrEna();
     return 1;
 }
 
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     config->Baudrate    = _Baudrate;
     config->DataBits    = UART_DATA_BITS_8;
@@ -349,13 +408,13 @@ int32_t uart_get_configuration(UART_Configuration *config)
     return 1;
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
 
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     cortex_int_state_t state;
     uint32_t cnt;
@@ -374,16 +433,21 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
     return cnt;
 }
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     cortex_int_state_t state;
     uint32_t cnt;
 
+    // Take the data of the half block the PDC is filling
+    state = cortex_int_get_and_disable();
+    _RxPdcFlush();
+    cortex_int_restore(state);
+
     cnt = circ_buf_read(&read_buffer, data, size);
 
     // Atomically check if RTS had been asserted, if there is space on the buffer then deassert RTS
     state = cortex_int_get_and_disable();
-    if (circ_buf_count_free(&read_buffer) > RX_OVRF_MSG_SIZE) {
+    if (circ_buf_count_free(&read_buffer) >= RX_READY_MIN_FREE) {
         set_rx_ready(1);
     }
     cortex_int_restore(state);
@@ -391,7 +455,7 @@ int32_t uart_read_data(uint8_t *data, uint16_t size)
     return cnt;
 }
 
-void uart_enable_flow_control(bool enabled)
+void uart_enable_flow_control(uint8_t instance, bool enabled)
 {
     _FlowControlEnabled = (U8)enabled;
 }
@@ -400,7 +464,6 @@ void UART_IRQHandler(void)
 {
     int Status;
     int32_t cnt;
-    U8 data;
     Status = UART_SR;                                 // Examine status register
 
     if (Status & UART_RX_ERR_FLAGS) {                 // In case of error: Set RSTSTA to reset status bits PARE, FRAME, OVRE and RXBRK
@@ -410,27 +473,8 @@ void UART_IRQHandler(void)
     //
     // Handle Rx event
     //
-    if (Status & UART_RXRDY_FLAG) {                   // Data received?
-        data = UART_RHR;
-        cnt = (int32_t)circ_buf_count_free(&read_buffer) - RX_OVRF_MSG_SIZE;
-        if (cnt > 0) {
-            circ_buf_push(&read_buffer, data);
-        } else if (config_get_overflow_detect()) {
-            if (0 == cnt) {
-                circ_buf_write(&read_buffer, (uint8_t*)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-            } else {
-                // Drop newest
-            }
-        } else {
-            // Drop oldest
-            circ_buf_pop(&read_buffer);
-            circ_buf_push(&read_buffer, data);
-        }
-
-        //If this was the last available byte on the buffer then assert RTS
-        if (cnt == 1) {
-            set_rx_ready(0);
-        }
+    if (Status & UART_ENDRX_FLAG) {                   // Half block received?
+        _RxPdcFlush();
     }
 
     //
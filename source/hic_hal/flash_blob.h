@@ -35,6 +35,7 @@ enum {
     kAlgoVerifyReturnsAddress = (1u << 0u),     /*!< Verify function returns address if bit set */
     kAlgoSingleInitType =       (1u << 1u),     /*!< The init function ignores the function code. */
     kAlgoSkipChipErase =        (1u << 2u),     /*!< Skip region when erase.act action triggers. */
+    kAlgoEraseSectorRange =     (1u << 3u),     /*!< EraseSector erases every sector of the byte count in R1 when it is not 0. */
 };
 
 typedef struct __attribute__((__packed__)) {
@@ -56,7 +57,9 @@ typedef struct __attribute__((__packed__)) {
     const uint32_t  algo_size;
     const uint32_t *algo_blob;
     const uint32_t  program_buffer_size;
-    const uint32_t  algo_flags;         /*!< Combination of kAlgoVerifyReturnsAddress, kAlgoSingleInitType and kAlgoSkipChipErase*/
+    const uint32_t  algo_flags;         /*!< Combination of kAlgoVerifyReturnsAddress, kAlgoSingleInitType, kAlgoSkipChipErase and kAlgoEraseSectorRange*/
+    const uint32_t  program_pages;      /*!< Optional, takes the ProgramPage arguments and calls ProgramPage for every page of the program buffer */
+    const uint32_t  program_compressed; /*!< Optional, expands the LZ4 block of R3 bytes at R2 into the program buffer and programs the R1 bytes to R0 */
 } program_target_t;
 
 typedef struct __attribute__((__packed__)) {
@@ -26,14 +26,11 @@
 #include "util.h"
 #include "cortex_m.h"
 #include "circ_buf.h"
-#include "settings.h" // for config_get_overflow_detect
 
 extern uint32_t SystemCoreClock;
 
 static void clear_buffers(void);
 
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
 #define BUFFER_SIZE         (512)
 
 
@@ -49,7 +46,19 @@ void clear_buffers(void)
     circ_buf_init(&read_buffer, read_buffer_data, sizeof(read_buffer_data));
 }
 
-int32_t uart_initialize(void)
+// Interrupt when the receive FIFO is half full, the idle interrupt takes
+// the rest. Only while the receiver is disabled.
+static void rx_fifo_enable(void)
+{
+    uint32_t size = (UART1->PFIFO & UART_PFIFO_RXFIFOSIZE_MASK) >> UART_PFIFO_RXFIFOSIZE_SHIFT;
+    uint32_t depth = size ? (2 << size) : 1;
+
+    UART1->PFIFO |= UART_PFIFO_RXFE_MASK;
+    UART1->CFIFO |= UART_CFIFO_RXFLUSH_MASK;
+    UART1->RWFIFO = (depth > 1) ? (depth / 2) : 1;
+}
+
+int32_t uart_initialize(uint8_t instance)
 {
     NVIC_DisableIRQ(UART1_RX_TX_IRQn);
     // enable clk PORTC
@@ -62,33 +71,34 @@ int32_t uart_initialize(void)
     // transmitter and receiver disabled
     UART1->C2 &= ~(UART_C2_RE_MASK | UART_C2_TE_MASK);
     // disable interrupt
-    UART1->C2 &= ~(UART_C2_RIE_MASK | UART_C2_TIE_MASK);
+    UART1->C2 &= ~(UART_C2_RIE_MASK | UART_C2_ILIE_MASK | UART_C2_TIE_MASK);
     
     clear_buffers();
+    rx_fifo_enable();
 
     // Enable receiver and transmitter
     UART1->C2 |= UART_C2_RE_MASK | UART_C2_TE_MASK;
     // alternate 3: UART1
     PORTC->PCR[3] = (3 << 8);
     PORTC->PCR[4] = (3 << 8);
-    // Enable receive interrupt
-    UART1->C2 |= UART_C2_RIE_MASK;
+    // Enable receive and idle line interrupt
+    UART1->C2 |= UART_C2_RIE_MASK | UART_C2_ILIE_MASK;
     NVIC_ClearPendingIRQ(UART1_RX_TX_IRQn);
     NVIC_EnableIRQ(UART1_RX_TX_IRQn);
     return 1;
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     // transmitter and receiver disabled
     UART1->C2 &= ~(UART_C2_RE_MASK | UART_C2_TE_MASK);
     // disable interrupt
-    UART1->C2 &= ~(UART_C2_RIE_MASK | UART_C2_TIE_MASK);
+    UART1->C2 &= ~(UART_C2_RIE_MASK | UART_C2_ILIE_MASK | UART_C2_TIE_MASK);
     clear_buffers();
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     // disable interrupt
     NVIC_DisableIRQ(UART1_RX_TX_IRQn);
@@ -100,7 +110,7 @@ int32_t uart_reset(void)
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint8_t data_bits = 8;
     uint8_t parity_enable = 0;
@@ -108,10 +118,11 @@ int32_t uart_set_configuration(UART_Configuration *config)
     uint32_t dll;
     // disable interrupt
     NVIC_DisableIRQ(UART1_RX_TX_IRQn);
-    UART1->C2 &= ~(UART_C2_RIE_MASK | UART_C2_TIE_MASK);
+    UART1->C2 &= ~(UART_C2_RIE_MASK | UART_C2_ILIE_MASK | UART_C2_TIE_MASK);
     // Disable receiver and transmitter while updating
     UART1->C2 &= ~(UART_C2_RE_MASK | UART_C2_TE_MASK);
     clear_buffers();
+    rx_fifo_enable();
 
     // set data bits, stop bits, parity
     if ((config->DataBits < 8) || (config->DataBits > 9)) {
@@ -150,25 +161,25 @@ int32_t uart_set_configuration(UART_Configuration *config)
     // Enable UART interrupt
     NVIC_ClearPendingIRQ(UART1_RX_TX_IRQn);
     NVIC_EnableIRQ(UART1_RX_TX_IRQn);
-    UART1->C2 |= UART_C2_RIE_MASK;
+    UART1->C2 |= UART_C2_RIE_MASK | UART_C2_ILIE_MASK;
     return 1;
 }
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     return 1;
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     cortex_int_state_t state;
     uint32_t cnt;
@@ -185,12 +196,12 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
     return cnt;
 }
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     return circ_buf_read(&read_buffer, data, size);
 }
 
-void uart_enable_flow_control(bool enabled)
+void uart_enable_flow_control(uint8_t instance, bool enabled)
 {
     // Flow control not implemented for this platform
 }
@@ -198,6 +209,7 @@ void uart_enable_flow_control(bool enabled)
 void UART1_RX_TX_IRQHandler(void)
 {
     uint32_t s1;
+    uint8_t data;
     volatile uint8_t errorData;
     // read interrupt status
     s1 = UART1->S1;
@@ -205,6 +217,9 @@ void UART1_RX_TX_IRQHandler(void)
     if (!(UART1->C2 & UART_C2_RIE_MASK)) {
         s1 &= ~UART_S1_RDRF_MASK;
     }
+    if (!(UART1->C2 & UART_C2_ILIE_MASK)) {
+        s1 &= ~UART_S1_IDLE_MASK;
+    }
     if (!(UART1->C2 & UART_C2_TIE_MASK)) {
         s1 &= ~UART_S1_TDRE_MASK;
     }
@@ -223,29 +238,27 @@ void UART1_RX_TX_IRQHandler(void)
         }
     }
 
-    // handle received character
-    if (s1 & UART_S1_RDRF_MASK) {
-        if ((s1 & UART_S1_NF_MASK) || (s1 & UART_S1_FE_MASK)) {
-            errorData = UART1->D;
-        } else {
-            uint32_t free;
-            uint8_t data;
-            
+    // handle received data, on the FIFO watermark or when the line goes idle
+    if (s1 & (UART_S1_RDRF_MASK | UART_S1_IDLE_MASK)) {
+        uint8_t block[UART_RX_BLOCK_SIZE];
+        uint32_t cnt = 0;
+
+        while (UART1->RCFIFO && (cnt < sizeof(block))) {
+            // S1 then D clears RDRF and IDLE, errors are for this byte
+            s1 = UART1->S1;
             data = UART1->D;
-            free = circ_buf_count_free(&read_buffer);
-            if (free > RX_OVRF_MSG_SIZE) {
-                circ_buf_push(&read_buffer, data);
-            } else if (config_get_overflow_detect()) {
-                if (RX_OVRF_MSG_SIZE == free) {
-                    circ_buf_write(&read_buffer, (uint8_t*)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-                } else {
-                    // Drop newest
-                }
-            } else {
-                // Drop oldest
-                circ_buf_pop(&read_buffer);
-                circ_buf_push(&read_buffer, data);
+            if (!(s1 & (UART_S1_NF_MASK | UART_S1_FE_MASK))) {
+                block[cnt++] = data;
+            }
+        }
+        if (UART1->S1 & UART_S1_IDLE_MASK) {
+            // Idle with an empty FIFO, the dummy read underflows it
+            errorData = UART1->D;
+            if (UART1->SFIFO & UART_SFIFO_RXUF_MASK) {
+                UART1->CFIFO |= UART_CFIFO_RXFLUSH_MASK;
+                UART1->SFIFO = UART_SFIFO_RXUF_MASK;
             }
         }
+        uart_rx_block_write(&read_buffer, block, cnt);
     }
 }
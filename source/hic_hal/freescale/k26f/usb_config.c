@@ -176,14 +176,14 @@
 #define USBD_HID_WMAXPACKETSIZE     64
 #define USBD_HID_BINTERVAL          1
 #define USBD_HID_HS_ENABLE          1
-#define USBD_HID_HS_WMAXPACKETSIZE  64 //| (2<<11)
+#define USBD_HID_HS_WMAXPACKETSIZE  1024 //| (2<<11)
 #define USBD_HID_HS_BINTERVAL       1
 #define USBD_HID_STRDESC            L"CMSIS-DAP v1"
 #define USBD_WEBUSB_STRDESC         L"WebUSB: CMSIS-DAP"
 #define USBD_HID_INREPORT_NUM       1
 #define USBD_HID_OUTREPORT_NUM      1
-#define USBD_HID_INREPORT_MAX_SZ    64
-#define USBD_HID_OUTREPORT_MAX_SZ   64
+#define USBD_HID_INREPORT_MAX_SZ    1024
+#define USBD_HID_OUTREPORT_MAX_SZ   1024
 #define USBD_HID_FEATREPORT_MAX_SZ  1
 
 //     <e0.0> Mass Storage Device (MSC)
@@ -26,17 +26,28 @@
 #include "cortex_m.h"
 #include "IO_Config.h"
 #include "circ_buf.h"
-#include "settings.h" // for config_get_overflow_detect
 
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
 #define BUFFER_SIZE         (512)
 
+// The UART has no FIFO, received data goes by DMA into a ring. The DMA
+// interrupts every half ring, the UART when the line goes idle.
+#define RX_DMA_CHANNEL      0
+#define RX_DMA_SOURCE       (2 + 2 * UART_NUM)  // UARTn receive
+#define RX_DMA_IRQn         DMA0_IRQn
+#define RX_DMA_IRQHandler   DMA0_IRQHandler
+#define RX_DMA_RING_SIZE    UART_RX_BLOCK_SIZE
+#define RX_DMA_RING_DMOD    3                   // Modulo of 64 bytes
+
+COMPILER_ASSERT(RX_DMA_RING_SIZE == (8 << RX_DMA_RING_DMOD));
+
 circ_buf_t write_buffer;
 uint8_t write_buffer_data[BUFFER_SIZE];
 circ_buf_t read_buffer;
 uint8_t read_buffer_data[BUFFER_SIZE];
 
+static uint8_t __ALIGNED(RX_DMA_RING_SIZE) rx_dma_ring[RX_DMA_RING_SIZE];
+static uint32_t rx_dma_pos;
+
 void clear_buffers(void)
 {
     util_assert(!(UART->C2 & UART_C2_TIE_MASK));
@@ -44,7 +55,54 @@ void clear_buffers(void)
     circ_buf_init(&read_buffer, read_buffer_data, sizeof(read_buffer_data));
 }
 
-int32_t uart_initialize(void)
+static void rx_dma_arm(void)
+{
+    DMA0->DMA[RX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+    DMA0->DMA[RX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(RX_DMA_RING_SIZE / 2);
+    DMA0->DMA[RX_DMA_CHANNEL].DCR |= DMA_DCR_ERQ_MASK;
+}
+
+static void rx_dma_start(void)
+{
+    DMAMUX0->CHCFG[RX_DMA_CHANNEL] = 0;
+    DMA0->DMA[RX_DMA_CHANNEL].SAR = (uint32_t)&UART->D;
+    DMA0->DMA[RX_DMA_CHANNEL].DAR = (uint32_t)rx_dma_ring;
+    DMA0->DMA[RX_DMA_CHANNEL].DCR = DMA_DCR_EINT_MASK | DMA_DCR_CS_MASK | DMA_DCR_SSIZE(1) |
+                                    DMA_DCR_DINC_MASK | DMA_DCR_DSIZE(1) |
+                                    DMA_DCR_DMOD(RX_DMA_RING_DMOD) | DMA_DCR_D_REQ_MASK;
+    rx_dma_pos = 0;
+    rx_dma_arm();
+    DMAMUX0->CHCFG[RX_DMA_CHANNEL] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(RX_DMA_SOURCE);
+
+    // With RDMAS set RIE raises DMA requests instead of interrupts
+    UART->C4 |= UART_C4_RDMAS_MASK;
+    UART->C2 |= UART_C2_RIE_MASK | UART_C2_ILIE_MASK;
+}
+
+static void rx_dma_stop(void)
+{
+    UART->C2 &= ~(UART_C2_RIE_MASK | UART_C2_ILIE_MASK);
+    UART->C4 &= ~UART_C4_RDMAS_MASK;
+    DMAMUX0->CHCFG[RX_DMA_CHANNEL] = 0;
+    DMA0->DMA[RX_DMA_CHANNEL].DCR = 0;
+}
+
+// Move the bytes the DMA wrote since the last call to read_buffer
+static void rx_dma_flush(void)
+{
+    uint32_t pos = DMA0->DMA[RX_DMA_CHANNEL].DAR - (uint32_t)rx_dma_ring;
+
+    if (pos < rx_dma_pos) {
+        uart_rx_block_write(&read_buffer, &rx_dma_ring[rx_dma_pos], RX_DMA_RING_SIZE - rx_dma_pos);
+        rx_dma_pos = 0;
+    }
+    if (pos > rx_dma_pos) {
+        uart_rx_block_write(&read_buffer, &rx_dma_ring[rx_dma_pos], pos - rx_dma_pos);
+        rx_dma_pos = pos;
+    }
+}
+
+int32_t uart_initialize(uint8_t instance)
 {
     NVIC_DisableIRQ(UART_RX_TX_IRQn);
 
@@ -74,10 +132,15 @@ int32_t uart_initialize(void)
         SIM->SCGC4 |= SIM_SCGC4_UART2_MASK;
     }
 
+    // enable clk dma
+    SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+    SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+
     // transmitter and receiver disabled
     UART->C2 &= ~(UART_C2_RE_MASK | UART_C2_TE_MASK);
     // disable interrupt
     UART->C2 &= ~(UART_C2_RIE_MASK | UART_C2_TIE_MASK);
+    rx_dma_stop();
 
     clear_buffers();
 
@@ -86,36 +149,46 @@ int32_t uart_initialize(void)
     UART_PORT->PCR[PIN_UART_TX_BIT] = PORT_PCR_MUX(PIN_UART_TX_MUX_ALT);
     // transmitter and receiver enabled
     UART->C2 |= UART_C2_RE_MASK | UART_C2_TE_MASK;
-    // Enable receive interrupt
-    UART->C2 |= UART_C2_RIE_MASK;
+    // Receive by DMA
+    rx_dma_start();
+    // Same priority for both, they share the DMA ring
+    NVIC_SetPriority(RX_DMA_IRQn, NVIC_GetPriority(UART_RX_TX_IRQn));
     NVIC_ClearPendingIRQ(UART_RX_TX_IRQn);
+    NVIC_ClearPendingIRQ(RX_DMA_IRQn);
     NVIC_EnableIRQ(UART_RX_TX_IRQn);
+    NVIC_EnableIRQ(RX_DMA_IRQn);
     return 1;
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     // transmitter and receiver disabled
     UART->C2 &= ~(UART_C2_RE_MASK | UART_C2_TE_MASK);
     // disable interrupt
     UART->C2 &= ~(UART_C2_RIE_MASK | UART_C2_TIE_MASK);
+    rx_dma_stop();
+    NVIC_DisableIRQ(RX_DMA_IRQn);
     clear_buffers();
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     // disable interrupt
     NVIC_DisableIRQ(UART_RX_TX_IRQn);
+    NVIC_DisableIRQ(RX_DMA_IRQn);
     // disable TIE interrupt
     UART->C2 &= ~(UART_C2_TIE_MASK);
     clear_buffers();
+    // Drop what the DMA has received so far
+    rx_dma_pos = DMA0->DMA[RX_DMA_CHANNEL].DAR - (uint32_t)rx_dma_ring;
     // enable interrupt
+    NVIC_EnableIRQ(RX_DMA_IRQn);
     NVIC_EnableIRQ(UART_RX_TX_IRQn);
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint8_t data_bits = 8;
     uint8_t parity_enable = 0;
@@ -123,9 +196,11 @@ int32_t uart_set_configuration(UART_Configuration *config)
     uint32_t dll;
     // disable interrupt
     NVIC_DisableIRQ(UART_RX_TX_IRQn);
+    NVIC_DisableIRQ(RX_DMA_IRQn);
     UART->C2 &= ~(UART_C2_RIE_MASK | UART_C2_TIE_MASK);
     // Disable receiver and transmitter while updating
     UART->C2 &= ~(UART_C2_RE_MASK | UART_C2_TE_MASK);
+    rx_dma_stop();
     clear_buffers();
 
     // set data bits, stop bits, parity
@@ -169,22 +244,24 @@ int32_t uart_set_configuration(UART_Configuration *config)
     UART->C2 |= UART_C2_RE_MASK | UART_C2_TE_MASK;
     // Enable UART interrupt
     NVIC_ClearPendingIRQ(UART_RX_TX_IRQn);
+    NVIC_ClearPendingIRQ(RX_DMA_IRQn);
     NVIC_EnableIRQ(UART_RX_TX_IRQn);
-    UART->C2 |= UART_C2_RIE_MASK;
+    NVIC_EnableIRQ(RX_DMA_IRQn);
+    rx_dma_start();
     return 1;
 }
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     return 1;
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     cortex_int_state_t state;
     uint32_t cnt;
@@ -201,16 +278,16 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
     return cnt;
 }
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     return circ_buf_read(&read_buffer, data, size);
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-void uart_enable_flow_control(bool enabled)
+void uart_enable_flow_control(uint8_t instance, bool enabled)
 {
     // Flow control not implemented for this platform
 }
@@ -222,8 +299,8 @@ void UART_RX_TX_IRQHandler(void)
     // read interrupt status
     s1 = UART->S1;
     // mask off interrupts that are not enabled
-    if (!(UART->C2 & UART_C2_RIE_MASK)) {
-        s1 &= ~UART_S1_RDRF_MASK;
+    if (!(UART->C2 & UART_C2_ILIE_MASK)) {
+        s1 &= ~UART_S1_IDLE_MASK;
     }
     if (!(UART->C2 & UART_C2_TIE_MASK)) {
         s1 &= ~UART_S1_TDRE_MASK;
@@ -242,29 +319,17 @@ void UART_RX_TX_IRQHandler(void)
         }
     }
 
-    // handle received character
-    if (s1 & UART_S1_RDRF_MASK) {
-        if ((s1 & UART_S1_NF_MASK) || (s1 & UART_S1_FE_MASK)) {
-            errorData = UART->D;
-        } else {
-            uint32_t free;
-            uint8_t data;
-            
-            data = UART1->D;
-            free = circ_buf_count_free(&read_buffer);
-            if (free > RX_OVRF_MSG_SIZE) {
-                circ_buf_push(&read_buffer, data);
-            } else if (config_get_overflow_detect()) {
-                if (RX_OVRF_MSG_SIZE == free) {
-                    circ_buf_write(&read_buffer, (uint8_t*)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-                } else {
-                    // Drop newest
-                }
-            } else {
-                // Drop oldest
-                circ_buf_pop(&read_buffer);
-                circ_buf_push(&read_buffer, data);
-            }
-        }
+    // Line went idle, hand over the rest of the received data
+    if (s1 & UART_S1_IDLE_MASK) {
+        // Reading D after S1 clears idle, the line is quiet so nothing is lost
+        errorData = UART->D;
+        rx_dma_flush();
     }
 }
+
+void RX_DMA_IRQHandler(void)
+{
+    // Half of the ring is in, go on with the other half
+    rx_dma_arm();
+    rx_dma_flush();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file    FlashPrg.c
+ * @brief   Internal flash of the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "FlashPrg.h"
+#include "flash_hal.h"
+#include "daplink_addr.h"
+
+// Bounds of the settings section, see settings_rom.c. It is part of the
+// executable rather than of the mapped flash.
+extern uint8_t __start_cfgrom[];
+extern uint8_t __stop_cfgrom[];
+
+static bool in_range(uint32_t start, uint32_t end, uint32_t addr, uint32_t size)
+{
+    return (addr >= start) && (addr <= end) && (size <= end - addr);
+}
+
+static bool in_rom(uint32_t addr, uint32_t size)
+{
+    return in_range(DAPLINK_ROM_START, DAPLINK_ROM_START + DAPLINK_ROM_SIZE, addr, size);
+}
+
+static bool in_cfgrom(uint32_t addr, uint32_t size)
+{
+    return in_range((uint32_t)__start_cfgrom, (uint32_t)__stop_cfgrom, addr, size);
+}
+
+bool flash_is_readable(uint32_t addr, uint32_t length)
+{
+    return in_rom(addr, length) || in_cfgrom(addr, length);
+}
+
+uint32_t Init(uint32_t adr, uint32_t clk, uint32_t fnc)
+{
+    return 0;
+}
+
+uint32_t UnInit(uint32_t fnc)
+{
+    return 0;
+}
+
+uint32_t EraseSector(uint32_t adr)
+{
+    if (in_cfgrom(adr, 1)) {
+        memset(__start_cfgrom, 0xFF, __stop_cfgrom - __start_cfgrom);
+        return 0;
+    }
+    if (!in_rom(adr, 1) || (adr % DAPLINK_SECTOR_SIZE)) {
+        return 1;
+    }
+    memset((void *)adr, 0xFF, DAPLINK_SECTOR_SIZE);
+    return 0;
+}
+
+uint32_t ProgramPage(uint32_t adr, uint32_t sz, uint32_t *buf)
+{
+    uint8_t *dst = (uint8_t *)adr;
+    const uint8_t *src = (const uint8_t *)buf;
+    uint32_t i;
+
+    if (in_cfgrom(adr, 1)) {
+        // The settings are written with a padded buffer that can extend past
+        // the end of the section
+        if (sz > (uint32_t)__stop_cfgrom - adr) {
+            sz = (uint32_t)__stop_cfgrom - adr;
+        }
+    } else if (!in_rom(adr, sz)) {
+        return 1;
+    }
+    // Programming can only clear bits, like NOR flash
+    for (i = 0; i < sz; i++) {
+        dst[i] &= src[i];
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file    IO_Config.h
+ * @brief   IO configuration for the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __IO_CONFIG_H__
+#define __IO_CONFIG_H__
+
+#include "host_sim.h"
+#include "compiler.h"
+#include "daplink.h"
+#include "swd_sim.h"
+
+// This GPIO configuration is only valid for the host simulation HIC
+COMPILER_ASSERT(DAPLINK_HIC_ID == DAPLINK_HIC_ID_HOST_SIM);
+
+// The debug port pins are routed to the backend in swd_sim.c, there is no
+// pin multiplexing to describe.
+
+#endif
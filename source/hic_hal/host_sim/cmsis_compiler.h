@@ -0,0 +1,164 @@
+/**
+ * @file    cmsis_compiler.h
+ * @brief   CMSIS compiler and core intrinsics for the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Shadows source/cmsis-core/cmsis_compiler.h, the host_sim include directory
+// must come first in the include path.
+
+#ifndef __CMSIS_COMPILER_H
+#define __CMSIS_COMPILER_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __ASM
+#define __ASM                       __asm
+#endif
+#ifndef __INLINE
+#define __INLINE                    inline
+#endif
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE             static inline
+#endif
+#ifndef __STATIC_FORCEINLINE
+#define __STATIC_FORCEINLINE        __attribute__((always_inline)) static inline
+#endif
+#ifndef __NO_RETURN
+#define __NO_RETURN                 __attribute__((__noreturn__))
+#endif
+#ifndef __USED
+#define __USED                      __attribute__((used))
+#endif
+#ifndef __WEAK
+#define __WEAK                      __attribute__((weak))
+#endif
+#ifndef __PACKED
+#define __PACKED                    __attribute__((packed, aligned(1)))
+#endif
+#ifndef __PACKED_STRUCT
+#define __PACKED_STRUCT             struct __attribute__((packed, aligned(1)))
+#endif
+#ifndef __PACKED_UNION
+#define __PACKED_UNION              union __attribute__((packed, aligned(1)))
+#endif
+#ifndef __UNALIGNED_UINT16_READ
+__PACKED_STRUCT T_UINT16_READ { uint16_t v; };
+#define __UNALIGNED_UINT16_READ(addr)       (((const struct T_UINT16_READ *)(const void *)(addr))->v)
+#endif
+#ifndef __UNALIGNED_UINT16_WRITE
+__PACKED_STRUCT T_UINT16_WRITE { uint16_t v; };
+#define __UNALIGNED_UINT16_WRITE(addr, val) (void)((((struct T_UINT16_WRITE *)(void *)(addr))->v) = (val))
+#endif
+#ifndef __UNALIGNED_UINT32_READ
+__PACKED_STRUCT T_UINT32_READ { uint32_t v; };
+#define __UNALIGNED_UINT32_READ(addr)       (((const struct T_UINT32_READ *)(const void *)(addr))->v)
+#endif
+#ifndef __UNALIGNED_UINT32_WRITE
+__PACKED_STRUCT T_UINT32_WRITE { uint32_t v; };
+#define __UNALIGNED_UINT32_WRITE(addr, val) (void)((((struct T_UINT32_WRITE *)(void *)(addr))->v) = (val))
+#endif
+#ifndef __ALIGNED
+#define __ALIGNED(x)                __attribute__((aligned(x)))
+#endif
+#ifndef __RESTRICT
+#define __RESTRICT                  __restrict
+#endif
+#ifndef __COMPILER_BARRIER
+#define __COMPILER_BARRIER()        __asm volatile("" ::: "memory")
+#endif
+
+#define __NOP()                     __COMPILER_BARRIER()
+#define __WFI()                     __COMPILER_BARRIER()
+#define __DSB()                     __sync_synchronize()
+#define __ISB()                     __sync_synchronize()
+#define __DMB()                     __sync_synchronize()
+
+#define __REV(value)                __builtin_bswap32(value)
+#define __REV16(value)              ((uint32_t)(__builtin_bswap16((uint16_t)((value) >> 16)) << 16) | \
+                                     __builtin_bswap16((uint16_t)(value)))
+#define __CLZ(value)                ((value) ? (uint8_t)__builtin_clz(value) : 32U)
+
+// PRIMASK is emulated with a lock shared by all threads. Code running with
+// "interrupts disabled" excludes the threads standing in for interrupt
+// handlers (USB transport, UART receive) the same way it would on a HIC.
+extern pthread_mutex_t host_sim_irq_lock;
+extern __thread uint32_t host_sim_primask;
+extern __thread uint32_t host_sim_ipsr;
+
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)
+{
+    return host_sim_primask;
+}
+
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t primask)
+{
+    if (primask && !host_sim_primask) {
+        pthread_mutex_lock(&host_sim_irq_lock);
+    } else if (!primask && host_sim_primask) {
+        pthread_mutex_unlock(&host_sim_irq_lock);
+    }
+    host_sim_primask = primask ? 1 : 0;
+}
+
+__STATIC_FORCEINLINE void __disable_irq(void)
+{
+    __set_PRIMASK(1);
+}
+
+__STATIC_FORCEINLINE void __enable_irq(void)
+{
+    __set_PRIMASK(0);
+}
+
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)
+{
+    return host_sim_ipsr;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_xPSR(void)
+{
+    return host_sim_ipsr;
+}
+
+// There is no exception stack frame to inspect on the host
+__STATIC_FORCEINLINE uint32_t __get_MSP(void)
+{
+    return 0;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_PSP(void)
+{
+    return 0;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_CONTROL(void)
+{
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMSIS_COMPILER_H */
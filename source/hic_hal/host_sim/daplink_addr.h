@@ -0,0 +1,82 @@
+/**
+ * @file    daplink_addr.h
+ * @brief
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DAPLINK_ADDR_H
+#define DAPLINK_ADDR_H
+
+/* Device sizes */
+
+// The simulated flash is mapped at this fixed address by hic_init.c. The
+// interface itself runs from the host executable, not from this region.
+#define DAPLINK_ROM_START               0x10000000
+#define DAPLINK_ROM_SIZE                0x00040000
+
+// Not backed by memory, only used for the layout checks
+#define DAPLINK_RAM_START               0x20000000
+#define DAPLINK_RAM_SIZE                0x00010000
+
+/* ROM sizes */
+
+#define DAPLINK_ROM_BL_START            0x10000000
+#define DAPLINK_ROM_BL_SIZE             0x00008000
+
+#define DAPLINK_ROM_IF_START            0x10008000
+#define DAPLINK_ROM_IF_SIZE             0x00037000
+
+#define DAPLINK_ROM_CONFIG_USER_START   0x1003F000
+#define DAPLINK_ROM_CONFIG_USER_SIZE    0x00001000
+
+/* RAM sizes */
+
+#define DAPLINK_RAM_APP_START           0x20000000
+#define DAPLINK_RAM_APP_SIZE            0x0000FF00
+
+#define DAPLINK_RAM_SHARED_START        0x2000FF00
+#define DAPLINK_RAM_SHARED_SIZE         0x00000100
+
+/* Flash Programming Info */
+
+#define DAPLINK_SECTOR_SIZE             0x00001000
+#define DAPLINK_MIN_WRITE_SIZE          0x00000100
+
+/* Current build */
+
+#if defined(DAPLINK_BL)
+
+#define DAPLINK_ROM_APP_START            DAPLINK_ROM_BL_START
+#define DAPLINK_ROM_APP_SIZE             DAPLINK_ROM_BL_SIZE
+#define DAPLINK_ROM_UPDATE_START         DAPLINK_ROM_IF_START
+#define DAPLINK_ROM_UPDATE_SIZE          DAPLINK_ROM_IF_SIZE
+
+#elif defined(DAPLINK_IF)
+
+#define DAPLINK_ROM_APP_START            DAPLINK_ROM_IF_START
+#define DAPLINK_ROM_APP_SIZE             DAPLINK_ROM_IF_SIZE
+#define DAPLINK_ROM_UPDATE_START         DAPLINK_ROM_BL_START
+#define DAPLINK_ROM_UPDATE_SIZE          DAPLINK_ROM_BL_SIZE
+
+#else
+
+#error "Build must be either bootloader or interface"
+
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file    gpio.c
+ * @brief   LEDs and buttons of the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DAP_config.h"
+#include "gpio.h"
+
+// LED changes are only logged when DAPLINK_SIM_VERBOSE is set since they
+// toggle every 30ms while USB is busy.
+static bool verbose;
+
+void gpio_init(void)
+{
+    verbose = getenv("DAPLINK_SIM_VERBOSE") != NULL;
+}
+
+void gpio_set_board_power(bool powerEnabled)
+{
+    if (verbose) {
+        fprintf(stderr, "gpio: board power %s\n", powerEnabled ? "on" : "off");
+    }
+}
+
+void gpio_set_hid_led(gpio_led_state_t state)
+{
+    if (verbose) {
+        fprintf(stderr, "gpio: HID LED %s\n", state ? "on" : "off");
+    }
+}
+
+void gpio_set_cdc_led(gpio_led_state_t state)
+{
+    if (verbose) {
+        fprintf(stderr, "gpio: CDC LED %s\n", state ? "on" : "off");
+    }
+}
+
+void gpio_set_msc_led(gpio_led_state_t state)
+{
+    if (verbose) {
+        fprintf(stderr, "gpio: MSC LED %s\n", state ? "on" : "off");
+    }
+}
+
+uint8_t gpio_get_reset_btn_no_fwrd(void)
+{
+    return 0;
+}
+
+uint8_t gpio_get_reset_btn_fwrd(void)
+{
+    return 0;
+}
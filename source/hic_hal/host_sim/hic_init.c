@@ -0,0 +1,129 @@
+/**
+ * @file    hic_init.c
+ * @brief   Process level setup of the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "host_sim.h"
+#include "daplink.h"
+#include "sdk.h"
+
+#ifndef OS_CLOCK
+#error "OS_CLOCK should be defined by the HIC configuration"
+#endif
+
+pthread_mutex_t host_sim_irq_lock = PTHREAD_MUTEX_INITIALIZER;
+__thread uint32_t host_sim_primask;
+__thread uint32_t host_sim_ipsr;
+
+SCB_Type host_sim_scb;
+
+// Only used to compute SWD bit delays
+uint32_t SystemCoreClock = OS_CLOCK;
+
+static int saved_argc;
+static char **saved_argv;
+
+// glibc passes the program arguments to constructors
+__attribute__((constructor)) static void save_args(int argc, char **argv)
+{
+    saved_argc = argc;
+    saved_argv = argv;
+}
+
+void NVIC_SystemReset(void)
+{
+    fflush(NULL);
+    // File descriptors are opened with CLOEXEC so the new image starts clean
+    if (saved_argc > 0) {
+        execv("/proc/self/exe", saved_argv);
+    }
+    perror("host_sim: reset failed");
+    exit(1);
+}
+
+// Map the simulated internal flash. It is backed by the file named by
+// DAPLINK_SIM_FLASH when set, so settings survive a restart.
+static void flash_map(void)
+{
+    const char *path = getenv("DAPLINK_SIM_FLASH");
+    struct stat st;
+    void *rom;
+    int fd = -1;
+    bool blank = true;
+
+    if (path) {
+        fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if ((fd < 0) || (fstat(fd, &st) != 0)) {
+            perror("host_sim: cannot open flash file");
+            exit(1);
+        }
+        blank = st.st_size < DAPLINK_ROM_SIZE;
+        if (blank && (ftruncate(fd, DAPLINK_ROM_SIZE) != 0)) {
+            perror("host_sim: cannot size flash file");
+            exit(1);
+        }
+        rom = mmap((void *)DAPLINK_ROM_START, DAPLINK_ROM_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+    } else {
+        rom = mmap((void *)DAPLINK_ROM_START, DAPLINK_ROM_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    }
+    if (rom != (void *)DAPLINK_ROM_START) {
+        fprintf(stderr, "host_sim: cannot map flash at 0x%08x\n", DAPLINK_ROM_START);
+        exit(1);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    if (blank) {
+        memset(rom, 0xFF, DAPLINK_ROM_SIZE);
+    }
+}
+
+// Leave through exit() so the atexit handlers (statistics) run
+static void stop(int sig)
+{
+    exit(0);
+}
+
+void sdk_init(void)
+{
+    daplink_info_t *info = (daplink_info_t *)(DAPLINK_ROM_IF_START + DAPLINK_INFO_OFFSET);
+
+    flash_map();
+
+    // Stand in for the header the startup file places in the vector table
+    info->build_key = DAPLINK_BUILD_KEY;
+    info->hic_id = DAPLINK_HIC_ID;
+    info->version = DAPLINK_VERSION;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+}
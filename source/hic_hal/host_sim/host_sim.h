@@ -0,0 +1,65 @@
+/**
+ * @file    host_sim.h
+ * @brief   Device header for the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+#include "cmsis_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reported like a Cortex-M3, which has all the fault status registers below
+#define __CORTEX_M                  (3U)
+
+// The parts of the System Control Block that DAPLink touches
+typedef struct {
+    volatile uint32_t VTOR;
+    volatile uint32_t CCR;
+    volatile uint32_t CFSR;
+    volatile uint32_t HFSR;
+    volatile uint32_t DFSR;
+    volatile uint32_t MMFAR;
+    volatile uint32_t BFAR;
+    volatile uint32_t AFSR;
+} SCB_Type;
+
+#define SCB_AIRCR_PRIGROUP_Pos      8U
+#define SCB_AIRCR_PRIGROUP_Msk      (7UL << SCB_AIRCR_PRIGROUP_Pos)
+#define SCB_VTOR_TBLOFF_Pos         7U
+#define SCB_VTOR_TBLOFF_Msk         (0x1FFFFFFUL << SCB_VTOR_TBLOFF_Pos)
+#define SCB_CCR_UNALIGN_TRP_Msk     (1UL << 3)
+
+extern SCB_Type host_sim_scb;
+#define SCB                         (&host_sim_scb)
+
+extern uint32_t SystemCoreClock;
+
+//! @brief Restart the process with the same arguments.
+__NO_RETURN void NVIC_SystemReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file    read_uid.c
+ * @brief   Unique ID of the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include "read_uid.h"
+
+void read_unique_id(uint32_t *id)
+{
+    // Stable for a given machine so the host keeps the same serial number
+    id[0] = (uint32_t)gethostid();
+    id[1] = 0x686F7374;
+    id[2] = 0x73696D00;
+    id[3] = DAPLINK_HIC_ID;
+}
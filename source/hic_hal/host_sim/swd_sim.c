@@ -0,0 +1,85 @@
+/**
+ * @file    swd_sim.c
+ * @brief   Pluggable target side of the simulated SWD pins
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+
+#include "swd_sim.h"
+
+static const swd_sim_backend_t *backend = NULL;
+static uint32_t swdio_out = 1;
+static uint32_t swdio_oe = 0;
+static uint32_t swdio_in = 1;
+static uint32_t nreset = 1;
+static uint64_t clock_count = 0;
+
+void swd_sim_set_backend(const swd_sim_backend_t *new_backend)
+{
+    backend = new_backend;
+    swdio_in = 1;
+}
+
+uint64_t swd_sim_get_clock_count(void)
+{
+    return clock_count;
+}
+
+void swd_sim_clock(void)
+{
+    clock_count++;
+    if (backend) {
+        swdio_in = backend->clock(swdio_out, swdio_oe) & 1;
+    } else {
+        // Nothing connected, SWDIO floats high and every ACK reads as 0b111
+        swdio_in = 1;
+    }
+}
+
+uint32_t swd_sim_swdio_in(void)
+{
+    // The probe reads back its own level while it drives the line
+    return swdio_oe ? swdio_out : swdio_in;
+}
+
+void swd_sim_swdio_out(uint32_t bit)
+{
+    swdio_out = bit & 1;
+}
+
+void swd_sim_swdio_oe(uint32_t enable)
+{
+    swdio_oe = enable ? 1 : 0;
+}
+
+void swd_sim_nreset_out(uint32_t bit)
+{
+    bit &= 1;
+    if (bit != nreset) {
+        nreset = bit;
+        if (backend && backend->set_reset) {
+            backend->set_reset(nreset);
+        }
+    }
+}
+
+uint32_t swd_sim_nreset_in(void)
+{
+    return nreset;
+}
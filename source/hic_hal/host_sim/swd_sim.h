@@ -0,0 +1,65 @@
+/**
+ * @file    swd_sim.h
+ * @brief   Pluggable target side of the simulated SWD pins
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SWD_SIM_H
+#define SWD_SIM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @brief Target connected to the simulated debug port.
+//!
+//! The pin functions in DAP_config.h forward every rising SWCLK edge to the
+//! backend, so the unmodified SW_DP.c bit-banging code is exercised.
+typedef struct {
+    //! @brief SWCLK rising edge.
+    //! @param swdio Level driven by the probe, only valid if @a swdio_oe is set.
+    //! @param swdio_oe Non-zero if the probe drives SWDIO during this cycle.
+    //! @return Level the target drives on SWDIO until the next rising edge.
+    //!     Return 1 while the target is not driving, matching the pull-up.
+    uint32_t (*clock)(uint32_t swdio, uint32_t swdio_oe);
+
+    //! @brief Level of nRESET changed.
+    void (*set_reset)(uint32_t nreset);
+} swd_sim_backend_t;
+
+//! @brief Select the target, NULL disconnects it.
+void swd_sim_set_backend(const swd_sim_backend_t *backend);
+
+//! @brief Count of SWCLK cycles since startup.
+uint64_t swd_sim_get_clock_count(void);
+
+// Pin layer used by DAP_config.h
+void swd_sim_clock(void);
+uint32_t swd_sim_swdio_in(void);
+void swd_sim_swdio_out(uint32_t bit);
+void swd_sim_swdio_oe(uint32_t enable);
+void swd_sim_nreset_out(uint32_t bit);
+uint32_t swd_sim_nreset_in(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
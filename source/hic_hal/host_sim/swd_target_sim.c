@@ -0,0 +1,931 @@
+/**
+ * @file    swd_target_sim.c
+ * @brief   Simulated Cortex-M target behind the host_sim SWD pins
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The model sits below SW_DP.c and sees every SWCLK edge, so the timing of
+// SWD_Transfer() and SWJ_Sequence() is exercised bit by bit:
+// - SW-DP: line reset, IDCODE, ABORT, CTRL/STAT, DLCR, SELECT, RDBUFF and
+//   RESEND, sticky flags, overrun detection and WAIT/FAULT responses.
+// - AHB-AP: CSW, TAR with auto-increment wrapping at 1KB, DRW, BD0-3, IDR
+//   and posted reads.
+// - Core: DHCSR, DCRSR/DCRDR, DEMCR, AIRCR resets with vector catch, DFSR.
+// - Flash that only the flash algorithm can change, with erase and program
+//   latencies in wall-clock time.
+//
+// There is no Thumb emulation. When the core is resumed at one of the entry
+// points of the configured flash algorithm the operation is performed
+// natively, the core keeps running for the configured latency and then halts
+// on the breakpoint held in LR with the result in R0, like a real algorithm.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "swd_target_sim.h"
+#include "swd_sim.h"
+#include "debug_cm.h"
+#include "util.h"
+
+#define NVIC_Addr               (0xe000e000)
+#define DBG_Addr                (0xe000edf0)
+#define DCRSR_REGWnR            (1 << 16)
+
+#define LINE_RESET_BITS         50
+#define JTAG_TO_SWD             0xE79E
+#define AHB_AP_IDR              0x24770011
+#define AHB_AP_BASE             0xE00FF003
+#define TAR_WRAP_MASK           0x3FF
+
+#define PPB_START               0xE0000000
+#define PPB_END                 0xE0100000
+#define PPB_SCRATCH_COUNT       64
+
+#define CORE_REG_COUNT          0x80
+#define REG_PC                  15
+#define REG_XPSR                16
+
+#define DP_STICKY_FLAGS         (STICKYORUN | STICKYCMP | STICKYERR | WDATAERR)
+#define DP_CTRL_WRITABLE        (ORUNDETECT | TRNMODE | MASKLANE | TRNCNT | \
+                                 CDBGRSTREQ | CDBGPWRUPREQ | CSYSPWRUPREQ)
+
+typedef enum {
+    STATE_LINE_RESET,           // Waiting for an idle cycle after a line reset
+    STATE_IDLE,
+    STATE_REQUEST,
+    STATE_RESPONSE,             // Driving ACK and read data
+    STATE_WRITE_TURNAROUND,
+    STATE_WRITE_DATA,
+} swd_state_t;
+
+static swd_target_sim_config_t config;
+static swd_target_sim_stats_t stats;
+static uint8_t *flash;
+static uint8_t *ram;
+
+// Wire protocol
+static swd_state_t state = STATE_LINE_RESET;
+static uint32_t ones;
+static uint32_t select_seq;
+static uint32_t select_count;
+static uint32_t request;
+static uint32_t bit_count;
+static uint64_t out_bits;
+static uint32_t out_count;
+static uint32_t delay;
+static uint32_t write_data;
+static bool write_phase;
+static bool write_pending;
+
+// Debug port and access port
+static uint32_t ctrl_stat;
+static uint32_t dp_select;
+static uint32_t dlcr;
+static uint32_t rdbuff;
+static uint32_t last_read;
+static uint32_t csw;
+static uint32_t tar;
+static uint32_t ap_count;
+static uint32_t access_count;
+
+// Core
+static uint32_t regs[CORE_REG_COUNT];
+static uint32_t dhcsr;
+static uint32_t dcrdr;
+static uint32_t demcr;
+static uint32_t dfsr;
+static uint32_t prigroup;
+static bool halted;
+static bool reset_st;
+static bool in_reset;
+static bool algo_running;
+static uint64_t algo_done_us;
+static uint32_t algo_result;
+static uint32_t algo_return;
+static struct {
+    uint32_t addr;
+    uint32_t value;
+} ppb_scratch[PPB_SCRATCH_COUNT];
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint32_t turnaround(void)
+{
+    return ((dlcr >> 8) & 3) + 1;
+}
+
+static uint8_t *mem_ptr(uint32_t addr, uint32_t size, bool write)
+{
+    if (!write && (addr >= config.flash_start) &&
+            (addr + size <= config.flash_start + config.flash_size)) {
+        return &flash[addr - config.flash_start];
+    }
+    if ((addr >= config.ram_start) && (addr + size <= config.ram_start + config.ram_size)) {
+        return &ram[addr - config.ram_start];
+    }
+    return NULL;
+}
+
+static uint32_t mem_read32(uint32_t addr)
+{
+    uint8_t *p = mem_ptr(addr, 4, false);
+
+    return p ? (p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24)) : 0xFFFFFFFF;
+}
+
+static void core_halt(uint32_t reason)
+{
+    halted = true;
+    algo_running = false;
+    dfsr |= reason;
+}
+
+// Let time pass for a flash operation in progress
+static void core_update(void)
+{
+    if (algo_running && (now_us() >= algo_done_us)) {
+        regs[0] = algo_result;
+        regs[REG_PC] = algo_return & ~1;
+        core_halt(BKPT);
+    }
+}
+
+static void core_reset(void)
+{
+    memset(regs, 0, sizeof(regs));
+    regs[13] = mem_read32(config.flash_start);
+    regs[REG_PC] = mem_read32(config.flash_start + 4) & ~1;
+    regs[REG_XPSR] = 0x01000000;
+    algo_running = false;
+    halted = false;
+    reset_st = true;
+    if ((dhcsr & C_DEBUGEN) && (demcr & VC_CORERESET)) {
+        core_halt(VCATCH);
+    }
+}
+
+// NOR flash only clears bits
+static uint64_t program_flash(uint8_t *dst, const uint8_t *src, uint32_t size)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++) {
+        dst[i] &= src[i];
+    }
+    stats.bytes_programmed += size;
+    return (uint64_t)config.program_page_us * ROUND_UP(size, config.page_size) / config.page_size;
+}
+
+// What the ProgramCompressed routine does with an LZ4 block, returns the
+// size expanded
+static uint32_t expand_lz4(uint8_t *out, uint32_t out_size, const uint8_t *in, uint32_t in_size)
+{
+    uint32_t in_pos = 0;
+    uint32_t out_pos = 0;
+    uint32_t length;
+    uint32_t offset;
+    uint8_t token;
+    uint8_t byte;
+
+    while (in_pos < in_size) {
+        token = in[in_pos++];
+        length = token >> 4;
+        if (15 == length) {
+            do {
+                byte = (in_pos < in_size) ? in[in_pos++] : 0;
+                length += byte;
+            } while (255 == byte);
+        }
+        if ((length > in_size - in_pos) || (length > out_size - out_pos)) {
+            return 0;
+        }
+        memcpy(&out[out_pos], &in[in_pos], length);
+        in_pos += length;
+        out_pos += length;
+        if (in_pos >= in_size) {
+            break;
+        }
+        if (in_size - in_pos < 2) {
+            return 0;
+        }
+        offset = in[in_pos] | (in[in_pos + 1] << 8);
+        in_pos += 2;
+        length = token & 0xF;
+        if (15 == length) {
+            do {
+                byte = (in_pos < in_size) ? in[in_pos++] : 0;
+                length += byte;
+            } while (255 == byte);
+        }
+        length += 4;
+        if ((0 == offset) || (offset > out_pos) || (length > out_size - out_pos)) {
+            return 0;
+        }
+        while (length--) {
+            out[out_pos] = out[out_pos - offset];
+            out_pos++;
+        }
+    }
+    return out_pos;
+}
+
+// Run a flash algorithm entry point, returns false for any other code
+static bool core_run_algo(uint32_t pc)
+{
+    const program_target_t *algo = config.flash_algo;
+    uint32_t addr = regs[0];
+    uint32_t size = regs[1];
+    uint8_t *dst;
+    uint8_t *src;
+    uint8_t *comp;
+    uint64_t busy = 0;
+    uint32_t result = 0;
+    uint32_t i;
+
+    if (NULL == algo) {
+        return false;
+    }
+
+    if ((pc == (algo->init & ~1)) || (pc == (algo->uninit & ~1))) {
+        result = 0;
+    } else if (pc == (algo->erase_chip & ~1)) {
+        memset(flash, 0xFF, config.flash_size);
+        busy = config.erase_chip_us;
+        stats.chip_erases++;
+    } else if (pc == (algo->erase_sector & ~1)) {
+        // R1 is only a sector range with kAlgoEraseSectorRange
+        if (!(algo->algo_flags & kAlgoEraseSectorRange) || (0 == size)) {
+            size = 1;
+        }
+        addr = ROUND_DOWN(addr, config.sector_size);
+        size = ROUND_UP(size, config.sector_size);
+        if ((addr >= config.flash_start) && (size <= config.flash_start + config.flash_size - addr)) {
+            memset(&flash[addr - config.flash_start], 0xFF, size);
+            busy = (uint64_t)config.erase_sector_us * (size / config.sector_size);
+            stats.sectors_erased += size / config.sector_size;
+        } else {
+            result = 1;
+        }
+    } else if ((pc == (algo->program_page & ~1)) ||
+               (algo->program_pages && (pc == (algo->program_pages & ~1)))) {
+        dst = mem_ptr(addr, size, false);
+        src = mem_ptr(regs[2], size, true);
+        // ProgramPage takes a single page, ProgramPages the whole buffer
+        if ((pc == (algo->program_page & ~1)) && (size > config.page_size)) {
+            dst = NULL;
+        }
+        if (dst && src && (dst != src) && (addr >= config.flash_start)) {
+            busy = program_flash(dst, src, size);
+        } else {
+            result = 1;
+        }
+    } else if (algo->program_compressed && (pc == (algo->program_compressed & ~1))) {
+        // The block expands into the program buffer
+        dst = mem_ptr(addr, size, false);
+        src = mem_ptr(algo->program_buffer, size, true);
+        comp = mem_ptr(regs[2], regs[3], true);
+        if (dst && src && comp && (addr >= config.flash_start) &&
+                (expand_lz4(src, size, comp, regs[3]) == size)) {
+            busy = program_flash(dst, src, size);
+        } else {
+            result = 1;
+        }
+    } else if (algo->verify && (pc == (algo->verify & ~1))) {
+        dst = mem_ptr(addr, size, false);
+        src = mem_ptr(regs[2], size, true);
+        result = addr + size;
+        for (i = 0; dst && src && (i < size); i++) {
+            if (dst[i] != src[i]) {
+                result = addr + i;
+                break;
+            }
+        }
+    } else {
+        return false;
+    }
+
+    stats.algo_calls++;
+    stats.busy_us += busy;
+    algo_running = true;
+    algo_done_us = now_us() + busy;
+    algo_result = result;
+    algo_return = regs[14];
+    return true;
+}
+
+static void core_resume(void)
+{
+    halted = false;
+    // Anything but the flash algorithm keeps running until halted again
+    core_run_algo(regs[REG_PC] & ~1);
+}
+
+static uint32_t *ppb_scratch_slot(uint32_t addr)
+{
+    uint32_t i;
+
+    for (i = 0; i < PPB_SCRATCH_COUNT; i++) {
+        if ((ppb_scratch[i].addr == addr) || (0 == ppb_scratch[i].addr)) {
+            ppb_scratch[i].addr = addr;
+            return &ppb_scratch[i].value;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t ppb_read(uint32_t addr)
+{
+    uint32_t *slot;
+    uint32_t value;
+
+    switch (addr) {
+        case DBG_HCSR:
+            core_update();
+            value = (dhcsr & (C_DEBUGEN | C_HALT | C_STEP | C_MASKINTS)) | S_REGRDY;
+            value |= halted ? S_HALT : 0;
+            value |= reset_st ? S_RESET_ST : 0;
+            reset_st = in_reset;
+            return value;
+
+        case DBG_CRDR:
+            return dcrdr;
+
+        case DBG_EMCR:
+            return demcr;
+
+        case NVIC_CPUID:
+            return config.cpuid;
+
+        case NVIC_AIRCR:
+            return 0xFA050000 | prigroup;
+
+        case NVIC_DFSR:
+            return dfsr;
+
+        default:
+            slot = ppb_scratch_slot(addr);
+            return slot ? *slot : 0;
+    }
+}
+
+static void ppb_write(uint32_t addr, uint32_t value)
+{
+    uint32_t *slot;
+    uint32_t sel;
+
+    switch (addr) {
+        case DBG_HCSR:
+            if ((value & 0xFFFF0000) != DBGKEY) {
+                break;
+            }
+            dhcsr = value & (C_DEBUGEN | C_HALT | C_STEP | C_MASKINTS);
+            core_update();
+            if (in_reset) {
+                break;
+            }
+            if ((dhcsr & C_DEBUGEN) && (dhcsr & C_HALT)) {
+                if (!halted) {
+                    core_halt(HALTED);
+                }
+            } else if (halted) {
+                core_resume();
+            }
+            break;
+
+        case DBG_CRSR:
+            sel = value & (CORE_REG_COUNT - 1);
+            if (!halted) {
+                break;
+            }
+            if (value & DCRSR_REGWnR) {
+                regs[sel] = dcrdr;
+            } else {
+                dcrdr = regs[sel];
+            }
+            break;
+
+        case DBG_CRDR:
+            dcrdr = value;
+            break;
+
+        case DBG_EMCR:
+            demcr = value;
+            break;
+
+        case NVIC_AIRCR:
+            if ((value & 0xFFFF0000) != VECTKEY) {
+                break;
+            }
+            prigroup = value & (7 << 8);
+            if (value & (SYSRESETREQ | VECTRESET)) {
+                core_reset();
+            }
+            break;
+
+        case NVIC_DFSR:
+            dfsr &= ~value;
+            break;
+
+        default:
+            slot = ppb_scratch_slot(addr);
+            if (slot) {
+                *slot = value;
+            }
+            break;
+    }
+}
+
+// Bus access of the AHB-AP, returns false on a bus error
+static bool mem_access(uint32_t addr, uint32_t size, uint32_t *data, bool write)
+{
+    uint32_t shift = (addr & 3) * 8;
+    uint32_t mask = (size >= 4) ? 0xFFFFFFFF : (((1u << (size * 8)) - 1) << shift);
+    uint8_t *p;
+    uint32_t word;
+    uint32_t i;
+
+    if (config.fault_every && (0 == (++access_count % config.fault_every))) {
+        return false;
+    }
+
+    if ((addr >= PPB_START) && (addr < PPB_END)) {
+        addr &= ~3;
+        if (write) {
+            ppb_write(addr, *data);
+        } else {
+            *data = ppb_read(addr);
+        }
+        return true;
+    }
+
+    addr &= ~(size - 1);
+    p = mem_ptr(addr & ~3, 4, write);
+    if (NULL == p) {
+        return false;
+    }
+    word = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    if (write) {
+        word = (word & ~mask) | (*data & mask);
+        for (i = 0; i < 4; i++) {
+            p[i] = word >> (i * 8);
+        }
+    } else {
+        *data = word & mask;
+    }
+    return true;
+}
+
+static uint32_t csw_size(void)
+{
+    switch (csw & CSW_SIZE) {
+        case CSW_SIZE8:
+            return 1;
+
+        case CSW_SIZE16:
+            return 2;
+
+        default:
+            return 4;
+    }
+}
+
+static void ap_access(uint32_t addr, uint32_t *data, bool write)
+{
+    uint32_t reg = (dp_select & APBANKSEL) | addr;
+    bool ok = true;
+
+    if ((dp_select & APSEL) != 0) {
+        // Only AP #0 exists
+        if (!write) {
+            *data = 0;
+        }
+        return;
+    }
+
+    switch (reg) {
+        case AP_CSW:
+            if (write) {
+                csw = *data & ~(CSW_DBGSTAT | CSW_TINPROG);
+            } else {
+                *data = csw | CSW_DBGSTAT;
+            }
+            break;
+
+        case AP_TAR:
+            if (write) {
+                tar = *data;
+            } else {
+                *data = tar;
+            }
+            break;
+
+        case AP_DRW:
+            ok = mem_access(tar, csw_size(), data, write);
+            if (ok && (csw & CSW_ADDRINC)) {
+                tar = (tar & ~TAR_WRAP_MASK) | ((tar + csw_size()) & TAR_WRAP_MASK);
+            }
+            break;
+
+        case AP_BD0:
+        case AP_BD1:
+        case AP_BD2:
+        case AP_BD3:
+            ok = mem_access((tar & ~0xF) | (reg & 0xC), 4, data, write);
+            break;
+
+        case AP_ROM:
+            if (!write) {
+                *data = AHB_AP_BASE;
+            }
+            break;
+
+        case AP_IDR:
+            if (!write) {
+                *data = AHB_AP_IDR;
+            }
+            break;
+
+        default:
+            if (!write) {
+                *data = 0;
+            }
+            break;
+    }
+
+    if (!ok) {
+        ctrl_stat |= STICKYERR;
+        if (!write) {
+            *data = 0;
+        }
+    }
+    if (!write) {
+        ctrl_stat = ok ? (ctrl_stat | READOK) : (ctrl_stat & ~READOK);
+    }
+}
+
+static uint32_t dp_read(uint32_t addr)
+{
+    uint32_t value;
+
+    switch (addr) {
+        case DP_IDCODE:
+            return config.idcode;
+
+        case DP_CTRL_STAT:
+            if ((dp_select & 0xF) == 1) {
+                return dlcr;
+            }
+            value = ctrl_stat;
+            value |= (ctrl_stat & CDBGPWRUPREQ) ? CDBGPWRUPACK : 0;
+            value |= (ctrl_stat & CSYSPWRUPREQ) ? CSYSPWRUPACK : 0;
+            value |= (ctrl_stat & CDBGRSTREQ) ? CDBGRSTACK : 0;
+            return value;
+
+        case DP_RESEND:
+            return last_read;
+
+        default:
+            return rdbuff;
+    }
+}
+
+static void dp_write(uint32_t addr, uint32_t value)
+{
+    switch (addr) {
+        case DP_ABORT:
+            ctrl_stat &= ~((value & STKCMPCLR) ? STICKYCMP : 0);
+            ctrl_stat &= ~((value & STKERRCLR) ? STICKYERR : 0);
+            ctrl_stat &= ~((value & WDERRCLR) ? WDATAERR : 0);
+            ctrl_stat &= ~((value & ORUNERRCLR) ? STICKYORUN : 0);
+            break;
+
+        case DP_CTRL_STAT:
+            if ((dp_select & 0xF) == 1) {
+                dlcr = value & 0x300;
+            } else {
+                ctrl_stat = (ctrl_stat & (DP_STICKY_FLAGS | READOK)) | (value & DP_CTRL_WRITABLE);
+            }
+            break;
+
+        case DP_SELECT:
+            dp_select = value;
+            break;
+
+        default:
+            // TARGETSEL is only used by multi-drop targets
+            break;
+    }
+}
+
+// Decode a complete request header and prepare the response
+static void handle_request(void)
+{
+    uint32_t apndp = (request >> 1) & 1;
+    uint32_t rnw = (request >> 2) & 1;
+    uint32_t addr = ((request >> 3) & 3) << 2;
+    uint32_t parity = ((request >> 1) ^ (request >> 2) ^ (request >> 3) ^ (request >> 4)) & 1;
+    uint32_t ack = DAP_TRANSFER_OK;
+    uint32_t data = 0;
+
+    if ((((request >> 5) & 1) != parity) || (request & (1 << 6)) || !(request & (1 << 7))) {
+        // No response, the host sees the line floating high. A line held
+        // high is the start of a line reset rather than a bad request.
+        if (request != 0xFF) {
+            stats.protocol_errors++;
+        }
+        state = STATE_IDLE;
+        return;
+    }
+
+    if (apndp) {
+        if (ctrl_stat & DP_STICKY_FLAGS) {
+            ack = DAP_TRANSFER_FAULT;
+        } else if (config.wait_every && (0 == (++ap_count % config.wait_every))) {
+            ack = DAP_TRANSFER_WAIT;
+            if (ctrl_stat & ORUNDETECT) {
+                ctrl_stat |= STICKYORUN;
+            }
+        } else if (rnw) {
+            // Posted read, the result is returned by the next AP read or RDBUFF
+            data = rdbuff;
+            ap_access(addr, &rdbuff, false);
+            stats.ap_reads++;
+        } else {
+            stats.ap_writes++;
+        }
+    } else if (rnw) {
+        data = dp_read(addr);
+        stats.dp_reads++;
+    } else {
+        stats.dp_writes++;
+    }
+
+    if (DAP_TRANSFER_WAIT == ack) {
+        stats.waits++;
+    } else if (DAP_TRANSFER_FAULT == ack) {
+        stats.faults++;
+    }
+
+    out_bits = ack;
+    out_count = 3;
+    write_phase = false;
+    write_pending = false;
+    if (rnw && ((DAP_TRANSFER_OK == ack) || (ctrl_stat & ORUNDETECT))) {
+        if (DAP_TRANSFER_OK == ack) {
+            last_read = data;
+            out_bits |= (uint64_t)data << 3;
+            out_bits |= (uint64_t)(__builtin_popcount(data) & 1) << 35;
+        }
+        out_count += 33;
+    } else if (!rnw && ((DAP_TRANSFER_OK == ack) || (ctrl_stat & ORUNDETECT))) {
+        write_phase = true;
+        write_pending = (DAP_TRANSFER_OK == ack);
+    }
+    delay = turnaround() - 1;
+    state = STATE_RESPONSE;
+}
+
+static void handle_write(uint32_t parity)
+{
+    uint32_t apndp = (request >> 1) & 1;
+    uint32_t addr = ((request >> 3) & 3) << 2;
+
+    if (!write_pending) {
+        return;
+    }
+    if ((__builtin_popcount(write_data) & 1) != parity) {
+        ctrl_stat |= WDATAERR;
+        return;
+    }
+    if (apndp) {
+        ap_access(addr, &write_data, true);
+    } else {
+        dp_write(addr, write_data);
+    }
+}
+
+static uint32_t target_clock(uint32_t swdio, uint32_t swdio_oe)
+{
+    uint32_t bit;
+
+    if (swdio_oe) {
+        ones = swdio ? (ones + 1) : 0;
+        if (LINE_RESET_BITS == ones) {
+            stats.line_resets++;
+            state = STATE_LINE_RESET;
+            select_seq = 0;
+            select_count = 0;
+            dp_select = 0;
+            return 1;
+        }
+    }
+
+    switch (state) {
+        case STATE_LINE_RESET:
+            // Two idle cycles end the reset, unless they are part of the
+            // JTAG to SWD selection sequence, which is consumed here.
+            if (!swdio_oe || (ones >= LINE_RESET_BITS)) {
+                return 1;
+            }
+            select_seq |= (swdio & 1) << select_count++;
+            if ((16 == select_count) && (JTAG_TO_SWD == select_seq)) {
+                select_seq = 0;
+                select_count = 0;
+            } else if ((select_count >= 2) && !(select_seq >> (select_count - 2)) &&
+                       ((JTAG_TO_SWD & ((1u << select_count) - 1)) != select_seq)) {
+                state = STATE_IDLE;
+            } else if (select_count >= 16) {
+                select_seq = 0;
+                select_count = 0;
+            }
+            return 1;
+
+        case STATE_IDLE:
+            if (swdio_oe && swdio) {
+                request = 1;
+                bit_count = 1;
+                state = STATE_REQUEST;
+            }
+            return 1;
+
+        case STATE_REQUEST:
+            request |= (swdio & 1) << bit_count;
+            if (++bit_count == 8) {
+                handle_request();
+            }
+            return 1;
+
+        case STATE_RESPONSE:
+            if (delay) {
+                delay--;
+                return 1;
+            }
+            bit = out_bits & 1;
+            out_bits >>= 1;
+            if (--out_count == 0) {
+                if (write_phase) {
+                    delay = turnaround() + 1;
+                    state = STATE_WRITE_TURNAROUND;
+                } else {
+                    state = STATE_IDLE;
+                }
+            }
+            return bit;
+
+        case STATE_WRITE_TURNAROUND:
+            if (--delay == 0) {
+                write_data = 0;
+                bit_count = 0;
+                state = STATE_WRITE_DATA;
+            }
+            return 1;
+
+        case STATE_WRITE_DATA:
+            if (bit_count < 32) {
+                write_data |= (swdio & 1) << bit_count++;
+            } else {
+                handle_write(swdio & 1);
+                state = STATE_IDLE;
+            }
+            return 1;
+
+        default:
+            return 1;
+    }
+}
+
+static void target_set_reset(uint32_t nreset)
+{
+    if (!nreset) {
+        in_reset = true;
+        reset_st = true;
+        halted = false;
+        algo_running = false;
+    } else {
+        in_reset = false;
+        core_reset();
+    }
+}
+
+static const swd_sim_backend_t backend = {
+    .clock = target_clock,
+    .set_reset = target_set_reset,
+};
+
+static void override(uint32_t *value, const char *name)
+{
+    const char *env = getenv(name);
+
+    if (env) {
+        *value = strtoul(env, NULL, 0);
+    }
+}
+
+static void print_stats(void)
+{
+    fprintf(stderr, "swd_target_sim: %llu SWCLK cycles, %llu line resets, %llu protocol errors\n"
+            "swd_target_sim: DP %llu reads %llu writes, AP %llu reads %llu writes, %llu WAIT %llu FAULT\n"
+            "swd_target_sim: %llu algo calls, %llu sectors and %llu chip erases, %llu bytes programmed, %llu us busy\n",
+            (unsigned long long)swd_sim_get_clock_count(), (unsigned long long)stats.line_resets,
+            (unsigned long long)stats.protocol_errors, (unsigned long long)stats.dp_reads,
+            (unsigned long long)stats.dp_writes, (unsigned long long)stats.ap_reads,
+            (unsigned long long)stats.ap_writes, (unsigned long long)stats.waits,
+            (unsigned long long)stats.faults, (unsigned long long)stats.algo_calls,
+            (unsigned long long)stats.sectors_erased, (unsigned long long)stats.chip_erases,
+            (unsigned long long)stats.bytes_programmed, (unsigned long long)stats.busy_us);
+}
+
+// Like the HIC flash, the target flash can be kept in a file
+static void flash_map(void)
+{
+    const char *path = getenv("DAPLINK_SIM_TARGET_FLASH");
+    struct stat st;
+    void *mem = MAP_FAILED;
+    bool blank = true;
+    int fd;
+
+    if (path) {
+        fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if ((fd < 0) || (fstat(fd, &st) != 0)) {
+            perror("swd_target_sim: cannot open flash file");
+            exit(1);
+        }
+        blank = st.st_size < config.flash_size;
+        if (blank && (ftruncate(fd, config.flash_size) != 0)) {
+            perror("swd_target_sim: cannot size flash file");
+            exit(1);
+        }
+        mem = mmap(NULL, config.flash_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+    } else {
+        mem = mmap(NULL, config.flash_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (MAP_FAILED == mem) {
+        perror("swd_target_sim: cannot map flash");
+        exit(1);
+    }
+    flash = mem;
+    if (blank) {
+        memset(flash, 0xFF, config.flash_size);
+    }
+}
+
+void swd_target_sim_init(const swd_target_sim_config_t *new_config)
+{
+    config = *new_config;
+    override(&config.erase_sector_us, "DAPLINK_SIM_ERASE_SECTOR_US");
+    override(&config.erase_chip_us, "DAPLINK_SIM_ERASE_CHIP_US");
+    override(&config.program_page_us, "DAPLINK_SIM_PROGRAM_PAGE_US");
+    override(&config.wait_every, "DAPLINK_SIM_WAIT_EVERY");
+    override(&config.fault_every, "DAPLINK_SIM_FAULT_EVERY");
+
+    flash_map();
+    ram = calloc(1, config.ram_size);
+
+    memset(&stats, 0, sizeof(stats));
+    dhcsr = 0;
+    demcr = 0;
+    core_reset();
+    swd_sim_set_backend(&backend);
+
+    if (getenv("DAPLINK_SIM_TARGET_STATS")) {
+        atexit(print_stats);
+    }
+}
+
+const swd_target_sim_stats_t *swd_target_sim_get_stats(void)
+{
+    return &stats;
+}
+
+void swd_target_sim_clear_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,88 @@
+/**
+ * @file    swd_target_sim.h
+ * @brief   Simulated Cortex-M target behind the host_sim SWD pins
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SWD_TARGET_SIM_H
+#define SWD_TARGET_SIM_H
+
+#include <stdint.h>
+#include "flash_blob.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @brief Memory map and timing of the simulated target.
+//!
+//! The latencies and the injection rates can be overridden at runtime with
+//! the DAPLINK_SIM_ERASE_SECTOR_US, DAPLINK_SIM_ERASE_CHIP_US,
+//! DAPLINK_SIM_PROGRAM_PAGE_US, DAPLINK_SIM_WAIT_EVERY and
+//! DAPLINK_SIM_FAULT_EVERY environment variables.
+typedef struct {
+    uint32_t idcode;                //!< SW-DP IDCODE
+    uint32_t cpuid;                 //!< SCB CPUID
+    uint32_t flash_start;
+    uint32_t flash_size;
+    uint32_t sector_size;           //!< Uniform erase sector size
+    uint32_t page_size;             //!< Program latency granularity
+    uint32_t ram_start;
+    uint32_t ram_size;
+    uint32_t erase_sector_us;
+    uint32_t erase_chip_us;
+    uint32_t program_page_us;
+    uint32_t wait_every;            //!< Answer WAIT to every Nth AP access, 0 disables
+    uint32_t fault_every;           //!< Fail every Nth memory access, 0 disables
+    //! Flash algorithm whose entry points are executed natively instead of
+    //! emulating the Thumb code (see swd_target_sim.c).
+    const program_target_t *flash_algo;
+} swd_target_sim_config_t;
+
+//! @brief Counters of the SWD traffic seen by the target.
+typedef struct {
+    uint64_t line_resets;
+    uint64_t protocol_errors;
+    uint64_t dp_reads;
+    uint64_t dp_writes;
+    uint64_t ap_reads;
+    uint64_t ap_writes;
+    uint64_t waits;
+    uint64_t faults;
+    uint64_t algo_calls;
+    uint64_t sectors_erased;
+    uint64_t chip_erases;
+    uint64_t bytes_programmed;
+    uint64_t busy_us;               //!< Time the core spent in flash operations
+} swd_target_sim_stats_t;
+
+//! @brief Power up the target and connect it to the SWD pins.
+//!
+//! Flash starts erased unless it is kept in the file named by
+//! DAPLINK_SIM_TARGET_FLASH. The statistics are printed at exit when
+//! DAPLINK_SIM_TARGET_STATS is set.
+void swd_target_sim_init(const swd_target_sim_config_t *config);
+
+const swd_target_sim_stats_t *swd_target_sim_get_stats(void);
+void swd_target_sim_clear_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * @file    uart.c
+ * @brief   Target UART of the host simulation HIC
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <termios.h>
+
+#include "uart.h"
+#include "util.h"
+#include "cortex_m.h"
+#include "circ_buf.h"
+
+// The target side of each UART is a pseudo terminal. Its name is printed on
+// startup, anything written to it shows up on the CDC port and vice versa.
+
+#define BUFFER_SIZE         (512)
+
+typedef struct {
+    circ_buf_t read_buffer;
+    uint8_t read_buffer_data[BUFFER_SIZE];
+    UART_Configuration configuration;
+    int pty_fd;
+    pthread_t rx_thread;
+    volatile bool enabled;
+} uart_sim_t;
+
+static uart_sim_t uarts[UART_COUNT] = {
+    [0 ... UART_COUNT - 1] = {
+        .configuration = {
+            .Baudrate = 9600,
+            .DataBits = UART_DATA_BITS_8,
+            .Parity = UART_PARITY_NONE,
+            .StopBits = UART_STOP_BITS_1,
+            .FlowControl = UART_FLOW_CONTROL_NONE,
+        },
+        .pty_fd = -1,
+    },
+};
+
+static void clear_buffers(uart_sim_t *uart)
+{
+    circ_buf_init(&uart->read_buffer, uart->read_buffer_data, sizeof(uart->read_buffer_data));
+}
+
+// Plays the part of the receive interrupt
+static void *rx_thread_entry(void *arg)
+{
+    uart_sim_t *uart = arg;
+    struct pollfd pfd = { .fd = uart->pty_fd, .events = POLLIN };
+    uint8_t data[UART_RX_BLOCK_SIZE];
+    ssize_t cnt;
+
+    host_sim_ipsr = 1;
+    while (1) {
+        if ((poll(&pfd, 1, -1) <= 0) || !(pfd.revents & POLLIN)) {
+            // No reader on the other end yet
+            usleep(10000);
+            continue;
+        }
+        // Whatever the pty has, up to a block, like a DMA with idle timeout
+        cnt = read(uart->pty_fd, data, sizeof(data));
+        if ((cnt <= 0) || !uart->enabled) {
+            continue;
+        }
+        uart_rx_block_write(&uart->read_buffer, data, cnt);
+    }
+    return NULL;
+}
+
+static bool pty_open(uint8_t instance)
+{
+    uart_sim_t *uart = &uarts[instance];
+    struct termios tio;
+
+    if (uart->pty_fd >= 0) {
+        return true;
+    }
+
+    uart->pty_fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if ((uart->pty_fd < 0) || (grantpt(uart->pty_fd) != 0) || (unlockpt(uart->pty_fd) != 0)) {
+        perror("host_sim: cannot create the UART pty");
+        return false;
+    }
+
+    // Raw byte stream in both directions
+    if (tcgetattr(uart->pty_fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(uart->pty_fd, TCSANOW, &tio);
+    }
+    fcntl(uart->pty_fd, F_SETFL, fcntl(uart->pty_fd, F_GETFL) | O_NONBLOCK);
+    fprintf(stderr, "host_sim: target UART%d on %s\n", instance, ptsname(uart->pty_fd));
+
+    pthread_create(&uart->rx_thread, NULL, rx_thread_entry, uart);
+    return true;
+}
+
+int32_t uart_initialize(uint8_t instance)
+{
+    uart_sim_t *uart = &uarts[instance];
+
+    clear_buffers(uart);
+    uart->enabled = pty_open(instance);
+    return 1;
+}
+
+int32_t uart_uninitialize(uint8_t instance)
+{
+    uarts[instance].enabled = false;
+    clear_buffers(&uarts[instance]);
+    return 1;
+}
+
+int32_t uart_reset(uint8_t instance)
+{
+    clear_buffers(&uarts[instance]);
+    return 1;
+}
+
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
+{
+    uarts[instance].configuration = *config;
+    clear_buffers(&uarts[instance]);
+    return 1;
+}
+
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
+{
+    *config = uarts[instance].configuration;
+    return 1;
+}
+
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
+{
+}
+
+int32_t uart_write_free(uint8_t instance)
+{
+    return BUFFER_SIZE;
+}
+
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
+{
+    uart_sim_t *uart = &uarts[instance];
+    ssize_t cnt;
+
+    if (!uart->enabled) {
+        return 0;
+    }
+    cnt = write(uart->pty_fd, data, size);
+    // Without a reader the pty fills up, drop the data like an unconnected UART
+    return (cnt < 0) ? size : cnt;
+}
+
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
+{
+    return circ_buf_read(&uarts[instance].read_buffer, data, size);
+}
+
+void uart_enable_flow_control(uint8_t instance, bool enabled)
+{
+    // Flow control not implemented for this platform
+}
@@ -0,0 +1,849 @@
+/**
+ * @file    usbd_host_sim.c
+ * @brief   USB device driver of the host simulation HIC, exported over USB/IP
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The device is served on a USB/IP socket (port 3240 on localhost unless
+// DAPLINK_SIM_USBIP_PORT and DAPLINK_SIM_USBIP_ADDR say otherwise), so the
+// unmodified RL-USB core and classes can be attached to the local machine
+// with "usbip attach -r localhost -b 1-1" or driven by a test client.
+//
+// A socket thread plays the part of the USB controller interrupt: it queues
+// the URBs received from the host and signals USBD_Handler, which runs them
+// against single packet endpoint buffers the same way a controller would.
+// Like on the hardware drivers, USBD_ReadEP and USBD_WriteEP must only be
+// called from the thread that runs USBD_Handler.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "cmsis_compiler.h"
+#include "rl_usb.h"
+#include "usb_lib.h"
+#include "util.h"
+
+#define __NO_USB_LIB_C
+#include "usb_config.c"
+
+#define USBIP_PORT              3240
+#define USBIP_VERSION           0x0111
+#define USBIP_BUSID             "1-1"
+#define USBIP_PATH              "/sys/devices/platform/daplink-host-sim/usb1/1-1"
+#define USBIP_SPEED_FULL        2
+
+// Connection setup
+#define OP_REQ_DEVLIST          0x8005
+#define OP_REP_DEVLIST          0x0005
+#define OP_REQ_IMPORT           0x8003
+#define OP_REP_IMPORT           0x0003
+#define OP_HEADER_SIZE          8
+#define OP_DEVICE_SIZE          312
+#define OP_BUSID_SIZE           32
+
+// URB traffic, all headers are 48 bytes
+#define USBIP_CMD_SUBMIT        1
+#define USBIP_CMD_UNLINK        2
+#define USBIP_RET_SUBMIT        3
+#define USBIP_RET_UNLINK        4
+#define USBIP_HEADER_SIZE       48
+#define USBIP_DIR_OUT           0
+#define USBIP_DIR_IN            1
+
+// Largest URB accepted, Linux splits bigger bulk transfers
+#define URB_MAX_LENGTH          (64 * 1024)
+
+#define EP_COUNT                16
+#define EP_BUF_SIZE             1024
+
+// Events from the socket thread
+#define EVENT_ATTACH            (1 << 0)
+#define EVENT_DETACH            (1 << 1)
+#define EVENT_SOF               (1 << 2)
+
+typedef struct urb {
+    struct urb *next;
+    uint32_t command;
+    uint32_t seqnum;
+    uint32_t generation;
+    uint32_t ep;
+    uint32_t dir;
+    uint32_t number_of_packets;
+    uint32_t unlink_seqnum;
+    uint32_t length;
+    uint32_t actual;
+    uint8_t setup[8];
+    uint8_t data[];
+} urb_t;
+
+typedef struct {
+    urb_t *head;
+    urb_t *tail;
+} urb_queue_t;
+
+typedef struct {
+    uint8_t buf[EP_BUF_SIZE];
+    uint32_t len;
+    uint32_t max_packet;
+    bool full;
+    bool stalled;
+} ep_t;
+
+// Shared with the socket thread
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static urb_queue_t incoming;
+static uint32_t events;
+static uint32_t generation;
+static int client_fd = -1;
+static volatile bool connected;
+static uint32_t frame;
+
+// Only used by the thread running USBD_Handler
+static urb_queue_t control_queue;
+static urb_queue_t out_queue[EP_COUNT];
+static urb_queue_t in_queue[EP_COUNT];
+static ep_t ep_out[EP_COUNT];
+static ep_t ep_in[EP_COUNT];
+static bool in_handler;
+
+static pthread_t server_thread;
+
+static void put_be16(uint8_t *p, uint16_t value)
+{
+    p[0] = value >> 8;
+    p[1] = value;
+}
+
+static void put_be32(uint8_t *p, uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+static uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static bool recv_all(int fd, void *buf, size_t size)
+{
+    uint8_t *p = buf;
+    ssize_t n;
+
+    while (size) {
+        n = recv(fd, p, size, 0);
+        if (n <= 0) {
+            if ((n < 0) && (EINTR == errno)) {
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool send_all(int fd, const void *buf, size_t size)
+{
+    const uint8_t *p = buf;
+    ssize_t n;
+
+    while (size) {
+        n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if ((n < 0) && (EINTR == errno)) {
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static void queue_push(urb_queue_t *queue, urb_t *urb)
+{
+    urb->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = urb;
+    } else {
+        queue->head = urb;
+    }
+    queue->tail = urb;
+}
+
+static urb_t *queue_pop(urb_queue_t *queue)
+{
+    urb_t *urb = queue->head;
+
+    if (urb) {
+        queue->head = urb->next;
+        if (NULL == queue->head) {
+            queue->tail = NULL;
+        }
+    }
+    return urb;
+}
+
+static bool queue_remove(urb_queue_t *queue, uint32_t seqnum)
+{
+    urb_t **link = &queue->head;
+    urb_t *prev = NULL;
+    urb_t *urb;
+
+    while ((urb = *link) != NULL) {
+        if (urb->seqnum == seqnum) {
+            *link = urb->next;
+            if (queue->tail == urb) {
+                queue->tail = prev;
+            }
+            free(urb);
+            return true;
+        }
+        prev = urb;
+        link = &urb->next;
+    }
+    return false;
+}
+
+static void queue_free(urb_queue_t *queue)
+{
+    urb_t *urb;
+
+    while ((urb = queue_pop(queue)) != NULL) {
+        free(urb);
+    }
+}
+
+// Send a reply unless the client that submitted the request has gone
+static void reply(const urb_t *urb, const uint8_t *header, const uint8_t *data, uint32_t size)
+{
+    pthread_mutex_lock(&lock);
+    if ((client_fd >= 0) && (urb->generation == generation)) {
+        if (!send_all(client_fd, header, USBIP_HEADER_SIZE) ||
+                !send_all(client_fd, data, size)) {
+            shutdown(client_fd, SHUT_RDWR);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+static void complete(urb_t *urb, int32_t status)
+{
+    uint8_t header[USBIP_HEADER_SIZE];
+    uint32_t size = 0;
+
+    memset(header, 0, sizeof(header));
+    put_be32(&header[0], USBIP_RET_SUBMIT);
+    put_be32(&header[4], urb->seqnum);
+    put_be32(&header[20], (uint32_t)status);
+    put_be32(&header[24], urb->actual);
+    put_be32(&header[32], urb->number_of_packets);
+
+    if ((USBIP_DIR_IN == urb->dir) && (0 == status)) {
+        size = urb->actual;
+    }
+    reply(urb, header, urb->data, size);
+    free(urb);
+}
+
+static void unlink_urb(urb_t *cmd)
+{
+    uint8_t header[USBIP_HEADER_SIZE];
+    bool found = false;
+    uint32_t i;
+
+    found = queue_remove(&control_queue, cmd->unlink_seqnum);
+    for (i = 0; (i < EP_COUNT) && !found; i++) {
+        found = queue_remove(&out_queue[i], cmd->unlink_seqnum) ||
+                queue_remove(&in_queue[i], cmd->unlink_seqnum);
+    }
+
+    // A request that already completed is reported with status 0
+    memset(header, 0, sizeof(header));
+    put_be32(&header[0], USBIP_RET_UNLINK);
+    put_be32(&header[4], cmd->seqnum);
+    put_be32(&header[20], found ? (uint32_t)-ECONNRESET : 0);
+    reply(cmd, header, NULL, 0);
+    free(cmd);
+}
+
+static void ep_event(uint32_t num, uint32_t event)
+{
+    if (USBD_P_EP[num]) {
+        USBD_P_EP[num](event);
+    }
+}
+
+// Run a whole control transfer: setup, data and status stages
+static void process_control(urb_t *urb)
+{
+    uint32_t max_packet = ep_out[0].max_packet;
+    uint32_t n;
+    bool done = false;
+
+    // A SETUP packet always clears the endpoint 0 stall
+    ep_out[0].stalled = false;
+    ep_in[0].stalled = false;
+    ep_in[0].full = false;
+
+    memcpy(ep_out[0].buf, urb->setup, sizeof(urb->setup));
+    ep_out[0].len = sizeof(urb->setup);
+    ep_out[0].full = true;
+    ep_event(0, USBD_EVT_SETUP);
+
+    if (urb->setup[0] & 0x80) {
+        // Collect IN packets until a short one or the host buffer is full
+        while (!ep_in[0].stalled && ep_in[0].full) {
+            n = MIN(ep_in[0].len, urb->length - urb->actual);
+            memcpy(&urb->data[urb->actual], ep_in[0].buf, n);
+            urb->actual += n;
+            ep_in[0].full = false;
+            if ((ep_in[0].len < max_packet) || (urb->actual >= urb->length)) {
+                done = true;
+                break;
+            }
+            ep_event(0, USBD_EVT_IN);
+        }
+        if (done) {
+            // Status stage
+            ep_out[0].len = 0;
+            ep_out[0].full = true;
+            ep_event(0, USBD_EVT_OUT);
+            ep_out[0].full = false;
+        }
+    } else {
+        while ((urb->actual < urb->length) && !ep_out[0].stalled && !ep_in[0].stalled) {
+            n = MIN(max_packet, urb->length - urb->actual);
+            memcpy(ep_out[0].buf, &urb->data[urb->actual], n);
+            ep_out[0].len = n;
+            ep_out[0].full = true;
+            urb->actual += n;
+            ep_event(0, USBD_EVT_OUT);
+        }
+        // Status stage, the device answers with a zero length packet
+        if (!ep_out[0].stalled && !ep_in[0].stalled && ep_in[0].full) {
+            ep_in[0].full = false;
+            done = true;
+            ep_event(0, USBD_EVT_IN);
+        }
+    }
+
+    complete(urb, done ? 0 : -EPIPE);
+}
+
+// Hand the next OUT packet to the endpoint once the previous one was read
+static bool process_out(uint32_t num)
+{
+    ep_t *ep = &ep_out[num];
+    urb_t *urb = out_queue[num].head;
+    uint32_t n;
+
+    if ((NULL == urb) || ep->full) {
+        return false;
+    }
+    if (ep->stalled) {
+        complete(queue_pop(&out_queue[num]), -EPIPE);
+        return true;
+    }
+
+    n = MIN(ep->max_packet, urb->length - urb->actual);
+    memcpy(ep->buf, &urb->data[urb->actual], n);
+    ep->len = n;
+    ep->full = true;
+    urb->actual += n;
+    if (urb->actual >= urb->length) {
+        complete(queue_pop(&out_queue[num]), 0);
+    }
+    ep_event(num, USBD_EVT_OUT);
+    return true;
+}
+
+// Move a written IN packet to the host once it asks for data
+static bool process_in(uint32_t num)
+{
+    ep_t *ep = &ep_in[num];
+    urb_t *urb = in_queue[num].head;
+    uint32_t n;
+
+    if (NULL == urb) {
+        return false;
+    }
+    if (ep->stalled) {
+        complete(queue_pop(&in_queue[num]), -EPIPE);
+        return true;
+    }
+    if (!ep->full) {
+        return false;
+    }
+
+    n = MIN(ep->len, urb->length - urb->actual);
+    memcpy(&urb->data[urb->actual], ep->buf, n);
+    urb->actual += n;
+    ep->full = false;
+    if ((ep->len < ep->max_packet) || (urb->actual >= urb->length)) {
+        complete(queue_pop(&in_queue[num]), 0);
+    }
+    ep_event(num, USBD_EVT_IN);
+    return true;
+}
+
+static void bus_reset(void)
+{
+    USBD_Reset();
+    usbd_reset_core();
+    if (USBD_P_Reset_Event) {
+        USBD_P_Reset_Event();
+    }
+}
+
+static void flush_queues(void)
+{
+    uint32_t i;
+
+    queue_free(&control_queue);
+    for (i = 0; i < EP_COUNT; i++) {
+        queue_free(&out_queue[i]);
+        queue_free(&in_queue[i]);
+    }
+}
+
+static uint32_t put_device(uint8_t *p)
+{
+    const uint8_t *desc = USBD_DeviceDescriptor;
+
+    memset(p, 0, OP_DEVICE_SIZE);
+    strcpy((char *)&p[0], USBIP_PATH);
+    strcpy((char *)&p[256], USBIP_BUSID);
+    put_be32(&p[288], 1);                                   // busnum
+    put_be32(&p[292], 1);                                   // devnum
+    put_be32(&p[296], USBIP_SPEED_FULL);
+    put_be16(&p[300], desc[8] | (desc[9] << 8));            // idVendor
+    put_be16(&p[302], desc[10] | (desc[11] << 8));          // idProduct
+    put_be16(&p[304], desc[12] | (desc[13] << 8));          // bcdDevice
+    p[306] = desc[4];                                       // bDeviceClass
+    p[307] = desc[5];                                       // bDeviceSubClass
+    p[308] = desc[6];                                       // bDeviceProtocol
+    p[309] = USBD_Configuration;
+    p[310] = desc[17];                                      // bNumConfigurations
+    p[311] = USBD_ConfigDescriptor[4];                      // bNumInterfaces
+    return OP_DEVICE_SIZE;
+}
+
+static void send_devlist(int fd)
+{
+    uint8_t buf[OP_HEADER_SIZE + 4 + OP_DEVICE_SIZE + 4 * 32];
+    const uint8_t *desc = USBD_ConfigDescriptor;
+    uint32_t total = desc[2] | (desc[3] << 8);
+    uint32_t size;
+    uint32_t i;
+
+    memset(buf, 0, sizeof(buf));
+    put_be16(&buf[0], USBIP_VERSION);
+    put_be16(&buf[2], OP_REP_DEVLIST);
+    put_be32(&buf[8], connected ? 1 : 0);
+    size = OP_HEADER_SIZE + 4;
+    if (connected) {
+        size += put_device(&buf[size]);
+        // Class triplet of every interface, alternate settings excluded
+        for (i = 0; (i < total) && (desc[i] != 0); i += desc[i]) {
+            if ((USB_INTERFACE_DESCRIPTOR_TYPE == desc[i + 1]) && (0 == desc[i + 3]) &&
+                    (size + 4 <= sizeof(buf))) {
+                buf[size + 0] = desc[i + 5];
+                buf[size + 1] = desc[i + 6];
+                buf[size + 2] = desc[i + 7];
+                size += 4;
+            }
+        }
+    }
+    send_all(fd, buf, size);
+}
+
+static bool send_import(int fd, const char *busid)
+{
+    uint8_t buf[OP_HEADER_SIZE + OP_DEVICE_SIZE];
+    bool ok = connected && (0 == strncmp(busid, USBIP_BUSID, OP_BUSID_SIZE));
+
+    memset(buf, 0, sizeof(buf));
+    put_be16(&buf[0], USBIP_VERSION);
+    put_be16(&buf[2], OP_REP_IMPORT);
+    put_be32(&buf[4], ok ? 0 : 1);
+    if (!ok) {
+        send_all(fd, buf, OP_HEADER_SIZE);
+        return false;
+    }
+    put_device(&buf[OP_HEADER_SIZE]);
+    return send_all(fd, buf, sizeof(buf));
+}
+
+static void post(urb_t *urb, uint32_t event)
+{
+    pthread_mutex_lock(&lock);
+    if (urb) {
+        urb->generation = generation;
+        queue_push(&incoming, urb);
+    }
+    events |= event;
+    pthread_mutex_unlock(&lock);
+    USBD_SignalHandler();
+}
+
+// Receive URBs from an attached client until it disconnects
+static void serve_urbs(int fd)
+{
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    uint8_t header[USBIP_HEADER_SIZE];
+    urb_t *urb;
+    uint32_t length;
+    uint32_t dir;
+    int ret;
+
+    while (1) {
+        // Start of frame every millisecond, used by the CDC and HID classes
+        ret = poll(&pfd, 1, 1);
+        if (0 == ret) {
+            post(NULL, EVENT_SOF);
+            continue;
+        }
+        if ((ret < 0) || !recv_all(fd, header, sizeof(header))) {
+            break;
+        }
+
+        dir = get_be32(&header[12]);
+        length = 0;
+        if (USBIP_CMD_SUBMIT == get_be32(&header[0])) {
+            length = get_be32(&header[24]);
+            if (length > URB_MAX_LENGTH) {
+                break;
+            }
+        } else if (get_be32(&header[0]) != USBIP_CMD_UNLINK) {
+            break;
+        }
+
+        urb = calloc(1, sizeof(urb_t) + length);
+        if (NULL == urb) {
+            break;
+        }
+        urb->command = get_be32(&header[0]);
+        urb->seqnum = get_be32(&header[4]);
+        urb->dir = dir;
+        urb->ep = get_be32(&header[16]) & 0x0F;
+        urb->length = length;
+        urb->unlink_seqnum = get_be32(&header[20]);
+        urb->number_of_packets = get_be32(&header[32]);
+        memcpy(urb->setup, &header[40], sizeof(urb->setup));
+        if ((USBIP_DIR_OUT == dir) && length && !recv_all(fd, urb->data, length)) {
+            free(urb);
+            break;
+        }
+        post(urb, 0);
+    }
+}
+
+static void *server_thread_entry(void *arg)
+{
+    struct sockaddr_in addr;
+    const char *env;
+    uint8_t header[OP_HEADER_SIZE];
+    char busid[OP_BUSID_SIZE];
+    int listen_fd;
+    int fd;
+    int one = 1;
+
+    // Plays the part of the USB interrupt
+    host_sim_ipsr = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    env = getenv("DAPLINK_SIM_USBIP_PORT");
+    addr.sin_port = htons(env ? atoi(env) : USBIP_PORT);
+    env = getenv("DAPLINK_SIM_USBIP_ADDR");
+    addr.sin_addr.s_addr = inet_addr(env ? env : "127.0.0.1");
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if ((bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+            (listen(listen_fd, 1) != 0)) {
+        perror("host_sim: cannot listen for USB/IP clients");
+        exit(1);
+    }
+    fprintf(stderr, "host_sim: USB/IP server on %s:%u, bus id " USBIP_BUSID "\n",
+            inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+
+    while (1) {
+        fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (recv_all(fd, header, sizeof(header))) {
+            switch (header[2] << 8 | header[3]) {
+                case OP_REQ_DEVLIST:
+                    send_devlist(fd);
+                    break;
+
+                case OP_REQ_IMPORT:
+                    if (!recv_all(fd, busid, sizeof(busid)) || !send_import(fd, busid)) {
+                        break;
+                    }
+                    pthread_mutex_lock(&lock);
+                    client_fd = fd;
+                    pthread_mutex_unlock(&lock);
+                    post(NULL, EVENT_ATTACH);
+
+                    serve_urbs(fd);
+
+                    pthread_mutex_lock(&lock);
+                    client_fd = -1;
+                    generation++;
+                    pthread_mutex_unlock(&lock);
+                    post(NULL, EVENT_DETACH);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+void USBD_Init(void)
+{
+    memset(ep_out, 0, sizeof(ep_out));
+    memset(ep_in, 0, sizeof(ep_in));
+    ep_out[0].max_packet = USBD_MAX_PACKET0;
+    ep_in[0].max_packet = USBD_MAX_PACKET0;
+    pthread_create(&server_thread, NULL, server_thread_entry, NULL);
+}
+
+void USBD_Connect(BOOL con)
+{
+    connected = con;
+    if (!con) {
+        // Unplug: drop the client, it can attach again after reconnecting
+        pthread_mutex_lock(&lock);
+        if (client_fd >= 0) {
+            shutdown(client_fd, SHUT_RDWR);
+        }
+        pthread_mutex_unlock(&lock);
+    }
+}
+
+void USBD_Reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < EP_COUNT; i++) {
+        ep_out[i].full = false;
+        ep_out[i].stalled = false;
+        ep_in[i].full = false;
+        ep_in[i].stalled = false;
+    }
+    ep_out[0].max_packet = USBD_MAX_PACKET0;
+    ep_in[0].max_packet = USBD_MAX_PACKET0;
+}
+
+void USBD_Suspend(void)
+{
+}
+
+void USBD_Resume(void)
+{
+}
+
+void USBD_WakeUp(void)
+{
+}
+
+void USBD_WakeUpCfg(BOOL cfg)
+{
+}
+
+void USBD_SetAddress(U32 adr, U32 setup)
+{
+    // The USB/IP client owns device addressing
+}
+
+void USBD_Configure(BOOL cfg)
+{
+}
+
+void USBD_ConfigEP(USB_ENDPOINT_DESCRIPTOR *pEPD)
+{
+    uint32_t num = pEPD->bEndpointAddress & 0x0F;
+    ep_t *ep = (pEPD->bEndpointAddress & 0x80) ? &ep_in[num] : &ep_out[num];
+
+    ep->max_packet = MIN(pEPD->wMaxPacketSize & 0x7FF, EP_BUF_SIZE);
+}
+
+void USBD_DirCtrlEP(U32 dir)
+{
+}
+
+void USBD_EnableEP(U32 EPNum)
+{
+}
+
+void USBD_DisableEP(U32 EPNum)
+{
+}
+
+void USBD_ResetEP(U32 EPNum)
+{
+    ep_t *ep = (EPNum & 0x80) ? &ep_in[EPNum & 0x0F] : &ep_out[EPNum & 0x0F];
+
+    ep->full = false;
+}
+
+void USBD_SetStallEP(U32 EPNum)
+{
+    ep_t *ep = (EPNum & 0x80) ? &ep_in[EPNum & 0x0F] : &ep_out[EPNum & 0x0F];
+
+    ep->stalled = true;
+}
+
+void USBD_ClrStallEP(U32 EPNum)
+{
+    ep_t *ep = (EPNum & 0x80) ? &ep_in[EPNum & 0x0F] : &ep_out[EPNum & 0x0F];
+
+    ep->stalled = false;
+    USBD_ResetEP(EPNum);
+}
+
+void USBD_ClearEPBuf(U32 EPNum)
+{
+    USBD_ResetEP(EPNum);
+}
+
+U32 USBD_ReadEP(U32 EPNum, U8 *pData, U32 cnt)
+{
+    ep_t *ep = &ep_out[EPNum & 0x0F];
+    uint32_t n;
+
+    if (!ep->full) {
+        return 0;
+    }
+    n = MIN(ep->len, cnt);
+    memcpy(pData, ep->buf, n);
+    ep->full = false;
+
+    // The buffer is free for the next packet
+    if (!in_handler) {
+        USBD_SignalHandler();
+    }
+    return n;
+}
+
+U32 USBD_WriteEP(U32 EPNum, U8 *pData, U32 cnt)
+{
+    ep_t *ep = &ep_in[EPNum & 0x0F];
+
+    cnt = MIN(cnt, EP_BUF_SIZE);
+    if (cnt) {
+        memcpy(ep->buf, pData, cnt);
+    }
+    ep->len = cnt;
+    ep->full = true;
+
+    if (!in_handler) {
+        USBD_SignalHandler();
+    }
+    return cnt;
+}
+
+U32 USBD_GetFrame(void)
+{
+    return frame & 0x7FF;
+}
+
+U32 USBD_GetError(void)
+{
+    return 0;
+}
+
+void USBD_Handler(void)
+{
+    urb_queue_t received;
+    uint32_t pending;
+    urb_t *urb;
+    bool progress;
+    uint32_t i;
+
+    pthread_mutex_lock(&lock);
+    received = incoming;
+    incoming.head = NULL;
+    incoming.tail = NULL;
+    pending = events;
+    events = 0;
+    pthread_mutex_unlock(&lock);
+
+    in_handler = true;
+
+    if (pending & (EVENT_ATTACH | EVENT_DETACH)) {
+        // Requests of a client that has gone are never answered
+        flush_queues();
+        bus_reset();
+    }
+
+    while ((urb = queue_pop(&received)) != NULL) {
+        if (USBIP_CMD_UNLINK == urb->command) {
+            unlink_urb(urb);
+        } else if (0 == urb->ep) {
+            queue_push(&control_queue, urb);
+        } else if (USBIP_DIR_IN == urb->dir) {
+            queue_push(&in_queue[urb->ep], urb);
+        } else {
+            queue_push(&out_queue[urb->ep], urb);
+        }
+    }
+
+    if ((pending & EVENT_SOF) && USBD_P_SOF_Event) {
+        frame++;
+        USBD_P_SOF_Event();
+    }
+
+    do {
+        progress = false;
+        while ((urb = queue_pop(&control_queue)) != NULL) {
+            process_control(urb);
+            progress = true;
+        }
+        for (i = 1; i < EP_COUNT; i++) {
+            progress |= process_out(i);
+            progress |= process_in(i);
+        }
+    } while (progress);
+
+    in_handler = false;
+}
@@ -29,6 +29,10 @@
                      MXC_F_UART_INTFL_RX_PARITY_ERR | \
                      MXC_F_UART_INTFL_RX_FIFO_OVERFLOW)
 
+// Receive interrupt at half of the FIFO, there is no receive timeout so
+// uart_read_data() takes the rest
+#define RX_FIFO_AF_LVL  (MXC_UART_FIFO_DEPTH / 2)
+
 
 // Track bit rate to avoid calculation from bus clock, clock scaler and baud divisor values
 static uint32_t baudrate;
@@ -59,7 +63,7 @@ static void set_bitrate(uint32_t bps)
 }
 
 /******************************************************************************/
-int32_t uart_initialize(void)
+int32_t uart_initialize(uint8_t instance)
 {
     if (MXC_CLKMAN->sys_clk_ctrl_8_uart != MXC_S_CLKMAN_CLK_SCALE_DIV_4) {
         MXC_CLKMAN->sys_clk_ctrl_8_uart = MXC_S_CLKMAN_CLK_SCALE_DIV_4;
@@ -78,9 +82,9 @@ int32_t uart_initialize(void)
     // Set the parity, size, stop and flow configuration
     CdcAcmUart->ctrl |= (MXC_S_UART_CTRL_DATA_SIZE_8_BITS | MXC_S_UART_CTRL_PARITY_DISABLE);
 
-    // Set receive fifo threshold to 0
+    // Set receive fifo threshold
     CdcAcmUart->rx_fifo_ctrl &= ~MXC_F_UART_RX_FIFO_CTRL_FIFO_AF_LVL;
-    CdcAcmUart->rx_fifo_ctrl |= (0 << MXC_F_UART_RX_FIFO_CTRL_FIFO_AF_LVL_POS);
+    CdcAcmUart->rx_fifo_ctrl |= (RX_FIFO_AF_LVL << MXC_F_UART_RX_FIFO_CTRL_FIFO_AF_LVL_POS);
 
     // Enable TX and RX fifos
     CdcAcmUart->ctrl |= (MXC_F_UART_CTRL_RX_FIFO_EN | MXC_F_UART_CTRL_TX_FIFO_EN);
@@ -92,7 +96,7 @@ int32_t uart_initialize(void)
     CdcAcmUart->tx_fifo_ctrl |= (MXC_UART_FIFO_DEPTH - (MXC_UART_FIFO_DEPTH >> 2)) << MXC_F_UART_TX_FIFO_CTRL_FIFO_AE_LVL_POS;
 
     // Enable TX and RX interrupts
-    CdcAcmUart->inten = (MXC_F_UART_INTEN_RX_FIFO_NOT_EMPTY | MXC_F_UART_INTFL_RX_FIFO_OVERFLOW | MXC_F_UART_INTEN_TX_FIFO_AE);
+    CdcAcmUart->inten = (MXC_F_UART_INTEN_RX_FIFO_AF | MXC_F_UART_INTFL_RX_FIFO_OVERFLOW | MXC_F_UART_INTEN_TX_FIFO_AE);
 
     // Enable UART
     CdcAcmUart->ctrl |= MXC_F_UART_CTRL_UART_EN;
@@ -101,7 +105,7 @@ int32_t uart_initialize(void)
 }
 
 /******************************************************************************/
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     // Disable UART
     CdcAcmUart->ctrl &= ~MXC_F_UART_CTRL_UART_EN;
@@ -118,12 +122,12 @@ int32_t uart_uninitialize(void)
 }
 
 /******************************************************************************/
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
 /******************************************************************************/
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     // Clear buffers
     memset(&write_buffer, 0, sizeof(write_buffer));
@@ -133,7 +137,7 @@ int32_t uart_reset(void)
 }
 
 /******************************************************************************/
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint32_t ctrl = 0;
 
@@ -181,7 +185,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
 }
 
 /******************************************************************************/
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint32_t ctrl = 0;
 
@@ -223,13 +227,13 @@ int32_t uart_get_configuration(UART_Configuration *config)
 }
 
 /******************************************************************************/
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return BUFFER_SIZE - (write_buffer.cnt_in - write_buffer.cnt_out);
 }
 
 /******************************************************************************/
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     uint16_t xfer_count = size;
 
@@ -258,10 +262,35 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
 }
 
 /******************************************************************************/
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+// Move what is in the receive FIFO to read_buffer
+static void rx_fifo_drain(void)
+{
+    while ((CdcAcmUart->rx_fifo_ctrl & MXC_F_UART_RX_FIFO_CTRL_FIFO_ENTRY) &&
+         ((read_buffer.cnt_in - read_buffer.cnt_out) < BUFFER_SIZE)) {
+        read_buffer.data[read_buffer.idx_in++] = CdcAcmUartFifo->rx;
+        CdcAcmUart->intfl = MXC_F_UART_INTFL_RX_FIFO_NOT_EMPTY;
+        read_buffer.idx_in &= (BUFFER_SIZE - 1);
+        read_buffer.cnt_in++;
+    }
+    // Mark data left behind in a full buffer
+    if ((CdcAcmUart->rx_fifo_ctrl & MXC_F_UART_RX_FIFO_CTRL_FIFO_ENTRY) &&
+        ((read_buffer.cnt_in - read_buffer.cnt_out) >= BUFFER_SIZE)) {
+        read_buffer.data[read_buffer.idx_in++] = '%';
+        read_buffer.idx_in &= (BUFFER_SIZE - 1);
+        read_buffer.cnt_in++;
+    }
+}
+
+/******************************************************************************/
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     int32_t cnt;
 
+    // Take what is below the FIFO threshold
+    NVIC_DisableIRQ(CdcAcmUartIrqNumber);
+    rx_fifo_drain();
+    NVIC_EnableIRQ(CdcAcmUartIrqNumber);
+
     for (cnt = 0; (cnt < size) && (read_buffer.cnt_in != read_buffer.cnt_out); cnt++) {
         *data++ = read_buffer.data[read_buffer.idx_out++];
         read_buffer.idx_out &= (BUFFER_SIZE - 1);
@@ -285,19 +314,8 @@ void UART0_IRQHandler(void)
             read_buffer.cnt_in++;
     }
 
-    if (intfl & (MXC_F_UART_INTFL_RX_FIFO_NOT_EMPTY | UART_ERRORS)) {
-        while ((CdcAcmUart->rx_fifo_ctrl & MXC_F_UART_RX_FIFO_CTRL_FIFO_ENTRY) &&
-             ((read_buffer.cnt_in - read_buffer.cnt_out) < BUFFER_SIZE)) {
-            read_buffer.data[read_buffer.idx_in++] = CdcAcmUartFifo->rx;
-            CdcAcmUart->intfl = MXC_F_UART_INTFL_RX_FIFO_NOT_EMPTY;
-            read_buffer.idx_in &= (BUFFER_SIZE - 1);
-            read_buffer.cnt_in++;
-        }
-        if (((read_buffer.cnt_in - read_buffer.cnt_out) >= BUFFER_SIZE)) {
-            read_buffer.data[read_buffer.idx_in++] = '%';
-            read_buffer.idx_in &= (BUFFER_SIZE - 1);
-            read_buffer.cnt_in++;
-        }
+    if (intfl & (MXC_F_UART_INTFL_RX_FIFO_AF | UART_ERRORS)) {
+        rx_fifo_drain();
     }
 
     if (intfl & MXC_F_UART_INTFL_TX_FIFO_AE) {
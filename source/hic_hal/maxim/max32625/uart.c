@@ -41,6 +41,10 @@ uint8_t write_buffer_data[BUFFER_SIZE];
 circ_buf_t read_buffer;
 uint8_t read_buffer_data[BUFFER_SIZE];
 
+// Receive interrupt at half of the FIFO, there is no receive timeout so
+// uart_read_data() takes the rest
+#define RX_FIFO_AF_LVL  (MXC_UART_FIFO_DEPTH / 2)
+
 /******************************************************************************/
 static void set_bitrate(uint32_t target_baud)
 {
@@ -145,7 +149,7 @@ int32_t uart_set_instance(uint32_t inst)
 }
 
 /******************************************************************************/
-int32_t uart_initialize(void)
+int32_t uart_initialize(uint8_t instance)
 {
     int idx;
 
@@ -183,9 +187,9 @@ int32_t uart_initialize(void)
     // Set the parity, size, stop and flow configuration
     CdcAcmUart->ctrl |= (MXC_S_UART_CTRL_DATA_SIZE_8_BITS | MXC_S_UART_CTRL_PARITY_DISABLE);
 
-    // Set receive fifo threshold to 0
+    // Set receive fifo threshold
     CdcAcmUart->rx_fifo_ctrl &= ~MXC_F_UART_RX_FIFO_CTRL_FIFO_AF_LVL;
-    CdcAcmUart->rx_fifo_ctrl |= (0 << MXC_F_UART_RX_FIFO_CTRL_FIFO_AF_LVL_POS);
+    CdcAcmUart->rx_fifo_ctrl |= (RX_FIFO_AF_LVL << MXC_F_UART_RX_FIFO_CTRL_FIFO_AF_LVL_POS);
 
     // Enable receive and transmit fifos
     CdcAcmUart->ctrl |= (MXC_F_UART_CTRL_RX_FIFO_EN | MXC_F_UART_CTRL_TX_FIFO_EN);
@@ -198,7 +202,7 @@ int32_t uart_initialize(void)
     CdcAcmUart->tx_fifo_ctrl |= (MXC_UART_FIFO_DEPTH - (MXC_UART_FIFO_DEPTH >> 2)) << MXC_F_UART_TX_FIFO_CTRL_FIFO_AE_LVL_POS;
 
     // Enable RX and TX interrupts
-    CdcAcmUart->inten = (MXC_F_UART_INTEN_RX_FIFO_NOT_EMPTY | MXC_F_UART_INTEN_RX_FIFO_OVERFLOW | MXC_F_UART_INTEN_TX_FIFO_AE);
+    CdcAcmUart->inten = (MXC_F_UART_INTEN_RX_FIFO_AF | MXC_F_UART_INTEN_RX_FIFO_OVERFLOW | MXC_F_UART_INTEN_TX_FIFO_AE);
 
     // Enable UART
     CdcAcmUart->ctrl |= MXC_F_UART_CTRL_UART_EN;
@@ -210,7 +214,7 @@ int32_t uart_initialize(void)
 }
 
 /******************************************************************************/
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     // Disable UART
     CdcAcmUart->ctrl &= ~MXC_F_UART_CTRL_UART_EN;
@@ -227,12 +231,12 @@ int32_t uart_uninitialize(void)
 }
 
 /******************************************************************************/
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
 /******************************************************************************/
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     circ_buf_init(&write_buffer, write_buffer_data, sizeof(write_buffer_data));
     circ_buf_init(&read_buffer, read_buffer_data, sizeof(read_buffer_data));
@@ -241,7 +245,7 @@ int32_t uart_reset(void)
 }
 
 /******************************************************************************/
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint32_t ctrl = 0;
 
@@ -290,7 +294,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
 }
 
 /******************************************************************************/
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint32_t ctrl = 0;
 
@@ -332,7 +336,7 @@ int32_t uart_get_configuration(UART_Configuration *config)
 }
 
 /******************************************************************************/
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     uint32_t cnt;
 
@@ -350,7 +354,7 @@ int32_t uart_write_free(void)
 }
 
 /******************************************************************************/
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     uint16_t xfer_count = size;
     uint16_t written = 0;
@@ -386,7 +390,20 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
 }
 
 /******************************************************************************/
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+// Move what is in the receive FIFO to read_buffer, with the UART IRQ disabled
+static void rx_fifo_drain(void)
+{
+    uint8_t block[MXC_UART_FIFO_DEPTH];
+    uint32_t cnt = 0;
+
+    while ((CdcAcmUart->rx_fifo_ctrl & MXC_F_UART_RX_FIFO_CTRL_FIFO_ENTRY) && (cnt < sizeof(block))) {
+        block[cnt++] = CdcAcmUartFifo->rx;
+    }
+    uart_rx_block_write(&read_buffer, block, cnt);
+}
+
+/******************************************************************************/
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     uint16_t read_count = 0;
 
@@ -394,6 +411,9 @@ int32_t uart_read_data(uint8_t *data, uint16_t size)
      * We read read_buffer.tail (written by ISR) so need protection. */
     NVIC_DisableIRQ(CdcAcmUartIrqNumber);
 
+    // Take what is below the FIFO threshold
+    rx_fifo_drain();
+
     while ((read_count < size) && (read_buffer.head != read_buffer.tail)) {
         data[read_count++] = read_buffer.buf[read_buffer.head];
         uint32_t next_head = read_buffer.head + 1;
@@ -421,19 +441,8 @@ void UART_IRQHandler(void)
         CdcAcmUart->ctrl |= MXC_F_UART_CTRL_RX_FIFO_EN;
     }
 
-    if (intfl & MXC_F_UART_INTFL_RX_FIFO_NOT_EMPTY) {
-        while (CdcAcmUart->rx_fifo_ctrl & MXC_F_UART_RX_FIFO_CTRL_FIFO_ENTRY) {
-            uint32_t next_tail = read_buffer.tail + 1;
-            if (next_tail >= read_buffer.size) {
-                next_tail = 0;
-            }
-            if (next_tail == read_buffer.head) {
-                break;  /* Buffer full */
-            }
-            read_buffer.buf[read_buffer.tail] = CdcAcmUartFifo->rx;
-            read_buffer.tail = next_tail;
-             CdcAcmUart->intfl = MXC_F_UART_INTFL_RX_FIFO_NOT_EMPTY;
-         }
+    if (intfl & MXC_F_UART_INTFL_RX_FIFO_AF) {
+        rx_fifo_drain();
     }
 
     if (intfl & MXC_F_UART_INTFL_TX_FIFO_AE) {
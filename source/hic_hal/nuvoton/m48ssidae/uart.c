@@ -26,11 +26,10 @@
 #include "circ_buf.h"
 #include "NuMicro.h"
 
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
 #define BUFFER_SIZE         (512)
 
 #define TX_FIFO_SIZE        16 /* TX Hardware FIFO size */
+#define RX_TIMEOUT_BITS     20 /* Idle time before the Rx time out, in bits */
 
 circ_buf_t write_buffer;
 uint8_t write_buffer_data[BUFFER_SIZE];
@@ -51,16 +50,19 @@ static void clear_buffers(void)
     circ_buf_init(&read_buffer, read_buffer_data, sizeof(read_buffer_data));
 }
 
-int32_t uart_initialize(void)
+int32_t uart_initialize(uint8_t instance)
 {
     clear_buffers();
     UART_Open(UART0, 115200);
+    /* Interrupt at half of the Rx FIFO, or once the line is idle */
+    UART0->FIFO = (UART0->FIFO & ~UART_FIFO_RFITL_Msk) | UART_FIFO_RFITL_8BYTES;
+    UART_SetTimeoutCnt(UART0, RX_TIMEOUT_BITS);
     UART_ENABLE_INT(UART0, (UART_INTEN_RDAIEN_Msk | UART_INTEN_THREIEN_Msk | UART_INTEN_RXTOIEN_Msk));
     NVIC_EnableIRQ(UART0_IRQn);
     return 1;
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     NVIC_DisableIRQ(UART0_IRQn);
     UART_Close(UART0);
@@ -68,14 +70,14 @@ int32_t uart_uninitialize(void)
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     UART_Configuration backup_configuration = configuration;
-    uart_set_configuration(&backup_configuration);
+    uart_set_configuration(instance, &backup_configuration);
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint32_t u32Reg;
     uint32_t u32Baud_Div;
@@ -136,7 +138,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
     return 1;
 }
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     config->Baudrate = configuration.Baudrate;
     config->DataBits = configuration.DataBits;
@@ -146,16 +148,16 @@ int32_t uart_get_configuration(UART_Configuration *config)
     return 1;
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     uint8_t bInChar;
     uint32_t u32Size = circ_buf_write(&write_buffer, data, size);
@@ -173,7 +175,7 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
     return u32Size;
 }
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     return circ_buf_read(&read_buffer, data, size);
 }
@@ -187,21 +189,15 @@ void UART0_IRQHandler(void)
 
     if ((u32IntStatus & UART_INTSTS_RDAINT_Msk) || (u32IntStatus & UART_INTSTS_RXTOINT_Msk)) {
         /* Receiver FIFO threshold level is reached or Rx time out */
+        uint8_t au8Block[UART_RX_BLOCK_SIZE];
+        uint32_t u32Cnt = 0;
+
         /* Get all the input characters */
-        while ((!UART_GET_RX_EMPTY(UART0))) {
-            /* Get the character from UART Buffer */
-            bInChar = UART_READ(UART0); /* Rx trigger level is 1 byte*/
-            /* Check if buffer full */
-            uint32_t u32Free = circ_buf_count_free(&read_buffer);
-
-            if (u32Free > RX_OVRF_MSG_SIZE) {
-                circ_buf_push(&read_buffer, bInChar);
-            } else if (RX_OVRF_MSG_SIZE == u32Free) {
-                circ_buf_write(&read_buffer, (uint8_t *)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-            } else {
-                // Drop character
-            }
+        while ((!UART_GET_RX_EMPTY(UART0)) && (u32Cnt < sizeof(au8Block))) {
+            au8Block[u32Cnt++] = UART_READ(UART0);
         }
+
+        uart_rx_block_write(&read_buffer, au8Block, u32Cnt);
     }
 
     if (u32IntStatus & UART_INTSTS_THREINT_Msk) {
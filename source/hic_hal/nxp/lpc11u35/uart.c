@@ -23,7 +23,6 @@
 #include "uart.h"
 #include "util.h"
 #include "circ_buf.h"
-#include "settings.h" // for config_get_overflow_detect
 
 static uint32_t baudrate;
 static uint32_t dll;
@@ -31,8 +30,10 @@ static uint32_t tx_in_progress;
 
 extern uint32_t SystemCoreClock;
 
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
+// FIFOs enabled with the RX trigger at 8 characters, anything less is
+// delivered by the character timeout interrupt (CTI) once the line is idle
+#define FCR_FIFO_SETUP      0x81
+#define FCR_FIFO_RESET      0x06
 #define BUFFER_SIZE         (64)
 
 circ_buf_t write_buffer;
@@ -44,7 +45,7 @@ static uint8_t flow_control_enabled = 0;
 
 static int32_t reset(void);
 
-int32_t uart_initialize(void)
+int32_t uart_initialize(uint8_t instance)
 {
     NVIC_DisableIRQ(UART_IRQn);
     LPC_SYSCON->SYSAHBCLKCTRL |= ((1UL <<  6) |   // enable clock for GPIO
@@ -56,8 +57,8 @@ int32_t uart_initialize(void)
     // alternate function USART and PullNone
     LPC_IOCON->PIO0_18 |= 0x01;
     LPC_IOCON->PIO0_19 |= 0x01;
-    // enable FIFOs (trigger level 1) and clear them
-    LPC_USART->FCR = 0x87;
+    // enable FIFOs and clear them
+    LPC_USART->FCR = FCR_FIFO_SETUP | FCR_FIFO_RESET;
     // Transmit Enable
     LPC_USART->TER     = 0x80;
     // reset uart
@@ -68,7 +69,7 @@ int32_t uart_initialize(void)
     return 1;
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     // disable interrupt
     LPC_USART->IER &= ~(0x7);
@@ -78,7 +79,7 @@ int32_t uart_uninitialize(void)
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     // disable interrupt
     NVIC_DisableIRQ(UART_IRQn);
@@ -89,7 +90,7 @@ int32_t uart_reset(void)
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint8_t DivAddVal = 0;
     uint8_t MulVal = 1;
@@ -169,7 +170,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
     return 1;
 }
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     float    br;
     uint32_t lcr;
@@ -260,16 +261,16 @@ int32_t uart_get_configuration(UART_Configuration *config)
     return 1;
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     uint32_t cnt;
 
@@ -287,12 +288,12 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
 }
 
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     return circ_buf_read(&read_buffer, data, size);
 }
 
-void uart_enable_flow_control(bool enabled)
+void uart_enable_flow_control(uint8_t instance, bool enabled)
 {
     flow_control_enabled = (uint8_t)enabled;
 }
@@ -320,26 +321,13 @@ void UART_IRQHandler(void)
     // handle received character
     if (((iir & 0x0E) == 0x04)  ||        // Rx interrupt (RDA)
             ((iir & 0x0E) == 0x0C))  {        // Rx interrupt (CTI)
-        while (LPC_USART->LSR & 0x01) {
-            uint32_t free;
-            uint8_t data;
-            
-            data = LPC_USART->RBR;
-            free = circ_buf_count_free(&read_buffer);
-            if (free > RX_OVRF_MSG_SIZE) {
-                circ_buf_push(&read_buffer, data);
-            } else if (config_get_overflow_detect()) {
-                if (RX_OVRF_MSG_SIZE == free) {
-                    circ_buf_write(&read_buffer, (uint8_t*)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-                } else {
-                    // Drop newest
-                }
-            } else {
-                // Drop oldest
-                circ_buf_pop(&read_buffer);
-                circ_buf_push(&read_buffer, data);
-            }
+        uint8_t block[UART_RX_BLOCK_SIZE];
+        uint32_t cnt = 0;
+
+        while ((LPC_USART->LSR & 0x01) && (cnt < sizeof(block))) {
+            block[cnt++] = LPC_USART->RBR;
         }
+        uart_rx_block_write(&read_buffer, block, cnt);
     }
 
     LPC_USART->LSR;
@@ -349,7 +337,7 @@ static int32_t reset(void)
 {
     uint32_t mcr;
     // Reset FIFOs
-    LPC_USART->FCR = 0x06;
+    LPC_USART->FCR = FCR_FIFO_SETUP | FCR_FIFO_RESET;
     baudrate  = 0;
     dll       = 0;
     tx_in_progress = 0;
@@ -363,7 +351,7 @@ static int32_t reset(void)
 
     // Ensure a clean start, no data in either TX or RX FIFO
     while ((LPC_USART->LSR & ((1 << 5) | (1 << 6))) != ((1 << 5) | (1 << 6))) {
-        LPC_USART->FCR = (1 << 1) | (1 << 2);
+        LPC_USART->FCR = FCR_FIFO_SETUP | FCR_FIFO_RESET;
     }
 
     // Restore previous mode (loopback off)
@@ -25,7 +25,6 @@
 #include "lpc43xx_scu.h"
 #include "util.h"
 #include "circ_buf.h"
-#include "settings.h" // for config_get_overflow_detect
 
 static uint32_t baudrate;
 static uint32_t dll;
@@ -33,8 +32,10 @@ static uint32_t tx_in_progress;
 
 extern uint32_t SystemCoreClock;
 
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
+// FIFOs enabled with the RX trigger at 8 characters, anything less is
+// delivered by the character timeout interrupt (CTI) once the line is idle
+#define FCR_FIFO_SETUP      0x81
+#define FCR_FIFO_RESET      0x06
 #define  BUFFER_SIZE    (512)
 
 circ_buf_t write_buffer;
@@ -54,7 +55,7 @@ static int32_t reset(void);
 #define PIN_UARTCTRL          (1<<PIN_UARTCTRL_IN_BIT)
 
 
-int32_t uart_initialize(void)
+int32_t uart_initialize(uint8_t instance)
 {
     NVIC_DisableIRQ(UART_IRQn);
 
@@ -70,8 +71,8 @@ int32_t uart_initialize(void)
     //   UARTCTRL low:   The LPC1549 gets uart input from the ISP_RX on the pinlist
     LPC_GPIO_PORT->CLR[PORT_UARTCTRL] = PIN_UARTCTRL;
     LPC_GPIO_PORT->DIR[PORT_UARTCTRL] |= (PIN_UARTCTRL);
-    // enable FIFOs (trigger level 1) and clear them
-    LPC_USART->FCR = 0x87;
+    // enable FIFOs and clear them
+    LPC_USART->FCR = FCR_FIFO_SETUP | FCR_FIFO_RESET;
     // Transmit Enable
     LPC_USART->TER     = 0x01;
     // reset uart
@@ -82,7 +83,7 @@ int32_t uart_initialize(void)
     return 1;
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     // disable interrupt
     LPC_USART->IER &= ~(0x7);
@@ -92,7 +93,7 @@ int32_t uart_uninitialize(void)
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     // disable interrupt
     NVIC_DisableIRQ(UART_IRQn);
@@ -103,7 +104,7 @@ int32_t uart_reset(void)
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint8_t DivAddVal = 0;
     uint8_t MulVal = 1;
@@ -171,7 +172,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
     return 1;
 }
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     float    br;
     uint32_t lcr;
@@ -257,16 +258,16 @@ int32_t uart_get_configuration(UART_Configuration *config)
     return 1;
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     uint32_t cnt;
 
@@ -287,12 +288,12 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
 }
 
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     return circ_buf_read(&read_buffer, data, size);
 }
 
-void uart_enable_flow_control(bool enabled)
+void uart_enable_flow_control(uint8_t instance, bool enabled)
 {
     // Flow control not implemented for this platform
 }
@@ -322,26 +323,13 @@ void UART_IRQHandler(void)
     // handle received character
     if (((iir & 0x0E) == 0x04)  ||        // Rx interrupt (RDA)
             ((iir & 0x0E) == 0x0C))  {        // Rx interrupt (CTI)
-        while (LPC_USART->LSR & 0x01) {
-            uint32_t free;
-            uint8_t data;
-
-            data = LPC_USART->RBR;
-            free = circ_buf_count_free(&read_buffer);
-            if (free > RX_OVRF_MSG_SIZE) {
-                circ_buf_push(&read_buffer, data);
-            } else if (config_get_overflow_detect()) {
-                if (RX_OVRF_MSG_SIZE == free) {
-                    circ_buf_write(&read_buffer, (uint8_t*)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-                } else {
-                    // Drop newest
-                }
-            } else {
-                // Drop oldest
-                circ_buf_pop(&read_buffer);
-                circ_buf_push(&read_buffer, data);
-            }
+        uint8_t block[UART_RX_BLOCK_SIZE];
+        uint32_t cnt = 0;
+
+        while ((LPC_USART->LSR & 0x01) && (cnt < sizeof(block))) {
+            block[cnt++] = LPC_USART->RBR;
         }
+        uart_rx_block_write(&read_buffer, block, cnt);
     }
 
     LPC_USART->LSR;
@@ -350,7 +338,7 @@ void UART_IRQHandler(void)
 static int32_t reset(void)
 {
     // Reset FIFOs
-    LPC_USART->FCR = 0x06;
+    LPC_USART->FCR = FCR_FIFO_SETUP | FCR_FIFO_RESET;
     baudrate  = 0;
     dll       = 0;
     tx_in_progress = 0;
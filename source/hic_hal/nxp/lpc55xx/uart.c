@@ -26,7 +26,6 @@
 #include "util.h"
 #include "cortex_m.h"
 #include "circ_buf.h"
-#include "settings.h" // for config_get_overflow_detect
 
 #define USART_INSTANCE (Driver_USART0)
 #define USART_IRQ      (FLEXCOMM0_IRQn)
@@ -35,8 +34,6 @@ extern uint32_t SystemCoreClock;
 
 static void clear_buffers(void);
 
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
 #define BUFFER_SIZE         (512)
 
 circ_buf_t write_buffer;
@@ -49,7 +46,9 @@ struct {
     // ongoing transfer and the uart_handler processed the last transfer.
     volatile uint32_t tx_size;
 
-    uint8_t rx;
+    // Block being received and how much of it is already in read_buffer
+    uint8_t rx[UART_RX_BLOCK_SIZE];
+    uint32_t rx_taken;
 } cb_buf;
 
 void uart_handler(uint32_t event);
@@ -60,7 +59,7 @@ void clear_buffers(void)
     circ_buf_init(&read_buffer, read_buffer_data, sizeof(read_buffer_data));
 }
 
-int32_t uart_initialize(void)
+int32_t uart_initialize(uint8_t instance)
 {
     clear_buffers();
     cb_buf.tx_size = 0;
@@ -70,7 +69,7 @@ int32_t uart_initialize(void)
     return 1;
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     USART_INSTANCE.Control(ARM_USART_CONTROL_RX, 0);
     USART_INSTANCE.Control(ARM_USART_ABORT_RECEIVE, 0U);
@@ -82,7 +81,7 @@ int32_t uart_uninitialize(void)
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     // disable interrupt
     NVIC_DisableIRQ(USART_IRQ);
@@ -97,7 +96,26 @@ int32_t uart_reset(void)
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+// Receive a block at a time. The driver drains the FIFO on each interrupt
+// and reports once the block is full, uart_read_data() takes the bytes of a
+// partial block so they do not wait for the rest.
+static void uart_start_rx_transfer(void)
+{
+    cb_buf.rx_taken = 0;
+    USART_INSTANCE.Receive(cb_buf.rx, sizeof(cb_buf.rx));
+}
+
+// Move the bytes received into the current block to read_buffer, called with
+// the USART interrupt disabled or from the handler
+static void uart_take_rx_data(uint32_t count)
+{
+    if (count > cb_buf.rx_taken) {
+        uart_rx_block_write(&read_buffer, &cb_buf.rx[cb_buf.rx_taken], count - cb_buf.rx_taken);
+        cb_buf.rx_taken = count;
+    }
+}
+
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     uint32_t control = ARM_USART_MODE_ASYNCHRONOUS;
 
@@ -178,7 +196,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
     }
     USART_INSTANCE.Control(ARM_USART_CONTROL_TX, 1);
     USART_INSTANCE.Control(ARM_USART_CONTROL_RX, 1);
-    USART_INSTANCE.Receive(&(cb_buf.rx), 1);
+    uart_start_rx_transfer();
 
     NVIC_ClearPendingIRQ(USART_IRQ);
     NVIC_EnableIRQ(USART_IRQ);
@@ -186,16 +204,16 @@ int32_t uart_set_configuration(UART_Configuration *config)
     return 1;
 }
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     return 1;
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
@@ -219,7 +237,7 @@ static void uart_start_tx_transfer() {
     }
 }
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     if (size == 0) {
         return 0;
@@ -239,22 +257,20 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
     return cnt;
 }
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
+    if (circ_buf_count_used(&read_buffer) < size) {
+        NVIC_DisableIRQ(USART_IRQ);
+        uart_take_rx_data(USART_INSTANCE.GetRxCount());
+        NVIC_EnableIRQ(USART_IRQ);
+    }
     return circ_buf_read(&read_buffer, data, size);
 }
 
 void uart_handler(uint32_t event) {
    if (event & ARM_USART_EVENT_RECEIVE_COMPLETE) {
-        uint32_t free = circ_buf_count_free(&read_buffer);
-        if (free > RX_OVRF_MSG_SIZE) {
-            circ_buf_push(&read_buffer, cb_buf.rx);
-        } else if ((RX_OVRF_MSG_SIZE == free) && config_get_overflow_detect()) {
-            circ_buf_write(&read_buffer, (uint8_t*)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-        } else {
-            // Drop character
-        }
-        USART_INSTANCE.Receive(&(cb_buf.rx), 1);
+        uart_take_rx_data(sizeof(cb_buf.rx));
+        uart_start_rx_transfer();
     }
 
     if (event & ARM_USART_EVENT_SEND_COMPLETE) {
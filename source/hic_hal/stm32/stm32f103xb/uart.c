@@ -35,6 +35,13 @@
 #define CDC_UART_IRQn                USART2_IRQn
 #define CDC_UART_IRQn_Handler        USART2_IRQHandler
 
+// USART2 RX requests go to DMA1 channel 6
+#define CDC_UART_RX_DMA              DMA1_Channel6
+#define CDC_UART_RX_DMA_ENABLE()     __HAL_RCC_DMA1_CLK_ENABLE()
+#define CDC_UART_RX_DMA_IRQn         DMA1_Channel6_IRQn
+#define CDC_UART_RX_DMA_IRQn_Handler DMA1_Channel6_IRQHandler
+#define CDC_UART_RX_DMA_CLEAR()      (DMA1->IFCR = DMA_IFCR_CGIF6)
+
 #define UART_PINS_PORT_ENABLE()      __HAL_RCC_GPIOA_CLK_ENABLE()
 #define UART_PINS_PORT_DISABLE()     __HAL_RCC_GPIOA_CLK_DISABLE()
 
@@ -50,9 +57,6 @@
 #define UART_RTS_PORT                GPIOA
 #define UART_RTS_PIN                 GPIO_PIN_1
 
-
-#define RX_OVRF_MSG         "<DAPLink:Overflow>\n"
-#define RX_OVRF_MSG_SIZE    (sizeof(RX_OVRF_MSG) - 1)
 #define BUFFER_SIZE         (512)
 
 circ_buf_t write_buffer;
@@ -60,6 +64,10 @@ uint8_t write_buffer_data[BUFFER_SIZE];
 circ_buf_t read_buffer;
 uint8_t read_buffer_data[BUFFER_SIZE];
 
+// Circular DMA buffer and how far it has been copied to read_buffer
+static uint8_t rx_dma_data[UART_RX_BLOCK_SIZE];
+static uint32_t rx_dma_pos;
+
 static UART_Configuration configuration = {
     .Baudrate = 9600,
     .DataBits = UART_DATA_BITS_8,
@@ -78,7 +86,45 @@ static void clear_buffers(void)
     circ_buf_init(&read_buffer, read_buffer_data, sizeof(read_buffer_data));
 }
 
-int32_t uart_initialize(void)
+// Receive by DMA, the interrupts come at half and full buffer and when the
+// line goes idle instead of for every byte
+static void rx_dma_start(void)
+{
+    CDC_UART_RX_DMA->CCR = 0;
+    CDC_UART_RX_DMA_CLEAR();
+    CDC_UART_RX_DMA->CPAR = (uint32_t)&CDC_UART->DR;
+    CDC_UART_RX_DMA->CMAR = (uint32_t)rx_dma_data;
+    CDC_UART_RX_DMA->CNDTR = sizeof(rx_dma_data);
+    rx_dma_pos = 0;
+    CDC_UART_RX_DMA->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    CDC_UART->CR3 |= USART_CR3_DMAR;
+    CDC_UART->CR1 |= USART_IT_IDLE;
+}
+
+static void rx_dma_stop(void)
+{
+    CDC_UART->CR1 &= ~USART_IT_IDLE;
+    CDC_UART->CR3 &= ~USART_CR3_DMAR;
+    CDC_UART_RX_DMA->CCR = 0;
+}
+
+// Move the bytes the DMA wrote since the last call to read_buffer
+static void rx_dma_flush(void)
+{
+    uint32_t pos = (sizeof(rx_dma_data) - CDC_UART_RX_DMA->CNDTR) % sizeof(rx_dma_data);
+
+    if (pos < rx_dma_pos) {
+        uart_rx_block_write(&read_buffer, &rx_dma_data[rx_dma_pos], sizeof(rx_dma_data) - rx_dma_pos);
+        rx_dma_pos = 0;
+    }
+    if (pos > rx_dma_pos) {
+        uart_rx_block_write(&read_buffer, &rx_dma_data[rx_dma_pos], pos - rx_dma_pos);
+        rx_dma_pos = pos;
+    }
+}
+
+int32_t uart_initialize(uint8_t instance)
 {
     GPIO_InitTypeDef GPIO_InitStructure;
 
@@ -86,6 +132,7 @@ int32_t uart_initialize(void)
     clear_buffers();
 
     CDC_UART_ENABLE();
+    CDC_UART_RX_DMA_ENABLE();
     UART_PINS_PORT_ENABLE();
 
     //TX pin
@@ -113,27 +160,33 @@ int32_t uart_initialize(void)
     HAL_GPIO_Init(UART_RTS_PORT, &GPIO_InitStructure);
 
     NVIC_EnableIRQ(CDC_UART_IRQn);
+    NVIC_EnableIRQ(CDC_UART_RX_DMA_IRQn);
 
     return 1;
 }
 
-int32_t uart_uninitialize(void)
+int32_t uart_uninitialize(uint8_t instance)
 {
     CDC_UART->CR1 &= ~(USART_IT_TXE | USART_IT_RXNE);
+    rx_dma_stop();
     clear_buffers();
     return 1;
 }
 
-int32_t uart_reset(void)
+int32_t uart_reset(uint8_t instance)
 {
     const uint32_t cr1 = CDC_UART->CR1;
-    CDC_UART->CR1 = cr1 & ~(USART_IT_TXE | USART_IT_RXNE);
+    CDC_UART->CR1 = cr1 & ~(USART_IT_TXE | USART_IT_IDLE);
+    NVIC_DisableIRQ(CDC_UART_RX_DMA_IRQn);
     clear_buffers();
+    // Drop what the DMA has received so far
+    rx_dma_pos = (sizeof(rx_dma_data) - CDC_UART_RX_DMA->CNDTR) % sizeof(rx_dma_data);
+    NVIC_EnableIRQ(CDC_UART_RX_DMA_IRQn);
     CDC_UART->CR1 = cr1 & ~USART_IT_TXE;
     return 1;
 }
 
-int32_t uart_set_configuration(UART_Configuration *config)
+int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config)
 {
     UART_HandleTypeDef uart_handle;
     HAL_StatusTypeDef status;
@@ -189,6 +242,7 @@ int32_t uart_set_configuration(UART_Configuration *config)
     
     // Disable uart and tx/rx interrupt
     CDC_UART->CR1 &= ~(USART_IT_TXE | USART_IT_RXNE);
+    rx_dma_stop();
 
     clear_buffers();
 
@@ -198,12 +252,12 @@ int32_t uart_set_configuration(UART_Configuration *config)
     util_assert(HAL_OK == status);
     (void)status;
 
-    CDC_UART->CR1 |= USART_IT_RXNE;
+    rx_dma_start();
 
     return 1;
 }
 
-int32_t uart_get_configuration(UART_Configuration *config)
+int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config)
 {
     config->Baudrate = configuration.Baudrate;
     config->DataBits = configuration.DataBits;
@@ -214,16 +268,16 @@ int32_t uart_get_configuration(UART_Configuration *config)
     return 1;
 }
 
-void uart_set_control_line_state(uint16_t ctrl_bmp)
+void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp)
 {
 }
 
-int32_t uart_write_free(void)
+int32_t uart_write_free(uint8_t instance)
 {
     return circ_buf_count_free(&write_buffer);
 }
 
-int32_t uart_write_data(uint8_t *data, uint16_t size)
+int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     uint32_t cnt = circ_buf_write(&write_buffer, data, size);
     CDC_UART->CR1 |= USART_IT_TXE;
@@ -231,7 +285,7 @@ int32_t uart_write_data(uint8_t *data, uint16_t size)
     return cnt;
 }
 
-int32_t uart_read_data(uint8_t *data, uint16_t size)
+int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size)
 {
     return circ_buf_read(&read_buffer, data, size);
 }
@@ -240,16 +294,10 @@ void CDC_UART_IRQn_Handler(void)
 {
     const uint32_t sr = CDC_UART->SR;
 
-    if (sr & USART_SR_RXNE) {
-        uint8_t dat = CDC_UART->DR;
-        uint32_t free = circ_buf_count_free(&read_buffer);
-        if (free > RX_OVRF_MSG_SIZE) {
-            circ_buf_push(&read_buffer, dat);
-        } else if (RX_OVRF_MSG_SIZE == free) {
-            circ_buf_write(&read_buffer, (uint8_t*)RX_OVRF_MSG, RX_OVRF_MSG_SIZE);
-        } else {
-            // Drop character
-        }
+    if ((sr & USART_SR_IDLE) && (CDC_UART->CR1 & USART_IT_IDLE)) {
+        // Cleared by reading SR then DR, the data itself went to the DMA
+        (void)CDC_UART->DR;
+        rx_dma_flush();
     }
 
     if (sr & USART_SR_TXE) {
@@ -260,3 +308,9 @@ void CDC_UART_IRQn_Handler(void)
         }
     }
 }
+
+void CDC_UART_RX_DMA_IRQn_Handler(void)
+{
+    CDC_UART_RX_DMA_CLEAR();
+    rx_dma_flush();
+}
@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "circ_buf.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -74,18 +75,38 @@ typedef struct {
  * FUNCTION PROTOTYPES
  *----------------------------------------------------------------------------*/
 
+/* Number of UARTs of the HIC. The functions below take the UART instance,
+   0 to UART_COUNT - 1, as first argument. HICs with a single UART ignore it. */
+#ifndef UART_COUNT
+#define UART_COUNT 1
+#endif
+
 /* UART driver function prototypes */
-extern int32_t uart_initialize(void);
-extern int32_t uart_uninitialize(void);
-extern int32_t uart_reset(void);
-extern int32_t uart_set_configuration(UART_Configuration *config);
-extern int32_t uart_get_configuration(UART_Configuration *config);
-extern int32_t uart_write_free(void);
-extern int32_t uart_write_data(uint8_t *data, uint16_t size);
-extern int32_t uart_read_data(uint8_t *data, uint16_t size);
-extern void uart_set_control_line_state(uint16_t ctrl_bmp);
-extern void uart_software_flow_control(void);
-extern void uart_enable_flow_control(bool enabled);
+extern int32_t uart_initialize(uint8_t instance);
+extern int32_t uart_uninitialize(uint8_t instance);
+extern int32_t uart_reset(uint8_t instance);
+extern int32_t uart_set_configuration(uint8_t instance, UART_Configuration *config);
+extern int32_t uart_get_configuration(uint8_t instance, UART_Configuration *config);
+extern int32_t uart_write_free(uint8_t instance);
+extern int32_t uart_write_data(uint8_t instance, uint8_t *data, uint16_t size);
+extern int32_t uart_read_data(uint8_t instance, uint8_t *data, uint16_t size);
+extern void uart_set_control_line_state(uint8_t instance, uint16_t ctrl_bmp);
+extern void uart_software_flow_control(uint8_t instance);
+extern void uart_enable_flow_control(uint8_t instance, bool enabled);
+
+/* Receive in blocks. Drivers collect received data by DMA or in the receive
+   FIFO and hand it over a block at a time, when half of UART_RX_BLOCK_SIZE is
+   in or the line has gone idle, instead of taking an interrupt per byte.
+   Without a hardware idle timeout, uart_read_data() takes what is there. */
+#ifndef UART_RX_BLOCK_SIZE
+#define UART_RX_BLOCK_SIZE 64
+#endif
+
+/* Append a received block to the read buffer of a driver. When it is full,
+   the newest data is dropped and an overflow message inserted if overflow
+   detection is on, otherwise the oldest data is dropped. Returns the number
+   of bytes of the block stored. */
+extern uint32_t uart_rx_block_write(circ_buf_t *read_buffer, const uint8_t *data, uint32_t size);
 
 #ifdef __cplusplus
 }
@@ -31,11 +31,14 @@ static uint64_t stk_main_task [MAIN_TASK_STACK / sizeof(uint64_t)];
 #define TIMER_TASK_STACK        (136)
 static uint64_t stk_timer_task[TIMER_TASK_STACK / sizeof(uint64_t)];
 
+#define MUTEX_COUNT             (3)
+
 static uint32_t taskCount = 0; 
 static osTimerFunc_t onlyTimerFunction = NULL;
 static uint32_t timerTick = 0;
 
-static OS_MUT onlyMutex;
+static OS_MUT mutexes[MUTEX_COUNT];
+static uint32_t mutexCount = 0;
 
 osStatus_t osKernelInitialize(void)
 {
@@ -50,6 +53,11 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
     if (taskCount == 0) {
         os_sys_init_user((void (*)(void))func, MAIN_TASK_PRIORITY, stk_main_task, MAIN_TASK_STACK);
     }
+    else if (attr && attr->stack_mem) {
+        // One RTX priority level per CMSIS-RTOS2 level below or above normal
+        U8 priority = MAIN_TASK_PRIORITY + ((int32_t)attr->priority - osPriorityNormal) / 8;
+        tid = os_tsk_create_user((void (*)(void))func, priority, attr->stack_mem, attr->stack_size);
+    }
     else {
         tid = os_tsk_create((void (*)(void))func, MAIN_TASK_PRIORITY+1);
     }
@@ -107,13 +115,22 @@ uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
 
 osMutexId_t osMutexNew(const osMutexAttr_t *attr)
 {
-    os_mut_init(onlyMutex);
-    return (osMutexId_t)onlyMutex;
+    OS_ID mutex;
+
+    // RTX mutexes are always recursive and inherit priority
+    if (mutexCount >= MUTEX_COUNT) {
+        return NULL;
+    }
+    mutex = mutexes[mutexCount++];
+    os_mut_init(mutex);
+    return (osMutexId_t)mutex;
 }
 
 osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
 {
-    os_mut_wait((OS_ID)mutex_id, timeout);
+    if (os_mut_wait((OS_ID)mutex_id, timeout) == OS_R_TMO) {
+        return (0 == timeout) ? osErrorResource : osErrorTimeout;
+    }
     return osOK;
 }
 
@@ -139,3 +156,13 @@ uint32_t osKernelGetSysTimerCount(void)
     return os_time_get();
 }
 
+
+uint32_t osKernelGetTickCount(void)
+{
+    return os_time_get();
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+    return OS_TICK_FREQ;
+}
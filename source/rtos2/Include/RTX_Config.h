@@ -247,14 +247,14 @@
 //   <e>Object specific Memory allocation
 //   <i> Enables object specific memory allocation.
 #ifndef OS_MUTEX_OBJ_MEM
-#define OS_MUTEX_OBJ_MEM            0
+#define OS_MUTEX_OBJ_MEM            1 // DAPLINK. Default was: 0
 #endif
 
 //     <o>Number of Mutex objects <1-1000>
 //     <i> Defines maximum number of objects that can be active at the same time.
 //     <i> Applies to objects with system provided memory for control blocks.
 #ifndef OS_MUTEX_NUM
-#define OS_MUTEX_NUM                1
+#define OS_MUTEX_NUM                3 // DAPLINK. Default was: 1
 #endif
 
 //   </e>
@@ -87,3 +87,13 @@ osThreadId_t osThreadGetId (void)
 {
     return (osThreadId_t)1;
 }
+
+uint32_t osKernelGetTickCount(void)
+{
+    return sysTickTime();
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+    return 1000000 / OS_TICK;
+}
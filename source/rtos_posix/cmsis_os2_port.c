@@ -0,0 +1,411 @@
+/**
+ * @file    cmsis_os2_port.c
+ * @brief   CMSIS-RTOS2 subset used by DAPLink, implemented with POSIX threads
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdbool.h>
+
+#include "cmsis_os2.h"
+
+#ifndef OS_TICK_FREQ
+#error "OS_TICK_FREQ should be defined by RTOS configuration"
+#endif
+
+#define OS_MAX_THREADS      8
+#define OS_MAX_TIMERS       4
+#define OS_MAX_MUTEXES      8
+
+// DAPLink casts addresses of buffers on the stack to uint32_t, so thread
+// stacks are statically allocated to keep them in the low 4 GB along with
+// the rest of the image.
+#define OS_STACK_SIZE       (256 * 1024)
+
+#define NS_PER_TICK         (1000000000ULL / OS_TICK_FREQ)
+
+typedef struct {
+    pthread_t handle;
+    pthread_cond_t cond;
+    osThreadFunc_t func;
+    void *argument;
+    uint32_t flags;
+} os_thread_t;
+
+typedef struct {
+    osTimerFunc_t func;
+    void *argument;
+    osTimerType_t type;
+    uint32_t period;
+    uint32_t next;
+    bool running;
+} os_timer_t;
+
+static os_thread_t threads[OS_MAX_THREADS];
+static uint32_t thread_count;
+static uint64_t thread_stacks[OS_MAX_THREADS][OS_STACK_SIZE / sizeof(uint64_t)];
+static __thread os_thread_t *thread_self;
+
+static os_timer_t timers[OS_MAX_TIMERS];
+static uint32_t timer_count;
+
+static pthread_mutex_t mutexes[OS_MAX_MUTEXES];
+static uint32_t mutex_count;
+
+// Protects thread flags, timers and kernel state
+static pthread_mutex_t kernel_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t kernel_started_cond = PTHREAD_COND_INITIALIZER;
+static bool kernel_started;
+static struct timespec kernel_start_time;
+
+static uint64_t elapsed_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - kernel_start_time.tv_sec) * 1000000000ULL +
+           (uint64_t)now.tv_nsec - (uint64_t)kernel_start_time.tv_nsec;
+}
+
+static void ticks_to_deadline(uint32_t ticks, struct timespec *deadline)
+{
+    uint64_t ns;
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    ns = (uint64_t)deadline->tv_nsec + (uint64_t)ticks * NS_PER_TICK;
+    deadline->tv_sec += ns / 1000000000ULL;
+    deadline->tv_nsec = ns % 1000000000ULL;
+}
+
+static void *thread_entry(void *argument)
+{
+    os_thread_t *thread = (os_thread_t *)argument;
+
+    thread_self = thread;
+
+    // Threads only run once the kernel has been started, like on RTX
+    pthread_mutex_lock(&kernel_lock);
+    while (!kernel_started) {
+        pthread_cond_wait(&kernel_started_cond, &kernel_lock);
+    }
+    pthread_mutex_unlock(&kernel_lock);
+
+    thread->func(thread->argument);
+    return NULL;
+}
+
+// Runs timer callbacks, like the RTX timer thread
+static void *timer_thread(void *argument)
+{
+    struct timespec next;
+    uint32_t tick;
+    uint32_t i;
+    os_timer_t *timer;
+    osTimerFunc_t func;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (1) {
+        next.tv_nsec += NS_PER_TICK;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR) {
+        }
+        tick = osKernelGetTickCount();
+
+        for (i = 0; i < timer_count; i++) {
+            timer = &timers[i];
+            func = NULL;
+
+            pthread_mutex_lock(&kernel_lock);
+            if (timer->running && ((int32_t)(tick - timer->next) >= 0)) {
+                func = timer->func;
+                if (osTimerPeriodic == timer->type) {
+                    timer->next += timer->period;
+                } else {
+                    timer->running = false;
+                }
+            }
+            pthread_mutex_unlock(&kernel_lock);
+
+            if (func) {
+                func(timer->argument);
+            }
+        }
+    }
+    return NULL;
+}
+
+osStatus_t osKernelInitialize(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &kernel_start_time);
+    return osOK;
+}
+
+osStatus_t osKernelStart(void)
+{
+    pthread_t handle;
+
+    pthread_create(&handle, NULL, timer_thread, NULL);
+
+    pthread_mutex_lock(&kernel_lock);
+    kernel_started = true;
+    pthread_cond_broadcast(&kernel_started_cond);
+    pthread_mutex_unlock(&kernel_lock);
+
+    // The calling context is not a thread on RTX either
+    while (1) {
+        pause();
+    }
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+    return (uint32_t)(elapsed_ns() / NS_PER_TICK);
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+    return OS_TICK_FREQ;
+}
+
+// Same resolution as the tick, matching the legacy RTX port
+uint32_t osKernelGetSysTimerCount(void)
+{
+    return osKernelGetTickCount();
+}
+
+uint32_t osKernelGetSysTimerFreq(void)
+{
+    return OS_TICK_FREQ;
+}
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+    os_thread_t *thread;
+    pthread_attr_t pattr;
+
+    pthread_mutex_lock(&kernel_lock);
+    if (thread_count >= OS_MAX_THREADS) {
+        pthread_mutex_unlock(&kernel_lock);
+        return NULL;
+    }
+    thread = &threads[thread_count];
+    pthread_attr_init(&pattr);
+    pthread_attr_setstack(&pattr, thread_stacks[thread_count], OS_STACK_SIZE);
+    thread_count++;
+    pthread_mutex_unlock(&kernel_lock);
+
+    thread->func = func;
+    thread->argument = argument;
+    thread->flags = 0;
+    pthread_cond_init(&thread->cond, NULL);
+    if (pthread_create(&thread->handle, &pattr, thread_entry, thread) != 0) {
+        thread = NULL;
+    }
+    pthread_attr_destroy(&pattr);
+    return (osThreadId_t)thread;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+    return (osThreadId_t)thread_self;
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+    os_thread_t *thread = (os_thread_t *)thread_id;
+    uint32_t result;
+
+    if (NULL == thread) {
+        return osFlagsErrorParameter;
+    }
+
+    pthread_mutex_lock(&kernel_lock);
+    thread->flags |= flags;
+    result = thread->flags;
+    pthread_cond_signal(&thread->cond);
+    pthread_mutex_unlock(&kernel_lock);
+    return result;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+    os_thread_t *thread = thread_self;
+    struct timespec deadline;
+    uint32_t result;
+    bool done;
+
+    if (NULL == thread) {
+        return osFlagsErrorISR;
+    }
+
+    if ((timeout != osWaitForever) && (timeout != 0)) {
+        ticks_to_deadline(timeout, &deadline);
+    }
+
+    pthread_mutex_lock(&kernel_lock);
+    while (1) {
+        result = thread->flags;
+        if (options & osFlagsWaitAll) {
+            done = (result & flags) == flags;
+        } else {
+            done = (result & flags) != 0;
+        }
+        if (done) {
+            if (!(options & osFlagsNoClear)) {
+                thread->flags &= ~flags;
+            }
+            break;
+        }
+
+        if (0 == timeout) {
+            result = osFlagsErrorResource;
+            break;
+        } else if (osWaitForever == timeout) {
+            pthread_cond_wait(&thread->cond, &kernel_lock);
+        } else if (pthread_cond_timedwait(&thread->cond, &kernel_lock, &deadline) == ETIMEDOUT) {
+            result = osFlagsErrorTimeout;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&kernel_lock);
+    return result;
+}
+
+osStatus_t osDelay(uint32_t ticks)
+{
+    struct timespec deadline;
+
+    ticks_to_deadline(ticks, &deadline);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+    return osOK;
+}
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument, const osTimerAttr_t *attr)
+{
+    os_timer_t *timer = NULL;
+
+    pthread_mutex_lock(&kernel_lock);
+    if (timer_count < OS_MAX_TIMERS) {
+        timer = &timers[timer_count];
+        timer->func = func;
+        timer->argument = argument;
+        timer->type = type;
+        timer->running = false;
+        timer_count++;
+    }
+    pthread_mutex_unlock(&kernel_lock);
+    return (osTimerId_t)timer;
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks)
+{
+    os_timer_t *timer = (os_timer_t *)timer_id;
+
+    if ((NULL == timer) || (0 == ticks)) {
+        return osErrorParameter;
+    }
+
+    pthread_mutex_lock(&kernel_lock);
+    timer->period = ticks;
+    timer->next = osKernelGetTickCount() + ticks;
+    timer->running = true;
+    pthread_mutex_unlock(&kernel_lock);
+    return osOK;
+}
+
+osStatus_t osTimerStop(osTimerId_t timer_id)
+{
+    os_timer_t *timer = (os_timer_t *)timer_id;
+
+    if (NULL == timer) {
+        return osErrorParameter;
+    }
+
+    pthread_mutex_lock(&kernel_lock);
+    timer->running = false;
+    pthread_mutex_unlock(&kernel_lock);
+    return osOK;
+}
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr)
+{
+    pthread_mutex_t *mutex = NULL;
+    pthread_mutexattr_t mattr;
+
+    pthread_mutex_lock(&kernel_lock);
+    if (mutex_count < OS_MAX_MUTEXES) {
+        mutex = &mutexes[mutex_count];
+        mutex_count++;
+    }
+    pthread_mutex_unlock(&kernel_lock);
+
+    if (mutex) {
+        // RTX mutexes are always recursive
+        pthread_mutexattr_init(&mattr);
+        pthread_mutexattr_settype(&mattr, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init(mutex, &mattr);
+        pthread_mutexattr_destroy(&mattr);
+    }
+    return (osMutexId_t)mutex;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)mutex_id;
+    struct timespec deadline;
+    int ret;
+
+    if (NULL == mutex) {
+        return osErrorParameter;
+    }
+
+    if (0 == timeout) {
+        ret = pthread_mutex_trylock(mutex);
+    } else if (osWaitForever == timeout) {
+        ret = pthread_mutex_lock(mutex);
+    } else {
+        // pthread_mutex_timedlock only supports CLOCK_REALTIME
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (timeout % OS_TICK_FREQ) * NS_PER_TICK;
+        deadline.tv_sec += timeout / OS_TICK_FREQ + deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        ret = pthread_mutex_timedlock(mutex, &deadline);
+    }
+
+    if (0 == ret) {
+        return osOK;
+    }
+    return (0 == timeout) ? osErrorResource : osErrorTimeout;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)mutex_id;
+
+    if (NULL == mutex) {
+        return osErrorParameter;
+    }
+    return (pthread_mutex_unlock(mutex) == 0) ? osOK : osErrorResource;
+}
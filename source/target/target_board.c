@@ -51,6 +51,17 @@ __WEAK uint16_t NO_OPTIMIZE_INLINE get_family_id(void)
 }
 NO_OPTIMIZE_POST
 
+__WEAK uint32_t get_uf2_family_id(void)
+{
+    if (g_board_info.uf2_family_id) {
+        return g_board_info.uf2_family_id;
+    } else if (g_target_family) {
+        return g_target_family->uf2_family_id;
+    } else {
+        return 0;
+    }
+}
+
 // Disable optimization of this function.
 //
 // This is required because for the "no target" builds, the compiler sees g_board_info.target_cfg as
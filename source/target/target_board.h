@@ -30,8 +30,9 @@
 //! @brief Current board info version.
 //!
 //! - Version 1: Initial version.
+//! - Version 2: Added uf2_family_id.
 enum _board_info_version {
-    kBoardInfoVersion = 1, //!< The current board info version.
+    kBoardInfoVersion = 2, //!< The current board info version.
 };
 
 //! @brief Flags for board_info
@@ -82,6 +83,11 @@ typedef struct board_info {
     char *board_vendor; //!< Board vendor. Maximum 60 characters including terminal NULL.
     char *board_name;   //!< Board name. Maximum 60 characters including terminal NULL.
     //@}
+
+    //! @name UF2 drag-n-drop
+    //@{
+    uint32_t uf2_family_id; //!< UF2 family ID of the target, 0 uses the one of the target family.
+    //@}
 } board_info_t;
 
 //! @brief Information describing the board on which DAPLink is running.
@@ -101,6 +107,12 @@ const char * get_board_id(void);
 //! The family ID will be 0 if there is no board.
 uint16_t get_family_id(void);
 
+//! @brief Returns the UF2 family ID of the target.
+//!
+//! The board's ID takes precedence over the one of the target family. The ID is 0 when
+//! neither knows it.
+uint32_t get_uf2_family_id(void);
+
 //! @brief Whether the board has a valid flash algo.
 uint8_t flash_algo_valid(void);
 
@@ -31,8 +31,9 @@
 //! @brief Current target configuration version.
 //!
 //! - Version 1: Initial version.
+//! - Version 2: Added region_info_t::target_sel.
 enum _target_config_version {
-    kTargetConfigVersion = 1, //!< The current board info version.
+    kTargetConfigVersion = 2, //!< The current board info version.
 };
 
 //! This can vary from target to target and should be in the structure or flash blob
@@ -56,6 +57,7 @@ typedef struct __attribute__((__packed__)) region_info {
     uint32_t flags;                 /*!< Flags for this region from the #_region_flags enumeration. */
     uint32_t alias_index;           /*!< Use with flags; will point to a different index if there is an alias region */
     program_target_t *flash_algo;   /*!< A pointer to the flash algorithm structure */
+    uint32_t target_sel;            /*!< TARGETSEL of the DP the region is on, for multi-drop SWD. 0 if there is a single DP. */
 } region_info_t;
 
 /*!
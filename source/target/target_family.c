@@ -22,6 +22,7 @@
 #include "daplink.h"
 #include "DAP_config.h"
 #include "swd_host.h"
+#include "swd_sched.h"
 #include "target_family.h"
 #include "target_board.h"
 
@@ -124,7 +125,7 @@ void init_family(void)
     }
 }
 
-uint8_t target_set_state(target_state_t state)
+static uint8_t set_state(target_state_t state)
 {
     if (g_board_info.target_set_state) { //target specific
         g_board_info.target_set_state(state);
@@ -154,6 +155,17 @@ uint8_t target_set_state(target_state_t state)
     }
 }
 
+uint8_t target_set_state(target_state_t state)
+{
+    uint8_t status;
+
+    // Called from the USB, CDC and main threads
+    swd_sched_lock();
+    status = set_state(state);
+    swd_sched_unlock();
+    return status;
+}
+
 void swd_set_target_reset(uint8_t asserted)
 {
     if (g_target_family && g_target_family->swd_set_target_reset) {
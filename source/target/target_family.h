@@ -109,6 +109,17 @@ typedef enum _family_id {
     kMaxim_MAX3266X_FamilyID = CREATE_FAMILY_ID(kMaxim_VendorID, 2),
 } family_id_t;
 
+//! @name UF2 family IDs
+//!
+//! Values of the familyID field of UF2 blocks, see
+//! https://github.com/microsoft/uf2/blob/master/utils/uf2families.json
+//@{
+#define UF2_FAMILY_ID_NRF52833      (0x621e937aU)
+#define UF2_FAMILY_ID_NRF52840      (0xada52840U)
+#define UF2_FAMILY_ID_LPC55         (0x2abc77ecU)
+#define UF2_FAMILY_ID_MIMXRT10XX    (0x4fb2d5bdU)
+//@}
+
 //! @brief Defines all characteristics of a device family.
 typedef struct target_family_descriptor {
     uint16_t family_id;                         /*!< Use to select or identify target family from defined target family or custom ones */
@@ -123,6 +134,7 @@ typedef struct target_family_descriptor {
     uint8_t (*validate_bin_nvic)(const uint8_t *buf);       /*!< Validate a bin file to be flash by drag and drop */
     uint8_t (*validate_hexfile)(const uint8_t *buf);        /*!< Validate a hex file to be flash by drag and drop */
     uint32_t apsel;                             /*!< APSEL for the family */
+    uint32_t uf2_family_id;                     /*!< UF2 family ID when every device of the family shares one, else 0 */
 } target_family_descriptor_t;
 
 //! @brief The active family used by the board.
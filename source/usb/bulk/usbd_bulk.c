@@ -34,6 +34,14 @@ static DAP_queue DAP_Cmd_queue;
 
 static volatile uint8_t  USB_ResponseIdle;
 
+// A command ends with a short packet, so one that fills a whole packet would
+// wait for a zero length packet hosts do not send. Keeping commands to a
+// single packet avoids that, at the speed the device enumerated with.
+static U16 bulk_packet_size(void)
+{
+    return MIN(usbd_bulk_maxpacketsize[USBD_HighSpeed], USBD_Bulk_BulkBufSize);
+}
+
 void usbd_bulk_init(void)
 {
     ptrDataIn     = USBD_Bulk_BulkOutBuf;
@@ -71,11 +79,15 @@ void USBD_BULK_EP_BULKOUT_Event(U32 event)
     U16 bytes_rece;
     uint8_t * rbuf;
 
+    if (!DataInReceLen) {
+        DAP_queue_set_packet_size(&DAP_Cmd_queue, bulk_packet_size());
+    }
+
     bytes_rece      = USBD_ReadEP(usbd_bulk_ep_bulkout, ptrDataIn, USBD_Bulk_BulkBufSize - DataInReceLen);
     ptrDataIn      += bytes_rece;
     DataInReceLen  += bytes_rece;
 
-    if ((DataInReceLen >= USBD_Bulk_BulkBufSize) ||
+    if ((DataInReceLen >= bulk_packet_size()) ||
             (bytes_rece    <  usbd_bulk_maxpacketsize[USBD_HighSpeed])) {
         if (DAP_queue_execute_buf(&DAP_Cmd_queue, USBD_Bulk_BulkOutBuf, DataInReceLen, &rbuf)) {
             //Trigger the BULKIn for the reply
@@ -28,105 +28,92 @@
 #define CDC_ACM_DEFAULT_BAUDRATE 9600
 #endif
 
-/* Module global variables                                                    */
-
-/** \ingroup  USBD_CDC_ACM_global_variables
-    \defgroup USBD_CDC_ACM_GLOBAL_VAR  Global Variables (GLOBAL_VAR)
-    \brief      Global variables used in USBD CDC ACM module
- */
-int32_t data_send_access;              /*!< Flag active while send data (in the send intermediate buffer) is being accessed */
-int32_t data_send_active;              /*!< Flag active while data is being sent */
-int32_t data_send_zlp;                 /*!< Flag active when ZLP needs to be sent */
-int32_t data_to_send_wr;               /*!< Number of bytes written to the send intermediate buffer */
-int32_t data_to_send_rd;               /*!< Number of bytes read from the send intermediate buffer */
-uint8_t *ptr_data_to_send;             /*!< Pointer to the send intermediate buffer to the data to be sent */
-uint8_t *ptr_data_sent;                /*!< Pointer to the send intermediate buffer to the data already sent */
-
-int32_t data_read_access;              /*!< Flag active while read data (in the receive intermediate buffer) is being accessed */
-int32_t data_receive_int_access;       /*!< Flag active while read data (in the receive intermediate buffer) is being accessed from the IRQ function*/
-int32_t data_received_pending_pckts;   /*!< Number of packets received but not handled (pending) */
-int32_t data_no_space_for_receive;     /*!< Flag active while there is no more space for reception */
-uint8_t *ptr_data_received;            /*!< Pointer to the receive intermediate buffer to the received unread data */
-uint8_t *ptr_data_read;                /*!< Pointer to the receive intermediate buffer to the received read data */
-
-uint16_t control_line_state;           /*!< Control line state settings bitmap (0. bit - DTR state, 1. bit - RTS state) */
-
-CDC_LINE_CODING line_coding;           /*!< Communication settings */
-
-/* end of group USBD_CDC_ACM_GLOBAL_VAR */
+/* Instance state and buffers                                                 */
+#define CDC_ACM_SEND_BUF(n)     (USBD_CDC_ACM_SendBuf    + (n) * usbd_cdc_acm_sendbuf_sz)
+#define CDC_ACM_RECEIVE_BUF(n)  (USBD_CDC_ACM_ReceiveBuf + (n) * usbd_cdc_acm_receivebuf_sz)
+#define CDC_ACM_NOTIFY_BUF(n)   (USBD_CDC_ACM_NotifyBuf  + (n) * 10)
 
 
 /* Functions that should be provided by user to use standard Virtual COM port
    functionality                                                              */
-__WEAK int32_t USBD_CDC_ACM_PortInitialize(void)
+__WEAK int32_t USBD_CDC_ACM_PortInitialize(uint8_t instance)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_PortUninitialize(void)
+__WEAK int32_t USBD_CDC_ACM_PortUninitialize(uint8_t instance)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_PortReset(void)
+__WEAK int32_t USBD_CDC_ACM_PortReset(uint8_t instance)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_PortSetLineCoding(CDC_LINE_CODING *line_coding)
+__WEAK int32_t USBD_CDC_ACM_PortSetLineCoding(uint8_t instance, CDC_LINE_CODING *line_coding)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_PortGetLineCoding(CDC_LINE_CODING *line_coding)
+__WEAK int32_t USBD_CDC_ACM_PortGetLineCoding(uint8_t instance, CDC_LINE_CODING *line_coding)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_PortSetControlLineState(uint16_t ctrl_bmp)
+__WEAK int32_t USBD_CDC_ACM_PortSetControlLineState(uint8_t instance, uint16_t ctrl_bmp)
+{
+    return (0);
+}
+__WEAK void USBD_CDC_ACM_PortPoll(void)
+{
+}
+__WEAK uint8_t USBD_CDC_ACM_PortGetLatency(uint8_t instance)
 {
     return (0);
 }
 
 /* Functions that can be used by user to use standard Virtual COM port
    functionality                                                              */
-int32_t USBD_CDC_ACM_DataSend(const uint8_t *buf, int32_t len);
-int32_t USBD_CDC_ACM_PutChar(const uint8_t  ch);
-int32_t USBD_CDC_ACM_DataRead(uint8_t *buf, int32_t len);
-int32_t USBD_CDC_ACM_GetChar(void);
-__WEAK int32_t USBD_CDC_ACM_DataReceived(int32_t len)
+int32_t USBD_CDC_ACM_DataSend(uint8_t instance, const uint8_t *buf, int32_t len);
+int32_t USBD_CDC_ACM_PutChar(uint8_t instance, const uint8_t  ch);
+int32_t USBD_CDC_ACM_DataRead(uint8_t instance, uint8_t *buf, int32_t len);
+int32_t USBD_CDC_ACM_GetChar(uint8_t instance);
+__WEAK int32_t USBD_CDC_ACM_DataReceived(uint8_t instance, int32_t len)
 {
     return (0);
 }
-int32_t USBD_CDC_ACM_DataAvailable(void);
-int32_t USBD_CDC_ACM_Notify(uint16_t stat);
+int32_t USBD_CDC_ACM_DataAvailable(uint8_t instance);
+int32_t USBD_CDC_ACM_Notify(uint8_t instance, uint16_t stat);
 
 /* Functions handling CDC ACM requests (can be overridden to provide custom
    handling of CDC ACM requests)                                              */
-__WEAK int32_t USBD_CDC_ACM_SendEncapsulatedCommand(void)
+__WEAK int32_t USBD_CDC_ACM_SendEncapsulatedCommand(uint8_t instance)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_GetEncapsulatedResponse(void)
+__WEAK int32_t USBD_CDC_ACM_GetEncapsulatedResponse(uint8_t instance)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_SetCommFeature(uint16_t feat)
+__WEAK int32_t USBD_CDC_ACM_SetCommFeature(uint8_t instance, uint16_t feat)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_GetCommFeature(uint16_t feat)
+__WEAK int32_t USBD_CDC_ACM_GetCommFeature(uint8_t instance, uint16_t feat)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_ClearCommFeature(uint16_t feat)
+__WEAK int32_t USBD_CDC_ACM_ClearCommFeature(uint8_t instance, uint16_t feat)
 {
     return (0);
 }
-__WEAK int32_t USBD_CDC_ACM_SendBreak(uint16_t dur)
+__WEAK int32_t USBD_CDC_ACM_SendBreak(uint8_t instance, uint16_t dur)
 {
     return (0);
 }
 
 
 /* Local function prototypes                                                  */
-static void USBD_CDC_ACM_EP_BULKOUT_HandleData(void);
-static void USBD_CDC_ACM_EP_BULKIN_HandleData(void);
+static void USBD_CDC_ACM_EP_BULKOUT_HandleData(uint8_t instance);
+static void USBD_CDC_ACM_EP_BULKIN_HandleData(uint8_t instance);
+static BOOL USBD_CDC_ACM_SendDue(uint8_t instance);
+static void USBD_CDC_ACM_SOF_HandleData(uint8_t instance);
 
 
 /*----------------- USB CDC ACM class handling functions ---------------------*/
@@ -136,31 +123,38 @@ static void USBD_CDC_ACM_EP_BULKIN_HandleData(void);
     The function calls USBD_CDC_ACM_PortInitialize function which
     initializes Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \return             0        Function failed.
     \return             1        Function succeeded.
  */
 
-__WEAK int32_t USBD_CDC_ACM_Initialize(void)
-{
-    data_send_access            = 0;
-    data_send_active            = 0;
-    data_send_zlp               = 0;
-    data_to_send_wr             = 0;
-    data_to_send_rd             = 0;
-    ptr_data_to_send            = USBD_CDC_ACM_SendBuf;
-    ptr_data_sent               = USBD_CDC_ACM_SendBuf;
-    data_read_access            = 0;
-    data_receive_int_access     = 0;
-    data_received_pending_pckts = 0;
-    data_no_space_for_receive   = 0;
-    ptr_data_received           = USBD_CDC_ACM_ReceiveBuf;
-    ptr_data_read               = USBD_CDC_ACM_ReceiveBuf;
-    control_line_state          = 0;
-    line_coding.dwDTERate       = CDC_ACM_DEFAULT_BAUDRATE;
-    line_coding.bCharFormat     = 0;
-    line_coding.bParityType     = 0;
-    line_coding.bDataBits       = 8;
-    return (USBD_CDC_ACM_PortInitialize());
+__WEAK int32_t USBD_CDC_ACM_Initialize(uint8_t instance)
+{
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+    uint8_t *send_buf = CDC_ACM_SEND_BUF(instance);
+    uint8_t *receive_buf = CDC_ACM_RECEIVE_BUF(instance);
+
+    acm->data_send_access            = 0;
+    acm->data_send_active            = 0;
+    acm->data_send_zlp               = 0;
+    acm->data_send_frames            = 0;
+    acm->data_send_due               = 0;
+    acm->data_to_send_wr             = 0;
+    acm->data_to_send_rd             = 0;
+    acm->ptr_data_to_send            = send_buf;
+    acm->ptr_data_sent               = send_buf;
+    acm->data_read_access            = 0;
+    acm->data_receive_int_access     = 0;
+    acm->data_received_pending_pckts = 0;
+    acm->data_no_space_for_receive   = 0;
+    acm->ptr_data_received           = receive_buf;
+    acm->ptr_data_read               = receive_buf;
+    acm->control_line_state          = 0;
+    acm->line_coding.dwDTERate       = CDC_ACM_DEFAULT_BAUDRATE;
+    acm->line_coding.bCharFormat     = 0;
+    acm->line_coding.bParityType     = 0;
+    acm->line_coding.bDataBits       = 8;
+    return (USBD_CDC_ACM_PortInitialize(instance));
 }
 
 
@@ -169,13 +163,14 @@ __WEAK int32_t USBD_CDC_ACM_Initialize(void)
     The function calls USBD_CDC_ACM_PortUninitialize function which
     uninitializes Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \return             0        Function failed.
     \return             1        Function succeeded.
  */
 
-__WEAK int32_t USBD_CDC_ACM_Uninitialization(void)
+__WEAK int32_t USBD_CDC_ACM_Uninitialization(uint8_t instance)
 {
-    return (USBD_CDC_ACM_PortUninitialize());
+    return (USBD_CDC_ACM_PortUninitialize(instance));
 }
 
 
@@ -187,32 +182,39 @@ __WEAK int32_t USBD_CDC_ACM_Uninitialization(void)
     default parameters to set default communication settings for the
     Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \return             0        Function failed.
     \return             1        Function succeeded.
  */
 
-__WEAK int32_t USBD_CDC_ACM_Reset(void)
-{
-    data_send_access            = 0;
-    data_send_active            = 0;
-    data_send_zlp               = 0;
-    data_to_send_wr             = 0;
-    data_to_send_rd             = 0;
-    ptr_data_to_send            = USBD_CDC_ACM_SendBuf;
-    ptr_data_sent               = USBD_CDC_ACM_SendBuf;
-    data_read_access            = 0;
-    data_receive_int_access     = 0;
-    data_received_pending_pckts = 0;
-    data_no_space_for_receive   = 0;
-    ptr_data_received           = USBD_CDC_ACM_ReceiveBuf;
-    ptr_data_read               = USBD_CDC_ACM_ReceiveBuf;
-    control_line_state          = 0;
-    USBD_CDC_ACM_PortReset();
-    line_coding.dwDTERate       = CDC_ACM_DEFAULT_BAUDRATE;
-    line_coding.bCharFormat     = 0;
-    line_coding.bParityType     = 0;
-    line_coding.bDataBits       = 8;
-    return (USBD_CDC_ACM_PortSetLineCoding(&line_coding));
+__WEAK int32_t USBD_CDC_ACM_Reset(uint8_t instance)
+{
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+    uint8_t *send_buf = CDC_ACM_SEND_BUF(instance);
+    uint8_t *receive_buf = CDC_ACM_RECEIVE_BUF(instance);
+
+    acm->data_send_access            = 0;
+    acm->data_send_active            = 0;
+    acm->data_send_zlp               = 0;
+    acm->data_send_frames            = 0;
+    acm->data_send_due               = 0;
+    acm->data_to_send_wr             = 0;
+    acm->data_to_send_rd             = 0;
+    acm->ptr_data_to_send            = send_buf;
+    acm->ptr_data_sent               = send_buf;
+    acm->data_read_access            = 0;
+    acm->data_receive_int_access     = 0;
+    acm->data_received_pending_pckts = 0;
+    acm->data_no_space_for_receive   = 0;
+    acm->ptr_data_received           = receive_buf;
+    acm->ptr_data_read               = receive_buf;
+    acm->control_line_state          = 0;
+    USBD_CDC_ACM_PortReset(instance);
+    acm->line_coding.dwDTERate       = CDC_ACM_DEFAULT_BAUDRATE;
+    acm->line_coding.bCharFormat     = 0;
+    acm->line_coding.bParityType     = 0;
+    acm->line_coding.bDataBits       = 8;
+    return (USBD_CDC_ACM_PortSetLineCoding(instance, &acm->line_coding));
 }
 
 
@@ -221,20 +223,23 @@ __WEAK int32_t USBD_CDC_ACM_Reset(void)
     The function is a callback function that forwards USB CDC ACM request
     to set communication settings to the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \return             0        Function failed.
     \return             1        Function succeeded.
  */
 
-__WEAK int32_t USBD_CDC_ACM_SetLineCoding(void)
+__WEAK int32_t USBD_CDC_ACM_SetLineCoding(uint8_t instance)
 {
-    line_coding.dwDTERate   = (USBD_EP0Buf[0] <<  0) |
-                              (USBD_EP0Buf[1] <<  8) |
-                              (USBD_EP0Buf[2] << 16) |
-                              (USBD_EP0Buf[3] << 24) ;
-    line_coding.bCharFormat =  USBD_EP0Buf[4];
-    line_coding.bParityType =  USBD_EP0Buf[5];
-    line_coding.bDataBits   =  USBD_EP0Buf[6];
-    return (USBD_CDC_ACM_PortSetLineCoding(&line_coding));
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+
+    acm->line_coding.dwDTERate   = (USBD_EP0Buf[0] <<  0) |
+                                   (USBD_EP0Buf[1] <<  8) |
+                                   (USBD_EP0Buf[2] << 16) |
+                                   (USBD_EP0Buf[3] << 24) ;
+    acm->line_coding.bCharFormat =  USBD_EP0Buf[4];
+    acm->line_coding.bParityType =  USBD_EP0Buf[5];
+    acm->line_coding.bDataBits   =  USBD_EP0Buf[6];
+    return (USBD_CDC_ACM_PortSetLineCoding(instance, &acm->line_coding));
 }
 
 
@@ -243,20 +248,23 @@ __WEAK int32_t USBD_CDC_ACM_SetLineCoding(void)
     The function is a callback function that forwards USB CDC ACM request
     to get communication settings from the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \return             0        Function failed.
     \return             1        Function succeeded.
  */
 
-__WEAK int32_t USBD_CDC_ACM_GetLineCoding(void)
+__WEAK int32_t USBD_CDC_ACM_GetLineCoding(uint8_t instance)
 {
-    if (USBD_CDC_ACM_PortGetLineCoding(&line_coding)) {
-        USBD_EP0Buf[0] = (line_coding.dwDTERate >>  0) & 0xFF;
-        USBD_EP0Buf[1] = (line_coding.dwDTERate >>  8) & 0xFF;
-        USBD_EP0Buf[2] = (line_coding.dwDTERate >> 16) & 0xFF;
-        USBD_EP0Buf[3] = (line_coding.dwDTERate >> 24) & 0xFF;
-        USBD_EP0Buf[4] =  line_coding.bCharFormat;
-        USBD_EP0Buf[5] =  line_coding.bParityType;
-        USBD_EP0Buf[6] =  line_coding.bDataBits;
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+
+    if (USBD_CDC_ACM_PortGetLineCoding(instance, &acm->line_coding)) {
+        USBD_EP0Buf[0] = (acm->line_coding.dwDTERate >>  0) & 0xFF;
+        USBD_EP0Buf[1] = (acm->line_coding.dwDTERate >>  8) & 0xFF;
+        USBD_EP0Buf[2] = (acm->line_coding.dwDTERate >> 16) & 0xFF;
+        USBD_EP0Buf[3] = (acm->line_coding.dwDTERate >> 24) & 0xFF;
+        USBD_EP0Buf[4] =  acm->line_coding.bCharFormat;
+        USBD_EP0Buf[5] =  acm->line_coding.bParityType;
+        USBD_EP0Buf[6] =  acm->line_coding.bDataBits;
         return (1);
     }
 
@@ -269,6 +277,7 @@ __WEAK int32_t USBD_CDC_ACM_GetLineCoding(void)
     The function is a callback function that forwards USB CDC ACM request
     to set desired control line state to the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \param [in]         ctrl_bmp Control line settings bitmap (
                           0. bit - DTR state,
                           1. bit - RTS state).
@@ -276,10 +285,10 @@ __WEAK int32_t USBD_CDC_ACM_GetLineCoding(void)
     \return             1        Function succeeded.
  */
 
-__WEAK int32_t USBD_CDC_ACM_SetControlLineState(uint16_t ctrl_bmp)
+__WEAK int32_t USBD_CDC_ACM_SetControlLineState(uint8_t instance, uint16_t ctrl_bmp)
 {
-    control_line_state = ctrl_bmp;
-    return (USBD_CDC_ACM_PortSetControlLineState(ctrl_bmp));
+    usbd_cdc_acm_state[instance].control_line_state = ctrl_bmp;
+    return (USBD_CDC_ACM_PortSetControlLineState(instance, ctrl_bmp));
 }
 
 
@@ -287,9 +296,11 @@ __WEAK int32_t USBD_CDC_ACM_SetControlLineState(uint16_t ctrl_bmp)
 
 /** \brief Number of free bytes in the Send buffer
 */
-int32_t USBD_CDC_ACM_DataFree(void)
+int32_t USBD_CDC_ACM_DataFree(uint8_t instance)
 {
-    return ((int32_t)usbd_cdc_acm_sendbuf_sz) - (data_to_send_wr - data_to_send_rd);
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+
+    return ((int32_t)usbd_cdc_acm_sendbuf_sz) - (acm->data_to_send_wr - acm->data_to_send_rd);
 }
 
 /** \brief  Sends data over the USB CDC ACM Virtual COM Port
@@ -297,17 +308,20 @@ int32_t USBD_CDC_ACM_DataFree(void)
     The function puts requested data to the send intermediate buffer and
     prepares it for sending over the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \param [in]         buf      Buffer containing data to be sent.
     \param [in]         len      Maximum number of bytes to be sent.
     \return                      Number of bytes accepted to be sent.
  */
 
-int32_t USBD_CDC_ACM_DataSend(const uint8_t *buf, int32_t len)
+int32_t USBD_CDC_ACM_DataSend(uint8_t instance, const uint8_t *buf, int32_t len)
 {
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+    uint8_t *send_buf = CDC_ACM_SEND_BUF(instance);
     int32_t  len_data, len_available, len_before_wrap;
     uint8_t *buf_loc;
     buf_loc       = (uint8_t *)buf;       /* Pointer to buf                     */
-    len_data      = data_to_send_wr - data_to_send_rd;  /* Num of data in buffer*/
+    len_data      = acm->data_to_send_wr - acm->data_to_send_rd; /* Num of data in buffer*/
     len_available = ((int32_t)usbd_cdc_acm_sendbuf_sz) - len_data;  /* Num of
                                            bytes of space available           */
 
@@ -323,26 +337,26 @@ int32_t USBD_CDC_ACM_DataSend(const uint8_t *buf, int32_t len)
 
     len_before_wrap = 0;                  /* Circular buffer size before wrap   */
 
-    if ((ptr_data_to_send >= ptr_data_sent) && /* If wrap is possible to happen */
-            ((ptr_data_to_send + len) >= (USBD_CDC_ACM_SendBuf + usbd_cdc_acm_sendbuf_sz))) {
+    if ((acm->ptr_data_to_send >= acm->ptr_data_sent) && /* If wrap is possible to happen */
+            ((acm->ptr_data_to_send + len) >= (send_buf + usbd_cdc_acm_sendbuf_sz))) {
         /* If data wraps around end of buffer */
-        len_before_wrap   = USBD_CDC_ACM_SendBuf + usbd_cdc_acm_sendbuf_sz - ptr_data_to_send;
-        memcpy(ptr_data_to_send, buf_loc, len_before_wrap); /* Copy data till end */
+        len_before_wrap   = send_buf + usbd_cdc_acm_sendbuf_sz - acm->ptr_data_to_send;
+        memcpy(acm->ptr_data_to_send, buf_loc, len_before_wrap); /* Copy data till end */
         buf_loc          += len_before_wrap;            /* Increment buf pointer  */
         len              -= len_before_wrap;            /* Decrement bytes to send*/
-        ptr_data_to_send  = USBD_CDC_ACM_SendBuf;       /* Wrap send buffer
+        acm->ptr_data_to_send  = send_buf;  /* Wrap send buffer
                                                        pointer to beginning of
                                                        the send buffer        */
     }
 
     if (len) {                            /* If there are bytes to send         */
-        memcpy(ptr_data_to_send, buf_loc, len);   /* Copy data to send buffer     */
-        ptr_data_to_send += len;            /* Correct position of write pointer  */
+        memcpy(acm->ptr_data_to_send, buf_loc, len); /* Copy data to send buffer     */
+        acm->ptr_data_to_send += len;       /* Correct position of write pointer  */
     }
 
     len += len_before_wrap;               /* Total number of bytes prepared for
                                            send                               */
-    data_to_send_wr += len;               /* Bytes prepared to send counter     */
+    acm->data_to_send_wr += len;          /* Bytes prepared to send counter     */
     return (len);                         /* Number of bytes accepted for send  */
 }
 
@@ -352,14 +366,15 @@ int32_t USBD_CDC_ACM_DataSend(const uint8_t *buf, int32_t len)
     The function puts requested data character to the send intermediate buffer
     and prepares it for sending over the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \param [in]         ch       Character to be sent.
     \return             -1       Function failed.
     \return                      Character accepted to be sent.
  */
 
-int32_t USBD_CDC_ACM_PutChar(const uint8_t ch)
+int32_t USBD_CDC_ACM_PutChar(uint8_t instance, const uint8_t ch)
 {
-    if ((USBD_CDC_ACM_DataSend(&ch, 1)) == 1) {
+    if ((USBD_CDC_ACM_DataSend(instance, &ch, 1)) == 1) {
         return ((uint32_t) ch);
     }
 
@@ -372,24 +387,26 @@ int32_t USBD_CDC_ACM_PutChar(const uint8_t ch)
     The function reads data from the receive intermediate buffer that was
     received over the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \param [in]         buf      Buffer to where data will be read.
     \param [in]         len      Maximum number of bytes to be read.
     \return                      Number of bytes actually read.
  */
 
-int32_t USBD_CDC_ACM_DataRead(uint8_t *buf, int32_t len)
+int32_t USBD_CDC_ACM_DataRead(uint8_t instance, uint8_t *buf, int32_t len)
 {
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
     int32_t len_data;
 
-    if (ptr_data_received > ptr_data_read) { /*If there is already received data   */
-        len_data = ptr_data_received - ptr_data_read; /* Available bytes of data  */
+    if (acm->ptr_data_received > acm->ptr_data_read) { /*If there is already received data   */
+        len_data = acm->ptr_data_received - acm->ptr_data_read; /* Available bytes of data  */
 
         if (len > len_data) {               /* If more requested then available   */
             len = len_data;    /* correct to return maximum available*/
         }
 
-        memcpy(buf, ptr_data_read, len);    /* Copy received data to provided buf */
-        ptr_data_read      += len;          /* Correct position of read pointer   */
+        memcpy(buf, acm->ptr_data_read, len); /* Copy received data to provided buf */
+        acm->ptr_data_read      += len;     /* Correct position of read pointer   */
     } else {
         len = 0;                            /* No data received                   */
     }
@@ -403,15 +420,16 @@ int32_t USBD_CDC_ACM_DataRead(uint8_t *buf, int32_t len)
     The function reads data character from the receive intermediate buffer that
     was received over the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \return             -1       No character available.
     \return                      Received character.
  */
 
-int32_t USBD_CDC_ACM_GetChar(void)
+int32_t USBD_CDC_ACM_GetChar(uint8_t instance)
 {
     uint8_t ch;
 
-    if ((USBD_CDC_ACM_DataRead(&ch, 1)) == 1) {
+    if ((USBD_CDC_ACM_DataRead(instance, &ch, 1)) == 1) {
         return ((int32_t) ch);
     }
 
@@ -424,12 +442,15 @@ int32_t USBD_CDC_ACM_GetChar(void)
     The function retrieves number of bytes available in the intermediate buffer
     that were received over the Virtual COM Port.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \return                      Number of bytes available for read.
  */
 
-int32_t USBD_CDC_ACM_DataAvailable(void)
+int32_t USBD_CDC_ACM_DataAvailable(uint8_t instance)
 {
-    return (ptr_data_received - ptr_data_read);
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+
+    return (acm->ptr_data_received - acm->ptr_data_read);
 }
 
 
@@ -438,6 +459,7 @@ int32_t USBD_CDC_ACM_DataAvailable(void)
     The function sends error and line status of the Virtual COM Port over the
     Interrupt endpoint. (SerialState notification is defined in usbcdc11.pdf, 6.3.5.)
 
+    \param [in]         instance Instance of the CDC ACM class.
     \param [in]         stat     Error and line statuses (
                                    6. bit - bOverRun,
                                    5. bit - bParity,
@@ -450,22 +472,24 @@ int32_t USBD_CDC_ACM_DataAvailable(void)
     \return             1        Function succeeded.
  */
 
-int32_t USBD_CDC_ACM_Notify(uint16_t stat)
+int32_t USBD_CDC_ACM_Notify(uint8_t instance, uint16_t stat)
 {
+    uint8_t *notify_buf = CDC_ACM_NOTIFY_BUF(instance);
+
     if (USBD_Configuration) {
-        USBD_CDC_ACM_NotifyBuf[0] = 0xA1;   /* bmRequestType                      */
-        USBD_CDC_ACM_NotifyBuf[1] = CDC_NOTIFICATION_SERIAL_STATE;/* bNotification
+        notify_buf[0] = 0xA1;   /* bmRequestType                      */
+        notify_buf[1] = CDC_NOTIFICATION_SERIAL_STATE;/* bNotification
                                           (SERIAL_STATE)                      */
-        USBD_CDC_ACM_NotifyBuf[2] = 0x00;   /* wValue                             */
-        USBD_CDC_ACM_NotifyBuf[3] = 0x00;
-        USBD_CDC_ACM_NotifyBuf[4] = 0x00;   /* wIndex (Interface 0)               */
-        USBD_CDC_ACM_NotifyBuf[5] = 0x00;
-        USBD_CDC_ACM_NotifyBuf[6] = 0x02;   /* wLength                            */
-        USBD_CDC_ACM_NotifyBuf[7] = 0x00;
-        USBD_CDC_ACM_NotifyBuf[8] = stat >> 0; /* UART State Bitmap                  */
-        USBD_CDC_ACM_NotifyBuf[9] = stat >> 8;
+        notify_buf[2] = 0x00;   /* wValue                             */
+        notify_buf[3] = 0x00;
+        notify_buf[4] = usbd_cdc_acm_cif_num[instance];   /* wIndex (Interface) */
+        notify_buf[5] = 0x00;
+        notify_buf[6] = 0x02;   /* wLength                            */
+        notify_buf[7] = 0x00;
+        notify_buf[8] = stat >> 0; /* UART State Bitmap                  */
+        notify_buf[9] = stat >> 8;
         /* Write notification to be sent      */
-        USBD_WriteEP(usbd_cdc_acm_ep_intin | 0x80, USBD_CDC_ACM_NotifyBuf, 10);
+        USBD_WriteEP(usbd_cdc_acm_ep_intin[instance] | 0x80, notify_buf, 10);
         return (1);
     }
 
@@ -482,7 +506,11 @@ int32_t USBD_CDC_ACM_Notify(uint16_t stat)
 
 void USBD_CDC_ACM_Reset_Event(void)
 {
-    USBD_CDC_ACM_Reset();
+    uint8_t instance;
+
+    for (instance = 0; instance < usbd_cdc_acm_num; instance++) {
+        USBD_CDC_ACM_Reset(instance);
+    }
 }
 
 
@@ -494,59 +522,90 @@ void USBD_CDC_ACM_Reset_Event(void)
     intermediate receive buffer and it calls received function callback
     (USBD_CDC_ACM_DataReceived) it also activates data send over the Bulk In
     endpoint if there is data to be sent (USBD_CDC_ACM_EP_BULKIN_HandleData).
+    This is done for every instance.
  */
 
 void USBD_CDC_ACM_SOF_Event(void)
 {
+    uint8_t instance;
+
     if (!USBD_Configuration) {
         // Don't process events until CDC is
         // configured and the endpoints enabled
         return;
     }
-    if ((!data_read_access)         &&    /* If not read active                 */
-            (ptr_data_received == ptr_data_read) &&     /* If received and read
+
+    for (instance = 0; instance < usbd_cdc_acm_num; instance++) {
+        USBD_CDC_ACM_SOF_HandleData(instance);
+    }
+
+    USBD_CDC_ACM_PortPoll();              /* Let the port move data every frame */
+}
+
+
+/** \brief  Handle SOF Event of an Instance
+
+    The function does the work of USBD_CDC_ACM_SOF_Event for one instance.
+
+    \param [in]         instance Instance of the CDC ACM class.
+ */
+
+static void USBD_CDC_ACM_SOF_HandleData(uint8_t instance)
+{
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+    uint8_t *receive_buf = CDC_ACM_RECEIVE_BUF(instance);
+
+    if ((!acm->data_read_access)         && /* If not read active                 */
+            (acm->ptr_data_received == acm->ptr_data_read) && /* If received and read
                                                      pointers point to same
                                                      the location             */
-            (ptr_data_received != USBD_CDC_ACM_ReceiveBuf)) {
+            (acm->ptr_data_received != receive_buf)) {
         /* and if receive
                                                        pointer does not already
                                                        point to the start of
                                                        the receive buffer       */
-        data_read_access = 1;               /* Block access to read data          */
-        ptr_data_received = USBD_CDC_ACM_ReceiveBuf;  /* Correct received pointer
+        acm->data_read_access = 1;          /* Block access to read data          */
+        acm->ptr_data_received = receive_buf; /* Correct received pointer
                                                      to point to the start of
                                                      the receive buffer       */
-        ptr_data_read     = USBD_CDC_ACM_ReceiveBuf;  /* Correct read pointer to
+        acm->ptr_data_read     = receive_buf; /* Correct read pointer to
                                                      point to the start of the
                                                      receive buffer           */
-        data_no_space_for_receive  = 0;               /* There is space for
+        acm->data_no_space_for_receive  = 0;          /* There is space for
                                                      reception available      */
-        data_read_access = 0;               /* Allow access to read data          */
+        acm->data_read_access = 0;          /* Allow access to read data          */
     }
 
-    if (data_received_pending_pckts &&    /* If packets are pending             */
-            (!data_read_access)          &&    /* and if not read active             */
-            (!data_no_space_for_receive)) {    /* and if there is space to receive   */
-        data_read_access = 1;               /* Disable access to read data        */
-        USBD_CDC_ACM_EP_BULKOUT_HandleData(); /* Handle received data             */
-        data_read_access = 0;               /* Enable access to read data         */
+    if (acm->data_received_pending_pckts && /* If packets are pending             */
+            (!acm->data_read_access)          && /* and if not read active             */
+            (!acm->data_no_space_for_receive)) { /* and if there is space to receive   */
+        acm->data_read_access = 1;          /* Disable access to read data        */
+        USBD_CDC_ACM_EP_BULKOUT_HandleData(instance); /* Handle received data             */
+        acm->data_read_access = 0;          /* Enable access to read data         */
 
-        if (ptr_data_received != ptr_data_read) {
-            USBD_CDC_ACM_DataReceived(ptr_data_received - ptr_data_read);
+        if (acm->ptr_data_received != acm->ptr_data_read) {
+            USBD_CDC_ACM_DataReceived(instance, acm->ptr_data_received - acm->ptr_data_read);
         }  /* Call
 
                                            received callback                  */
     }
 
-    if ((!data_send_access)         &&    /* If send data is not being accessed */
-            (!data_send_active)         &&    /* and send is not active             */
-            (data_to_send_wr - data_to_send_rd) /* and if there is data to be sent    */
-//&& ((control_line_state & 3) == 3)    /* and if DTR and RTS is 1            */
+    if (acm->data_to_send_wr - acm->data_to_send_rd) { /* If there is data to be sent  */
+        acm->data_send_frames++;            /* it waited one more frame           */
+    } else {
+        acm->data_send_frames = 0;
+    }
+
+    if ((!acm->data_send_access)         && /* If send data is not being accessed */
+            (!acm->data_send_active)         && /* and send is not active             */
+            (acm->data_to_send_wr - acm->data_to_send_rd) && /* and if there is data to be sent*/
+            USBD_CDC_ACM_SendDue(instance)        /* and if it is due                   */
+//&& ((acm->control_line_state & 3) == 3)    /* and if DTR and RTS is 1            */
        ) {
-        data_send_access = 1;               /* Block access to send data          */
-        data_send_active = 1;               /* Start data sending                 */
-        USBD_CDC_ACM_EP_BULKIN_HandleData();/* Handle data to send                */
-        data_send_access = 0;               /* Allow access to send data          */
+        acm->data_send_access = 1;          /* Block access to send data          */
+        acm->data_send_active = 1;          /* Start data sending                 */
+        USBD_CDC_ACM_EP_BULKIN_HandleData(instance);/* Handle data to send                */
+        acm->data_send_access = 0;          /* Allow access to send data          */
     }
 }
 
@@ -555,6 +614,7 @@ void USBD_CDC_ACM_SOF_Event(void)
 
     The function handles Interrupt In endpoint events.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \param [in]         event    Type of event (USBD_EVT_IN - input event).
  */
 
@@ -572,30 +632,32 @@ void USBD_CDC_ACM_EP_INTIN_Event(uint32_t event)
     available.
  */
 
-static void USBD_CDC_ACM_EP_BULKOUT_HandleData()
+static void USBD_CDC_ACM_EP_BULKOUT_HandleData(uint8_t instance)
 {
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+    uint8_t *receive_buf = CDC_ACM_RECEIVE_BUF(instance);
     uint32_t len_free_to_recv;
     int32_t len_received;
 
-    if ((usbd_cdc_acm_receivebuf_sz - (ptr_data_received - USBD_CDC_ACM_ReceiveBuf)) >= usbd_cdc_acm_maxpacketsize1[USBD_HighSpeed]) {
+    if ((usbd_cdc_acm_receivebuf_sz - (acm->ptr_data_received - receive_buf)) >= usbd_cdc_acm_maxpacketsize1[USBD_HighSpeed]) {
         /* If there is space for 1 max packet */
         /* Read received packet to receive buf*/
-        len_free_to_recv = usbd_cdc_acm_receivebuf_sz - (ptr_data_received - USBD_CDC_ACM_ReceiveBuf);
-        len_received       = USBD_ReadEP(usbd_cdc_acm_ep_bulkout, ptr_data_received, len_free_to_recv);
-        ptr_data_received += len_received;  /* Correct pointer to received data   */
+        len_free_to_recv = usbd_cdc_acm_receivebuf_sz - (acm->ptr_data_received - receive_buf);
+        len_received       = USBD_ReadEP(usbd_cdc_acm_ep_bulkout[instance], acm->ptr_data_received, len_free_to_recv);
+        acm->ptr_data_received += len_received; /* Correct pointer to received data   */
 
-        if (data_received_pending_pckts &&  /* If packet was pending              */
-                !data_receive_int_access) {      /* and not interrupt access           */
-            data_received_pending_pckts--;    /* Decrement pending packets number   */
+        if (acm->data_received_pending_pckts && /* If packet was pending              */
+                !acm->data_receive_int_access) { /* and not interrupt access           */
+            acm->data_received_pending_pckts--; /* Decrement pending packets number   */
         }
     } else {
-        data_no_space_for_receive = 1;      /* There is no space in receive buffer
+        acm->data_no_space_for_receive = 1; /* There is no space in receive buffer
                                            for the newly received data        */
 
-        if (data_receive_int_access) {
+        if (acm->data_receive_int_access) {
             /* If this access is from interrupt
                                                    function                           */
-            data_received_pending_pckts++;    /* then this is new unhandled packet  */
+            acm->data_received_pending_pckts++; /* then this is new unhandled packet  */
         }
     }
 }
@@ -607,22 +669,26 @@ static void USBD_CDC_ACM_EP_BULKOUT_HandleData()
     pending data to be sent that is already in the send intermediate buffer,
     and it also sends Zero Length Packet if last packet sent was not a short
     packet.
+
+    \param [in]         instance Instance of the CDC ACM class.
  */
 
-static void USBD_CDC_ACM_EP_BULKIN_HandleData(void)
+static void USBD_CDC_ACM_EP_BULKIN_HandleData(uint8_t instance)
 {
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+    uint8_t *send_buf = CDC_ACM_SEND_BUF(instance);
     int32_t len_to_send, len_sent;
 
-    if (!data_send_active) {              /* If sending is not active           */
+    if (!acm->data_send_active) {         /* If sending is not active           */
         return;
     }
 
-    len_to_send = data_to_send_wr - data_to_send_rd;  /* Num of data to send    */
+    len_to_send = acm->data_to_send_wr - acm->data_to_send_rd; /* Num of data to send    */
 
     /* Check if sending is finished                                             */
     if (!len_to_send    &&                /* If all data was sent               */
-            !data_send_zlp)  {                /* and ZLP was sent if necessary also */
-        data_send_active = 0;               /* Sending not active any more        */
+            !acm->data_send_zlp)  {           /* and ZLP was sent if necessary also */
+        acm->data_send_active = 0;          /* Sending not active any more        */
         return;
     }
 
@@ -630,13 +696,13 @@ static void USBD_CDC_ACM_EP_BULKIN_HandleData(void)
     if (len_to_send) {
         /* If there is data available do be
                                                  sent                               */
-        if ((ptr_data_sent >= ptr_data_to_send) && /* If data before end of buf avail*/
-                ((ptr_data_sent + len_to_send) >= (USBD_CDC_ACM_SendBuf + usbd_cdc_acm_sendbuf_sz))) {
+        if ((acm->ptr_data_sent >= acm->ptr_data_to_send) && /* If data before end of buf avail*/
+                ((acm->ptr_data_sent + len_to_send) >= (send_buf + usbd_cdc_acm_sendbuf_sz))) {
             /* and if available data wraps around
                the end of the send buffer         */
             /* Correct bytes to send to data
                available untill end of send buf   */
-            len_to_send = USBD_CDC_ACM_SendBuf + usbd_cdc_acm_sendbuf_sz - ptr_data_sent;
+            len_to_send = send_buf + usbd_cdc_acm_sendbuf_sz - acm->ptr_data_sent;
         }
 
         if (len_to_send > usbd_cdc_acm_maxpacketsize1[USBD_HighSpeed]) {
@@ -646,33 +712,82 @@ static void USBD_CDC_ACM_EP_BULKIN_HandleData(void)
             /* Correct to send maximum pckt size  */
             len_to_send = usbd_cdc_acm_maxpacketsize1[USBD_HighSpeed];
         }
-    } else if (data_send_zlp) {           /* or if ZLP should be sent           */
+
+        if (!acm->data_send_zlp &&          /* If no ZLP is owed to the host      */
+                !USBD_CDC_ACM_SendDue(instance)) {
+            /* and a partial packet may still wait*/
+            acm->data_send_active = 0;      /* SOF restarts sending when it is due*/
+            return;
+        }
+    } else if (acm->data_send_zlp) {      /* or if ZLP should be sent           */
         len_to_send = 0;
     }
 
-    data_send_zlp = 0;
+    acm->data_send_zlp = 0;
     /* Send data                          */
-    len_sent = USBD_WriteEP(usbd_cdc_acm_ep_bulkin | 0x80, ptr_data_sent, len_to_send);
-    ptr_data_sent    += len_sent;         /* Correct position of sent pointer   */
-    data_to_send_rd  += len_sent;         /* Correct num of bytes left to send  */
+    len_sent = USBD_WriteEP(usbd_cdc_acm_ep_bulkin[instance] | 0x80, acm->ptr_data_sent, len_to_send);
+    acm->ptr_data_sent    += len_sent;    /* Correct position of sent pointer   */
+    acm->data_to_send_rd  += len_sent;    /* Correct num of bytes left to send  */
+    acm->data_send_frames  = 0;           /* Latency restarts with every packet */
 
-    if (ptr_data_sent == USBD_CDC_ACM_SendBuf + usbd_cdc_acm_sendbuf_sz)
+    if (acm->ptr_data_sent == send_buf + usbd_cdc_acm_sendbuf_sz)
         /* If pointer to sent data wraps      */
     {
-        ptr_data_sent = USBD_CDC_ACM_SendBuf;
+        acm->ptr_data_sent = send_buf;
     } /* Correct it to beginning of send
 
                                            buffer                             */
 
-    if ((data_to_send_wr == data_to_send_rd) &&   /* If there are no more
+    if ((acm->data_to_send_wr == acm->data_to_send_rd) && /* If there are no more
                                            bytes available to be sent         */
             (len_sent == usbd_cdc_acm_maxpacketsize1[USBD_HighSpeed])) {
         /* If last packet size was same as
            maximum packet size                */
-        data_send_zlp = 1;                  /* ZLP packet should be sent          */
+        acm->data_send_zlp = 1;             /* ZLP packet should be sent          */
     } else {
-        data_send_zlp = 0;                  /* No ZLP packet should be sent       */
+        acm->data_send_zlp = 0;             /* No ZLP packet should be sent       */
+    }
+}
+
+
+/** \brief  Check if Data to Send is Due
+
+    The function checks if data in the send intermediate buffer should be sent
+    now. With a latency of 0 data is sent as soon as possible, otherwise a
+    partial packet is held back until it is full or has waited the latency
+    returned by USBD_CDC_ACM_PortGetLatency, so a stream of data goes out in
+    full packets. Once due, all data in the buffer at that time is sent, even
+    if it takes several packets.
+
+    \param [in]         instance Instance of the CDC ACM class.
+    \return             __TRUE   Data should be sent.
+    \return             __FALSE  Data may wait for more.
+ */
+
+static BOOL USBD_CDC_ACM_SendDue(uint8_t instance)
+{
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+    int32_t len = acm->data_to_send_wr - acm->data_to_send_rd;
+    uint32_t latency = USBD_CDC_ACM_PortGetLatency(instance);
+
+    if (!latency ||                       /* If data is not held back           */
+            ((acm->data_send_due - acm->data_to_send_rd) > 0)) { /* or was due already   */
+        return (__TRUE);
+    }
+
+    if (USBD_HighSpeed) {                 /* SOF comes every microframe at HS   */
+        latency *= 8;
+    }
+
+    if ((len >= usbd_cdc_acm_maxpacketsize1[USBD_HighSpeed]) ||   /* If a packet
+                                           is full                            */
+            (len >= usbd_cdc_acm_sendbuf_sz) ||   /* or no more data fits       */
+            (acm->data_send_frames >= latency)) { /* or it waited long enough   */
+        acm->data_send_due = acm->data_to_send_wr; /* Send all data there is now       */
+        return (__TRUE);
     }
+
+    return (__FALSE);
 }
 
 
@@ -683,27 +798,29 @@ static void USBD_CDC_ACM_EP_BULKIN_HandleData(void)
     unless data was being accessed in which case function just acknowledges
     that there is data to be handled later.
 
-    \param [in]         event    Type of event (USBD_EVT_OUT - output event).
+    \param [in]         instance Instance of the CDC ACM class.
  */
 
-void USBD_CDC_ACM_EP_BULKOUT_Event(uint32_t event)
+static void USBD_CDC_ACM_EP_BULKOUT_InstanceEvent(uint8_t instance)
 {
-    if (data_read_access) {
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+
+    if (acm->data_read_access) {
         /* If data is being accessed from
                                                  read function                      */
-        data_received_pending_pckts++;      /* 1 more packet received and not
+        acm->data_received_pending_pckts++; /* 1 more packet received and not
                                            handled                            */
         return;
     }
 
-    data_read_access = 1;                 /* Block access to read data          */
-    data_receive_int_access = 1;          /* Read access from interrupt function*/
-    USBD_CDC_ACM_EP_BULKOUT_HandleData(); /* Handle received data               */
-    data_receive_int_access = 0;          /* Read access from interrupt func end*/
-    data_read_access = 0;                 /* Allow access to read data          */
+    acm->data_read_access = 1;            /* Block access to read data          */
+    acm->data_receive_int_access = 1;     /* Read access from interrupt function*/
+    USBD_CDC_ACM_EP_BULKOUT_HandleData(instance); /* Handle received data               */
+    acm->data_receive_int_access = 0;     /* Read access from interrupt func end*/
+    acm->data_read_access = 0;            /* Allow access to read data          */
 
-    if (ptr_data_received != ptr_data_read) {
-        USBD_CDC_ACM_DataReceived(ptr_data_received - ptr_data_read);
+    if (acm->ptr_data_received != acm->ptr_data_read) {
+        USBD_CDC_ACM_DataReceived(instance, acm->ptr_data_received - acm->ptr_data_read);
     }    /* Call
 
                                            received callback                  */
@@ -716,20 +833,22 @@ void USBD_CDC_ACM_EP_BULKOUT_Event(uint32_t event)
     USBD_CDC_ACM_EP_BULKIN_HandleData function to handle send data
     unless data was being accessed in which case function just returns.
 
-    \param [in]         event    Type of event (USBD_EVT_IN - input event).
+    \param [in]         instance Instance of the CDC ACM class.
  */
 
-void USBD_CDC_ACM_EP_BULKIN_Event(uint32_t event)
+static void USBD_CDC_ACM_EP_BULKIN_InstanceEvent(uint8_t instance)
 {
-    if (data_send_access                  /* If send data is being accessed     */
-// ||((control_line_state & 3) != 3)    /* or if DTR or RTS is 0              */
+    USBD_CDC_ACM_STATE *acm = &usbd_cdc_acm_state[instance];
+
+    if (acm->data_send_access             /* If send data is being accessed     */
+// ||((acm->control_line_state & 3) != 3)    /* or if DTR or RTS is 0              */
        ) {
         return;
     }
 
-    data_send_access = 1;                 /* Block access to send data          */
-    USBD_CDC_ACM_EP_BULKIN_HandleData();  /* Handle data to send                */
-    data_send_access = 0;                 /* Allow access to send data          */
+    acm->data_send_access = 1;            /* Block access to send data          */
+    USBD_CDC_ACM_EP_BULKIN_HandleData(instance);  /* Handle data to send                */
+    acm->data_send_access = 0;            /* Allow access to send data          */
 }
 
 
@@ -739,23 +858,68 @@ void USBD_CDC_ACM_EP_BULKIN_Event(uint32_t event)
     that do In and Out functionality on the same endpoint number. It dispatches
     events to appropriate In or Out event handlers.
 
+    \param [in]         instance Instance of the CDC ACM class.
     \param [in]         event    Type of event (
                                    USBD_EVT_IN  - input event,
                                    USBD_EVT_OUT - output event).
  */
 
-void USBD_CDC_ACM_EP_BULK_Event(uint32_t event)
+static void USBD_CDC_ACM_EP_BULK_InstanceEvent(uint8_t instance, uint32_t event)
 {
     if (event & USBD_EVT_OUT) {
-        USBD_CDC_ACM_EP_BULKOUT_Event(event);
+        USBD_CDC_ACM_EP_BULKOUT_InstanceEvent(instance);
     }
 
     if (event & USBD_EVT_IN) {
-        USBD_CDC_ACM_EP_BULKIN_Event(event);
+        USBD_CDC_ACM_EP_BULKIN_InstanceEvent(instance);
     }
 }
 
 
+/** \brief  Handle Endpoint Events of the Instances
+
+    The functions below are the endpoint event handlers of each instance,
+    the ones without a number belong to instance 0.
+
+    \param [in]         event    Type of event (
+                                   USBD_EVT_IN  - input event,
+                                   USBD_EVT_OUT - output event).
+ */
+
+void USBD_CDC_ACM_EP_BULKOUT_Event(uint32_t event)
+{
+    USBD_CDC_ACM_EP_BULKOUT_InstanceEvent(0);
+}
+
+void USBD_CDC_ACM_EP_BULKIN_Event(uint32_t event)
+{
+    USBD_CDC_ACM_EP_BULKIN_InstanceEvent(0);
+}
+
+void USBD_CDC_ACM_EP_BULK_Event(uint32_t event)
+{
+    USBD_CDC_ACM_EP_BULK_InstanceEvent(0, event);
+}
+
+void USBD_CDC_ACM1_EP_INTIN_Event(uint32_t event)
+{
+}
+
+void USBD_CDC_ACM1_EP_BULK_Event(uint32_t event)
+{
+    USBD_CDC_ACM_EP_BULK_InstanceEvent(1, event);
+}
+
+void USBD_CDC_ACM2_EP_INTIN_Event(uint32_t event)
+{
+}
+
+void USBD_CDC_ACM2_EP_BULK_Event(uint32_t event)
+{
+    USBD_CDC_ACM_EP_BULK_InstanceEvent(2, event);
+}
+
+
 #ifdef __RTX                            /* RTX tasks for handling events      */
 
 /** \brief  Task Handling Interrupt In Endpoint Events
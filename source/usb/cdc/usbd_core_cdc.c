@@ -25,6 +25,27 @@
 #include "usb_for_lib.h"
 
 
+/*
+ *  Find the CDC ACM instance a request to an interface is for
+ *    Parameters:      if_num:   interface number
+ *    Return Value:    instance, usbd_cdc_acm_num if no instance has the interface
+ */
+
+static U8 USBD_CDC_ACM_FindInstance(U8 if_num)
+{
+    U8 instance;
+
+    for (instance = 0; instance < usbd_cdc_acm_num; instance++) {
+        if ((if_num == usbd_cdc_acm_cif_num[instance]) ||
+                (if_num == usbd_cdc_acm_dif_num[instance])) {
+            break;
+        }
+    }
+
+    return (instance);
+}
+
+
 /*
  *  USB Device Endpoint 0 Event Callback - CDC specific handling (Setup Request To Interface)
  *    Parameters:      none
@@ -33,15 +54,16 @@
 
 __WEAK BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
 {
-    if ((USBD_SetupPacket.wIndexL == usbd_cdc_acm_cif_num)  || /* IF number correct? */
-            (USBD_SetupPacket.wIndexL == usbd_cdc_acm_dif_num)) {
+    U8 instance = USBD_CDC_ACM_FindInstance(USBD_SetupPacket.wIndexL);
+
+    if (instance < usbd_cdc_acm_num) {                     /* IF number correct? */
         switch (USBD_SetupPacket.bRequest) {
             case CDC_SEND_ENCAPSULATED_COMMAND:
                 USBD_EP0Data.pData = USBD_EP0Buf;                    /* data to be received, see USBD_EVT_OUT */
                 return (__TRUE);
 
             case CDC_GET_ENCAPSULATED_RESPONSE:
-                if (USBD_CDC_ACM_GetEncapsulatedResponse()) {
+                if (USBD_CDC_ACM_GetEncapsulatedResponse(instance)) {
                     USBD_EP0Data.pData = USBD_EP0Buf;                  /* point to data to be sent */
                     USBD_DataInStage();                                /* send requested data */
                     return (__TRUE);
@@ -54,7 +76,7 @@ __WEAK BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
                 return (__TRUE);
 
             case CDC_GET_COMM_FEATURE:
-                if (USBD_CDC_ACM_GetCommFeature(USBD_SetupPacket.wValue)) {
+                if (USBD_CDC_ACM_GetCommFeature(instance, USBD_SetupPacket.wValue)) {
                     USBD_EP0Data.pData = USBD_EP0Buf;                  /* point to data to be sent */
                     USBD_DataInStage();                                /* send requested data */
                     return (__TRUE);
@@ -63,7 +85,7 @@ __WEAK BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
                 break;
 
             case CDC_CLEAR_COMM_FEATURE:
-                if (USBD_CDC_ACM_ClearCommFeature(USBD_SetupPacket.wValue)) {
+                if (USBD_CDC_ACM_ClearCommFeature(instance, USBD_SetupPacket.wValue)) {
                     USBD_StatusInStage();                              /* send Acknowledge */
                     return (__TRUE);
                 }
@@ -75,7 +97,7 @@ __WEAK BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
                 return (__TRUE);
 
             case CDC_GET_LINE_CODING:
-                if (USBD_CDC_ACM_GetLineCoding()) {
+                if (USBD_CDC_ACM_GetLineCoding(instance)) {
                     USBD_EP0Data.pData = USBD_EP0Buf;                  /* point to data to be sent */
                     USBD_DataInStage();                                /* send requested data */
                     return (__TRUE);
@@ -84,7 +106,7 @@ __WEAK BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
                 break;
 
             case CDC_SET_CONTROL_LINE_STATE:
-                if (USBD_CDC_ACM_SetControlLineState(USBD_SetupPacket.wValue)) {
+                if (USBD_CDC_ACM_SetControlLineState(instance, USBD_SetupPacket.wValue)) {
                     USBD_StatusInStage();                              /* send Acknowledge */
                     return (__TRUE);
                 }
@@ -92,7 +114,7 @@ __WEAK BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
                 break;
 
             case CDC_SEND_BREAK:
-                if (USBD_CDC_ACM_SendBreak(USBD_SetupPacket.wValue)) {
+                if (USBD_CDC_ACM_SendBreak(instance, USBD_SetupPacket.wValue)) {
                     USBD_StatusInStage();                              /* send Acknowledge */
                     return (__TRUE);
                 }
@@ -113,11 +135,12 @@ __WEAK BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
 
 __WEAK BOOL USBD_EndPoint0_Out_CDC_ReqToIF(void)
 {
-    if ((USBD_SetupPacket.wIndexL == usbd_cdc_acm_cif_num) || /* IF number correct? */
-            (USBD_SetupPacket.wIndexL == usbd_cdc_acm_dif_num)) {
+    U8 instance = USBD_CDC_ACM_FindInstance(USBD_SetupPacket.wIndexL);
+
+    if (instance < usbd_cdc_acm_num) {                     /* IF number correct? */
         switch (USBD_SetupPacket.bRequest) {
             case CDC_SEND_ENCAPSULATED_COMMAND:
-                if (USBD_CDC_ACM_SendEncapsulatedCommand()) {
+                if (USBD_CDC_ACM_SendEncapsulatedCommand(instance)) {
                     USBD_StatusInStage();                        /* send Acknowledge */
                     return (__TRUE);
                 }
@@ -125,7 +148,7 @@ __WEAK BOOL USBD_EndPoint0_Out_CDC_ReqToIF(void)
                 break;
 
             case CDC_SET_COMM_FEATURE:
-                if (USBD_CDC_ACM_SetCommFeature(USBD_SetupPacket.wValue)) {
+                if (USBD_CDC_ACM_SetCommFeature(instance, USBD_SetupPacket.wValue)) {
                     USBD_StatusInStage();                        /* send Acknowledge */
                     return (__TRUE);
                 }
@@ -133,7 +156,7 @@ __WEAK BOOL USBD_EndPoint0_Out_CDC_ReqToIF(void)
                 break;
 
             case CDC_SET_LINE_CODING:
-                if (USBD_CDC_ACM_SetLineCoding()) {
+                if (USBD_CDC_ACM_SetLineCoding(instance)) {
                     USBD_StatusInStage();                        /* send Acknowledge */
                     return (__TRUE);
                 }
@@ -58,6 +58,7 @@ void usbd_hid_init(void)
 {
     USB_ResponseIdle = 1;
     DAP_queue_init(&DAP_Cmd_queue);
+    DAP_queue_set_packet_size(&DAP_Cmd_queue, USBD_HID_OUTREPORT_MAX_SZ);
 }
 
 // USB HID Callback: when data needs to be prepared for the host
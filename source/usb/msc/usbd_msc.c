@@ -45,6 +45,7 @@ U32 Length;     /* R/W Length */
 
 U8 BulkStage;   /* Bulk Stage */
 U32 BulkLen;    /* Bulk In/Out Length */
+BOOL BulkOutHeld;   /* Bulk Out packet left in the endpoint */
 
 
 /* Dummy Weak Functions that need to be provided by user */
@@ -64,6 +65,10 @@ __WEAK void usbd_msc_start_stop(BOOL start)
 {
 
 }
+__WEAK BOOL usbd_msc_busy(BOOL write_data)
+{
+    return (__FALSE);
+}
 
 
 /*
@@ -116,6 +121,11 @@ BOOL USBD_MSC_Reset(void)
     USBD_EndPointStall = 0x00000000;         /* EP must stay stalled */
     USBD_MSC_CSW.dSignature = 0;             /* invalid signature */
     BulkStage = MSC_BS_RESET;
+
+    if (BulkOutHeld) {                       /* drop a held packet of the command being reset */
+        BulkOutHeld = __FALSE;
+        USBD_ReadEP(usbd_msc_ep_bulkout, USBD_MSC_BulkBuf, USBD_MSC_BulkBufSize);
+    }
     return (__TRUE);
 }
 
@@ -1114,6 +1124,7 @@ void USBD_MSC_BulkOut(void)
 
 void USBD_MSC_Reset_Event(void)
 {
+    BulkOutHeld = __FALSE;                   /* endpoint buffers are gone after a bus reset */
     USBD_MSC_Reset();
 }
 
@@ -1137,11 +1148,37 @@ void USBD_MSC_EP_BULKIN_Event(U32 event)
 
 void USBD_MSC_EP_BULKOUT_Event(U32 event)
 {
+    BOOL write_data = (BulkStage == MSC_BS_DATA_OUT) &&
+                      ((USBD_MSC_CBW.CB[0] == SCSI_WRITE10) || (USBD_MSC_CBW.CB[0] == SCSI_WRITE12));
+
+    /* Leave the packet in the endpoint, so the host gets NAKed, until the
+       media has room for it. USBD_MSC_Resume() picks it up later. */
+    if (usbd_msc_busy(write_data)) {
+        BulkOutHeld = __TRUE;
+        return;
+    }
+
+    BulkOutHeld = __FALSE;
     BulkLen = USBD_ReadEP(usbd_msc_ep_bulkout, USBD_MSC_BulkBuf, USBD_MSC_BulkBufSize);
     USBD_MSC_BulkOut();
 }
 
 
+/*
+ *  USB Device MSC Resume a held Bulk Out packet
+ *    Called from the thread running USBD_Handler once the media got less busy
+ *    Parameters:      None
+ *    Return Value:    None
+ */
+
+void USBD_MSC_Resume(void)
+{
+    if (BulkOutHeld) {
+        USBD_MSC_EP_BULKOUT_Event(0);
+    }
+}
+
+
 /*
  *  USB Device MSC Bulk In/Out Endpoint Event Callback
  *    Parameters:      event: USB Device Event
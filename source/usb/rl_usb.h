@@ -50,38 +50,45 @@ extern void  usbd_msc_init(void);
 extern void  usbd_msc_read_sect(U32 block, U8 *buf, U32 num_of_blocks);
 extern void  usbd_msc_write_sect(U32 block, U8 *buf, U32 num_of_blocks);
 extern void  usbd_msc_start_stop(BOOL start);
+extern BOOL  usbd_msc_busy(BOOL write_data);
+/* USB Device Mass Storage Class module functions called by user              */
+extern void  USBD_MSC_Resume(void);
 
 /* USB Device user functions imported to USB Audio Class module               */
 extern void  usbd_adc_init(void);
 
 /* USB Device CDC ACM class functions called automatically by USBD Core module*/
-extern int32_t  USBD_CDC_ACM_Initialize(void);
-extern int32_t  USBD_CDC_ACM_Uninitialize(void);
-extern int32_t  USBD_CDC_ACM_Reset(void);
+/* All take the CDC ACM instance, 0 to usbd_cdc_acm_num - 1, as first argument */
+extern const uint8_t usbd_cdc_acm_num;
+extern int32_t  USBD_CDC_ACM_Initialize(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_Uninitialize(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_Reset(uint8_t instance);
 /* USB Device CDC ACM class user functions                                    */
-extern int32_t  USBD_CDC_ACM_PortInitialize(void);
-extern int32_t  USBD_CDC_ACM_PortUninitialize(void);
-extern int32_t  USBD_CDC_ACM_PortReset(void);
-extern int32_t  USBD_CDC_ACM_PortSetLineCoding(CDC_LINE_CODING *line_coding);
-extern int32_t  USBD_CDC_ACM_PortGetLineCoding(CDC_LINE_CODING *line_coding);
-extern int32_t  USBD_CDC_ACM_PortSetControlLineState(uint16_t ctrl_bmp);
-extern int32_t  USBD_CDC_ACM_DataSend(const uint8_t *buf, int32_t len);
-extern int32_t  USBD_CDC_ACM_DataFree(void);
-extern int32_t  USBD_CDC_ACM_PutChar(const uint8_t  ch);
-extern int32_t  USBD_CDC_ACM_DataRead(uint8_t *buf, int32_t len);
-extern int32_t  USBD_CDC_ACM_GetChar(void);
-extern int32_t  USBD_CDC_ACM_DataAvailable(void);
-extern int32_t  USBD_CDC_ACM_Notify(uint16_t stat);
+extern int32_t  USBD_CDC_ACM_PortInitialize(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_PortUninitialize(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_PortReset(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_PortSetLineCoding(uint8_t instance, CDC_LINE_CODING *line_coding);
+extern int32_t  USBD_CDC_ACM_PortGetLineCoding(uint8_t instance, CDC_LINE_CODING *line_coding);
+extern int32_t  USBD_CDC_ACM_PortSetControlLineState(uint8_t instance, uint16_t ctrl_bmp);
+extern void     USBD_CDC_ACM_PortPoll(void);
+extern uint8_t  USBD_CDC_ACM_PortGetLatency(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_DataSend(uint8_t instance, const uint8_t *buf, int32_t len);
+extern int32_t  USBD_CDC_ACM_DataFree(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_PutChar(uint8_t instance, const uint8_t  ch);
+extern int32_t  USBD_CDC_ACM_DataRead(uint8_t instance, uint8_t *buf, int32_t len);
+extern int32_t  USBD_CDC_ACM_GetChar(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_DataAvailable(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_Notify(uint8_t instance, uint16_t stat);
 /* USB Device CDC ACM class overridable functions                             */
-extern int32_t  USBD_CDC_ACM_SendEncapsulatedCommand(void);
-extern int32_t  USBD_CDC_ACM_GetEncapsulatedResponse(void);
-extern int32_t  USBD_CDC_ACM_SetCommFeature(uint16_t feat);
-extern int32_t  USBD_CDC_ACM_GetCommFeature(uint16_t feat);
-extern int32_t  USBD_CDC_ACM_ClearCommFeature(uint16_t feat);
-extern int32_t  USBD_CDC_ACM_SetLineCoding(void);
-extern int32_t  USBD_CDC_ACM_GetLineCoding(void);
-extern int32_t  USBD_CDC_ACM_SetControlLineState(uint16_t ctrl_bmp);
-extern int32_t  USBD_CDC_ACM_SendBreak(uint16_t dur);
+extern int32_t  USBD_CDC_ACM_SendEncapsulatedCommand(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_GetEncapsulatedResponse(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_SetCommFeature(uint8_t instance, uint16_t feat);
+extern int32_t  USBD_CDC_ACM_GetCommFeature(uint8_t instance, uint16_t feat);
+extern int32_t  USBD_CDC_ACM_ClearCommFeature(uint8_t instance, uint16_t feat);
+extern int32_t  USBD_CDC_ACM_SetLineCoding(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_GetLineCoding(uint8_t instance);
+extern int32_t  USBD_CDC_ACM_SetControlLineState(uint8_t instance, uint16_t ctrl_bmp);
+extern int32_t  USBD_CDC_ACM_SendBreak(uint8_t instance, uint16_t dur);
 
 /* USB Device user functions imported to USB Custom Class module              */
 extern void  usbd_cls_init(void);
@@ -118,19 +118,51 @@ S16  USBD_ADC_DataBuf[8 * USBD_ADC_CFG_P_C * USBD_ADC_CFG_P_S];
 #endif
 #endif
 
+/* Number of CDC ACM instances. Instance 0 uses the USBD_CDC_ACM_EP_* endpoints,
+   instance n the USBD_CDC_ACMn_EP_* ones, all share the packet and buffer
+   sizes and the strings of instance 0. */
+#ifndef USBD_CDC_ACM_NUM
+#define USBD_CDC_ACM_NUM     USBD_CDC_ACM_ENABLE
+#endif
+
+#if    (USBD_CDC_ACM_NUM > 3)
+#error "Up to 3 CDC ACM instances are supported"
+#endif
+#if    (USBD_CDC_ACM_NUM > 1) && defined(__RTX)
+#error "Multiple CDC ACM instances are not supported with RTX endpoint tasks"
+#endif
+#if    (USBD_CDC_ACM_NUM > 1) && (USBD_CDC_ACM1_EP_BULKIN != USBD_CDC_ACM1_EP_BULKOUT)
+#error "CDC ACM instance 1 must use the same endpoint number for Bulk IN and OUT"
+#endif
+#if    (USBD_CDC_ACM_NUM > 2) && (USBD_CDC_ACM2_EP_BULKIN != USBD_CDC_ACM2_EP_BULKOUT)
+#error "CDC ACM instance 2 must use the same endpoint number for Bulk IN and OUT"
+#endif
+
+#if    (USBD_CDC_ACM_NUM == 1)
+#define USBD_CDC_ACM_EP_LIST(ep)  {USBD_CDC_ACM_EP_##ep}
+#elif  (USBD_CDC_ACM_NUM == 2)
+#define USBD_CDC_ACM_EP_LIST(ep)  {USBD_CDC_ACM_EP_##ep, USBD_CDC_ACM1_EP_##ep}
+#else
+#define USBD_CDC_ACM_EP_LIST(ep)  {USBD_CDC_ACM_EP_##ep, USBD_CDC_ACM1_EP_##ep, USBD_CDC_ACM2_EP_##ep}
+#endif
+
 #if    (USBD_CDC_ACM_ENABLE)
-U8 usbd_cdc_acm_cif_num = 0; //assigned during runtime init
-U8 usbd_cdc_acm_dif_num = 0; //assigned during runtime init
-const U8 usbd_cdc_acm_ep_intin = USBD_CDC_ACM_EP_INTIN;
-const U8 usbd_cdc_acm_ep_bulkin = USBD_CDC_ACM_EP_BULKIN;
-const U8 usbd_cdc_acm_ep_bulkout = USBD_CDC_ACM_EP_BULKOUT;
+const U8 usbd_cdc_acm_num = USBD_CDC_ACM_NUM;
+U8 usbd_cdc_acm_cif_num[USBD_CDC_ACM_NUM]; //assigned during runtime init
+U8 usbd_cdc_acm_dif_num[USBD_CDC_ACM_NUM]; //assigned during runtime init
+const U8 usbd_cdc_acm_ep_intin[USBD_CDC_ACM_NUM] = USBD_CDC_ACM_EP_LIST(INTIN);
+const U8 usbd_cdc_acm_ep_bulkin[USBD_CDC_ACM_NUM] = USBD_CDC_ACM_EP_LIST(BULKIN);
+const U8 usbd_cdc_acm_ep_bulkout[USBD_CDC_ACM_NUM] = USBD_CDC_ACM_EP_LIST(BULKOUT);
 const U16 usbd_cdc_acm_sendbuf_sz = USBD_CDC_ACM_SENDBUF_SIZE;
 const U16 usbd_cdc_acm_receivebuf_sz = USBD_CDC_ACM_RECEIVEBUF_SIZE;
 const U16 usbd_cdc_acm_maxpacketsize[2] = {USBD_CDC_ACM_WMAXPACKETSIZE, USBD_CDC_ACM_HS_WMAXPACKETSIZE};
 const U16 usbd_cdc_acm_maxpacketsize1[2] = {USBD_CDC_ACM_WMAXPACKETSIZE1, USBD_CDC_ACM_HS_WMAXPACKETSIZE1};
-U8 USBD_CDC_ACM_SendBuf[USBD_CDC_ACM_SENDBUF_SIZE];
-U8 USBD_CDC_ACM_ReceiveBuf[USBD_CDC_ACM_RECEIVEBUF_SIZE];
-U8 USBD_CDC_ACM_NotifyBuf[10];
+U8 USBD_CDC_ACM_SendBuf[USBD_CDC_ACM_NUM * USBD_CDC_ACM_SENDBUF_SIZE];
+U8 USBD_CDC_ACM_ReceiveBuf[USBD_CDC_ACM_NUM * USBD_CDC_ACM_RECEIVEBUF_SIZE];
+U8 USBD_CDC_ACM_NotifyBuf[USBD_CDC_ACM_NUM * 10];
+USBD_CDC_ACM_STATE usbd_cdc_acm_state[USBD_CDC_ACM_NUM];
+#else
+const U8 usbd_cdc_acm_num;
 #endif
 
 #if    (USBD_WEBUSB_ENABLE)
@@ -911,6 +943,138 @@ BOOL USBD_EndPoint0_Out_ADC_ReqToEP(void)
 #endif
 #endif
 #endif
+
+#if    (USBD_CDC_ACM_NUM > 1)
+#if    (USBD_CDC_ACM1_EP_INTIN == 1)
+#define USBD_EndPoint1                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 2)
+#define USBD_EndPoint2                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 3)
+#define USBD_EndPoint3                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 4)
+#define USBD_EndPoint4                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 5)
+#define USBD_EndPoint5                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 6)
+#define USBD_EndPoint6                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 7)
+#define USBD_EndPoint7                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 8)
+#define USBD_EndPoint8                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 9)
+#define USBD_EndPoint9                 USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 10)
+#define USBD_EndPoint10                USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 11)
+#define USBD_EndPoint11                USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 12)
+#define USBD_EndPoint12                USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 13)
+#define USBD_EndPoint13                USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 14)
+#define USBD_EndPoint14                USBD_CDC_ACM1_EP_INTIN_Event
+#elif  (USBD_CDC_ACM1_EP_INTIN == 15)
+#define USBD_EndPoint15                USBD_CDC_ACM1_EP_INTIN_Event
+#endif
+
+#if    (USBD_CDC_ACM1_EP_BULKIN == 1)
+#define USBD_EndPoint1                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 2)
+#define USBD_EndPoint2                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 3)
+#define USBD_EndPoint3                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 4)
+#define USBD_EndPoint4                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 5)
+#define USBD_EndPoint5                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 6)
+#define USBD_EndPoint6                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 7)
+#define USBD_EndPoint7                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 8)
+#define USBD_EndPoint8                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 9)
+#define USBD_EndPoint9                 USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 10)
+#define USBD_EndPoint10                USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 11)
+#define USBD_EndPoint11                USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 12)
+#define USBD_EndPoint12                USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 13)
+#define USBD_EndPoint13                USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 14)
+#define USBD_EndPoint14                USBD_CDC_ACM1_EP_BULK_Event
+#elif  (USBD_CDC_ACM1_EP_BULKIN == 15)
+#define USBD_EndPoint15                USBD_CDC_ACM1_EP_BULK_Event
+#endif
+#endif
+
+#if    (USBD_CDC_ACM_NUM > 2)
+#if    (USBD_CDC_ACM2_EP_INTIN == 1)
+#define USBD_EndPoint1                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 2)
+#define USBD_EndPoint2                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 3)
+#define USBD_EndPoint3                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 4)
+#define USBD_EndPoint4                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 5)
+#define USBD_EndPoint5                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 6)
+#define USBD_EndPoint6                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 7)
+#define USBD_EndPoint7                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 8)
+#define USBD_EndPoint8                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 9)
+#define USBD_EndPoint9                 USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 10)
+#define USBD_EndPoint10                USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 11)
+#define USBD_EndPoint11                USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 12)
+#define USBD_EndPoint12                USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 13)
+#define USBD_EndPoint13                USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 14)
+#define USBD_EndPoint14                USBD_CDC_ACM2_EP_INTIN_Event
+#elif  (USBD_CDC_ACM2_EP_INTIN == 15)
+#define USBD_EndPoint15                USBD_CDC_ACM2_EP_INTIN_Event
+#endif
+
+#if    (USBD_CDC_ACM2_EP_BULKIN == 1)
+#define USBD_EndPoint1                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 2)
+#define USBD_EndPoint2                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 3)
+#define USBD_EndPoint3                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 4)
+#define USBD_EndPoint4                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 5)
+#define USBD_EndPoint5                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 6)
+#define USBD_EndPoint6                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 7)
+#define USBD_EndPoint7                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 8)
+#define USBD_EndPoint8                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 9)
+#define USBD_EndPoint9                 USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 10)
+#define USBD_EndPoint10                USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 11)
+#define USBD_EndPoint11                USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 12)
+#define USBD_EndPoint12                USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 13)
+#define USBD_EndPoint13                USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 14)
+#define USBD_EndPoint14                USBD_CDC_ACM2_EP_BULK_Event
+#elif  (USBD_CDC_ACM2_EP_BULKIN == 15)
+#define USBD_EndPoint15                USBD_CDC_ACM2_EP_BULK_Event
+#endif
+#endif
 #else
 BOOL USBD_EndPoint0_Setup_CDC_ReqToIF(void)
 {
@@ -1595,7 +1759,7 @@ void USBD_RTX_TaskInit(void)
                                            USBD_MSC_ENABLE * USBD_MSC_DESC_LEN + USBD_CDC_ACM_ENABLE * USBD_CDC_ACM_DESC_LEN)
 
 #define USBD_WTOTALLENGTH_MAX              (USB_CONFIGUARTION_DESC_SIZE +                 \
-                                           USBD_CDC_ACM_DESC_LEN * USBD_CDC_ACM_ENABLE + \
+                                           USBD_CDC_ACM_DESC_LEN * USBD_CDC_ACM_NUM    + \
                                            USBD_HID_DESC_LEN     * USBD_HID_ENABLE     + \
                                            (USB_INTERFACE_DESC_SIZE) * USBD_WEBUSB_ENABLE + \
                                            USBD_BULK_DESC_LEN     * USBD_BULK_ENABLE + \
@@ -2330,7 +2494,7 @@ const U8 USBD_BinaryObjectStoreDescriptor[] = { 0 };
 /* USB Device Configuration Descriptor (for Full Speed) */
 /*   All Descriptors (Configuration, Interface, Endpoint, Class, Vendor) */
 __WEAK \
-U8 USBD_ConfigDescriptor[200] = { 0 };
+U8 USBD_ConfigDescriptor[USBD_WTOTALLENGTH_MAX + 1] = { 0 };
 
 #if (USBD_HS_ENABLE == 0)               /* If High-speed not enabled, declare dummy descriptors for High-speed */
 __WEAK \
@@ -2339,7 +2503,7 @@ U8 USBD_ConfigDescriptor_HS[] = { 0 };
 /* USB Device Configuration Descriptor (for High Speed) */
 /*   All Descriptors (Configuration, Interface, Endpoint, Class, Vendor) */
 __WEAK \
-U8 USBD_ConfigDescriptor_HS[200] = { 0 };
+U8 USBD_ConfigDescriptor_HS[USBD_WTOTALLENGTH_MAX + 1] = { 0 };
 
 #endif
 
@@ -2536,7 +2700,28 @@ static U16 hid_desc_fill(U8 * config_desc, U8 * config_desc_hs, U8 if_num) {
     return sizeof(hid_desc);
 }
 
-static U16 acm_cdc_desc_fill(U8 * config_desc, U8 * config_desc_hs, U8 if_num) {
+/* Set the interface and endpoint numbers of a CDC ACM instance */
+static void acm_cdc_desc_patch(U8 * pD, U8 instance, U8 if_num) {
+#if (USBD_MULTI_IF)
+    ((USB_INTERFACE_ASSOCIATION_DESCRIPTOR *)pD)->bFirstInterface = if_num;
+    pD += USB_INTERFACE_ASSOC_DESC_SIZE;
+#endif
+
+    ((USB_INTERFACE_DESCRIPTOR *)pD)->bInterfaceNumber = if_num;
+    pD += USB_INTERFACE_DESC_SIZE + CDC_HEADER_SIZE + CDC_CALL_MANAGEMENT_SIZE + CDC_ABSTRACT_CONTROL_MANAGEMENT_SIZE;
+    ((UNION_FUNCTIONAL_DESCRIPTOR*)pD)->bMasterInterface = if_num;
+    ((UNION_FUNCTIONAL_DESCRIPTOR*)pD)->bSlaveInterface0 = if_num + 1;
+    pD += CDC_UNION_SIZE;
+    ((USB_ENDPOINT_DESCRIPTOR *)pD)->bEndpointAddress = USB_ENDPOINT_IN(usbd_cdc_acm_ep_intin[instance]);
+    pD += USB_ENDPOINT_DESC_SIZE;
+    ((USB_INTERFACE_DESCRIPTOR *)pD)->bInterfaceNumber = if_num + 1;
+    pD += USB_INTERFACE_DESC_SIZE;
+    ((USB_ENDPOINT_DESCRIPTOR *)pD)->bEndpointAddress = USB_ENDPOINT_OUT(usbd_cdc_acm_ep_bulkout[instance]);
+    pD += USB_ENDPOINT_DESC_SIZE;
+    ((USB_ENDPOINT_DESCRIPTOR *)pD)->bEndpointAddress = USB_ENDPOINT_IN(usbd_cdc_acm_ep_bulkin[instance]);
+}
+
+static U16 acm_cdc_desc_fill(U8 * config_desc, U8 * config_desc_hs, U8 instance, U8 if_num) {
     U8 * pD = 0;
     const U8 cdc_desc[] = {
     #if (USBD_MULTI_IF)
@@ -2549,18 +2734,7 @@ static U16 acm_cdc_desc_fill(U8 * config_desc, U8 * config_desc_hs, U8 if_num) {
     };
     pD = config_desc;
     memcpy(pD, cdc_desc, sizeof(cdc_desc));
-
-#if (USBD_MULTI_IF)
-    ((USB_INTERFACE_ASSOCIATION_DESCRIPTOR *)pD)->bFirstInterface = if_num;
-    pD += USB_INTERFACE_ASSOC_DESC_SIZE;
-#endif
-
-    ((USB_INTERFACE_DESCRIPTOR *)pD)->bInterfaceNumber = if_num;
-    pD += USB_INTERFACE_DESC_SIZE + CDC_HEADER_SIZE + CDC_CALL_MANAGEMENT_SIZE + CDC_ABSTRACT_CONTROL_MANAGEMENT_SIZE;
-    ((UNION_FUNCTIONAL_DESCRIPTOR*)pD)->bMasterInterface = if_num;
-    ((UNION_FUNCTIONAL_DESCRIPTOR*)pD)->bSlaveInterface0 = if_num + 1;
-    pD += CDC_UNION_SIZE + USB_ENDPOINT_DESC_SIZE;
-    ((USB_INTERFACE_DESCRIPTOR *)pD)->bInterfaceNumber = if_num + 1;
+    acm_cdc_desc_patch(pD, instance, if_num);
 
 #if (USBD_HS_ENABLE == 1)
     const U8 cdc_desc_hs[] = {
@@ -2574,18 +2748,7 @@ static U16 acm_cdc_desc_fill(U8 * config_desc, U8 * config_desc_hs, U8 if_num) {
     };
      pD = config_desc_hs;
     memcpy(pD, cdc_desc_hs, sizeof(cdc_desc_hs));
-
-#if (USBD_MULTI_IF)
-    ((USB_INTERFACE_ASSOCIATION_DESCRIPTOR *)pD)->bFirstInterface = if_num;
-    pD += USB_INTERFACE_ASSOC_DESC_SIZE;
-#endif
-
-    ((USB_INTERFACE_DESCRIPTOR *)pD)->bInterfaceNumber = if_num;
-    pD += USB_INTERFACE_DESC_SIZE + CDC_HEADER_SIZE + CDC_CALL_MANAGEMENT_SIZE + CDC_ABSTRACT_CONTROL_MANAGEMENT_SIZE;
-    ((UNION_FUNCTIONAL_DESCRIPTOR*)pD)->bMasterInterface = if_num;
-    ((UNION_FUNCTIONAL_DESCRIPTOR*)pD)->bSlaveInterface0 = if_num + 1;
-    pD += CDC_UNION_SIZE + USB_ENDPOINT_DESC_SIZE;
-    ((USB_INTERFACE_DESCRIPTOR *)pD)->bInterfaceNumber = if_num +1 ;
+    acm_cdc_desc_patch(pD, instance, if_num);
 #endif  //(USBD_HS_ENABLE == 1)
     return sizeof(cdc_desc);
 }
@@ -2716,10 +2879,10 @@ void usbd_class_init(void)
 #endif //#if (USBD_MSC_ENABLE)
 
 #if (USBD_CDC_ACM_ENABLE)
-    usbd_cdc_acm_cif_num = if_num++;
-    usbd_cdc_acm_dif_num = if_num++;
-    desc_ptr += acm_cdc_desc_fill(&USBD_ConfigDescriptor[desc_ptr], &USBD_ConfigDescriptor_HS[desc_ptr], usbd_cdc_acm_cif_num);
-    USBD_CDC_ACM_Initialize();
+    usbd_cdc_acm_cif_num[0] = if_num++;
+    usbd_cdc_acm_dif_num[0] = if_num++;
+    desc_ptr += acm_cdc_desc_fill(&USBD_ConfigDescriptor[desc_ptr], &USBD_ConfigDescriptor_HS[desc_ptr], 0, usbd_cdc_acm_cif_num[0]);
+    USBD_CDC_ACM_Initialize(0);
 #endif
 
 #if (USBD_HID_ENABLE)
@@ -2739,6 +2902,16 @@ void usbd_class_init(void)
     usbd_bulk_init();
 #endif
 
+#if (USBD_CDC_ACM_NUM > 1)
+    // Further instances go last, so the interfaces before them keep their numbers
+    for (U8 n = 1; n < USBD_CDC_ACM_NUM; n++) {
+        usbd_cdc_acm_cif_num[n] = if_num++;
+        usbd_cdc_acm_dif_num[n] = if_num++;
+        desc_ptr += acm_cdc_desc_fill(&USBD_ConfigDescriptor[desc_ptr], &USBD_ConfigDescriptor_HS[desc_ptr], n, usbd_cdc_acm_cif_num[n]);
+        USBD_CDC_ACM_Initialize(n);
+    }
+#endif
+
 #if (USBD_CLS_ENABLE)
     usbd_cls_init();
 #endif
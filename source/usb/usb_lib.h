@@ -80,19 +80,21 @@ extern const U32 usbd_adc_cfg_b_s;
 extern       S16 USBD_ADC_DataBuf[];
 
 extern const U8 usbd_cdc_acm_enable;
-extern U8 usbd_cdc_acm_cif_num;
-extern U8 usbd_cdc_acm_dif_num;
+extern const U8 usbd_cdc_acm_num;
+extern U8 usbd_cdc_acm_cif_num[];
+extern U8 usbd_cdc_acm_dif_num[];
 extern const U8 usbd_cdc_acm_bufsize;
-extern const U8 usbd_cdc_acm_ep_intin;
-extern const U8 usbd_cdc_acm_ep_bulkin;
-extern const U8 usbd_cdc_acm_ep_bulkout;
+extern const U8 usbd_cdc_acm_ep_intin[];
+extern const U8 usbd_cdc_acm_ep_bulkin[];
+extern const U8 usbd_cdc_acm_ep_bulkout[];
 extern const U16 usbd_cdc_acm_sendbuf_sz;
 extern const U16 usbd_cdc_acm_receivebuf_sz;
 extern const U16 usbd_cdc_acm_maxpacketsize[2];
 extern const U16 usbd_cdc_acm_maxpacketsize1[2];
 extern U8 USBD_CDC_ACM_SendBuf[];
 extern U8 USBD_CDC_ACM_ReceiveBuf[];
-extern U8 USBD_CDC_ACM_NotifyBuf[10];
+extern U8 USBD_CDC_ACM_NotifyBuf[];
+extern USBD_CDC_ACM_STATE usbd_cdc_acm_state[];
 
 extern const U8 usbd_webusb_vendor_code;
 extern const U8 usbd_winusb_vendor_code;
@@ -23,6 +23,32 @@
 #define __USBD_CDC_ACM_H__
 
 
+/*--------------------------- Instance state ---------------------------------*/
+
+/* State of one CDC ACM instance, the instances are allocated in usb_lib.c    */
+typedef struct {
+    int32_t  data_send_access;            /* Send data is being accessed           */
+    int32_t  data_send_active;            /* Data is being sent                    */
+    int32_t  data_send_zlp;               /* ZLP needs to be sent                  */
+    int32_t  data_to_send_wr;             /* Bytes written to the send buffer      */
+    int32_t  data_to_send_rd;             /* Bytes read from the send buffer       */
+    uint8_t *ptr_data_to_send;            /* Send buffer write pointer             */
+    uint8_t *ptr_data_sent;               /* Send buffer read pointer              */
+    uint32_t data_send_frames;            /* Frames the send data has waited for   */
+    int32_t  data_send_due;               /* Bytes written that are due to be sent */
+
+    int32_t  data_read_access;            /* Receive data is being accessed        */
+    int32_t  data_receive_int_access;     /* Receive data is accessed from the IRQ */
+    int32_t  data_received_pending_pckts; /* Packets received but not handled      */
+    int32_t  data_no_space_for_receive;   /* No more space for reception           */
+    uint8_t *ptr_data_received;           /* Receive buffer write pointer          */
+    uint8_t *ptr_data_read;               /* Receive buffer read pointer           */
+
+    uint16_t control_line_state;          /* Bit 0 - DTR state, bit 1 - RTS state  */
+    CDC_LINE_CODING line_coding;          /* Communication settings                */
+} USBD_CDC_ACM_STATE;
+
+
 /*--------------------------- Event handling routines ------------------------*/
 
 extern void USBD_CDC_ACM_Reset_Event(void);
@@ -34,6 +60,11 @@ extern void USBD_CDC_ACM_EP_BULKIN_Event(U32 event);
 extern void USBD_CDC_ACM_EP_BULKOUT_Event(U32 event);
 extern void USBD_CDC_ACM_EP_BULK_Event(U32 event);
 
+extern void USBD_CDC_ACM1_EP_INTIN_Event(U32 event);
+extern void USBD_CDC_ACM1_EP_BULK_Event(U32 event);
+extern void USBD_CDC_ACM2_EP_INTIN_Event(U32 event);
+extern void USBD_CDC_ACM2_EP_BULK_Event(U32 event);
+
 #ifdef __RTX
 extern void USBD_RTX_CDC_ACM_EP_INTIN_Event(void);
 extern void USBD_RTX_CDC_ACM_EP_BULKIN_Event(void);
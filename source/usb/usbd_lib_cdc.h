@@ -25,15 +25,15 @@
 
 /*--------------------------- USB Requests -----------------------------------*/
 
-extern int32_t USBD_CDC_ACM_SendEncapsulatedCommand(void);
-extern int32_t USBD_CDC_ACM_GetEncapsulatedResponse(void);
-extern int32_t USBD_CDC_ACM_SetCommFeature(uint16_t feat);
-extern int32_t USBD_CDC_ACM_GetCommFeature(uint16_t feat);
-extern int32_t USBD_CDC_ACM_ClearCommFeature(uint16_t feat);
-extern int32_t USBD_CDC_ACM_SetLineCoding(void);
-extern int32_t USBD_CDC_ACM_GetLineCoding(void);
-extern int32_t USBD_CDC_ACM_SetControlLineState(uint16_t ctrl_bmp);
-extern int32_t USBD_CDC_ACM_SendBreak(uint16_t dur);
+extern int32_t USBD_CDC_ACM_SendEncapsulatedCommand(uint8_t instance);
+extern int32_t USBD_CDC_ACM_GetEncapsulatedResponse(uint8_t instance);
+extern int32_t USBD_CDC_ACM_SetCommFeature(uint8_t instance, uint16_t feat);
+extern int32_t USBD_CDC_ACM_GetCommFeature(uint8_t instance, uint16_t feat);
+extern int32_t USBD_CDC_ACM_ClearCommFeature(uint8_t instance, uint16_t feat);
+extern int32_t USBD_CDC_ACM_SetLineCoding(uint8_t instance);
+extern int32_t USBD_CDC_ACM_GetLineCoding(uint8_t instance);
+extern int32_t USBD_CDC_ACM_SetControlLineState(uint8_t instance, uint16_t ctrl_bmp);
+extern int32_t USBD_CDC_ACM_SendBreak(uint8_t instance, uint16_t dur);
 
 
 #endif  /* __USBD_LIB_CDC_H__ */
@@ -0,0 +1,370 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Record, report and replay the CMSIS-DAP command trace of a probe
+
+The trace is only in builds with DAP_TRACE_COUNT set. Typical use:
+
+    dap_trace.py record session.csv     # after running a debug session
+    dap_trace.py report session.csv     # time spent on the probe
+    dap_trace.py replay session.csv     # round trip time from the host
+"""
+
+from __future__ import print_function
+
+import argparse
+import csv
+import struct
+import sys
+import time
+
+ID_DAP_TRACE_READ = 0xA1
+TRACE_OP_READ = 0
+TRACE_OP_START = 1
+TRACE_OP_STOP = 2
+TRACE_RECORD_SIZE = 20
+TRACE_REQUEST_SIZE = 7
+
+DAP_OK = 0
+
+COMMAND_NAMES = {
+    0x00: "Info",
+    0x01: "HostStatus",
+    0x02: "Connect",
+    0x03: "Disconnect",
+    0x04: "TransferConfigure",
+    0x05: "Transfer",
+    0x06: "TransferBlock",
+    0x07: "TransferAbort",
+    0x08: "WriteABORT",
+    0x09: "Delay",
+    0x0A: "ResetTarget",
+    0x10: "SWJ_Pins",
+    0x11: "SWJ_Clock",
+    0x12: "SWJ_Sequence",
+    0x13: "SWD_Configure",
+    0x14: "JTAG_Sequence",
+    0x15: "JTAG_Configure",
+    0x16: "JTAG_IDCODE",
+    0x17: "SWO_Transport",
+    0x18: "SWO_Mode",
+    0x19: "SWO_Baudrate",
+    0x1A: "SWO_Control",
+    0x1B: "SWO_Status",
+    0x1C: "SWO_Data",
+    0x1D: "SWD_Sequence",
+    0x1E: "SWO_ExtendedStatus",
+    0x7E: "QueueCommands",
+    0x7F: "ExecuteCommands",
+}
+
+# Commands replayed from the head of the recorded request. The others
+# change the target or the probe state, or are vendor commands.
+REPLAY_AS_IS = (0x00, 0x01, 0x04, 0x07, 0x09, 0x11, 0x13, 0x1D)
+
+# DP register reads of RDBUFF and writes of ABORT have no side effect
+DP_READ_RDBUFF = 0x0E
+DP_WRITE_ABORT = 0x00
+
+
+def command_name(cmd):
+    if 0x80 <= cmd <= 0x9F:
+        return "Vendor%i" % (cmd - 0x80)
+    if cmd >= 0xA0:
+        return "VendorEx%i" % (cmd - 0xA0)
+    return COMMAND_NAMES.get(cmd, "0x%02x" % cmd)
+
+
+class UsbTransport(object):
+    """CMSIS-DAP v2 bulk interface, or the v1 HID interface"""
+
+    def __init__(self, vid, pid, serial=None):
+        import usb.core
+        import usb.util
+
+        def match(dev):
+            return serial is None or usb.util.get_string(dev, dev.iSerialNumber) == serial
+
+        dev = usb.core.find(idVendor=vid, idProduct=pid, custom_match=match)
+        if dev is None:
+            raise Exception("No probe found")
+        self._dev = dev
+        self._hid = False
+        self.ep_in = None
+        self.ep_out = None
+
+        config = dev.get_active_configuration()
+        for interface in config:
+            name = usb.util.get_string(dev, interface.iInterface) or ""
+            if "CMSIS-DAP" not in name:
+                continue
+            if interface.bInterfaceClass == 0x03 and self.ep_in is not None:
+                continue
+            self._hid = interface.bInterfaceClass == 0x03
+            for endpoint in interface:
+                if endpoint.bEndpointAddress & 0x80:
+                    self.ep_in = endpoint
+                else:
+                    self.ep_out = endpoint
+            num = interface.bInterfaceNumber
+            try:
+                if dev.is_kernel_driver_active(num):
+                    dev.detach_kernel_driver(num)
+            except (NotImplementedError, usb.core.USBError):
+                pass
+            usb.util.claim_interface(dev, num)
+            if not self._hid:
+                break
+        if self.ep_in is None or self.ep_out is None:
+            raise Exception("No CMSIS-DAP interface found")
+        self.packet_size = self.ep_in.wMaxPacketSize
+
+    def write(self, data):
+        if self._hid:
+            data = data + b"\0" * (self.packet_size - len(data))
+        self.ep_out.write(data)
+
+    def read(self):
+        return bytes(bytearray(self.ep_in.read(self.packet_size, 10 * 1000)))
+
+
+class TraceRecord(object):
+
+    FIELDS = ("timestamp", "duration", "request_size", "response_size",
+              "queued", "request")
+
+    def __init__(self, timestamp, duration, request_size, response_size,
+                 queued, request):
+        self.timestamp = timestamp
+        self.duration = duration
+        self.request_size = request_size
+        self.response_size = response_size
+        self.queued = queued
+        self.request = request
+
+    @property
+    def command(self):
+        return self.request[0]
+
+    @classmethod
+    def unpack(cls, data):
+        values = struct.unpack("<IIHHB", data[:13])
+        return cls(*(values + (bytes(bytearray(data[13:20])),)))
+
+
+def dap_command(transport, request):
+    transport.write(bytes(bytearray(request)))
+    response = transport.read()
+    if bytearray(response)[0] != bytearray(request)[0]:
+        raise Exception("Command 0x%02x not supported" % bytearray(request)[0])
+    return response
+
+
+def trace_command(transport, op, index=0):
+    response = bytearray(dap_command(transport, struct.pack(
+        "<BBH", ID_DAP_TRACE_READ, op, index)))
+    if response[1] != DAP_OK:
+        raise Exception("No trace in this build")
+    count, clock, n = struct.unpack("<HIB", bytes(response[2:9]))
+    records = [TraceRecord.unpack(response[9 + i * TRACE_RECORD_SIZE:])
+               for i in range(n)]
+    return count, clock, records
+
+
+def trace_download(transport):
+    """Stop the trace and read all of it, the oldest record first"""
+    count, clock, records = trace_command(transport, TRACE_OP_STOP)
+    while len(records) < count:
+        _, _, more = trace_command(transport, TRACE_OP_READ, len(records))
+        if not more:
+            break
+        records.extend(more)
+    return clock, records
+
+
+def save_csv(path, clock, records):
+    with open(path, "w") as f:
+        writer = csv.writer(f)
+        writer.writerow(("clock", clock))
+        writer.writerow(TraceRecord.FIELDS)
+        for record in records:
+            writer.writerow((record.timestamp, record.duration,
+                             record.request_size, record.response_size,
+                             record.queued,
+                             "".join("%02x" % b for b in bytearray(record.request))))
+
+
+def load_csv(path):
+    with open(path) as f:
+        reader = csv.reader(f)
+        clock = int(next(reader)[1])
+        next(reader)
+        records = [TraceRecord(int(row[0]), int(row[1]), int(row[2]),
+                               int(row[3]), int(row[4]),
+                               bytes(bytearray.fromhex(row[5])))
+                   for row in reader]
+    return clock, records
+
+
+def percentile(values, fraction):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * fraction))]
+
+
+def print_histograms(title, samples):
+    """Print samples of microseconds per command name"""
+    print(title)
+    print("%-20s %7s %9s %9s %9s" % ("Command", "Count", "Median", "P90", "Max"))
+    for name in sorted(samples, key=lambda n: -sum(samples[n])):
+        values = samples[name]
+        print("%-20s %7i %9.1f %9.1f %9.1f" % (
+            name, len(values), percentile(values, 0.5),
+            percentile(values, 0.9), max(values)))
+    for name in sorted(samples):
+        buckets = {}
+        for value in samples[name]:
+            bucket = 1
+            while bucket < value:
+                bucket *= 2
+            buckets[bucket] = buckets.get(bucket, 0) + 1
+        print("")
+        print("%s (us)" % name)
+        most = max(buckets.values())
+        for bucket in sorted(buckets):
+            print("  <= %7i %7i %s" % (bucket, buckets[bucket],
+                                       "#" * max(1, buckets[bucket] * 40 // most)))
+    print("")
+
+
+def report(clock, records):
+    samples = {}
+    queued = {}
+    for record in records:
+        name = command_name(record.command)
+        samples.setdefault(name, []).append(record.duration * 1e6 / clock)
+        queued.setdefault(name, []).append(record.queued)
+    print_histograms("Execution time on the probe, %i requests" % len(records),
+                     samples)
+    print("%-20s %9s %9s" % ("Command", "Queued", "Max"))
+    for name in sorted(queued):
+        values = queued[name]
+        print("%-20s %9.2f %9i" % (name, float(sum(values)) / len(values),
+                                   max(values)))
+
+
+def replay_request(record, packet_size):
+    """Build a request like the recorded one without its side effects"""
+    cmd = record.command
+    head = bytearray(record.request)
+    if cmd == 0x05:
+        # Transfer: the same number of DP reads
+        count = min(head[2], (packet_size - 3) // 4)
+        return bytearray([0x05, 0, count]) + bytearray([DP_READ_RDBUFF] * count)
+    if cmd == 0x06:
+        # TransferBlock: the same number of words to or from a DP register
+        count = head[2] | (head[3] << 8)
+        if head[4] & 0x02:
+            count = min(count, (packet_size - 4) // 4)
+            return bytearray(struct.pack("<BBHB", 0x06, 0, count, DP_READ_RDBUFF))
+        count = min(count, (packet_size - 5) // 4)
+        return (bytearray(struct.pack("<BBHB", 0x06, 0, count, DP_WRITE_ABORT)) +
+                bytearray(4 * count))
+    if cmd == 0x12:
+        # SWJ_Sequence: the same number of idle cycles, a line reset would
+        # need the IDCODE read again
+        bits = head[1] or 256
+        return bytearray([0x12, head[1]]) + bytearray((bits + 7) // 8)
+    if cmd in REPLAY_AS_IS:
+        size = min(max(record.request_size, 1), packet_size)
+        return head[:size] + bytearray(max(0, size - len(head)))
+    return None
+
+
+def replay_connect(transport):
+    """Select SWD, read the IDCODE and power up the debug port"""
+    dap_command(transport, [0x02, 0x01])
+    dap_command(transport, [0x04, 0x00, 0x40, 0x00, 0x00, 0x00])
+    dap_command(transport, [0x12, 51] + [0xFF] * 7)
+    dap_command(transport, [0x12, 16, 0x9E, 0xE7])
+    dap_command(transport, [0x12, 51] + [0xFF] * 7)
+    dap_command(transport, [0x12, 8, 0x00])
+    response = bytearray(dap_command(transport, [0x05, 0x00, 0x01, 0x02]))
+    if response[2] != 0x01:
+        raise Exception("No response from the target")
+    dap_command(transport, [0x05, 0x00, 0x01, 0x04, 0x00, 0x00, 0x00, 0x50])
+    return struct.unpack("<I", bytes(response[3:7]))[0]
+
+
+def replay(transport, records, repeat=1):
+    idcode = replay_connect(transport)
+    print("IDCODE 0x%08x" % idcode)
+    samples = {}
+    skipped = {}
+    for _ in range(repeat):
+        for record in records:
+            name = command_name(record.command)
+            request = replay_request(record, transport.packet_size)
+            if request is None:
+                skipped[name] = skipped.get(name, 0) + 1
+                continue
+            start = time.time()
+            dap_command(transport, request)
+            samples.setdefault(name, []).append((time.time() - start) * 1e6)
+    print_histograms("Round trip time from the host", samples)
+    for name in sorted(skipped):
+        print("Skipped %i %s" % (skipped[name], name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("action", choices=("record", "report", "replay", "start"),
+                        help="record: save the trace and record again, "
+                        "report: show the recorded times, "
+                        "replay: send the recorded commands again, "
+                        "start: clear the trace")
+    parser.add_argument("csv", nargs="?", help="trace file")
+    parser.add_argument("--vid", type=lambda x: int(x, 0), default=0x0D28)
+    parser.add_argument("--pid", type=lambda x: int(x, 0), default=0x0204)
+    parser.add_argument("--serial", help="serial number of the probe")
+    parser.add_argument("--repeat", type=int, default=1,
+                        help="times to replay the trace")
+    args = parser.parse_args()
+
+    if args.action != "start" and args.csv is None:
+        parser.error("a trace file is needed")
+
+    if args.action == "report":
+        report(*load_csv(args.csv))
+        return
+
+    transport = UsbTransport(args.vid, args.pid, args.serial)
+    if args.action == "start":
+        trace_command(transport, TRACE_OP_START)
+    elif args.action == "record":
+        clock, records = trace_download(transport)
+        trace_command(transport, TRACE_OP_START)
+        save_csv(args.csv, clock, records)
+        print("Saved %i requests to %s" % (len(records), args.csv))
+    else:
+        clock, records = load_csv(args.csv)
+        replay(transport, records, args.repeat)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,158 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""CMSIS-DAP v2 over the bulk endpoints, with word access to target memory
+
+Only what the tests need: SWD connect, DP power up and MEM-AP 0 reads and
+writes through DAP_TransferBlock.
+"""
+
+import struct
+
+from usbip import CLASS_VENDOR
+
+ID_DAP_INFO = 0x00
+ID_DAP_CONNECT = 0x02
+ID_DAP_DISCONNECT = 0x03
+ID_DAP_TRANSFER = 0x05
+ID_DAP_TRANSFER_BLOCK = 0x06
+ID_DAP_SWJ_SEQUENCE = 0x12
+DAP_INFO_PACKET_SIZE = 0xFF
+DAP_PORT_SWD = 1
+DAP_OK = 0x00
+TRANSFER_OK = 0x01
+
+# Transfer requests
+DP_READ_IDCODE = 0x02
+DP_WRITE_ABORT = 0x00
+DP_WRITE_CTRL_STAT = 0x04
+DP_READ_CTRL_STAT = 0x06
+DP_WRITE_SELECT = 0x08
+AP_WRITE_CSW = 0x01
+AP_WRITE_TAR = 0x05
+AP_WRITE_DRW = 0x0D
+AP_READ_DRW = 0x0F
+
+CSYSPWRUPACK_CDBGPWRUPACK = 0xA0000000
+CSYSPWRUPREQ_CDBGPWRUPREQ = 0x50000000
+CSW_WORD_AUTO_INCREMENT = 0x23000012
+TAR_WRAP = 1024
+
+
+class DapError(Exception):
+    pass
+
+
+class Dap(object):
+
+    def __init__(self, device):
+        self.device = device
+        interface = device.find_interface(CLASS_VENDOR)
+        self.ep_in = interface.ep_in
+        self.ep_out = interface.ep_out
+        self.packet_size = 64
+        response = self.command(bytes([ID_DAP_INFO, DAP_INFO_PACKET_SIZE]))
+        self.packet_size = struct.unpack("<H", response[2:4])[0]
+
+    def command(self, request):
+        self.device.bulk_write(self.ep_out, request)
+        response = self.device.bulk_read(self.ep_in, self.packet_size)
+        if response[0] != request[0]:
+            raise DapError("response 0x%02x to command 0x%02x" % (response[0], request[0]))
+        return response
+
+    def vendor(self, command, payload=b""):
+        """Send a vendor command, returns the response without the ID"""
+        return self.command(bytes([command]) + payload)[1:]
+
+    def connect(self):
+        if self.command(bytes([ID_DAP_CONNECT, DAP_PORT_SWD]))[1] != DAP_PORT_SWD:
+            raise DapError("SWD connect failed")
+        # Line reset, JTAG to SWD, line reset and idle cycles
+        self.command(bytes([ID_DAP_SWJ_SEQUENCE, 56]) + b"\xFF" * 7)
+        self.command(bytes([ID_DAP_SWJ_SEQUENCE, 16, 0x9E, 0xE7]))
+        self.command(bytes([ID_DAP_SWJ_SEQUENCE, 56]) + b"\xFF" * 7)
+        self.command(bytes([ID_DAP_SWJ_SEQUENCE, 8, 0x00]))
+        idcode = self.transfer([(DP_READ_IDCODE, None)])[0]
+        self.transfer([(DP_WRITE_ABORT, 0x1E), (DP_WRITE_SELECT, 0),
+                       (DP_WRITE_CTRL_STAT, CSYSPWRUPREQ_CDBGPWRUPREQ)])
+        for _ in range(100):
+            if self.transfer([(DP_READ_CTRL_STAT, None)])[0] & CSYSPWRUPACK_CDBGPWRUPACK == CSYSPWRUPACK_CDBGPWRUPACK:
+                break
+        else:
+            raise DapError("debug power up failed")
+        self.transfer([(AP_WRITE_CSW, CSW_WORD_AUTO_INCREMENT)])
+        return idcode
+
+    def disconnect(self):
+        self.command(bytes([ID_DAP_DISCONNECT]))
+
+    def transfer(self, requests):
+        """[(request, value or None for a read)] -> values read"""
+        packet = bytearray([ID_DAP_TRANSFER, 0, len(requests)])
+        reads = 0
+        for request, value in requests:
+            packet.append(request)
+            if value is None:
+                reads += 1
+            else:
+                packet += struct.pack("<I", value)
+        response = self.command(bytes(packet))
+        if response[1] != len(requests) or response[2] != TRANSFER_OK:
+            raise DapError("transfer failed after %i requests, ack %i" % (response[1], response[2]))
+        return list(struct.unpack("<%iI" % reads, response[3:3 + 4 * reads]))
+
+    def _blocks(self, addr, size):
+        # Blocks of whole packets that do not cross the TAR auto increment wrap
+        per_packet = (self.packet_size - 5) // 4 * 4
+        while size:
+            length = min(size, per_packet, TAR_WRAP - addr % TAR_WRAP)
+            yield addr, length
+            addr += length
+            size -= length
+
+    def write_memory(self, addr, data):
+        """Write whole words"""
+        if addr % 4 or len(data) % 4:
+            raise DapError("unaligned write")
+        pos = 0
+        for block_addr, length in self._blocks(addr, len(data)):
+            self.transfer([(AP_WRITE_TAR, block_addr)])
+            response = self.command(struct.pack("<BBHB", ID_DAP_TRANSFER_BLOCK, 0, length // 4, AP_WRITE_DRW) +
+                                    data[pos:pos + length])
+            if response[3] != TRANSFER_OK:
+                raise DapError("block write at 0x%08x failed" % block_addr)
+            pos += length
+
+    def read_memory(self, addr, size):
+        if addr % 4 or size % 4:
+            raise DapError("unaligned read")
+        data = b""
+        for block_addr, length in self._blocks(addr, size):
+            self.transfer([(AP_WRITE_TAR, block_addr)])
+            response = self.command(struct.pack("<BBHB", ID_DAP_TRANSFER_BLOCK, 0, length // 4, AP_READ_DRW))
+            if response[3] != TRANSFER_OK:
+                raise DapError("block read at 0x%08x failed" % block_addr)
+            data += response[4:4 + length]
+        return data
+
+    def write_words(self, addr, *words):
+        self.write_memory(addr, struct.pack("<%iI" % len(words), *words))
+
+    def read_words(self, addr, count):
+        return list(struct.unpack("<%iI" % count, self.read_memory(addr, 4 * count)))
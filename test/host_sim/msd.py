@@ -0,0 +1,167 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Mass storage access to the DAPLink drive without an OS file system
+
+Bulk only transport with the SCSI commands the firmware implements, and just
+enough FAT to list the root directory, read files and write a new file the way
+an OS does: data first, then the directory entry.
+"""
+
+import struct
+import time
+
+from usbip import CLASS_MSC, UsbipError
+
+SECTOR_SIZE = 512
+CBW_SIGNATURE = 0x43425355
+SCSI_TEST_UNIT_READY = 0x00
+SCSI_READ10 = 0x28
+SCSI_WRITE10 = 0x2A
+MAX_TRANSFER = 64 * SECTOR_SIZE
+
+
+class Drive(object):
+
+    def __init__(self, device):
+        self.device = device
+        interface = device.find_interface(CLASS_MSC)
+        self.ep_in = interface.ep_in
+        self.ep_out = interface.ep_out
+        self.tag = 0
+        self.mount()
+
+    def command(self, cdb, direction_in=True, length=0, data=b""):
+        """Run one SCSI command, returns (status, data)"""
+        self.tag += 1
+        cbw = struct.pack("<IIIBBB", CBW_SIGNATURE, self.tag, length, 0x80 if direction_in else 0, 0, len(cdb))
+        self.device.bulk_write(self.ep_out, cbw + cdb.ljust(16, b"\0"))
+        result = b""
+        if direction_in:
+            while len(result) < length:
+                result += self.device.bulk_read(self.ep_in, min(length - len(result), 4096))
+        else:
+            for pos in range(0, length, 4096):
+                self.device.bulk_write(self.ep_out, data[pos:pos + 4096])
+        csw = self.device.bulk_read(self.ep_in, 13)
+        tag, residue, status = struct.unpack("<xxxxIIB", csw)
+        if tag != self.tag:
+            raise UsbipError("CSW tag %i for CBW %i" % (tag, self.tag))
+        return status, result
+
+    def read(self, lba, count=1):
+        status, data = self.command(struct.pack(">BBIBHB", SCSI_READ10, 0, lba, 0, count, 0),
+                                    True, count * SECTOR_SIZE)
+        if status != 0:
+            raise UsbipError("read of sector %i failed" % lba)
+        return data
+
+    def write(self, lba, data):
+        count = len(data) // SECTOR_SIZE
+        status, _ = self.command(struct.pack(">BBIBHB", SCSI_WRITE10, 0, lba, 0, count, 0),
+                                 False, len(data), data)
+        if status != 0:
+            raise UsbipError("write of sector %i failed" % lba)
+
+    def ready(self):
+        status, _ = self.command(struct.pack(">B5x", SCSI_TEST_UNIT_READY), False)
+        return status == 0
+
+    def mount(self):
+        boot = self.read(0)
+        (self.sector_size, self.sectors_per_cluster, reserved, fats,
+         root_entries) = struct.unpack("<HBHBH", boot[11:19])
+        fat_sectors = struct.unpack("<H", boot[22:24])[0]
+        self.root_lba = reserved + fats * fat_sectors
+        self.root_sectors = root_entries * 32 // SECTOR_SIZE
+        self.data_lba = self.root_lba + self.root_sectors
+
+    def wait_remount(self, timeout=30):
+        """Wait for the drive to go away after a transfer and to come back"""
+        end = time.time() + timeout
+        gone = False
+        while time.time() < end:
+            if not self.ready():
+                gone = True
+            elif gone:
+                self.mount()
+                return
+            time.sleep(0.1)
+        raise UsbipError("drive did not remount")
+
+    def _root(self):
+        return self.read(self.root_lba, self.root_sectors)
+
+    def files(self):
+        """{8.3 name: (first cluster, size)} of the root directory"""
+        root = self._root()
+        result = {}
+        for pos in range(0, len(root), 32):
+            entry = root[pos:pos + 32]
+            if entry[0] in (0, 0xE5) or entry[11] & 0x0F == 0x0F or entry[11] & 0x08:
+                continue
+            name = entry[0:8].decode().rstrip() + "." + entry[8:11].decode().rstrip()
+            cluster, size = struct.unpack("<HI", entry[26:32])
+            result[name.rstrip(".")] = (cluster, size)
+        return result
+
+    def read_file(self, name):
+        files = self.files()
+        if name not in files:
+            return None
+        cluster, size = files[name]
+        lba = self.data_lba + (cluster - 2) * self.sectors_per_cluster
+        return self.read(lba, (size + SECTOR_SIZE - 1) // SECTOR_SIZE)[:size]
+
+    def copy(self, name, data, order=None, early=None):
+        """Write a file to a free cluster, then its directory entry
+
+        order lists the sector numbers of the file in the order they are
+        written, by default in sequence. early maps sector numbers, counted
+        from the start of the file, to data written before anything else,
+        like a host flushing its cache.
+        """
+        cluster_size = self.sectors_per_cluster * SECTOR_SIZE
+        used = [cluster + (size + cluster_size - 1) // cluster_size for cluster, size in self.files().values()]
+        cluster = max(used + [2]) + 16
+        lba = self.data_lba + (cluster - 2) * self.sectors_per_cluster
+        padded = data + b"\0" * (-len(data) % SECTOR_SIZE)
+        sectors = len(padded) // SECTOR_SIZE
+
+        for sector, content in sorted((early or {}).items()):
+            self.write(lba + sector, content)
+
+        if order is None:
+            step = MAX_TRANSFER // SECTOR_SIZE
+            for sector in range(0, sectors, step):
+                self.write(lba + sector, padded[sector * SECTOR_SIZE:(sector + step) * SECTOR_SIZE])
+        else:
+            for sector in order:
+                self.write(lba + sector, padded[sector * SECTOR_SIZE:(sector + 1) * SECTOR_SIZE])
+
+        base, _, ext = name.partition(".")
+        entry = (base.ljust(8) + ext.ljust(3)).encode() + b"\x20" + b"\0" * 14 + struct.pack("<HI", cluster, len(data))
+        root = self._root()
+        for pos in range(0, len(root), 32):
+            if root[pos] in (0, 0xE5):
+                break
+        else:
+            raise UsbipError("root directory full")
+        root = root[:pos] + entry + root[pos + 32:]
+        sector = pos // SECTOR_SIZE
+        self.write(self.root_lba + sector, root[sector * SECTOR_SIZE:(sector + 1) * SECTOR_SIZE])
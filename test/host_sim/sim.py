@@ -0,0 +1,116 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Start and stop a host_sim_target_if process for a test
+
+The executable is taken from DAPLINK_HOST_SIM, by default the output of
+
+    python tools/host_sim_build.py host_sim_target_if
+"""
+
+import os
+import shutil
+import socket
+import subprocess
+import tempfile
+import time
+
+from usbip import UsbipDevice
+
+DAPLINK_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+DEFAULT_EXECUTABLE = os.path.join(DAPLINK_DIR, "projectfiles", "host_sim", "host_sim_target_if",
+                                  "build", "host_sim_target_if")
+
+TARGET_FLASH_START = 0x00000000
+TARGET_FLASH_SIZE = 512 * 1024
+TARGET_SECTOR_SIZE = 4 * 1024
+TARGET_RAM_START = 0x20000000
+TARGET_RAM_SIZE = 64 * 1024
+
+
+def _free_port():
+    sock = socket.socket()
+    sock.bind(("127.0.0.1", 0))
+    port = sock.getsockname()[1]
+    sock.close()
+    return port
+
+
+class HostSim(object):
+    """One firmware process with a simulated target and its USB/IP device
+
+    target_flash is the initial content of the target flash, blank by default.
+    Extra environment variables are passed to the process.
+    """
+
+    def __init__(self, target_flash=None, **env):
+        self.executable = os.environ.get("DAPLINK_HOST_SIM", DEFAULT_EXECUTABLE)
+        self.directory = tempfile.mkdtemp(prefix="host_sim")
+        self.target_flash_path = os.path.join(self.directory, "target_flash.bin")
+        if target_flash is not None:
+            with open(self.target_flash_path, "wb") as f:
+                f.write(target_flash.ljust(TARGET_FLASH_SIZE, b"\xFF"))
+        self.port = _free_port()
+        self.env = dict(os.environ)
+        self.env.update({
+            "DAPLINK_SIM_TARGET_FLASH": self.target_flash_path,
+            "DAPLINK_SIM_USBIP_PORT": str(self.port),
+        })
+        self.env.update({key: str(value) for key, value in env.items()})
+        self.log_path = os.path.join(self.directory, "host_sim.log")
+        self.process = None
+        self.device = None
+
+    def start(self, timeout=10):
+        with open(self.log_path, "wb") as log:
+            self.process = subprocess.Popen([self.executable], cwd=self.directory, env=self.env,
+                                            stdout=log, stderr=subprocess.STDOUT)
+        end = time.time() + timeout
+        while True:
+            try:
+                self.device = UsbipDevice(port=self.port)
+                return self.device
+            except (OSError, EOFError):
+                if time.time() > end or self.process.poll() is not None:
+                    raise RuntimeError("host_sim did not start:\n" + self.log())
+                time.sleep(0.1)
+
+    def stop(self):
+        if self.device:
+            self.device.close()
+            self.device = None
+        if self.process:
+            self.process.terminate()
+            self.process.wait()
+            self.process = None
+
+    def log(self):
+        with open(self.log_path, "rb") as log:
+            return log.read().decode(errors="replace")
+
+    def target_flash(self):
+        with open(self.target_flash_path, "rb") as f:
+            return f.read()
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, *args):
+        self.stop()
+        shutil.rmtree(self.directory, ignore_errors=True)
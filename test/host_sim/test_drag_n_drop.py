@@ -0,0 +1,179 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Drag-n-drop programming of the simulated target"""
+
+import os
+import random
+import re
+import struct
+import sys
+import unittest
+
+from msd import Drive
+from sim import HostSim, TARGET_FLASH_SIZE, TARGET_SECTOR_SIZE
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "tools"))
+import dlz_pack  # noqa: E402
+
+UF2_PAYLOAD_SIZE = 256
+UF2_FLAG_FAMILY_ID = 0x2000
+UF2_OOO_ERROR = "without erasing or programming data twice"
+
+
+def make_image(size, seed):
+    """Random data behind a vector table the bin stream accepts"""
+    rnd = random.Random(seed)
+    vectors = struct.pack("<IIII", 0x20008000, 0x101, 0x105, 0x109)
+    return vectors + bytes(bytearray(rnd.getrandbits(8) for _ in range(size - len(vectors))))
+
+
+def make_uf2(data, start, family_id=None):
+    """One 512 byte block for each 256 bytes of data"""
+    count = (len(data) + UF2_PAYLOAD_SIZE - 1) // UF2_PAYLOAD_SIZE
+    flags = 0 if family_id is None else UF2_FLAG_FAMILY_ID
+    blocks = bytearray()
+    for number in range(count):
+        payload = data[number * UF2_PAYLOAD_SIZE:(number + 1) * UF2_PAYLOAD_SIZE]
+        blocks += struct.pack("<IIIIIIII", 0x0A324655, 0x9E5D5157, flags, start + number * UF2_PAYLOAD_SIZE,
+                              len(payload), number, count, family_id or 0)
+        blocks += payload.ljust(476, b"\0")
+        blocks += struct.pack("<I", 0x0AB16F30)
+    return bytes(blocks)
+
+
+def shuffled(count, seed, window=None):
+    """Sector numbers in random order, within windows of the given size"""
+    rnd = random.Random(seed)
+    window = window or count
+    order = []
+    for start in range(0, count, window):
+        part = list(range(start, min(start + window, count)))
+        rnd.shuffle(part)
+        order += part
+    return order
+
+
+class DragNDropTest(unittest.TestCase):
+
+    IMAGE_SIZE = 128 * 1024
+
+    def setUp(self):
+        self.image = make_image(self.IMAGE_SIZE, 1)
+        # Old content of the target, sectors the image does not cover must keep it
+        self.old_flash = make_image(TARGET_FLASH_SIZE, 2)
+
+    def program(self, sim, name, data, order=None, page_erase=False):
+        drive = Drive(sim.device)
+        if page_erase:
+            drive.copy("PAGE_ON.ACT", b"")
+            drive.wait_remount()
+        drive.copy(name, data, order)
+        drive.wait_remount()
+        return drive.read_file("FAIL.TXT")
+
+    def assert_programmed(self, flash, old_flash=None):
+        self.assertEqual(flash[:self.IMAGE_SIZE], self.image)
+        if old_flash is not None:
+            self.assertEqual(flash[self.IMAGE_SIZE:], old_flash[self.IMAGE_SIZE:])
+
+    def test_bin(self):
+        with HostSim() as sim:
+            self.assertIsNone(self.program(sim, "IMAGE.BIN", self.image))
+            self.assert_programmed(sim.target_flash())
+
+    def test_dlz_expanded_on_target(self):
+        # Compressed blocks go over SWD as they are and expand on the target
+        rnd = random.Random(5)
+        image = self.image[:16] + bytes(bytearray(rnd.choice(b"\0\1\xff") for _ in range(self.IMAGE_SIZE - 16)))
+        dlz = dlz_pack.pack_bin(image)
+        with HostSim() as sim:
+            drive = Drive(sim.device)
+            drive.copy("IMAGE.DLZ", dlz)
+            drive.wait_remount()
+            self.assertIsNone(drive.read_file("FAIL.TXT"))
+            self.assertEqual(sim.target_flash()[:self.IMAGE_SIZE], image)
+            perf = drive.read_file("PERF.TXT").decode()
+            swd_bytes = int(re.search(r"SWD write: \d+ us, (\d+) bytes", perf).group(1))
+            self.assertLess(swd_bytes, len(dlz))
+
+    def test_bin_page_erase(self):
+        # Sectors are erased ahead of the data, but never past the image
+        with HostSim(self.old_flash) as sim:
+            self.assertIsNone(self.program(sim, "IMAGE.BIN", self.image, page_erase=True))
+            self.assert_programmed(sim.target_flash(), self.old_flash)
+
+    def test_bin_stale_sector_before_start(self):
+        # A sector flushed before the file started is only used once the
+        # directory entry shows it is part of the file
+        sectors = self.IMAGE_SIZE // 512
+        early = {1: self.image[512:1024], sectors: b"\xA5" * 512}
+        with HostSim(self.old_flash) as sim:
+            drive = Drive(sim.device)
+            drive.copy("PAGE_ON.ACT", b"")
+            drive.wait_remount()
+            drive.copy("IMAGE.BIN", self.image, [0] + list(range(2, sectors)), early)
+            drive.wait_remount()
+            self.assertIsNone(drive.read_file("FAIL.TXT"))
+            self.assert_programmed(sim.target_flash(), self.old_flash)
+
+    def test_uf2_random_order(self):
+        uf2 = make_uf2(self.image, 0)
+        with HostSim(self.old_flash) as sim:
+            order = shuffled(len(uf2) // 512, 3)
+            self.assertIsNone(self.program(sim, "IMAGE.UF2", uf2, order))
+            self.assert_programmed(sim.target_flash())
+
+    def test_uf2_two_families(self):
+        # The simulated target has no UF2 family, the first one in the file
+        # is programmed and the other one, with fewer blocks, is skipped
+        uf2 = make_uf2(self.image, 0, 0x11111111)
+        other = make_uf2(self.image[:self.IMAGE_SIZE // 2][::-1], 0, 0x22222222)
+        blocks = bytearray()
+        for number in range(len(uf2) // 512):
+            blocks += uf2[number * 512:(number + 1) * 512]
+            blocks += other[number * 512:(number + 1) * 512]
+        with HostSim() as sim:
+            self.assertIsNone(self.program(sim, "IMAGE.UF2", bytes(blocks)))
+            self.assert_programmed(sim.target_flash())
+
+    def test_uf2_page_erase_windowed_order(self):
+        # Blocks shuffled within a few sectors leave few holes open at a time
+        uf2 = make_uf2(self.image, 0)
+        with HostSim(self.old_flash) as sim:
+            order = shuffled(len(uf2) // 512, 4, 2 * TARGET_SECTOR_SIZE // UF2_PAYLOAD_SIZE)
+            self.assertIsNone(self.program(sim, "IMAGE.UF2", uf2, order, page_erase=True))
+            self.assert_programmed(sim.target_flash(), self.old_flash)
+
+    def test_uf2_page_erase_random_order(self):
+        # Too many holes to track, the transfer may fail but never loses data
+        # by erasing a sector or programming a page twice
+        uf2 = make_uf2(self.image, 0)
+        for seed in range(3):
+            with HostSim(self.old_flash) as sim:
+                fail = self.program(sim, "IMAGE.UF2", uf2, shuffled(len(uf2) // 512, seed), page_erase=True)
+                flash = sim.target_flash()
+            if fail is None:
+                self.assert_programmed(flash, self.old_flash)
+            else:
+                self.assertIn(UF2_OOO_ERROR, fail.decode())
+                self.assertEqual(flash[self.IMAGE_SIZE:], self.old_flash[self.IMAGE_SIZE:])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,131 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""RTT bridge between the trace virtual COM port and the simulated target
+
+A SEGGER RTT control block is written to the target RAM with CMSIS-DAP, then
+the debugger lets go of the port and the bridge has to find the block and
+move data through its buffers.
+"""
+
+import struct
+import time
+import unittest
+
+from dap import Dap
+from sim import HostSim
+from usbip import CLASS_CDC_DATA, UsbipError
+
+ID_DAP_RTT_BRIDGE = 0x8F
+UART_COUNT = 2
+
+RTT_ID = b"SEGGER RTT".ljust(16, b"\0")
+# The ID crosses the boundary of two 256 byte scan chunks
+CB_ADDR = 0x200080F8
+UP_DESC_ADDR = CB_ADDR + 24
+DOWN_DESC_ADDR = UP_DESC_ADDR + 24
+UP_BUFFER = 0x20009000
+UP_SIZE = 64
+DOWN_BUFFER = 0x20009100
+DOWN_SIZE = 16
+DESC_WROFF = 12
+DESC_RDOFF = 16
+
+
+def buffer_desc(buffer, size, wroff, rdoff):
+    # sName, pBuffer, SizeOfBuffer, WrOff, RdOff, Flags
+    return struct.pack("<6I", 0, buffer, size, wroff, rdoff, 0)
+
+
+class RttBridgeTest(unittest.TestCase):
+
+    def setUp(self):
+        self.sim = HostSim()
+        self.sim.start()
+        self.dap = Dap(self.sim.device)
+        cdc = [i for i in self.sim.device.interfaces if i.cls == CLASS_CDC_DATA and i.ep_in]
+        self.cdc = cdc[UART_COUNT] if len(cdc) > UART_COUNT else cdc[0]
+
+    def tearDown(self):
+        self.sim.stop()
+
+    def place_control_block(self, up, down, up_data=b"", down_data=b""):
+        self.dap.connect()
+        self.dap.write_memory(UP_BUFFER, up_data.ljust(UP_SIZE, b"\0"))
+        self.dap.write_memory(DOWN_BUFFER, down_data.ljust(DOWN_SIZE, b"\0"))
+        self.dap.write_memory(CB_ADDR, RTT_ID + struct.pack("<II", 1, 1) +
+                              buffer_desc(UP_BUFFER, UP_SIZE, *up) +
+                              buffer_desc(DOWN_BUFFER, DOWN_SIZE, *down))
+        # The bridge powers the link up itself once the debugger is gone
+        self.dap.disconnect()
+        self.assertEqual(self.dap.vendor(ID_DAP_RTT_BRIDGE, b"\x01")[0], 0)
+
+    def read_cdc(self, size, timeout=5):
+        data = b""
+        end = time.time() + timeout
+        while len(data) < size and time.time() < end:
+            try:
+                data += self.sim.device.bulk_read(self.cdc.ep_in, 64, timeout=0.5)
+            except UsbipError:
+                pass
+        return data
+
+    def read_desc(self, addr):
+        self.dap.connect()
+        wroff, rdoff = self.dap.read_words(addr + DESC_WROFF, 2)
+        self.dap.disconnect()
+        return wroff, rdoff
+
+    def test_up_wraps(self):
+        # 14 bytes up to the end of the buffer and 20 from its start
+        first = b"0123456789ABCD"
+        second = b"abcdefghijklmnopqrst"
+        up_data = second + b"\0" * (UP_SIZE - len(second) - len(first)) + first
+        self.place_control_block((len(second), UP_SIZE - len(first)), (0, 0), up_data)
+
+        self.assertEqual(self.read_cdc(len(first + second)), first + second)
+        self.assertEqual(self.read_desc(UP_DESC_ADDR), (len(second), len(second)))
+
+    def test_down_wraps(self):
+        # Room for 6 bytes up to the end of the buffer and 9 from its start
+        self.place_control_block((0, 0), (10, 10))
+        message = b"Hello, RTT!!"
+        self.sim.device.bulk_write(self.cdc.ep_out, message)
+
+        end = time.time() + 5
+        while self.read_desc(DOWN_DESC_ADDR)[0] != 6 and time.time() < end:
+            time.sleep(0.1)
+        self.dap.connect()
+        data = self.dap.read_memory(DOWN_BUFFER, DOWN_SIZE)
+        wroff = self.dap.read_words(DOWN_DESC_ADDR + DESC_WROFF, 1)[0]
+        self.assertEqual(wroff, 6)
+        self.assertEqual(data[10:] + data[:6], message)
+
+    def test_disable(self):
+        self.place_control_block((4, 0), (0, 0), b"RTT!")
+        self.assertEqual(self.read_cdc(4), b"RTT!")
+        self.assertEqual(self.dap.vendor(ID_DAP_RTT_BRIDGE, b"\x00")[0], 0)
+        # Nothing comes from the RTT buffer any more
+        self.dap.connect()
+        self.dap.write_words(UP_DESC_ADDR + DESC_WROFF, 8)
+        self.dap.disconnect()
+        self.assertEqual(self.read_cdc(1, timeout=1), b"")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,206 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Minimal USB/IP client for the device exported by host_sim
+
+Transfers are submitted from any thread and completed by a reader thread, so
+a test can keep a bulk IN pending on one interface while it uses another.
+"""
+
+import socket
+import struct
+import threading
+
+USBIP_VERSION = 0x0111
+OP_REQ_IMPORT = 0x8003
+OP_REP_IMPORT_SIZE = 8 + 312
+USBIP_CMD_SUBMIT = 1
+USBIP_CMD_UNLINK = 2
+USBIP_RET_SUBMIT = 3
+USBIP_HEADER_SIZE = 48
+DEVID = 0x10001
+
+DESC_DEVICE = 1
+DESC_CONFIG = 2
+DESC_INTERFACE = 4
+DESC_ENDPOINT = 5
+
+CLASS_CDC_DATA = 0x0A
+CLASS_MSC = 0x08
+CLASS_VENDOR = 0xFF
+
+
+class UsbipError(Exception):
+    pass
+
+
+class Interface(object):
+    """Bulk endpoint numbers of one interface"""
+
+    def __init__(self, number, cls):
+        self.number = number
+        self.cls = cls
+        self.ep_in = None
+        self.ep_out = None
+
+
+class UsbipDevice(object):
+
+    def __init__(self, host="127.0.0.1", port=3240, busid=b"1-1", timeout=30):
+        self._sock = socket.create_connection((host, port), timeout)
+        try:
+            self._sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            self._sock.sendall(struct.pack(">HHI", USBIP_VERSION, OP_REQ_IMPORT, 0) + busid.ljust(32, b"\0"))
+            reply = self._recv(OP_REP_IMPORT_SIZE)
+            status = struct.unpack(">I", reply[4:8])[0]
+            if status != 0:
+                raise UsbipError("import of %s failed with status %i" % (busid, status))
+        except Exception:
+            self._sock.close()
+            raise
+        self._sock.settimeout(None)
+        self.timeout = timeout
+        self._seqnum = 0
+        self._lock = threading.Lock()
+        self._done = threading.Condition()
+        self._pending = {}
+        self._results = {}
+        self._closed = False
+        self._reader = threading.Thread(target=self._read_loop)
+        self._reader.daemon = True
+        self._reader.start()
+        self.interfaces = []
+        self._configure()
+
+    def close(self):
+        self._closed = True
+        self._sock.close()
+
+    def _recv(self, size):
+        data = b""
+        while len(data) < size:
+            chunk = self._sock.recv(size - len(data))
+            if not chunk:
+                raise EOFError("USB/IP connection closed")
+            data += chunk
+        return data
+
+    def _read_loop(self):
+        try:
+            while True:
+                header = self._recv(USBIP_HEADER_SIZE)
+                command, seqnum = struct.unpack(">II", header[:8])
+                status, actual = struct.unpack(">iI", header[20:28])
+                data = b""
+                if command == USBIP_RET_SUBMIT and self._pending.get(seqnum) and actual:
+                    data = self._recv(actual)
+                with self._done:
+                    self._results[seqnum] = (status, data, actual)
+                    self._done.notify_all()
+        except (EOFError, OSError):
+            with self._done:
+                self._closed = True
+                self._done.notify_all()
+
+    def _submit(self, command, ep, direction_in, length, data, setup, unlink_seqnum=0):
+        with self._lock:
+            self._seqnum += 1
+            seqnum = self._seqnum
+            self._pending[seqnum] = direction_in and command == USBIP_CMD_SUBMIT
+            header = struct.pack(">IIIII", command, seqnum, DEVID, 1 if direction_in else 0, ep)
+            if command == USBIP_CMD_UNLINK:
+                header += struct.pack(">I", unlink_seqnum).ljust(28, b"\0")
+            else:
+                header += struct.pack(">IiiIi", 0, length, 0, 0xFFFFFFFF, 0) + setup
+            self._sock.sendall(header + (b"" if direction_in else data))
+        return seqnum
+
+    def _wait(self, seqnum, timeout):
+        with self._done:
+            self._done.wait_for(lambda: seqnum in self._results or self._closed, timeout)
+            if self._closed and seqnum not in self._results:
+                raise UsbipError("connection closed")
+            return self._results.pop(seqnum, None)
+
+    def transfer(self, ep, direction_in, length, data=b"", setup=b"\0" * 8, timeout=None):
+        """Submit one URB and wait for it
+
+        Returns the data of an IN transfer or the length of an OUT transfer.
+        A transfer that times out is unlinked, so it cannot take data meant
+        for the next one.
+        """
+        seqnum = self._submit(USBIP_CMD_SUBMIT, ep, direction_in, length, data, setup)
+        result = self._wait(seqnum, timeout or self.timeout)
+        if result is None:
+            unlink = self._submit(USBIP_CMD_UNLINK, ep, direction_in, 0, b"", b"", seqnum)
+            self._wait(unlink, self.timeout)
+            del self._pending[unlink]
+            # It may have completed before the unlink
+            result = self._wait(seqnum, 0)
+        del self._pending[seqnum]
+        if result is None:
+            raise UsbipError("transfer on endpoint %i timed out" % ep)
+        status, data, actual = result
+        if status != 0:
+            raise UsbipError("transfer on endpoint %i failed with status %i" % (ep, status))
+        return data if direction_in else actual
+
+    def control(self, request_type, request, value, index, length_or_data=0):
+        direction_in = bool(request_type & 0x80)
+        data = b"" if direction_in else bytes(length_or_data or b"")
+        length = length_or_data if direction_in else len(data)
+        setup = struct.pack("<BBHHH", request_type, request, value, index, length)
+        return self.transfer(0, direction_in, length, data, setup)
+
+    def bulk_write(self, ep, data, timeout=None):
+        return self.transfer(ep, False, len(data), data, timeout=timeout)
+
+    def bulk_read(self, ep, length, timeout=None):
+        return self.transfer(ep, True, length, timeout=timeout)
+
+    def _configure(self):
+        """Select configuration 1 and find the bulk endpoints of each interface"""
+        self.control(0x80, 6, DESC_DEVICE << 8, 0, 18)
+        header = self.control(0x80, 6, DESC_CONFIG << 8, 0, 9)
+        total = struct.unpack("<H", header[2:4])[0]
+        config = self.control(0x80, 6, DESC_CONFIG << 8, 0, total)
+        self.control(0x00, 9, 1, 0)
+
+        interface = None
+        pos = 0
+        while pos + 2 <= len(config):
+            size, kind = config[pos], config[pos + 1]
+            if size == 0:
+                break
+            desc = config[pos:pos + size]
+            if kind == DESC_INTERFACE and desc[3] == 0:
+                interface = Interface(desc[2], desc[5])
+                self.interfaces.append(interface)
+            elif kind == DESC_ENDPOINT and interface is not None and (desc[3] & 3) == 2:
+                if desc[2] & 0x80:
+                    interface.ep_in = desc[2] & 0x0F
+                else:
+                    interface.ep_out = desc[2] & 0x0F
+            pos += size
+
+    def find_interface(self, cls):
+        """First interface of the class with a pair of bulk endpoints"""
+        for interface in self.interfaces:
+            if interface.cls == cls and interface.ep_in and interface.ep_out:
+                return interface
+        raise UsbipError("no interface of class 0x%02x" % cls)
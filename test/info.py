@@ -264,6 +264,7 @@ SUPPORTED_CONFIGURATIONS = [
 
 # Add new HICs here
 HIC_STRING_TO_ID = {
+    'host_sim': 0x686F7374,
     'k20dx': 0x97969900,
     'k26f': 0x97969909,
     'kl26z': 0x97969901,
@@ -0,0 +1,72 @@
+/**
+ * @file    itm_decode.c
+ * @brief   Host driver for the ITM decoder tests
+ *
+ * DAPLink Interface Firmware
+ * Copyright (c) 2026 Arm Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Usage: itm_decode <port mask> <chunk size> <output size> < capture
+//
+// Feeds the capture from stdin to the decoder in chunks, like the bridge
+// does with what SWO_ReadTrace() returns, into an output buffer of the
+// given size. Writes the forwarded bytes to stdout and the counters to
+// stderr.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "itm_decoder.h"
+
+#define MAX_SIZE    4096
+
+int main(int argc, char *argv[])
+{
+    static uint8_t capture[1024 * 1024];
+    uint8_t out[MAX_SIZE];
+    itm_decoder_t decoder;
+    uint32_t chunk_size;
+    uint32_t out_size;
+    uint32_t size;
+    uint32_t pos = 0;
+    uint32_t chunk_end;
+    uint32_t out_len;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s <port mask> <chunk size> <output size>\n", argv[0]);
+        return 2;
+    }
+    chunk_size = strtoul(argv[2], NULL, 0);
+    out_size = strtoul(argv[3], NULL, 0);
+    if ((chunk_size == 0) || (out_size == 0) || (out_size > MAX_SIZE)) {
+        return 2;
+    }
+
+    size = fread(capture, 1, sizeof(capture), stdin);
+    itm_decoder_init(&decoder, strtoul(argv[1], NULL, 0));
+
+    while (pos < size) {
+        chunk_end = (size - pos > chunk_size) ? pos + chunk_size : size;
+        // A full output buffer leaves the rest of the chunk for the next call
+        while (pos < chunk_end) {
+            pos += itm_decoder_process(&decoder, &capture[pos], chunk_end - pos, out, out_size, &out_len);
+            fwrite(out, 1, out_len, stdout);
+        }
+    }
+
+    fprintf(stderr, "dropped=%u overflows=%u\n", (unsigned)decoder.dropped, (unsigned)decoder.overflows);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Write swo_capture.bin, the ITM stream the decoder tests run on
+
+The stream models what a Cortex-M4 sends with the ITM, local and global
+timestamps, PC sampling and exception trace enabled, while it prints a log
+on stimulus ports 0 and 1 and debug values on port 2. Packet encodings are
+from the ARMv7-M Architecture Reference Manual, appendix D4. Writes
+swo_capture.expected with what ports 0 and 1 carry, and prints the counters the
+decoder ends with when it forwards those two ports.
+"""
+
+import os
+import random
+import struct
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+SYNC = b"\x00\x00\x00\x00\x00\x80"
+OVERFLOW = b"\x70"
+
+
+def continued(value, count):
+    """count 7 bit groups, all but the last with the C bit"""
+    out = bytearray()
+    for i in range(count):
+        group = (value >> (7 * i)) & 0x7F
+        out.append(group | (0x80 if i < count - 1 else 0))
+    return bytes(out)
+
+
+def local_ts(delta):
+    # Format 2 for small deltas, else format 1 with up to 4 payload bytes
+    if 0 < delta < 7:
+        return bytes([delta << 4])
+    count = 1
+    while delta >> (7 * count) and count < 4:
+        count += 1
+    return b"\xC0" + continued(delta, count)
+
+
+def global_ts1(value):
+    return b"\x94" + continued(value, 4)
+
+
+def global_ts2(value):
+    return b"\xB4" + continued(value, 4)
+
+
+def stimulus(port, data):
+    size = {1: 1, 2: 2, 4: 3}[len(data)]
+    return bytes([(port << 3) | size]) + data
+
+
+def hardware(discriminator, data):
+    size = {1: 1, 2: 2, 4: 3}[len(data)]
+    return bytes([(discriminator << 3) | 0x04 | size]) + data
+
+
+def port_page(page):
+    return bytes([0x08 | (page << 4)])
+
+
+def printf(port, text, width):
+    # ITM_SendChar writes bytes, optimized code writes words padded with zeros
+    out = b""
+    for pos in range(0, len(text), width):
+        out += stimulus(port, text[pos:pos + width].ljust(width, b"\0"))
+    return out
+
+
+class Capture(object):
+
+    def __init__(self):
+        self.stream = b""
+        self.forwarded = b""
+        self.dropped = 0
+        self.overflows = 0
+
+    def add(self, packet, forwarded=b"", dropped=0):
+        self.stream += packet
+        self.forwarded += forwarded
+        self.dropped += dropped
+
+    def log(self, port, text, width=1):
+        self.add(printf(port, text, width), text)
+
+    def debug_value(self, port, value):
+        self.add(stimulus(port, struct.pack("<I", value)), dropped=4)
+
+
+def build():
+    rnd = random.Random(26)
+    cap = Capture()
+    cap.add(SYNC)
+    cap.add(global_ts2(0x1234567))
+    cap.add(global_ts1(0x0ABCDEF))
+    cap.log(0, b"boot: DAPLink ITM test\n")
+    tick = 0
+    for line in range(40):
+        tick += rnd.randint(1, 5000)
+        cap.add(local_ts(rnd.choice([1, 3, 6, 100, 5000, 300000, 0x3FFFFFF])))
+        cap.log(0, b"tick %i: %i\n" % (line, tick), rnd.choice([1, 2, 4]))
+        if line % 3 == 0:
+            # PC sample and exception entry and return
+            cap.add(hardware(2, struct.pack("<I", 0x00001000 + line * 4)), dropped=4)
+            cap.add(hardware(1, struct.pack("<H", 0x100F)), dropped=2)
+            cap.add(hardware(1, struct.pack("<H", 0x300F)), dropped=2)
+        if line % 4 == 1:
+            cap.log(1, b"port1 line %i\r\n" % line, 4)
+            cap.debug_value(2, 0xDEAD0000 + line)
+        if line % 7 == 2:
+            # Ports 32 and up on another page, not forwarded
+            cap.add(port_page(1))
+            cap.add(printf(0, b"page one", 1), dropped=8)
+            cap.add(port_page(0))
+        if line % 10 == 5:
+            cap.add(OVERFLOW)
+            cap.overflows += 1
+            cap.add(global_ts1(tick))
+        if line % 13 == 6:
+            # Idle zeros and a sync packet between packets
+            cap.add(b"\x00" * 7 + b"\x80")
+        if line % 9 == 4:
+            # Extension packet with payload, a hardware source extension
+            cap.add(b"\x8C" + continued(0x1234, 2))
+    cap.log(0, b"done\n", 4)
+    return cap
+
+
+def main():
+    cap = build()
+    with open(os.path.join(HERE, "swo_capture.bin"), "wb") as f:
+        f.write(cap.stream)
+    with open(os.path.join(HERE, "swo_capture.expected"), "wb") as f:
+        f.write(cap.forwarded)
+    print("dropped=%i overflows=%i" % (cap.dropped, cap.overflows))
+
+
+if __name__ == "__main__":
+    main()
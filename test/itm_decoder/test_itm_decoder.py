@@ -0,0 +1,86 @@
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Decode swo_capture.bin with itm_decoder.c built for the host
+
+The capture is fed in chunks of several sizes, so packets are split between
+calls, and into output buffers small enough to stop the decoder early.
+"""
+
+import os
+import shutil
+import subprocess
+import tempfile
+import unittest
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DAPLINK_DIR = os.path.abspath(os.path.join(HERE, "..", ".."))
+DECODER_DIR = os.path.join(DAPLINK_DIR, "source", "daplink", "cmsis-dap")
+
+PORT_MASK = 0x3
+# Printed by make_capture.py
+DROPPED = 200
+OVERFLOWS = 4
+
+
+class ItmDecoderTest(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.build_dir = tempfile.mkdtemp(prefix="itm_decoder")
+        cls.program = os.path.join(cls.build_dir, "itm_decode")
+        subprocess.check_call([os.environ.get("CC", "gcc"), "-std=gnu99", "-Wall", "-Werror",
+                               "-I" + DECODER_DIR, "-o", cls.program,
+                               os.path.join(HERE, "itm_decode.c"),
+                               os.path.join(DECODER_DIR, "itm_decoder.c")])
+        with open(os.path.join(HERE, "swo_capture.bin"), "rb") as f:
+            cls.capture = f.read()
+        with open(os.path.join(HERE, "swo_capture.expected"), "rb") as f:
+            cls.expected = f.read()
+
+    @classmethod
+    def tearDownClass(cls):
+        shutil.rmtree(cls.build_dir, ignore_errors=True)
+
+    def decode(self, port_mask, chunk_size, out_size):
+        process = subprocess.Popen([self.program, str(port_mask), str(chunk_size), str(out_size)],
+                                   stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        out, counters = process.communicate(self.capture)
+        self.assertEqual(process.returncode, 0)
+        return out, counters.decode().strip()
+
+    def test_whole_capture(self):
+        out, counters = self.decode(PORT_MASK, len(self.capture), 4096)
+        self.assertEqual(out, self.expected)
+        self.assertEqual(counters, "dropped=%i overflows=%i" % (DROPPED, OVERFLOWS))
+
+    def test_split_packets(self):
+        for chunk_size in (1, 2, 3, 5, 7, 64):
+            for out_size in (1, 3, 64):
+                out, counters = self.decode(PORT_MASK, chunk_size, out_size)
+                self.assertEqual(out, self.expected, "chunk %i, output %i" % (chunk_size, out_size))
+                self.assertEqual(counters, "dropped=%i overflows=%i" % (DROPPED, OVERFLOWS))
+
+    def test_no_ports(self):
+        out, counters = self.decode(0, 64, 64)
+        self.assertEqual(out, b"")
+        self.assertTrue(counters.endswith(" overflows=%i" % OVERFLOWS))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -19,7 +19,9 @@
 from __future__ import absolute_import
 from __future__ import division
 import os
+import sys
 import time
+import struct
 import shutil
 import six
 import info
@@ -29,6 +31,9 @@ from test_info import TestInfo
 from pyocd.core.helpers import ConnectHelper
 from pyocd.core.memory_map import MemoryType
 
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'tools'))
+import dlz_pack
+
 
 def _same(d1, d2):
     assert type(d1) is bytearray
@@ -41,6 +46,43 @@ def _same(d1, d2):
     return True
 
 
+def _uf2(data, start, family_id=None):
+    """Split data into UF2 blocks of 256 bytes."""
+    payload_size = 256
+    num_blocks = (len(data) + payload_size - 1) // payload_size
+    flags = 0 if family_id is None else 0x2000
+    uf2 = bytearray()
+    for block_no in range(num_blocks):
+        payload = data[block_no * payload_size:(block_no + 1) * payload_size]
+        uf2 += struct.pack("<IIIIIIII", 0x0A324655, 0x9E5D5157, flags, start + block_no * payload_size,
+                           len(payload), block_no, num_blocks, family_id or 0)
+        uf2 += bytes(payload).ljust(476, b"\0")
+        uf2 += struct.pack("<I", 0x0AB16F30)
+    return uf2
+
+
+def _elf(segments, debug_size=0x4000):
+    """Build a 32 bit ARM ELF file with a PT_LOAD segment per (address, data)
+    and debug data after them, laid out like a linker does."""
+    phnum = len(segments)
+    offset = 0x100
+    phdrs = bytearray()
+    contents = bytearray()
+    for addr, data in segments:
+        phdrs += struct.pack("<IIIIIIII", 1, offset + len(contents), addr, addr,
+                             len(data), len(data), 5, 4)
+        contents += data
+        contents += b"\0" * (-len(contents) % 4)
+    elf = bytearray(b"\x7fELF" + bytes(bytearray([1, 1, 1])) + b"\0" * 9)
+    elf += struct.pack("<HHIIIIIHHHHHH", 2, 40, 1, segments[0][0] | 1, 52, 0, 0x5000000,
+                       52, 32, phnum, 40, 0, 0)
+    elf += phdrs
+    elf += b"\0" * (offset - len(elf))
+    elf += contents
+    elf += bytearray(os.urandom(debug_size))
+    return elf
+
+
 MOCK_DIR_LIST = [
     "test",
     "blarg",
@@ -380,6 +422,39 @@ def test_mass_storage(workspace, parent_test, quick=False):
         test.set_flush_size(0x1000)
         test.run()
 
+    # Test loading a compressed image
+    dlz_file_contents = bytearray(dlz_pack.pack_bin(bin_file_contents, start))
+    test = MassStorageTester(board, test_info, "Load compressed image")
+    test.set_programming_data(dlz_file_contents, 'image.dlz')
+    test.set_expected_data(bin_file_contents, start)
+    test.run()
+
+    # Test loading a compressed image with a bad block CRC
+    if not quick:
+        bad_dlz_file_contents = bytearray(dlz_file_contents)
+        bad_dlz_file_contents[16 + 8] ^= 0xFF
+        test = MassStorageTester(board, test_info, "Load compressed image with bad CRC")
+        test.set_programming_data(bad_dlz_file_contents, 'image.dlz')
+        test.set_expected_failure_msg("The compressed image cannot be decoded. Checksum calculation failure occurred.", "transient, user")
+        test.set_expected_data(None, start)
+        test.run()
+
+    # Test loading a UF2 file
+    uf2_file_contents = _uf2(bin_file_contents, start)
+    test = MassStorageTester(board, test_info, "Load UF2 file")
+    test.set_programming_data(uf2_file_contents, 'image.uf2')
+    test.set_expected_data(bin_file_contents, start)
+    test.run()
+
+    # Test loading an ELF file, segments are written in file order
+    half = len(bin_file_contents) // 2
+    elf_file_contents = _elf([(start + half, bin_file_contents[half:]),
+                              (start, bin_file_contents[:half])])
+    test = MassStorageTester(board, test_info, "Load ELF file")
+    test.set_programming_data(elf_file_contents, 'image.elf')
+    test.set_expected_data(bin_file_contents, start)
+    test.run()
+
     # Test loading a binary smaller than a sector
     if not bad_vector_table and not quick:
         test = MassStorageTester(board, test_info, "Load .bin smaller than sector")
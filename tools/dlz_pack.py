@@ -0,0 +1,225 @@
+#!/usr/bin/env python
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Pack a bin or hex image into a compressed .dlz image for drag-n-drop.
+
+The container is decoded by the DLZ stream of file_stream.c:
+
+    header  "DLZ1", start address, end address, flags       (4 x 32 bit)
+    block   address, size, compressed size, CRC-32 of data  (32, 16, 16, 32 bit)
+            compressed data, or the data itself when it does not compress
+    ...
+    end     block header with a size of 0
+
+Blocks hold at most 512 bytes and are LZ4 compressed independently, so the
+interface firmware only needs a block of RAM to expand them. Everything is
+little endian.
+"""
+
+from __future__ import absolute_import
+from __future__ import print_function
+
+import argparse
+import struct
+import zlib
+import os
+
+MAGIC = b"DLZ1"
+BLOCK_SIZE = 512
+FLAG_CONTIGUOUS = 1 << 0
+
+# LZ4 block format limits
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MATCH_LIMIT = 12
+MAX_OFFSET = 0xFFFF
+
+
+def _write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _write_sequence(out, literals, offset, match_length):
+    literal_length = len(literals)
+    token = min(literal_length, 15) << 4
+    if match_length:
+        token |= min(match_length - MIN_MATCH, 15)
+    out.append(token)
+    if literal_length >= 15:
+        _write_length(out, literal_length - 15)
+    out += literals
+    if match_length:
+        out += struct.pack("<H", offset)
+        if match_length - MIN_MATCH >= 15:
+            _write_length(out, match_length - MIN_MATCH - 15)
+
+
+def lz4_compress_block(data):
+    """Compress data as a single LZ4 block."""
+    data = bytes(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    pos = 0
+    limit = len(data) - MATCH_LIMIT
+    while pos < limit:
+        key = data[pos:pos + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = pos
+        if candidate is None or pos - candidate > MAX_OFFSET:
+            pos += 1
+            continue
+        length = MIN_MATCH
+        while (pos + length < len(data) - LAST_LITERALS and
+               data[candidate + length] == data[pos + length]):
+            length += 1
+        _write_sequence(out, data[anchor:pos], pos - candidate, length)
+        pos += length
+        anchor = pos
+    _write_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def _read_length(data, pos, length):
+    if length == 15:
+        while True:
+            value = data[pos]
+            pos += 1
+            length += value
+            if value != 255:
+                break
+    return length, pos
+
+
+def lz4_decompress_block(data, size):
+    """Expand a single LZ4 block of size bytes."""
+    out = bytearray()
+    pos = 0
+    while True:
+        token = data[pos]
+        literal_length, pos = _read_length(data, pos + 1, token >> 4)
+        out += data[pos:pos + literal_length]
+        pos += literal_length
+        if pos >= len(data):
+            break
+        offset = struct.unpack_from("<H", data, pos)[0]
+        match_length, pos = _read_length(data, pos + 2, token & 0xF)
+        match_length += MIN_MATCH
+        if offset == 0 or offset > len(out):
+            raise ValueError("Invalid match offset")
+        for _ in range(match_length):
+            out.append(out[-offset])
+    if len(out) != size:
+        raise ValueError("Block expands to %i bytes instead of %i" % (len(out), size))
+    return bytes(out)
+
+
+def pack(segments, contiguous=False):
+    """Pack a list of (address, data) segments into a .dlz image."""
+    segments = sorted((addr, bytes(data)) for addr, data in segments if data)
+    start = segments[0][0] if segments else 0
+    end = max(addr + len(data) for addr, data in segments) if segments else 0
+    out = bytearray(struct.pack("<4sIII", MAGIC, start, end, FLAG_CONTIGUOUS if contiguous else 0))
+    for addr, data in segments:
+        pos = 0
+        while pos < len(data):
+            # Keep the blocks aligned so they map onto flash pages
+            size = min(BLOCK_SIZE - (addr + pos) % BLOCK_SIZE, len(data) - pos)
+            block = data[pos:pos + size]
+            compressed = lz4_compress_block(block)
+            if len(compressed) >= size:
+                compressed = block
+            out += struct.pack("<IHHI", addr + pos, size, len(compressed), zlib.crc32(block) & 0xFFFFFFFF)
+            out += compressed
+            pos += size
+    out += struct.pack("<IHHI", 0, 0, 0, 0)
+    return bytes(out)
+
+
+def pack_bin(data, start=0):
+    """Pack a binary image loaded at start."""
+    return pack([(start, data)], contiguous=True)
+
+
+def unpack(image):
+    """Expand a .dlz image into a list of (address, data) blocks."""
+    magic, start, end, flags = struct.unpack_from("<4sIII", image, 0)
+    if magic != MAGIC:
+        raise ValueError("Not a compressed image")
+    blocks = []
+    pos = 16
+    while True:
+        addr, size, compressed_size, crc = struct.unpack_from("<IHHI", image, pos)
+        pos += 12
+        if size == 0:
+            break
+        compressed = image[pos:pos + compressed_size]
+        pos += compressed_size
+        data = compressed if compressed_size == size else lz4_decompress_block(compressed, size)
+        if zlib.crc32(data) & 0xFFFFFFFF != crc:
+            raise ValueError("CRC mismatch in block at 0x%x" % addr)
+        if addr < start or addr + size > end:
+            raise ValueError("Block at 0x%x is outside of the image" % addr)
+        blocks.append((addr, data))
+    return blocks
+
+
+def load_segments(file_name, start):
+    if file_name.lower().endswith(".hex"):
+        from intelhex import IntelHex
+        intel_hex = IntelHex(file_name)
+        segments = [(seg_start, intel_hex.tobinstr(seg_start, seg_end - 1))
+                    for seg_start, seg_end in intel_hex.segments()]
+        return segments, len(segments) == 1
+    with open(file_name, "rb") as bin_file:
+        return [(start, bin_file.read())], True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack a bin or hex image into a compressed .dlz image')
+    parser.add_argument('input', help='Image to pack, .bin or .hex')
+    parser.add_argument('-o', '--output', type=str, help='Output file (default: input with a .dlz extension)')
+    parser.add_argument('--start', type=lambda value: int(value, 0), default=0,
+                        help='Load address of a .bin image (default: 0)')
+    args = parser.parse_args()
+
+    segments, contiguous = load_segments(args.input, args.start)
+    image = pack(segments, contiguous)
+
+    # Round trip before writing anything
+    expected = [(addr, data) for addr, data in sorted(segments) if data]
+    blocks = unpack(image)
+    for addr, data in expected:
+        unpacked = b"".join(block for block_addr, block in blocks
+                            if addr <= block_addr < addr + len(data))
+        if unpacked != data:
+            raise ValueError("Round trip failed for segment at 0x%x" % addr)
+
+    output = args.output or os.path.splitext(args.input)[0] + ".dlz"
+    with open(output, "wb") as dlz_file:
+        dlz_file.write(image)
+    size = sum(len(data) for _, data in segments)
+    print("Packed %i bytes into %i (%.1fx) in %s" % (size, len(image), float(size) / len(image), output))
+
+
+if __name__ == "__main__":
+    main()
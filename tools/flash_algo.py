@@ -33,6 +33,128 @@ from elftools.elf.sections import SymbolTableSection
 logger = logging.getLogger(__name__)
 logger.addHandler(logging.NullHandler())
 
+# ProgramPages(adr, sz, buf): call ProgramPage for every page of a buffer
+# larger than a page, so a single call from DAPLink programs all of it.
+# Cortex-M0 Thumb code, position independent, followed by two literals.
+PROGRAM_PAGES_CODE = (
+    0xb5f0,     # push  {r4-r7, lr}
+    0x4604,     # mov   r4, r0              ; adr
+    0x460d,     # mov   r5, r1              ; bytes left
+    0x4616,     # mov   r6, r2              ; buf
+    0x2d00,     # loop: cmp r5, #0
+    0xd00e,     # beq   done
+    0x4908,     # ldr   r1, page_size
+    0x428d,     # cmp   r5, r1
+    0xd200,     # bhs   1f
+    0x4629,     # mov   r1, r5              ; last page
+    0x460f,     # 1: mov r7, r1
+    0x4620,     # mov   r0, r4
+    0x4632,     # mov   r2, r6
+    0x4b06,     # ldr   r3, program_page
+    0x4798,     # blx   r3
+    0x2800,     # cmp   r0, #0
+    0xd104,     # bne   fail
+    0x19e4,     # adds  r4, r4, r7
+    0x19f6,     # adds  r6, r6, r7
+    0x1bed,     # subs  r5, r5, r7
+    0xe7ee,     # b     loop
+    0x2000,     # done: movs r0, #0
+    0xbdf0,     # fail: pop {r4-r7, pc}
+    0x46c0,     # nop, aligns the literals
+)
+
+
+# ProgramCompressed(adr, sz, src, src_sz): expand the LZ4 block of src_sz
+# bytes at src into the program buffer and program the sz bytes it holds
+# with ProgramPages, or ProgramPage when the buffer is a single page. Returns
+# 1 if the block does not expand to sz bytes. DAPLink checks the block
+# before it sends it. Cortex-M0 Thumb code, position independent, followed by
+# two literals.
+PROGRAM_COMPRESSED_CODE = (
+    0xb5f0,     # push  {r4-r7, lr}
+    0xb403,     # push  {r0, r1}
+    0x18d3,     # adds  r3, r2, r3          ; src end
+    0x4c1c,     # ldr   r4, buffer          ; dst
+    0x429a,     # token: cmp r2, r3
+    0xd22a,     # bhs   done
+    0x7815,     # ldrb  r5, [r2]            ; token
+    0x3201,     # adds  r2, #1
+    0x092e,     # lsrs  r6, r5, #4          ; literal length
+    0x2e0f,     # cmp   r6, #15
+    0xd104,     # bne   lit
+    0x7817,     # 1: ldrb r7, [r2]
+    0x3201,     # adds  r2, #1
+    0x19f6,     # adds  r6, r6, r7
+    0x2fff,     # cmp   r7, #255
+    0xd0fa,     # beq   1b
+    0x2e00,     # lit: cmp r6, #0
+    0xd005,     # beq   2f
+    0x7817,     # 3: ldrb r7, [r2]          ; copy literals
+    0x7027,     # strb  r7, [r4]
+    0x3201,     # adds  r2, #1
+    0x3401,     # adds  r4, #1
+    0x3e01,     # subs  r6, #1
+    0xd1f9,     # bne   3b
+    0x429a,     # 2: cmp r2, r3             ; the last sequence has no match
+    0xd216,     # bhs   done
+    0x7816,     # ldrb  r6, [r2]            ; offset
+    0x7857,     # ldrb  r7, [r2, #1]
+    0x023f,     # lsls  r7, r7, #8
+    0x433e,     # orrs  r6, r7
+    0x3202,     # adds  r2, #2
+    0x072d,     # lsls  r5, r5, #28         ; match length
+    0x0f2d,     # lsrs  r5, r5, #28
+    0x2d0f,     # cmp   r5, #15
+    0xd104,     # bne   4f
+    0x7817,     # 5: ldrb r7, [r2]
+    0x3201,     # adds  r2, #1
+    0x19ed,     # adds  r5, r5, r7
+    0x2fff,     # cmp   r7, #255
+    0xd0fa,     # beq   5b
+    0x3504,     # 4: adds r5, #4
+    0x1ba6,     # subs  r6, r4, r6
+    0x7837,     # 6: ldrb r7, [r6]          ; copy match, may overlap
+    0x7027,     # strb  r7, [r4]
+    0x3601,     # adds  r6, #1
+    0x3401,     # adds  r4, #1
+    0x3d01,     # subs  r5, #1
+    0xd1f9,     # bne   6b
+    0xe7d2,     # b     token
+    0xbc03,     # done: pop {r0, r1}
+    0x4a04,     # ldr   r2, buffer
+    0x1aa4,     # subs  r4, r4, r2
+    0x428c,     # cmp   r4, r1
+    0xd102,     # bne   fail
+    0x4b03,     # ldr   r3, program_pages
+    0x4798,     # blx   r3
+    0xbdf0,     # pop   {r4-r7, pc}
+    0x2001,     # fail: movs r0, #1
+    0xbdf0,     # pop   {r4-r7, pc}
+    0x46c0,     # nop, aligns the literals
+)
+
+
+def program_pages_routine(page_size, program_page):
+    """Return the ProgramPages routine as 32 bit words
+
+    :param page_size: Largest size ProgramPage accepts
+    :param program_page: Address of ProgramPage in target RAM
+    """
+    code = struct.pack("<%iH" % len(PROGRAM_PAGES_CODE), *PROGRAM_PAGES_CODE)
+    code += struct.pack("<II", page_size, program_page | 1)
+    return list(struct.unpack("<%iI" % (len(code) // 4), code))
+
+
+def program_compressed_routine(program_buffer, program_pages):
+    """Return the ProgramCompressed routine as 32 bit words
+
+    :param program_buffer: Address of the program buffer in target RAM
+    :param program_pages: Address of ProgramPages, or of ProgramPage
+    """
+    code = struct.pack("<%iH" % len(PROGRAM_COMPRESSED_CODE), *PROGRAM_COMPRESSED_CODE)
+    code += struct.pack("<II", program_buffer, program_pages | 1)
+    return list(struct.unpack("<%iI" % (len(code) // 4), code))
+
 
 def main():
     parser = argparse.ArgumentParser(description="Algo Extracter")
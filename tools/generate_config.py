@@ -32,17 +32,19 @@ CFG_KEY = 0x6b766c64
 # 8  - automation_allowed
 # 8  - overflow_detect
 # 8  - detect_incompatible_target
+# 8  - cdc_latency
 # 0  - 'end' member omitted
-FORMAT = '<LHBBBB'
+FORMAT = '<LHBBBBB'
 FORMAT_LENGTH = struct.calcsize(FORMAT)
 MINIMUM_ALIGN = 1 << 10  # 1k aligned
 
 
 def create_hex(filename, addr, auto_rst, automation_allowed,
-               overflow_detect, detect_incompatible_target, pad_size):
+               overflow_detect, detect_incompatible_target, cdc_latency, pad_size):
     intel_hex = IntelHex()
     intel_hex.puts(addr, struct.pack(FORMAT, CFG_KEY, FORMAT_LENGTH, auto_rst,
-                                     automation_allowed, overflow_detect, detect_incompatible_target))
+                                     automation_allowed, overflow_detect, detect_incompatible_target,
+                                     cdc_latency))
     pad_addr = addr + FORMAT_LENGTH
     pad_byte_count = pad_size - (FORMAT_LENGTH % pad_size)
     pad_data = '\xFF' * pad_byte_count
@@ -61,6 +63,7 @@ parser.add_argument("--auto_rst", type=int, required=True, choices=[0, 1], help=
 parser.add_argument("--automation_allowed", type=int, required=True, choices=[0,1], help="Allow automation from filesystem interaction")
 parser.add_argument("--overflow_detect", type=int, required=True, choices=[0,1], help="Enable detection of UART overflow")
 parser.add_argument("--detect_incompatible_target", type=int, default=0, choices=[0,1], help="Enable detection of incompatible target image")
+parser.add_argument("--cdc_latency", type=int, default=0, choices=range(256), metavar="{0..255}", help="Milliseconds the virtual COM port may hold a partial packet")
 parser.add_argument("--pad", type=int, default=16, choices=POWERS_OF_TWO, metavar="{1, 2, 4,...}", help="Byte aligned boundary to pad region to")
 parser.add_argument("--output_file", type=str, default='settings.hex', help="Name of output file")
 
@@ -78,9 +81,11 @@ def main():
     print("  automation_allowed: %i" % args.automation_allowed)
     print("  overflow_detect: %i" % args.overflow_detect)
     print("  detect_incompatible_target: %i" % args.detect_incompatible_target)
+    print("  cdc_latency: %i" % args.cdc_latency)
     print("")
     create_hex(args.output_file, args.addr, args.auto_rst,
-               args.automation_allowed, args.overflow_detect, args.detect_incompatible_target, args.pad)
+               args.automation_allowed, args.overflow_detect, args.detect_incompatible_target,
+               args.cdc_latency, args.pad)
 
 if __name__ == '__main__':
     main()
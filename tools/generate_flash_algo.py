@@ -27,6 +27,7 @@ import os
 import struct
 from datetime import datetime
 from pyocd.target.pack.flash_algo import PackFlashAlgo
+from flash_algo import program_pages_routine, program_compressed_routine
 
 # This header consists of two instructions:
 #
@@ -70,6 +71,14 @@ DAPLINK_TEMPLATE = \
 static const uint32_t {{name}}_flash_prog_blob[] = {
     {{prog_header}}
     {{algo.format_algo_data(4, 8, "c")}}
+{%- if program_pages %},
+
+    // ProgramPages, calls ProgramPage for every page of the program buffer
+    {{program_pages}}
+{%- endif %},
+
+    // ProgramCompressed, expands an LZ4 block into the program buffer and programs it
+    {{program_compressed}}
 };
 
 // Start address of flash
@@ -120,7 +129,17 @@ static const program_target_t flash = {
     // address of prog_blob
     {{name}}_flash_prog_blob,
     // ram_to_flash_bytes_to_be_written
-    {{'0x%08x' % algo.page_size}}
+    {{'0x%08x' % program_buffer_size}},
+    // algo_flags
+    0x00000000,
+    // ProgramPages
+{%- if program_pages %}
+    {{'0x%08x' % (program_pages_offset + entry + 1)}},
+{%- else %}
+    0x00000000,
+{%- endif %}
+    // ProgramCompressed
+    {{'0x%08x' % (program_compressed_offset + entry + 1)}}
 };
 
 """
@@ -199,6 +218,11 @@ def main():
                         "address of the flash blob in target RAM.")
     parser.add_argument("--stack-size", default=STACK_SIZE, type=str_to_num, help="Stack size for the algo "
                         f"(default {STACK_SIZE}).")
+    parser.add_argument("--program-buffer-size", default=None, type=str_to_num, help="Size of the program "
+                        "buffer, a multiple of the page size. When larger than a page, a ProgramPages routine "
+                        "is added so each call programs the whole buffer (default is the page size). A "
+                        "ProgramCompressed routine is always added, it needs room for a compressed block after "
+                        "the data in the buffer.")
     parser.add_argument("--pack-path", default=None, help="Path to pack file from which flash algo is from")
     parser.add_argument("-i", "--info-only", action="store_true", help="Only print information about the flash "
                         "algo, do not generate a blob.")
@@ -224,10 +248,28 @@ def main():
 
         print(algo.flash_info)
 
+        program_buffer_size = args.program_buffer_size or algo.page_size
+        if program_buffer_size % algo.page_size:
+            raise ValueError(f"Program buffer size {program_buffer_size:#x} is not a multiple of "
+                             f"the page size {algo.page_size:#x}")
+
         # Allocate stack after algo and its rw/zi data, with bottom rounded to 8 bytes.
         stack_base = (args.blob_start + HEADER_SIZE
                         + algo.rw_start + algo.rw_size # rw_start incorporates instruction size
                         + algo.zi_size)
+
+        # ProgramPages goes after the algo data, which is padded to words in the blob
+        program_page = args.blob_start + HEADER_SIZE + algo.symbols['ProgramPage']
+        program_pages = None
+        program_pages_offset = HEADER_SIZE + (len(algo.algo_data) + 3) // 4 * 4
+        program_compressed_offset = program_pages_offset
+        if program_buffer_size > algo.page_size:
+            program_pages = program_pages_routine(algo.page_size, program_page)
+            program_compressed_offset += 4 * len(program_pages)
+        # ProgramCompressed follows, it only takes the address of the buffer,
+        # which is placed after the code
+        program_compressed_size = 4 * len(program_compressed_routine(0, 0))
+        stack_base = max(stack_base, args.blob_start + program_compressed_offset + program_compressed_size)
         stack_base = (stack_base + 7) // 8 * 8
         # Stack top rounded to at least 256 bytes
         sp = stack_base + args.stack_size
@@ -235,6 +277,8 @@ def main():
             sp = (sp + algo.page_size - 1) // algo.page_size * algo.page_size
         else:
             sp = (sp + 255) // 256 * 256
+        program_compressed = program_compressed_routine(
+            sp, args.blob_start + program_pages_offset if program_pages else program_page)
 
         print(f"load addr:   {args.blob_start:#010x}")
         print(f"header:      {HEADER_SIZE:#x} bytes")
@@ -243,7 +287,10 @@ def main():
         print(f"rw:          {algo.rw_start:#010x} + {algo.rw_size:#x} bytes")
         print(f"zi:          {algo.zi_start:#010x} + {algo.zi_size:#x} bytes")
         print(f"stack:       {stack_base:#010x} .. {sp:#010x} ({sp - stack_base:#x} bytes)")
-        print(f"buffer:      {sp:#010x} .. {sp + algo.page_size:#010x} ({algo.page_size:#x} bytes)")
+        if program_pages:
+            print(f"ProgramPages:{args.blob_start + program_pages_offset:#010x} + {4 * len(program_pages):#x} bytes")
+        print(f"ProgramCompressed: {args.blob_start + program_compressed_offset:#010x} + {program_compressed_size:#x} bytes")
+        print(f"buffer:      {sp:#010x} .. {sp + program_buffer_size:#010x} ({program_buffer_size:#x} bytes)")
 
         print("\nSymbol offsets:")
         for n, v in sorted(algo.symbols.items(), key=lambda x: x[1]):
@@ -282,6 +329,13 @@ def main():
             'header_size': HEADER_SIZE,
             'entry': args.blob_start,
             'stack_pointer': sp,
+            'program_buffer_size': program_buffer_size,
+            'program_pages': ",\n    ".join(", ".join("0x%08x" % word for word in program_pages[pos:pos + 8])
+                                              for pos in range(0, len(program_pages), 8)) if program_pages else None,
+            'program_pages_offset': program_pages_offset,
+            'program_compressed': ",\n    ".join(", ".join("0x%08x" % word for word in program_compressed[pos:pos + 8])
+                                                   for pos in range(0, len(program_compressed), 8)),
+            'program_compressed_offset': program_compressed_offset,
             'year': datetime.now().year if args.copyright else ("2009-%d" % datetime.now().year),
             'copyright_owner': args.copyright or "Arm Limited, All Rights Reserved",
         }
@@ -0,0 +1,147 @@
+#!/usr/bin/env python
+#
+# DAPLink Interface Firmware
+# Copyright (c) 2026, ARM Limited, All Rights Reserved
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Build a host_sim project as a process for the development machine.
+
+project_generator only exports the ARM toolchains, so this script reads the
+common section of the project records in projects.yaml and compiles the
+sources with the host gcc. The result is started directly, see
+docs/hic/host_sim.md.
+"""
+
+from __future__ import absolute_import
+from __future__ import print_function
+
+from multiprocessing.pool import ThreadPool
+from pre_build_script import generate_version_file
+import subprocess
+import argparse
+import yaml
+import sys
+import os
+
+self_path = os.path.abspath(__file__)
+tools_dir = os.path.dirname(self_path)
+daplink_dir = os.path.dirname(tools_dir)
+
+PROJECTS_YAML = os.path.join(daplink_dir, "projects.yaml")
+
+# The firmware stores pointers in uint32_t, so everything it touches must
+# live below 4GB: no PIE, and the thread stacks are static (rtos_posix).
+# char is unsigned on ARM and wchar_t is 16 bit like in the gcc_arm build.
+CFLAGS = ["-std=gnu99", "-g", "-O1", "-pthread", "-fno-pie", "-fno-common",
+          "-funsigned-char", "-fshort-wchar",
+          "-Wno-int-to-pointer-cast", "-Wno-pointer-to-int-cast"]
+LDFLAGS = ["-no-pie", "-pthread"]
+
+
+def flatten(records):
+    for record in records:
+        if isinstance(record, list):
+            for sub_record in flatten(record):
+                yield sub_record
+        else:
+            yield record
+
+
+def load_project(name):
+    with open(PROJECTS_YAML, 'r') as top_yaml:
+        projects = yaml.safe_load(top_yaml)['projects']
+    if name not in projects:
+        print("Unknown project '%s'" % name)
+        exit(-1)
+
+    macros = []
+    includes = []
+    sources = []
+    for record in flatten(projects[name]):
+        with open(os.path.join(daplink_dir, record), 'r') as record_yaml:
+            common = (yaml.safe_load(record_yaml) or {}).get('common', {})
+        macros += common.get('macros', [])
+        # The HIC headers shadow the CMSIS ones (cmsis_compiler.h)
+        if record.startswith("records/hic_hal"):
+            includes = common.get('includes', []) + includes
+        else:
+            includes += common.get('includes', [])
+        for group in common.get('sources', {}).values():
+            sources += group
+    return macros, includes, sources
+
+
+def find_sources(paths):
+    files = []
+    for path in paths:
+        full_path = os.path.join(daplink_dir, path)
+        if os.path.isdir(full_path):
+            # Like progen, directories are not searched recursively
+            files += [os.path.join(full_path, f) for f in sorted(os.listdir(full_path))
+                      if f.endswith(".c")]
+        elif full_path.endswith(".c"):
+            files.append(full_path)
+    return sorted(set(files))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build a host_sim DAPLink project with the host gcc')
+    parser.add_argument('project', help='Project from projects.yaml', nargs='?', default='host_sim_if')
+    parser.add_argument('--cc', type=str, default='gcc', help='C compiler (default: gcc)')
+    parser.add_argument('--m32', dest='m32', action='store_true', help='Build a 32 bit executable')
+    parser.add_argument('--build-dir', type=str, help='Output directory (default: projectfiles/host_sim/<project>/build)')
+    parser.add_argument('-j', dest='jobs', type=int, default=0, help='Parallel compilations (default: core count)')
+    parser.add_argument('-v', dest='verbosity', action='count', help='Print the compiler commands', default=0)
+    args = parser.parse_args()
+
+    build_dir = args.build_dir or os.path.join(daplink_dir, "projectfiles", "host_sim", args.project, "build")
+    if not os.path.isdir(build_dir):
+        os.makedirs(build_dir)
+    if generate_version_file(build_dir):
+        exit(-1)
+
+    macros, includes, sources = load_project(args.project)
+    cflags = list(CFLAGS) + (["-m32"] if args.m32 else [])
+    cflags += ["-D" + str(macro) for macro in macros]
+    cflags += ["-I" + build_dir] + ["-I" + os.path.join(daplink_dir, inc) for inc in includes]
+    ldflags = list(LDFLAGS) + (["-m32"] if args.m32 else [])
+
+    def compile_source(source):
+        obj = os.path.join(build_dir, os.path.relpath(source, daplink_dir).replace(os.sep, "_")[:-2] + ".o")
+        cmd = [args.cc] + cflags + ["-c", source, "-o", obj]
+        if args.verbosity:
+            print(" ".join(cmd))
+        else:
+            print("Compiling %s" % os.path.relpath(source, daplink_dir))
+        return obj, subprocess.call(cmd)
+
+    pool = ThreadPool(args.jobs or None)
+    results = pool.map(compile_source, find_sources(sources))
+    pool.close()
+    if any(result != 0 for _, result in results):
+        exit(-1)
+
+    output = os.path.join(build_dir, args.project)
+    cmd = [args.cc] + ldflags + [obj for obj, _ in results] + ["-o", output]
+    if args.verbosity:
+        print(" ".join(cmd))
+    if subprocess.call(cmd) != 0:
+        exit(-1)
+    print("Built %s" % output)
+
+
+if __name__ == "__main__":
+    main()
@@ -123,12 +123,15 @@ def post_build_script(input_file, output_file, board_id=None, family_id=None, bi
         if pack_flash_algo is not None:
             blob_header = (0xE00ABE00, 0x062D780D, 0x24084068, 0xD3000040, 0x1E644058, 0x1C49D1FA, 0x2A001E52, 0x4770D1F2)
             stack_size = 0x200
-            region_info_fmt = '5I'
+            region_info_fmt = '6I'
             region_info_total = 10
-            target_cfg_fmt = '3I'+ region_info_fmt*region_info_total*2 + 'IHBB'
+            # target_cfg_t up to and including the target vendor and part number strings
+            target_cfg_fmt = '3I'+ region_info_fmt*region_info_total*2 + 'IHBB' + '2I'
             sector_info_fmt = '2I'
             sector_info_len = len(pack_flash_algo.sector_sizes)
-            program_target_fmt = '14I'
+            # program_target_t, up to and including program_compressed
+            program_target_fmt = '17I'
+            algo_flags = 0x1 #kAlgoVerifyReturnsAddress, Verify of a CMSIS-Pack algo returns the end address
             flash_blob_entry = int(flash_blob_entry, 16)
             blob_pad_size = ((len(pack_flash_algo.algo_data) + ALIGN_PADS -1) // ALIGN_PADS * ALIGN_PADS) - len(pack_flash_algo.algo_data)
             blob_header_size = len(blob_header) * 4
@@ -161,20 +164,26 @@ def post_build_script(input_file, output_file, board_id=None, family_id=None, bi
                                                             flash_blob_entry, #location to write prog_blob in target RAM
                                                             blob_header_size + len(pack_flash_algo.algo_data) + blob_pad_size, #prog_blob size
                                                             flash_blob_addr, #address of prog_blob
-                                                            pack_flash_algo.page_size #ram_to_flash_bytes_to_be_written
+                                                            pack_flash_algo.page_size, #ram_to_flash_bytes_to_be_written
+                                                            algo_flags, #algo_flags
+                                                            0, #program_pages, the blob has no ProgramPages routine
+                                                            0 #program_compressed, nor a ProgramCompressed routine
                                                             ))
             target_cfg_addr = program_target_addr + struct.calcsize(program_target_fmt)
+            # The whole target_cfg_t must fit before the CRC, its last words are read as pointers
+            assert target_cfg_addr + struct.calcsize(target_cfg_fmt) == end + 1 - 4
             print("target_cfg offset:", hex(target_cfg_addr - start))
             if target_ram_start is None or target_ram_end is None:
                  raise Exception("target_ram_start and target_ram_end should be defined!")
-            first_flash_region = (pack_flash_algo.flash_start, pack_flash_algo.flash_start + pack_flash_algo.flash_size, 1, 0, program_target_addr)
-            first_ram_region = (int(target_ram_start, 16), int(target_ram_end, 16), 0, 0, 0)
-            emypty_region = (0, 0, 0, 0, 0) * (region_info_total -1)
+            first_flash_region = (pack_flash_algo.flash_start, pack_flash_algo.flash_start + pack_flash_algo.flash_size, 1, 0, program_target_addr, 0)
+            first_ram_region = (int(target_ram_start, 16), int(target_ram_end, 16), 0, 0, 0, 0)
+            emypty_region = (0, 0, 0, 0, 0, 0) * (region_info_total -1)
             all_regions = first_flash_region + emypty_region + first_ram_region + emypty_region
             target_flags = ( 0, 0, 0, 0) #realtime board ID, family ID and erase reset flag
-            regions_flags = all_regions + target_flags
+            target_strings = (0, 0) #target vendor and part number
+            regions_flags = all_regions + target_flags + target_strings
             new_hex_file.puts(target_cfg_addr, struct.pack('<' + target_cfg_fmt,
-                                                            0x1,                #script generated
+                                                            0x2,                #script generated, kTargetConfigVersion
                                                             sector_info_addr,   # Sector start and length list
                                                             sector_info_len,    #Sector start and length list total
                                                             *regions_flags
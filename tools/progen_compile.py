@@ -95,6 +95,8 @@ if 'armc' in toolchain:
 # musca projects are too large to fit when compiled with gcc. LTO should fix that but it does not work (yet)
 if 'gcc' in toolchain and args.release:
     project_list = list(filter(lambda p: "musca" not in p, project_list))
+# host_sim projects run on the development machine and are built by host_sim_build.py
+project_list = list(filter(lambda p: not p.startswith("host_sim"), project_list))
 # remove all test projects from list
 if not args.test:
     project_list = list(filter(lambda p: not p.endswith("test_if"), project_list))